@@ -0,0 +1,314 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by agent                                           *
+ *   agent@local                                                           *
+ *                                                                         *
+ *   This file is part of the dbus-cxx library.                            *
+ *                                                                         *
+ *   The dbus-cxx library is free software; you can redistribute it and/or *
+ *   modify it under the terms of the GNU General Public License           *
+ *   version 3 as published by the Free Software Foundation.               *
+ *                                                                         *
+ *   The dbus-cxx library is distributed in the hope that it will be       *
+ *   useful, but WITHOUT ANY WARRANTY; without even the implied warranty   *
+ *   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU   *
+ *   General Public License for more details.                              *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this software. If not see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#include "benchmark.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+Benchmarks::Benchmarks():
+    m_min_time( 0.2 ),
+    m_repetitions( 3 )
+{
+}
+
+void Benchmarks::add( const std::string& name, Function function, uint64_t bytes_per_op )
+{
+  Entry entry;
+  entry.name = name;
+  entry.function = function;
+  entry.bytes_per_op = bytes_per_op;
+  m_entries.push_back( entry );
+}
+
+void Benchmarks::set_filter( const std::string& filter )
+{
+  m_filter = filter;
+}
+
+void Benchmarks::set_min_time( double seconds )
+{
+  m_min_time = seconds;
+}
+
+void Benchmarks::set_repetitions( unsigned int repetitions )
+{
+  m_repetitions = ( repetitions == 0 ) ? 1 : repetitions;
+}
+
+std::vector<std::string> Benchmarks::names() const
+{
+  std::vector<std::string> result;
+
+  for ( size_t i = 0; i < m_entries.size(); i++ )
+  {
+    if ( m_filter.empty() or m_entries[i].name.find( m_filter ) != std::string::npos )
+      result.push_back( m_entries[i].name );
+  }
+
+  return result;
+}
+
+const std::vector<Benchmarks::Result>& Benchmarks::run()
+{
+  m_results.clear();
+
+  for ( size_t i = 0; i < m_entries.size(); i++ )
+  {
+    if ( not m_filter.empty() and m_entries[i].name.find( m_filter ) == std::string::npos ) continue;
+
+    Result result = this->measure( m_entries[i] );
+    m_results.push_back( result );
+
+    std::fprintf( stderr, "%-48s %12.1f ns/op %12llu iterations",
+                  result.name.c_str(), result.ns_per_op, (unsigned long long)result.iterations );
+    if ( result.bytes_per_op > 0 and result.ns_per_op > 0 )
+      std::fprintf( stderr, " %10.1f MB/s", result.bytes_per_op * 1000.0 / result.ns_per_op );
+    std::fprintf( stderr, "\n" );
+  }
+
+  return m_results;
+}
+
+Benchmarks::Result Benchmarks::measure( const Entry& entry ) const
+{
+  typedef std::chrono::steady_clock clock;
+  Result result;
+  uint64_t iterations = 1;
+  double elapsed = 0;
+
+  result.name = entry.name;
+  result.bytes_per_op = entry.bytes_per_op;
+
+  // Find an iteration count that runs for at least the minimum time
+  while ( true )
+  {
+    clock::time_point start = clock::now();
+    entry.function( iterations );
+    elapsed = std::chrono::duration<double>( clock::now() - start ).count();
+
+    if ( elapsed >= m_min_time or iterations >= ( UINT64_C(1) << 40 ) ) break;
+
+    if ( elapsed <= 0 ) iterations *= 10;
+    else iterations = (uint64_t)( iterations * std::min( 10.0, 1.4 * m_min_time / elapsed ) ) + 1;
+  }
+
+  // The fastest repetition is the least disturbed by the rest of the system
+  result.iterations = iterations;
+  result.ns_per_op = elapsed * 1e9 / iterations;
+
+  for ( unsigned int r = 1; r < m_repetitions; r++ )
+  {
+    clock::time_point start = clock::now();
+    entry.function( iterations );
+    elapsed = std::chrono::duration<double>( clock::now() - start ).count();
+    result.ns_per_op = std::min( result.ns_per_op, elapsed * 1e9 / iterations );
+  }
+
+  return result;
+}
+
+const std::vector<Benchmarks::Result>& Benchmarks::results() const
+{
+  return m_results;
+}
+
+std::string Benchmarks::to_json() const
+{
+  std::ostringstream json;
+  char ns_per_op[32];
+
+  json << "{\n"
+       << "  \"library\": \"dbus-cxx\",\n"
+       << "  \"version\": \"" << DBUS_CXX_PACKAGE_MAJOR_VERSION << "."
+                              << DBUS_CXX_PACKAGE_MINOR_VERSION << "."
+                              << DBUS_CXX_PACKAGE_MICRO_VERSION << "\",\n"
+       << "  \"benchmarks\": [\n";
+
+  for ( size_t i = 0; i < m_results.size(); i++ )
+  {
+    std::snprintf( ns_per_op, sizeof(ns_per_op), "%.3f", m_results[i].ns_per_op );
+    json << "    { \"name\": \"" << m_results[i].name << "\""
+         << ", \"iterations\": " << m_results[i].iterations
+         << ", \"ns_per_op\": " << ns_per_op
+         << ", \"bytes_per_op\": " << m_results[i].bytes_per_op << " }"
+         << ( i + 1 < m_results.size() ? ",\n" : "\n" );
+  }
+
+  json << "  ]\n"
+       << "}\n";
+
+  return json.str();
+}
+
+std::vector<Benchmarks::Result> Benchmarks::from_json( const std::string& json )
+{
+  std::vector<Result> results;
+  std::istringstream in( json );
+  std::string line;
+
+  // Only the layout written by to_json() is understood: one benchmark per line
+  while ( std::getline( in, line ) )
+  {
+    size_t name = line.find( "\"name\": \"" );
+    if ( name == std::string::npos ) continue;
+
+    Result result;
+    name += 9;
+    result.name = line.substr( name, line.find( '"', name ) - name );
+
+    size_t iterations = line.find( "\"iterations\": " );
+    size_t ns_per_op = line.find( "\"ns_per_op\": " );
+    size_t bytes_per_op = line.find( "\"bytes_per_op\": " );
+    if ( iterations == std::string::npos or ns_per_op == std::string::npos ) continue;
+
+    result.iterations = std::strtoull( line.c_str() + iterations + 14, NULL, 10 );
+    result.ns_per_op = std::strtod( line.c_str() + ns_per_op + 13, NULL );
+    result.bytes_per_op = ( bytes_per_op == std::string::npos ) ? 0 : std::strtoull( line.c_str() + bytes_per_op + 16, NULL, 10 );
+    results.push_back( result );
+  }
+
+  return results;
+}
+
+unsigned int Benchmarks::compare( const std::vector<Result>& baseline, double tolerance ) const
+{
+  unsigned int regressions = 0;
+
+  for ( size_t i = 0; i < m_results.size(); i++ )
+  {
+    for ( size_t j = 0; j < baseline.size(); j++ )
+    {
+      if ( baseline[j].name != m_results[i].name or baseline[j].ns_per_op <= 0 ) continue;
+
+      double change = ( m_results[i].ns_per_op / baseline[j].ns_per_op - 1.0 ) * 100.0;
+      if ( change > tolerance ) {
+        std::fprintf( stderr, "REGRESSION %s: %.1f ns/op -> %.1f ns/op (%+.1f%%)\n",
+                      m_results[i].name.c_str(), baseline[j].ns_per_op, m_results[i].ns_per_op, change );
+        regressions++;
+      }
+      break;
+    }
+  }
+
+  return regressions;
+}
+
+DBus::Dispatcher::pointer benchmark_dispatcher()
+{
+  static DBus::Dispatcher::pointer dispatcher;
+  if ( not dispatcher ) dispatcher = DBus::Dispatcher::create();
+  return dispatcher;
+}
+
+DBus::LoopbackBus::pointer benchmark_bus()
+{
+  static DBus::LoopbackBus::pointer bus;
+  if ( not bus ) bus = DBus::LoopbackBus::create( benchmark_dispatcher() );
+  return bus;
+}
+
+static void usage( const char* program )
+{
+  std::cerr << "Usage: " << program << " [options]\n"
+            << "  --filter TEXT       only run benchmarks whose name contains TEXT\n"
+            << "  --list              list the benchmarks and exit\n"
+            << "  --min-time SECONDS  minimum duration of one measurement (default 0.2)\n"
+            << "  --repetitions N     measurements per benchmark, the fastest is kept (default 3)\n"
+            << "  --output FILE       write the JSON results to FILE instead of stdout\n"
+            << "  --baseline FILE     compare with earlier JSON results\n"
+            << "  --tolerance PERCENT slowdown allowed against the baseline (default 10)\n"
+            << "Exits with 2 if any benchmark regressed against the baseline.\n";
+}
+
+int main( int argc, char** argv )
+{
+  Benchmarks benchmarks;
+  std::string output;
+  std::string baseline;
+  double tolerance = 10.0;
+  bool list = false;
+
+  for ( int i = 1; i < argc; i++ )
+  {
+    std::string arg = argv[i];
+    bool has_value = ( i + 1 < argc );
+
+    if ( arg == "--filter" and has_value ) benchmarks.set_filter( argv[++i] );
+    else if ( arg == "--list" ) list = true;
+    else if ( arg == "--min-time" and has_value ) benchmarks.set_min_time( std::atof( argv[++i] ) );
+    else if ( arg == "--repetitions" and has_value ) benchmarks.set_repetitions( std::atoi( argv[++i] ) );
+    else if ( arg == "--output" and has_value ) output = argv[++i];
+    else if ( arg == "--baseline" and has_value ) baseline = argv[++i];
+    else if ( arg == "--tolerance" and has_value ) tolerance = std::atof( argv[++i] );
+    else {
+      usage( argv[0] );
+      return 1;
+    }
+  }
+
+  DBus::init();
+
+  add_marshalling_benchmarks( benchmarks );
+  add_dispatch_benchmarks( benchmarks );
+  add_roundtrip_benchmarks( benchmarks );
+
+  if ( list ) {
+    std::vector<std::string> names = benchmarks.names();
+    for ( size_t i = 0; i < names.size(); i++ ) std::cout << names[i] << "\n";
+    return 0;
+  }
+
+  try {
+    benchmarks.run();
+  }
+  catch ( DBus::Error::pointer e ) {
+    std::cerr << "Benchmark failed: " << e->name() << ": " << e->message() << std::endl;
+    return 1;
+  }
+
+  if ( output.empty() ) {
+    std::cout << benchmarks.to_json();
+  }
+  else {
+    std::ofstream out( output.c_str() );
+    out << benchmarks.to_json();
+    if ( not out ) {
+      std::cerr << "Unable to write " << output << std::endl;
+      return 1;
+    }
+  }
+
+  if ( not baseline.empty() ) {
+    std::ifstream in( baseline.c_str() );
+    std::stringstream json;
+    json << in.rdbuf();
+    if ( not in ) {
+      std::cerr << "Unable to read " << baseline << std::endl;
+      return 1;
+    }
+    if ( benchmarks.compare( Benchmarks::from_json( json.str() ), tolerance ) > 0 ) return 2;
+  }
+
+  return 0;
+}
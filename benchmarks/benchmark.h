@@ -0,0 +1,127 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by agent                                           *
+ *   agent@local                                                           *
+ *                                                                         *
+ *   This file is part of the dbus-cxx library.                            *
+ *                                                                         *
+ *   The dbus-cxx library is free software; you can redistribute it and/or *
+ *   modify it under the terms of the GNU General Public License           *
+ *   version 3 as published by the Free Software Foundation.               *
+ *                                                                         *
+ *   The dbus-cxx library is distributed in the hope that it will be       *
+ *   useful, but WITHOUT ANY WARRANTY; without even the implied warranty   *
+ *   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU   *
+ *   General Public License for more details.                              *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this software. If not see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#include <functional>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include <dbus-cxx.h>
+
+#ifndef DBUSCXX_BENCHMARK_H
+#define DBUSCXX_BENCHMARK_H
+
+/**
+ * A small harness for the dbus-cxx microbenchmarks.
+ *
+ * Each benchmark is a function that runs its operation a given number of
+ * times. The runner grows the iteration count until one run lasts at least
+ * the minimum time, repeats the run and keeps the fastest, and reports the
+ * time per operation as JSON so that results can be compared between builds.
+ */
+class Benchmarks
+{
+  public:
+
+    /** Runs the measured operation the given number of times */
+    typedef std::function<void(uint64_t)> Function;
+
+    struct Result
+    {
+      std::string name;
+      uint64_t iterations;
+      double ns_per_op;
+      uint64_t bytes_per_op;
+    };
+
+    Benchmarks();
+
+    /**
+     * Adds a benchmark
+     * @param bytes_per_op The payload size of one operation, used to report throughput
+     */
+    void add( const std::string& name, Function function, uint64_t bytes_per_op=0 );
+
+    /** Only benchmarks whose name contains the filter are run */
+    void set_filter( const std::string& filter );
+
+    void set_min_time( double seconds );
+
+    void set_repetitions( unsigned int repetitions );
+
+    /** The names of the benchmarks the filter selects */
+    std::vector<std::string> names() const;
+
+    /** Runs the selected benchmarks, printing progress to stderr */
+    const std::vector<Result>& run();
+
+    const std::vector<Result>& results() const;
+
+    std::string to_json() const;
+
+    /** Reads results written by to_json() */
+    static std::vector<Result> from_json( const std::string& json );
+
+    /**
+     * Compares the results with a baseline, printing every benchmark that
+     * got slower by more than tolerance percent
+     * @return the number of regressions
+     */
+    unsigned int compare( const std::vector<Result>& baseline, double tolerance ) const;
+
+  protected:
+
+    struct Entry
+    {
+      std::string name;
+      Function function;
+      uint64_t bytes_per_op;
+    };
+
+    std::vector<Entry> m_entries;
+
+    std::vector<Result> m_results;
+
+    std::string m_filter;
+
+    double m_min_time;
+
+    unsigned int m_repetitions;
+
+    Result measure( const Entry& entry ) const;
+};
+
+/** The bus shared by the benchmarks that need one, started on first use */
+DBus::LoopbackBus::pointer benchmark_bus();
+
+DBus::Dispatcher::pointer benchmark_dispatcher();
+
+void add_marshalling_benchmarks( Benchmarks& benchmarks );
+
+void add_dispatch_benchmarks( Benchmarks& benchmarks );
+
+void add_roundtrip_benchmarks( Benchmarks& benchmarks );
+
+/** Keeps the compiler from discarding a value a benchmark computes */
+template <typename T>
+inline void do_not_optimize( const T& value )
+{
+  asm volatile( "" : : "g"( &value ) : "memory" );
+}
+
+#endif
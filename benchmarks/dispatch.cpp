@@ -0,0 +1,146 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by agent                                           *
+ *   agent@local                                                           *
+ *                                                                         *
+ *   This file is part of the dbus-cxx library.                            *
+ *                                                                         *
+ *   The dbus-cxx library is free software; you can redistribute it and/or *
+ *   modify it under the terms of the GNU General Public License           *
+ *   version 3 as published by the Free Software Foundation.               *
+ *                                                                         *
+ *   The dbus-cxx library is distributed in the hope that it will be       *
+ *   useful, but WITHOUT ANY WARRANTY; without even the implied warranty   *
+ *   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU   *
+ *   General Public License for more details.                              *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this software. If not see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#include "benchmark.h"
+
+#include <atomic>
+#include <sstream>
+
+/*
+ * Method<> dispatch through Object::handle_message() and signal fan-out
+ * through Connection::on_filter_callback() to signal proxies.
+ */
+
+static double add( double a, double b )
+{
+  return a + b;
+}
+
+static std::atomic<uint64_t> received( 0 );
+
+static void on_signal( int32_t )
+{
+  received++;
+}
+
+struct MethodFixture
+{
+  DBus::Connection::pointer connection;
+  DBus::Object::pointer object;
+  DBus::CallMessage::pointer call;
+
+  MethodFixture( unsigned int methods )
+  {
+    connection = benchmark_bus()->create_connection();
+
+    object = DBus::Object::create( "/bench/dispatch" );
+    for ( unsigned int i = 0; i < methods; i++ ) {
+      std::ostringstream name;
+      name << "Add" << i;
+      object->create_method<double,double,double>( "bench.Dispatch", name.str(), sigc::ptr_fun( add ) );
+    }
+
+    std::ostringstream name;
+    name << "Add" << methods - 1;
+    call = DBus::CallMessage::create( "/bench/dispatch", "bench.Dispatch", name.str() );
+    *call << 1.0 << 2.0;
+    // A reply needs the serial a sent call would have had
+    dbus_message_set_serial( call->cobj(), 1 );
+    // Methods build no reply to such a call, so nothing queues up on the bus
+    call->set_no_reply( true );
+  }
+};
+
+struct FanoutFixture
+{
+  DBus::Connection::pointer receiver;
+  DBus::SignalMessage::pointer message;
+  std::vector<DBus::signal_proxy<void,int32_t>::pointer> proxies;
+
+  /**
+   * The receiver has one proxy per path and the signal is for the last
+   * path, so that delivery has to look past every other proxy first
+   */
+  FanoutFixture( unsigned int paths, unsigned int slots )
+  {
+    receiver = benchmark_bus()->create_connection();
+
+    for ( unsigned int i = 0; i < paths; i++ ) {
+      std::ostringstream path;
+      path << "/bench/fanout/" << i;
+      proxies.push_back( receiver->create_signal_proxy<void,int32_t>( path.str(), "bench.Fanout", "Tick" ) );
+    }
+
+    for ( unsigned int i = 0; i < slots; i++ )
+      proxies.back()->connect( sigc::ptr_fun( on_signal ) );
+
+    message = DBus::SignalMessage::create( proxies.back()->path(), "bench.Fanout", "Tick" );
+    *message << (int32_t)1;
+  }
+};
+
+static void add_method( Benchmarks& benchmarks, unsigned int methods )
+{
+  std::ostringstream name;
+  name << "dispatch/method/" << methods;
+
+  // Fixtures are built on first use, so unselected benchmarks cost nothing
+  std::shared_ptr<MethodFixture> fixture;
+
+  benchmarks.add( name.str(), [fixture, methods]( uint64_t iterations ) mutable {
+    if ( not fixture ) fixture.reset( new MethodFixture( methods ) );
+
+    for ( uint64_t i = 0; i < iterations; i++ ) {
+      DBus::HandlerResult result = fixture->object->handle_message( fixture->connection, fixture->call );
+      do_not_optimize( result );
+    }
+  } );
+}
+
+static void add_fanout( Benchmarks& benchmarks, unsigned int paths, unsigned int slots )
+{
+  std::ostringstream name;
+  name << "signal/fanout/paths:" << paths << "/slots:" << slots;
+
+  std::shared_ptr<FanoutFixture> fixture;
+
+  benchmarks.add( name.str(), [fixture, paths, slots]( uint64_t iterations ) mutable {
+    if ( not fixture ) fixture.reset( new FanoutFixture( paths, slots ) );
+
+    uint64_t expected = received + iterations * slots;
+
+    // Straight into the receiver's filter, so no socket hop is measured
+    for ( uint64_t i = 0; i < iterations; i++ ) {
+      DBus::HandlerResult result = fixture->receiver->deliver_incoming( fixture->message );
+      do_not_optimize( result );
+    }
+
+    if ( received != expected )
+      throw DBus::ErrorFailed::create( "signal/fanout: not every slot was called" );
+  } );
+}
+
+void add_dispatch_benchmarks( Benchmarks& benchmarks )
+{
+  add_method( benchmarks, 1 );
+  add_method( benchmarks, 64 );
+
+  add_fanout( benchmarks, 1, 1 );
+  add_fanout( benchmarks, 1, 16 );
+  add_fanout( benchmarks, 128, 1 );
+}
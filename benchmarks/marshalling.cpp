@@ -0,0 +1,106 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by agent                                           *
+ *   agent@local                                                           *
+ *                                                                         *
+ *   This file is part of the dbus-cxx library.                            *
+ *                                                                         *
+ *   The dbus-cxx library is free software; you can redistribute it and/or *
+ *   modify it under the terms of the GNU General Public License           *
+ *   version 3 as published by the Free Software Foundation.               *
+ *                                                                         *
+ *   The dbus-cxx library is distributed in the hope that it will be       *
+ *   useful, but WITHOUT ANY WARRANTY; without even the implied warranty   *
+ *   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU   *
+ *   General Public License for more details.                              *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this software. If not see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#include "benchmark.h"
+
+#include <map>
+#include <sstream>
+
+/*
+ * MessageAppendIterator and MessageIterator for every basic type and for
+ * arrays, strings and dictionaries of several sizes. Marshalling includes
+ * creating the call message; message/create measures that part alone.
+ */
+
+template <typename T>
+static void add_type( Benchmarks& benchmarks, const std::string& name, const T& value, uint64_t bytes )
+{
+  DBus::CallMessage::pointer filled = DBus::CallMessage::create( "/bench", "bench.Marshal", "Method" );
+  *filled << value;
+
+  benchmarks.add( "marshal/" + name, [value]( uint64_t iterations ) {
+    for ( uint64_t i = 0; i < iterations; i++ ) {
+      DBus::CallMessage::pointer msg = DBus::CallMessage::create( "/bench", "bench.Marshal", "Method" );
+      *msg << value;
+      do_not_optimize( msg );
+    }
+  }, bytes );
+
+  benchmarks.add( "demarshal/" + name, [filled]( uint64_t iterations ) {
+    for ( uint64_t i = 0; i < iterations; i++ ) {
+      T result;
+      filled->begin() >> result;
+      do_not_optimize( result );
+    }
+  }, bytes );
+}
+
+static std::string sized( const std::string& name, size_t size )
+{
+  std::ostringstream result;
+  result << name << "/" << size;
+  return result.str();
+}
+
+void add_marshalling_benchmarks( Benchmarks& benchmarks )
+{
+  benchmarks.add( "message/create-call", []( uint64_t iterations ) {
+    for ( uint64_t i = 0; i < iterations; i++ ) {
+      DBus::CallMessage::pointer msg = DBus::CallMessage::create( "/bench", "bench.Marshal", "Method" );
+      do_not_optimize( msg );
+    }
+  } );
+
+  add_type( benchmarks, "bool", true, sizeof(uint32_t) );
+  add_type( benchmarks, "uint8", (uint8_t)7, sizeof(uint8_t) );
+  add_type( benchmarks, "int16", (int16_t)-7, sizeof(int16_t) );
+  add_type( benchmarks, "uint16", (uint16_t)7, sizeof(uint16_t) );
+  add_type( benchmarks, "int32", (int32_t)-7, sizeof(int32_t) );
+  add_type( benchmarks, "uint32", (uint32_t)7, sizeof(uint32_t) );
+  add_type( benchmarks, "int64", (int64_t)-7, sizeof(int64_t) );
+  add_type( benchmarks, "uint64", (uint64_t)7, sizeof(uint64_t) );
+  add_type( benchmarks, "double", 7.5, sizeof(double) );
+  add_type( benchmarks, "path", DBus::Path( "/org/freedesktop/DBus/Benchmark" ), 31 );
+  add_type( benchmarks, "signature", DBus::Signature( "a{sv}" ), 5 );
+
+  const size_t string_sizes[] = { 16, 1024, 65536 };
+  for ( size_t i = 0; i < sizeof(string_sizes) / sizeof(string_sizes[0]); i++ )
+    add_type( benchmarks, sized( "string", string_sizes[i] ), std::string( string_sizes[i], 'x' ), string_sizes[i] );
+
+  const size_t byte_sizes[] = { 64, 4096, 1024 * 1024 };
+  for ( size_t i = 0; i < sizeof(byte_sizes) / sizeof(byte_sizes[0]); i++ )
+    add_type( benchmarks, sized( "array-uint8", byte_sizes[i] ), std::vector<uint8_t>( byte_sizes[i], 3 ), byte_sizes[i] );
+
+  const size_t element_sizes[] = { 16, 1024 };
+  for ( size_t i = 0; i < sizeof(element_sizes) / sizeof(element_sizes[0]); i++ )
+  {
+    size_t size = element_sizes[i];
+    std::map<std::string,int32_t> dictionary;
+
+    for ( size_t j = 0; j < size; j++ ) {
+      std::ostringstream key;
+      key << "key" << j;
+      dictionary[ key.str() ] = j;
+    }
+
+    add_type( benchmarks, sized( "array-int32", size ), std::vector<int32_t>( size, 3 ), size * sizeof(int32_t) );
+    add_type( benchmarks, sized( "array-double", size ), std::vector<double>( size, 3.0 ), size * sizeof(double) );
+    add_type( benchmarks, sized( "array-string", size ), std::vector<std::string>( size, std::string( 16, 'x' ) ), size * 16 );
+    add_type( benchmarks, sized( "dict-string-int32", size ), dictionary, 0 );
+  }
+}
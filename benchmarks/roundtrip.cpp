@@ -0,0 +1,134 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by agent                                           *
+ *   agent@local                                                           *
+ *                                                                         *
+ *   This file is part of the dbus-cxx library.                            *
+ *                                                                         *
+ *   The dbus-cxx library is free software; you can redistribute it and/or *
+ *   modify it under the terms of the GNU General Public License           *
+ *   version 3 as published by the Free Software Foundation.               *
+ *                                                                         *
+ *   The dbus-cxx library is distributed in the hope that it will be       *
+ *   useful, but WITHOUT ANY WARRANTY; without even the implied warranty   *
+ *   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU   *
+ *   General Public License for more details.                              *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this software. If not see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#include "benchmark.h"
+
+#include <sstream>
+#include <unistd.h>
+
+/*
+ * End to end calls: marshal, send, dispatch to the method, reply and
+ * demarshal. Calls either go through the loopback bus or straight to a
+ * Server over a private peer connection.
+ */
+
+static double add( double a, double b )
+{
+  return a + b;
+}
+
+static uint64_t size( std::vector<uint8_t> data )
+{
+  return data.size();
+}
+
+struct BusFixture
+{
+  DBus::Connection::pointer server;
+  DBus::Connection::pointer client;
+  DBus::Object::pointer object;
+  DBus::ObjectProxy::pointer proxy;
+  DBus::MethodProxy<double,double,double>::pointer add;
+  DBus::MethodProxy<uint64_t,std::vector<uint8_t> >::pointer size;
+
+  BusFixture()
+  {
+    server = benchmark_bus()->create_connection();
+    client = benchmark_bus()->create_connection();
+
+    object = server->create_object( "/bench/roundtrip" );
+    object->create_method<double,double,double>( "bench.RoundTrip", "Add", sigc::ptr_fun( ::add ) );
+    object->create_method<uint64_t,std::vector<uint8_t> >( "bench.RoundTrip", "Size", sigc::ptr_fun( ::size ) );
+
+    proxy = client->create_object_proxy( server->unique_name(), "/bench/roundtrip" );
+    add = proxy->create_method<double,double,double>( "bench.RoundTrip", "Add" );
+    size = proxy->create_method<uint64_t,std::vector<uint8_t> >( "bench.RoundTrip", "Size" );
+  }
+};
+
+struct PeerFixture
+{
+  DBus::Server::pointer server;
+  DBus::Connection::pointer client;
+  DBus::Object::pointer object;
+
+  PeerFixture()
+  {
+    std::ostringstream address;
+    address << "unix:abstract=dbus-cxx-benchmark-" << getpid();
+
+    server = DBus::Server::create( address.str() );
+    benchmark_dispatcher()->add_server( server );
+
+    object = DBus::Object::create( "/bench/roundtrip" );
+    object->create_method<double,double,double>( "bench.RoundTrip", "Add", sigc::ptr_fun( ::add ) );
+    server->register_object( object );
+
+    client = DBus::Connection::create_peer( server->address() );
+    benchmark_dispatcher()->add_connection( client );
+  }
+};
+
+// Built on first use, so unselected benchmarks cost nothing
+static BusFixture& bus()
+{
+  static BusFixture* fixture = new BusFixture();
+  return *fixture;
+}
+
+static PeerFixture& peer()
+{
+  static PeerFixture* fixture = new PeerFixture();
+  return *fixture;
+}
+
+void add_roundtrip_benchmarks( Benchmarks& benchmarks )
+{
+  benchmarks.add( "roundtrip/bus/double", []( uint64_t iterations ) {
+    for ( uint64_t i = 0; i < iterations; i++ ) {
+      double sum = (*bus().add)( 1.0, 2.0 );
+      do_not_optimize( sum );
+    }
+  } );
+
+  const size_t payload_sizes[] = { 4096, 1024 * 1024 };
+  for ( size_t s = 0; s < sizeof(payload_sizes) / sizeof(payload_sizes[0]); s++ )
+  {
+    std::ostringstream name;
+    std::vector<uint8_t> payload( payload_sizes[s], 3 );
+    name << "roundtrip/bus/array-uint8/" << payload.size();
+
+    benchmarks.add( name.str(), [payload]( uint64_t iterations ) {
+      for ( uint64_t i = 0; i < iterations; i++ ) {
+        uint64_t received = (*bus().size)( payload );
+        do_not_optimize( received );
+      }
+    }, payload.size() );
+  }
+
+  benchmarks.add( "roundtrip/peer/double", []( uint64_t iterations ) {
+    for ( uint64_t i = 0; i < iterations; i++ ) {
+      DBus::CallMessage::pointer call = DBus::CallMessage::create( "/bench/roundtrip", "bench.RoundTrip", "Add" );
+      *call << 1.0 << 2.0;
+      DBus::ReturnMessage::const_pointer reply = peer().client->send_with_reply_blocking( call );
+      double sum = 0;
+      reply->begin() >> sum;
+      do_not_optimize( sum );
+    }
+  } );
+}
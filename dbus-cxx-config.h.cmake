@@ -1,7 +1,17 @@
 #cmakedefine DBUS_CXX_HAVE_DBUS_12
+#cmakedefine DBUS_CXX_HAVE_MEMFD
+#cmakedefine DBUS_CXX_HAVE_EXECINFO
+#cmakedefine DBUS_CXX_HAVE_LZ4
+#cmakedefine DBUS_CXX_HAVE_ZSTD
+#cmakedefine DBUS_CXX_HAVE_SDT
 #define DBUS_CXX_USE_CXX0X_SMART_POINTER
 #cmakedefine DBUS_CXX_SIZEOF_LONG_INT @DBUS_CXX_SIZEOF_LONG_INT@
 
 #define DBUS_CXX_PACKAGE_MAJOR_VERSION ${DBUS_CXX_PACKAGE_MAJOR_VERSION}
 #define DBUS_CXX_PACKAGE_MINOR_VERSION ${DBUS_CXX_PACKAGE_MINOR_VERSION}
 #define DBUS_CXX_PACKAGE_MICRO_VERSION ${DBUS_CXX_PACKAGE_MICRO_VERSION}
+
+/* Log messages below this level are compiled out */
+#ifndef DBUS_CXX_LOG_FLOOR
+#define DBUS_CXX_LOG_FLOOR SL_${DBUS_CXX_LOG_FLOOR}
+#endif
@@ -69,8 +69,8 @@ namespace DBus
       thread_wakeup.events = POLLIN;
       
       while ( m_running ) {
-        // wait forever until some file descriptor has events
-        selresult = poll( fds.data(), fds.size(), -1 );
+        // wait until some file descriptor has events or a deferred call is due
+        selresult = poll( fds.data(), fds.size(), deferred_call_timeout() );
 
         m_glibmm_dispatcher.emit();
       }
@@ -79,6 +79,8 @@ namespace DBus
     void Dispatcher::on_glibmm_dispatch()
     {
       dispatch_connections();
+
+      process_deferred_calls();
     }
   
   }
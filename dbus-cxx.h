@@ -25,8 +25,10 @@
 
 #include <dbus-cxx/dbus-cxx-config.h>
 #include <dbus-cxx/accumulators.h>
+#include <dbus-cxx/arena.h>
 #include <dbus-cxx/callmessage.h>
 #include <dbus-cxx/connection.h>
+#include <dbus-cxx/connectionpool.h>
 #include <dbus-cxx/dbus_signal.h>
 #include <dbus-cxx/dispatcher.h>
 #include <dbus-cxx/enums.h>
@@ -34,6 +36,7 @@
 #include <dbus-cxx/errormessage.h>
 #include <dbus-cxx/interface.h>
 #include <dbus-cxx/interfaceproxy.h>
+#include <dbus-cxx/loopbackbus.h>
 #include <dbus-cxx/messageappenditerator.h>
 #include <dbus-cxx/messagefilter.h>
 #include <dbus-cxx/message.h>
@@ -43,12 +46,25 @@
 #include <dbus-cxx/method.h>
 #include <dbus-cxx/methodproxybase.h>
 #include <dbus-cxx/methodproxy.h>
+#include <dbus-cxx/metrics.h>
+#include <dbus-cxx/metricsobject.h>
 #include <dbus-cxx/object.h>
+#include <dbus-cxx/objectmanager.h>
+#include <dbus-cxx/objectmanagerproxy.h>
 #include <dbus-cxx/objectpathhandler.h>
+#include <dbus-cxx/objectpathrouter.h>
 #include <dbus-cxx/objectproxy.h>
 #include <dbus-cxx/pendingcall.h>
 #include <dbus-cxx/pointer.h>
+#include <dbus-cxx/property.h>
+#include <dbus-cxx/propertybase.h>
 #include <dbus-cxx/returnmessage.h>
+#include <dbus-cxx/result.h>
+#include <dbus-cxx/messageplayer.h>
+#include <dbus-cxx/messagerecorder.h>
+#include <dbus-cxx/server.h>
+#include <dbus-cxx/sharedbuffer.h>
+#include <dbus-cxx/compressedbuffer.h>
 #include <dbus-cxx/signal_base.h>
 #include <dbus-cxx/signalmessage.h>
 #include <dbus-cxx/signal_proxy_base.h>
@@ -57,9 +73,11 @@
 #include <dbus-cxx/signature.h>
 #include <dbus-cxx/signatureiterator.h>
 #include <dbus-cxx/timeout.h>
+#include <dbus-cxx/tracing.h>
 #include <dbus-cxx/utility.h>
 #include <dbus-cxx/watch.h>
 #include <dbus-cxx/variant.h>
+#include <dbus-cxx/virtualsubtree.h>
 #include <dbus-cxx/filedescriptor.h>
 #include <dbus-cxx/simplelogger_defs.h>
 
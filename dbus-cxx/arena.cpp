@@ -0,0 +1,156 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by agent                                           *
+ *   agent@local                                                           *
+ *                                                                         *
+ *   This file is part of the dbus-cxx library.                            *
+ *                                                                         *
+ *   The dbus-cxx library is free software; you can redistribute it and/or *
+ *   modify it under the terms of the GNU General Public License           *
+ *   version 3 as published by the Free Software Foundation.               *
+ *                                                                         *
+ *   The dbus-cxx library is distributed in the hope that it will be       *
+ *   useful, but WITHOUT ANY WARRANTY; without even the implied warranty   *
+ *   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU   *
+ *   General Public License for more details.                              *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this software. If not see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#include <cstdlib>
+
+#include "arena.h"
+
+namespace DBus
+{
+
+  static thread_local Arena* current_arena = NULL;
+
+  Arena::Arena( size_t block_size ):
+      m_blocks( NULL ),
+      m_cursor( NULL ),
+      m_end( NULL ),
+      m_allocated( 0 ),
+      m_capacity( 0 ),
+      m_block_size( block_size )
+  {
+  }
+
+  Arena::~Arena()
+  {
+    while ( m_blocks ) {
+      Block* next = m_blocks->next;
+      free( m_blocks );
+      m_blocks = next;
+    }
+  }
+
+  void* Arena::allocate( size_t size, size_t alignment )
+  {
+    uintptr_t cursor = (uintptr_t)m_cursor;
+    uintptr_t aligned = ( cursor + alignment - 1 ) & ~(uintptr_t)( alignment - 1 );
+
+    if ( m_cursor == NULL or aligned + size > (uintptr_t)m_end ) {
+      this->add_block( size + alignment );
+      cursor = (uintptr_t)m_cursor;
+      aligned = ( cursor + alignment - 1 ) & ~(uintptr_t)( alignment - 1 );
+    }
+
+    m_allocated += aligned + size - cursor;
+    m_cursor = (char*)( aligned + size );
+    return (void*)aligned;
+  }
+
+  void Arena::reset()
+  {
+    Block* kept = NULL;
+
+    // Keep one block of the usual size for the next message; an oversized
+    // block taken for one large value would otherwise be held forever
+    while ( m_blocks ) {
+      Block* next = m_blocks->next;
+      if ( kept == NULL and m_blocks->size == m_block_size ) {
+        kept = m_blocks;
+        kept->next = NULL;
+      } else {
+        m_capacity -= m_blocks->size;
+        free( m_blocks );
+      }
+      m_blocks = next;
+    }
+
+    m_blocks = kept;
+    m_allocated = 0;
+
+    if ( kept == NULL ) {
+      m_cursor = NULL;
+      m_end = NULL;
+      return;
+    }
+
+    m_cursor = (char*)( kept + 1 );
+    m_end = m_cursor + kept->size;
+  }
+
+  size_t Arena::bytes_allocated() const
+  {
+    return m_allocated;
+  }
+
+  size_t Arena::capacity() const
+  {
+    return m_capacity;
+  }
+
+  Arena* Arena::current()
+  {
+    return current_arena;
+  }
+
+  Arena& Arena::thread_arena()
+  {
+    static thread_local Arena arena;
+    return arena;
+  }
+
+  void Arena::add_block( size_t minimum )
+  {
+    size_t size = minimum > m_block_size ? minimum : m_block_size;
+    Block* block = (Block*)malloc( sizeof(Block) + size );
+
+    if ( block == NULL ) throw std::bad_alloc();
+
+    block->next = m_blocks;
+    block->size = size;
+    m_blocks = block;
+    m_capacity += size;
+
+    // Whatever was left at the end of the previous block goes unused
+    m_cursor = (char*)( block + 1 );
+    m_end = m_cursor + size;
+  }
+
+  ArenaScope::ArenaScope():
+      m_arena( Arena::thread_arena() ),
+      m_previous( current_arena ),
+      m_start( m_arena.bytes_allocated() )
+  {
+    current_arena = &m_arena;
+  }
+
+  ArenaScope::~ArenaScope()
+  {
+    current_arena = m_previous;
+    if ( m_previous == NULL ) m_arena.reset();
+  }
+
+  size_t ArenaScope::bytes_allocated() const
+  {
+    return m_arena.bytes_allocated() - m_start;
+  }
+
+  bool ArenaScope::is_outermost() const
+  {
+    return m_previous == NULL;
+  }
+
+}
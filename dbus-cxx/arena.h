@@ -0,0 +1,223 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by agent                                           *
+ *   agent@local                                                           *
+ *                                                                         *
+ *   This file is part of the dbus-cxx library.                            *
+ *                                                                         *
+ *   The dbus-cxx library is free software; you can redistribute it and/or *
+ *   modify it under the terms of the GNU General Public License           *
+ *   version 3 as published by the Free Software Foundation.               *
+ *                                                                         *
+ *   The dbus-cxx library is distributed in the hope that it will be       *
+ *   useful, but WITHOUT ANY WARRANTY; without even the implied warranty   *
+ *   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU   *
+ *   General Public License for more details.                              *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this software. If not see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#include <cstddef>
+#include <new>
+#include <string>
+#include <utility>
+#include <vector>
+#include <stdint.h>
+
+#include <dbus/dbus.h>
+#include <dbus-cxx/enums.h>
+
+#ifndef DBUSCXX_ARENA_H
+#define DBUSCXX_ARENA_H
+
+namespace DBus
+{
+
+  /**
+   * A monotonic buffer for the temporaries of handling one message.
+   *
+   * Allocation bumps a pointer through blocks taken from the heap;
+   * nothing is freed until reset(), which gives back every block but one
+   * of the usual size. Each thread has its own arena, so allocating from it takes no
+   * lock. While a Connection dispatches a message the arena of the
+   * dispatching thread is current and is reset once the message has been
+   * handled; anything allocated from it must not outlive the handler.
+   *
+   * @ingroup core
+   *
+   * @author agent <agent@local>
+   */
+  class Arena
+  {
+    public:
+
+      static const size_t BLOCK_SIZE = 4096;
+
+      Arena( size_t block_size=BLOCK_SIZE );
+
+      ~Arena();
+
+      /** Never returns NULL; throws std::bad_alloc if no block can be had */
+      void* allocate( size_t size, size_t alignment=sizeof(void*) );
+
+      void reset();
+
+      /** Bytes handed out since the last reset, including alignment padding */
+      size_t bytes_allocated() const;
+
+      /** Bytes held in blocks, used or not */
+      size_t capacity() const;
+
+      /**
+       * The arena of the calling thread while it dispatches a message, or
+       * NULL if it isn't dispatching.
+       */
+      static Arena* current();
+
+      /** The arena of the calling thread, current or not */
+      static Arena& thread_arena();
+
+    protected:
+
+      struct Block
+      {
+        Block* next;
+        size_t size;
+      };
+
+      Block* m_blocks;
+
+      char* m_cursor;
+
+      char* m_end;
+
+      size_t m_allocated;
+
+      size_t m_capacity;
+
+      size_t m_block_size;
+
+      void add_block( size_t minimum );
+
+    private:
+
+      Arena( const Arena& );
+
+      Arena& operator=( const Arena& );
+  };
+
+  /**
+   * Makes the calling thread's arena current for the life of the scope.
+   *
+   * Scopes nest; only the outermost one resets the arena when it ends, so
+   * a handler that dispatches again from within a dispatch does not free
+   * the memory of the message it is handling.
+   *
+   * @ingroup core
+   */
+  class ArenaScope
+  {
+    public:
+
+      ArenaScope();
+
+      ~ArenaScope();
+
+      /** Bytes taken from the arena since this scope began */
+      size_t bytes_allocated() const;
+
+      bool is_outermost() const;
+
+    protected:
+
+      Arena& m_arena;
+
+      Arena* m_previous;
+
+      size_t m_start;
+
+    private:
+
+      ArenaScope( const ArenaScope& );
+
+      ArenaScope& operator=( const ArenaScope& );
+  };
+
+  /**
+   * A standard allocator that takes memory from the arena that was current
+   * when it was created, or from the heap if none was.
+   *
+   * Method handlers can take ArenaString and ArenaVector arguments to have
+   * their demarshalled values built in the dispatch arena instead of on
+   * the heap. Such values must not be kept past the end of the handler.
+   *
+   * @ingroup core
+   */
+  template <typename T>
+  class ArenaAllocator
+  {
+    public:
+
+      typedef T value_type;
+      typedef T* pointer;
+      typedef const T* const_pointer;
+      typedef T& reference;
+      typedef const T& const_reference;
+      typedef size_t size_type;
+      typedef ptrdiff_t difference_type;
+
+      template <typename U>
+      struct rebind { typedef ArenaAllocator<U> other; };
+
+      ArenaAllocator(): m_arena( Arena::current() ) { }
+
+      explicit ArenaAllocator( Arena* arena ): m_arena( arena ) { }
+
+      template <typename U>
+      ArenaAllocator( const ArenaAllocator<U>& other ): m_arena( other.arena() ) { }
+
+      T* allocate( size_t n, const void* = 0 )
+      {
+        if ( m_arena ) return static_cast<T*>( m_arena->allocate( n * sizeof(T), alignof(T) ) );
+        return static_cast<T*>( ::operator new( n * sizeof(T) ) );
+      }
+
+      void deallocate( T* p, size_t )
+      {
+        if ( not m_arena ) ::operator delete( p );
+      }
+
+      size_t max_size() const { return size_t(-1) / sizeof(T); }
+
+      template <typename U, typename... Args>
+      void construct( U* p, Args&&... args ) { ::new( (void*)p ) U( std::forward<Args>( args )... ); }
+
+      template <typename U>
+      void destroy( U* p ) { p->~U(); }
+
+      Arena* arena() const { return m_arena; }
+
+    protected:
+
+      Arena* m_arena;
+  };
+
+  template <typename T, typename U>
+  inline bool operator==( const ArenaAllocator<T>& a, const ArenaAllocator<U>& b ) { return a.arena() == b.arena(); }
+
+  template <typename T, typename U>
+  inline bool operator!=( const ArenaAllocator<T>& a, const ArenaAllocator<U>& b ) { return a.arena() != b.arena(); }
+
+  typedef std::basic_string<char, std::char_traits<char>, ArenaAllocator<char> > ArenaString;
+
+  template <typename T>
+  using ArenaVector = std::vector<T, ArenaAllocator<T> >;
+
+  inline std::string signature( const ArenaString& ) { return DBUS_TYPE_STRING_AS_STRING; }
+
+  inline Type type( const ArenaString& ) { return TYPE_STRING; }
+
+  inline std::string type_string( const ArenaString& ) { return "ArenaString"; }
+
+}
+
+#endif
@@ -95,6 +95,9 @@ namespace DBus
 
   CallMessage::pointer CallMessage::create(DBusMessage * cobj)
   {
+    CallMessage::pointer cached_call = dbus_cxx_dynamic_pointer_cast<CallMessage>( Message::cached( cobj ) );
+    if ( cached_call ) return cached_call;
+
     try{
       return pointer( new CallMessage(cobj) );
     }catch(DBusCxxPointer<DBus::ErrorInvalidMessageType> err){
@@ -104,6 +107,9 @@ namespace DBus
 
   CallMessage::pointer CallMessage::create(Message::pointer msg)
   {
+    CallMessage::pointer call = dbus_cxx_dynamic_pointer_cast<CallMessage>( msg );
+    if ( call ) return call;
+
     try{
       return pointer( new CallMessage(msg) );
     }catch(DBusCxxPointer<DBus::ErrorInvalidMessageType> err){
@@ -113,6 +119,9 @@ namespace DBus
 
   CallMessage::const_pointer CallMessage::create(Message::const_pointer msg)
   {
+    CallMessage::const_pointer call = dbus_cxx_dynamic_pointer_cast<const CallMessage>( msg );
+    if ( call ) return call;
+
     try{
       return const_pointer( new CallMessage(msg) );
     }catch(DBusCxxPointer<DBus::ErrorInvalidMessageType> err){
@@ -0,0 +1,311 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by agent                                           *
+ *   agent@local                                                           *
+ *                                                                         *
+ *   This file is part of the dbus-cxx library.                            *
+ *                                                                         *
+ *   The dbus-cxx library is free software; you can redistribute it and/or *
+ *   modify it under the terms of the GNU General Public License           *
+ *   version 3 as published by the Free Software Foundation.               *
+ *                                                                         *
+ *   The dbus-cxx library is distributed in the hope that it will be       *
+ *   useful, but WITHOUT ANY WARRANTY; without even the implied warranty   *
+ *   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU   *
+ *   General Public License for more details.                              *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this software. If not see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#include "compressedbuffer.h"
+#include "connection.h"
+#include "error.h"
+#include "dbus-cxx-config.h"
+#include "dbus-cxx-private.h"
+
+#include <algorithm>
+#include <cstring>
+
+#ifdef DBUS_CXX_HAVE_LZ4
+#include <lz4.h>
+#endif
+
+#ifdef DBUS_CXX_HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+namespace DBus
+{
+
+  std::atomic<int> CompressedBuffer::m_default_codec( COMPRESSION_NONE );
+
+  std::atomic<size_t> CompressedBuffer::m_compression_threshold( 4 * 1024 );
+
+  std::atomic<size_t> CompressedBuffer::m_max_decoded_size( 128 * 1024 * 1024 );
+
+  CompressedBuffer::CompressedBuffer( const void* data, size_t size, CompressionCodec codec ):
+      m_codec( codec )
+  {
+    const uint8_t* bytes = static_cast<const uint8_t*>( data );
+    if ( bytes and size ) m_bytes.assign( bytes, bytes + size );
+  }
+
+  CompressedBuffer::pointer CompressedBuffer::create( const void* data, size_t size )
+  {
+    return pointer( new CompressedBuffer( data, size, default_codec() ) );
+  }
+
+  CompressedBuffer::pointer CompressedBuffer::create( const void* data, size_t size, CompressionCodec codec )
+  {
+    return pointer( new CompressedBuffer( data, size, codec ) );
+  }
+
+  CompressedBuffer::pointer CompressedBuffer::create( const std::vector<uint8_t>& data )
+  {
+    return pointer( new CompressedBuffer( data.data(), data.size(), default_codec() ) );
+  }
+
+  CompressedBuffer::pointer CompressedBuffer::create( const std::string& text )
+  {
+    return pointer( new CompressedBuffer( text.data(), text.size(), default_codec() ) );
+  }
+
+  CompressedBuffer::pointer CompressedBuffer::decode( const std::string& codec_name, const uint8_t* payload, size_t length )
+  {
+    if ( codec_name.empty() )
+    {
+      if ( length > max_decoded_size() ) throw ErrorInvalidArgs::create( "CompressedBuffer: payload is larger than the maximum size" );
+      return pointer( new CompressedBuffer( payload, length, COMPRESSION_NONE ) );
+    }
+
+#ifdef DBUS_CXX_HAVE_LZ4
+    if ( codec_name == "lz4" )
+    {
+      uint32_t size;
+
+      if ( length < 4 ) throw ErrorInvalidArgs::create( "CompressedBuffer: lz4 payload is truncated" );
+      size = payload[0] | ( payload[1] << 8 ) | ( payload[2] << 16 ) | ( (uint32_t)payload[3] << 24 );
+      if ( size > max_decoded_size() or size > (uint32_t)LZ4_MAX_INPUT_SIZE )
+        throw ErrorInvalidArgs::create( "CompressedBuffer: lz4 payload is larger than the maximum size" );
+
+      pointer p = pointer( new CompressedBuffer( NULL, 0, COMPRESSION_LZ4 ) );
+      p->m_bytes.resize( size );
+      if ( LZ4_decompress_safe( reinterpret_cast<const char*>( payload + 4 ), reinterpret_cast<char*>( p->m_bytes.data() ), length - 4, size ) != (int)size )
+        throw ErrorInvalidArgs::create( "CompressedBuffer: lz4 payload is corrupt" );
+      return p;
+    }
+#endif
+
+#ifdef DBUS_CXX_HAVE_ZSTD
+    if ( codec_name == "zstd" )
+    {
+      unsigned long long size = ZSTD_getFrameContentSize( payload, length );
+
+      if ( size == ZSTD_CONTENTSIZE_ERROR or size == ZSTD_CONTENTSIZE_UNKNOWN )
+        throw ErrorInvalidArgs::create( "CompressedBuffer: zstd payload is corrupt" );
+      if ( size > max_decoded_size() )
+        throw ErrorInvalidArgs::create( "CompressedBuffer: zstd payload is larger than the maximum size" );
+
+      pointer p = pointer( new CompressedBuffer( NULL, 0, COMPRESSION_ZSTD ) );
+      p->m_bytes.resize( size );
+      size_t result = ZSTD_decompress( p->m_bytes.data(), size, payload, length );
+      if ( ZSTD_isError( result ) or result != size )
+        throw ErrorInvalidArgs::create( "CompressedBuffer: zstd payload is corrupt" );
+      return p;
+    }
+#endif
+
+    throw ErrorInvalidArgs::create( ( "CompressedBuffer: unsupported codec " + codec_name ).c_str() );
+  }
+
+  const uint8_t* CompressedBuffer::data() const
+  {
+    return m_bytes.data();
+  }
+
+  size_t CompressedBuffer::size() const
+  {
+    return m_bytes.size();
+  }
+
+  const std::vector<uint8_t>& CompressedBuffer::bytes() const
+  {
+    return m_bytes;
+  }
+
+  std::string CompressedBuffer::str() const
+  {
+    return std::string( m_bytes.begin(), m_bytes.end() );
+  }
+
+  CompressionCodec CompressedBuffer::codec() const
+  {
+    return m_codec;
+  }
+
+  void CompressedBuffer::set_codec( CompressionCodec codec )
+  {
+    m_codec = codec;
+  }
+
+  std::string CompressedBuffer::encode( std::vector<uint8_t>& payload ) const
+  {
+    payload.clear();
+
+    if ( m_bytes.size() >= compression_threshold() and is_supported( m_codec ) )
+    {
+      switch ( m_codec )
+      {
+#ifdef DBUS_CXX_HAVE_LZ4
+        case COMPRESSION_LZ4:
+          if ( m_bytes.size() <= (size_t)LZ4_MAX_INPUT_SIZE )
+          {
+            uint32_t size = m_bytes.size();
+            int written;
+
+            payload.resize( 4 + LZ4_compressBound( size ) );
+            payload[0] = size & 0xff;
+            payload[1] = ( size >> 8 ) & 0xff;
+            payload[2] = ( size >> 16 ) & 0xff;
+            payload[3] = ( size >> 24 ) & 0xff;
+            written = LZ4_compress_default( reinterpret_cast<const char*>( m_bytes.data() ), reinterpret_cast<char*>( payload.data() + 4 ), size, payload.size() - 4 );
+            if ( written > 0 and (size_t)written + 4 < m_bytes.size() )
+            {
+              payload.resize( written + 4 );
+              return "lz4";
+            }
+          }
+          break;
+#endif
+
+#ifdef DBUS_CXX_HAVE_ZSTD
+        case COMPRESSION_ZSTD:
+          {
+            size_t written;
+
+            payload.resize( ZSTD_compressBound( m_bytes.size() ) );
+            written = ZSTD_compress( payload.data(), payload.size(), m_bytes.data(), m_bytes.size(), 1 );
+            if ( not ZSTD_isError( written ) and written < m_bytes.size() )
+            {
+              payload.resize( written );
+              return "zstd";
+            }
+          }
+          break;
+#endif
+
+        default:
+          break;
+      }
+    }
+
+    // Not worth compressing, so send the bytes as they are
+    payload = m_bytes;
+    return std::string();
+  }
+
+  bool CompressedBuffer::is_supported( CompressionCodec codec )
+  {
+    switch ( codec )
+    {
+      case COMPRESSION_NONE:
+        return true;
+#ifdef DBUS_CXX_HAVE_LZ4
+      case COMPRESSION_LZ4:
+        return true;
+#endif
+#ifdef DBUS_CXX_HAVE_ZSTD
+      case COMPRESSION_ZSTD:
+        return true;
+#endif
+      default:
+        return false;
+    }
+  }
+
+  std::vector<std::string> CompressedBuffer::supported_codecs()
+  {
+    std::vector<std::string> codecs;
+    if ( is_supported( COMPRESSION_ZSTD ) ) codecs.push_back( codec_name( COMPRESSION_ZSTD ) );
+    if ( is_supported( COMPRESSION_LZ4 ) ) codecs.push_back( codec_name( COMPRESSION_LZ4 ) );
+    return codecs;
+  }
+
+  std::string CompressedBuffer::codec_name( CompressionCodec codec )
+  {
+    switch ( codec )
+    {
+      case COMPRESSION_LZ4:  return "lz4";
+      case COMPRESSION_ZSTD: return "zstd";
+      default:               return std::string();
+    }
+  }
+
+  CompressionCodec CompressedBuffer::negotiate( const std::vector<std::string>& peer_codecs )
+  {
+    std::vector<std::string> codecs = supported_codecs();
+
+    for ( size_t i = 0; i < codecs.size(); i++ )
+    {
+      if ( std::find( peer_codecs.begin(), peer_codecs.end(), codecs[i] ) == peer_codecs.end() ) continue;
+      if ( codecs[i] == codec_name( COMPRESSION_ZSTD ) ) return COMPRESSION_ZSTD;
+      if ( codecs[i] == codec_name( COMPRESSION_LZ4 ) ) return COMPRESSION_LZ4;
+    }
+
+    return COMPRESSION_NONE;
+  }
+
+  CompressionCodec CompressedBuffer::negotiate( Connection::pointer connection, const std::string& destination, int timeout_milliseconds )
+  {
+    std::vector<std::string> peer_codecs;
+    PendingCall::pointer pending;
+    Message::pointer reply;
+
+    if ( not connection or destination.empty() ) return COMPRESSION_NONE;
+
+    CallMessage::pointer msg = CallMessage::create( destination, "/", DBUS_CXX_COMPRESSION_INTERFACE, "GetCodecs" );
+
+    pending = connection->send_with_reply_async( msg, timeout_milliseconds );
+    if ( not pending ) return COMPRESSION_NONE;
+    connection->flush();
+    pending->block();
+    reply = pending->steal_reply();
+
+    // Peers that predate the interface answer with UnknownMethod
+    if ( not reply or reply->type() != RETURN_MESSAGE or not dbus_message_has_signature( reply->cobj(), "as" ) )
+      return COMPRESSION_NONE;
+
+    reply >> peer_codecs;
+    return negotiate( peer_codecs );
+  }
+
+  CompressionCodec CompressedBuffer::default_codec()
+  {
+    return static_cast<CompressionCodec>( m_default_codec.load() );
+  }
+
+  void CompressedBuffer::set_default_codec( CompressionCodec codec )
+  {
+    m_default_codec = codec;
+  }
+
+  size_t CompressedBuffer::compression_threshold()
+  {
+    return m_compression_threshold;
+  }
+
+  void CompressedBuffer::set_compression_threshold( size_t bytes )
+  {
+    m_compression_threshold = bytes;
+  }
+
+  size_t CompressedBuffer::max_decoded_size()
+  {
+    return m_max_decoded_size;
+  }
+
+  void CompressedBuffer::set_max_decoded_size( size_t bytes )
+  {
+    m_max_decoded_size = bytes;
+  }
+
+}
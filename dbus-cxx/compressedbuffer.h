@@ -0,0 +1,163 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by agent                                           *
+ *   agent@local                                                           *
+ *                                                                         *
+ *   This file is part of the dbus-cxx library.                            *
+ *                                                                         *
+ *   The dbus-cxx library is free software; you can redistribute it and/or *
+ *   modify it under the terms of the GNU General Public License           *
+ *   version 3 as published by the Free Software Foundation.               *
+ *                                                                         *
+ *   The dbus-cxx library is distributed in the hope that it will be       *
+ *   useful, but WITHOUT ANY WARRANTY; without even the implied warranty   *
+ *   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU   *
+ *   General Public License for more details.                              *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this software. If not see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#include <atomic>
+#include <cstddef>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include <dbus-cxx/enums.h>
+#include <dbus-cxx/pointer.h>
+
+#ifndef DBUSCXX_COMPRESSEDBUFFER_H
+#define DBUSCXX_COMPRESSEDBUFFER_H
+
+#define DBUS_CXX_COMPRESSION_INTERFACE "org.dbus_cxx.Compression"
+
+namespace DBus
+{
+
+  class Connection;
+
+  /**
+   * A block of bytes that is compressed on the wire.
+   *
+   * On the wire a CompressedBuffer is a @c (say) struct: the name of the
+   * codec ("", "lz4" or "zstd") followed by the payload. The receiver
+   * decompresses according to the name, so each message describes itself
+   * and a CompressedBuffer::pointer can be used as a Method or MethodProxy
+   * argument or return value like any other type.
+   *
+   * Compression is opt-in. Buffers are sent with codec(), which defaults to
+   * default_codec(), itself COMPRESSION_NONE unless changed. Buffers smaller
+   * than compression_threshold(), buffers that do not shrink, and codecs
+   * this build does not support are sent uncompressed.
+   *
+   * Every Connection answers GetCodecs on the org.dbus_cxx.Compression
+   * interface at any path with supported_codecs() as @c as. negotiate()
+   * asks a peer for its codecs and picks one both sides support, falling
+   * back to COMPRESSION_NONE for peers that do not answer, so a sender can
+   * pick the codec of the buffers it sends to each peer.
+   *
+   * @ingroup core
+   *
+   * @author agent <agent@local>
+   */
+  class CompressedBuffer
+  {
+    public:
+
+      typedef DBusCxxPointer<CompressedBuffer> pointer;
+
+    protected:
+
+      CompressedBuffer( const void* data, size_t size, CompressionCodec codec );
+
+    public:
+
+      /** Creates a buffer holding a copy of @p size bytes from @p data */
+      static pointer create( const void* data, size_t size );
+
+      static pointer create( const void* data, size_t size, CompressionCodec codec );
+
+      static pointer create( const std::vector<uint8_t>& data );
+
+      static pointer create( const std::string& text );
+
+      /**
+       * Creates a buffer from a received payload.
+       *
+       * @throw ErrorInvalidArgs if the codec is unknown or unsupported, or the
+       *        payload is corrupt or would decode to more than max_decoded_size()
+       */
+      static pointer decode( const std::string& codec_name, const uint8_t* payload, size_t length );
+
+      const uint8_t* data() const;
+
+      size_t size() const;
+
+      const std::vector<uint8_t>& bytes() const;
+
+      /** The bytes as a string */
+      std::string str() const;
+
+      /** The codec used when this buffer is sent */
+      CompressionCodec codec() const;
+
+      void set_codec( CompressionCodec codec );
+
+      /**
+       * Fills @p payload with what is sent for this buffer and returns the
+       * name of the codec it is encoded with.
+       */
+      std::string encode( std::vector<uint8_t>& payload ) const;
+
+      /** True if this build can compress and decompress with the codec */
+      static bool is_supported( CompressionCodec codec );
+
+      /** The names of the codecs this build supports, in order of preference */
+      static std::vector<std::string> supported_codecs();
+
+      static std::string codec_name( CompressionCodec codec );
+
+      /**
+       * The first of supported_codecs() that is also in @p peer_codecs, or
+       * COMPRESSION_NONE if there is none.
+       */
+      static CompressionCodec negotiate( const std::vector<std::string>& peer_codecs );
+
+      /**
+       * Asks @p destination for its codecs with GetCodecs and negotiates
+       * with the answer. Returns COMPRESSION_NONE if the peer returns an
+       * error or does not answer within the timeout.
+       */
+      static CompressionCodec negotiate( DBusCxxPointer<Connection> connection, const std::string& destination, int timeout_milliseconds = -1 );
+
+      static CompressionCodec default_codec();
+
+      /** Sets the codec of buffers created without one */
+      static void set_default_codec( CompressionCodec codec );
+
+      /** Buffers smaller than this many bytes are sent uncompressed; the default is 4 KiB */
+      static size_t compression_threshold();
+
+      static void set_compression_threshold( size_t bytes );
+
+      /** The largest buffer decode() accepts; the default is 128 MiB, the libdbus message limit */
+      static size_t max_decoded_size();
+
+      static void set_max_decoded_size( size_t bytes );
+
+    protected:
+
+      std::vector<uint8_t> m_bytes;
+
+      CompressionCodec m_codec;
+
+      static std::atomic<int> m_default_codec;
+
+      static std::atomic<size_t> m_compression_threshold;
+
+      static std::atomic<size_t> m_max_decoded_size;
+
+  };
+
+}
+
+#endif
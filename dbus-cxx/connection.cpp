@@ -19,8 +19,13 @@
 
 #include "utility.h"
 #include "connection.h"
+#include "dbus-cxx-config.h"
 #include "dbus-cxx-private.h"
+#include "tracing.h"
+#include "arena.h"
+#include "compressedbuffer.h"
 
+#include <algorithm>
 #include <iostream>
 #include <sys/time.h>
 #include <cassert>
@@ -31,6 +36,26 @@ namespace DBus
 {
 
   dbus_int32_t Connection::m_weak_pointer_slot = -1;
+
+  dbus_int32_t Connection::m_outgoing_message_slot = -1;
+
+  std::mutex Connection::m_outgoing_message_slot_mutex;
+
+  /**
+   * The message being dispatched on this thread. Holding it from the
+   * filter on keeps its wrapper alive for the object path handlers, which
+   * would otherwise each wrap the message again.
+   */
+  static thread_local Message::pointer dispatched_message;
+
+  /** How deeply the calling thread is nested in dispatching messages or deferred calls */
+  static thread_local unsigned int dispatch_depth = 0;
+
+  struct DispatchDepth
+  {
+    DispatchDepth() { dispatch_depth++; }
+    ~DispatchDepth() { dispatch_depth--; }
+  };
   
   Connection::Connection( DBusConnection* cobj, bool is_private ):
       m_cobj( cobj )
@@ -151,6 +176,22 @@ namespace DBus
 
   }
 
+  Connection::pointer Connection::create_peer( const std::string& address )
+  {
+    Error::pointer error = Error::create();
+    DBusConnection* cobj;
+    pointer p;
+
+    cobj = dbus_connection_open_private( address.c_str(), error->cobj() );
+    if ( error->is_set() ) throw error;
+    if ( cobj == NULL ) throw ErrorFailed::create();
+
+    // The Connection holds its own reference
+    p = create( cobj, true );
+    dbus_connection_unref( cobj );
+    return p;
+  }
+
   Connection::pointer Connection::create( const Connection& other )
   {
     pointer p = pointer( new Connection(other) );
@@ -170,6 +211,9 @@ namespace DBus
 
   Connection::~Connection()
   {
+    // The root fallback points at our router
+    if ( m_path_router and this->is_valid() )
+      dbus_connection_unregister_object_path( m_cobj, "/" );
     if ( this->is_valid() and this->is_private() )
       dbus_connection_close( m_cobj );
     if ( m_cobj ) dbus_connection_unref( m_cobj );
@@ -376,10 +420,62 @@ namespace DBus
 
   uint32_t Connection::send( Message::const_pointer msg )
   {
-    uint32_t serial;
     if ( not this->is_valid() ) throw ErrorDisconnected::create();
     if ( not msg or not *msg ) return 0;
+
+    if ( m_high_watermark_bytes == 0 and m_high_watermark_messages == 0 )
+      return this->send_unchecked( msg );
+
+    // Without a Dispatcher nothing else sends the held signals
+    if ( m_outgoing_congested ) this->process_outgoing();
+
+    switch ( m_flow_control_policy )
+    {
+      case FLOW_CONTROL_FAIL:
+        if ( this->is_above_high_watermark() ) {
+          m_outgoing_congested = true;
+          return 0;
+        }
+        break;
+
+      case FLOW_CONTROL_DROP_OLDEST_SIGNAL:
+        if ( msg->type() == SIGNAL_MESSAGE ) {
+          std::lock_guard<std::mutex> lock( m_flow_control_mutex );
+          // Signals queue behind the held ones so that their order is kept
+          if ( not m_held_signals.empty() or m_sending_held_signals or this->is_above_high_watermark() ) {
+            m_outgoing_congested = true;
+            m_held_signals.push_back( msg );
+            while ( m_held_signals.size() > m_held_signal_limit ) {
+              m_held_signals.pop_front();
+              m_dropped_signals++;
+            }
+            return 0;
+          }
+        }
+        else if ( this->is_above_high_watermark() ) {
+          m_outgoing_congested = true;
+        }
+        break;
+
+      default:
+        if ( this->is_above_high_watermark() ) {
+          m_outgoing_congested = true;
+          if ( this->wait_for_outgoing_drain() ) this->check_outgoing_drained();
+          else if ( dispatch_depth == 0 ) return 0;
+        }
+        break;
+    }
+
+    return this->send_unchecked( msg );
+  }
+
+  uint32_t Connection::send_unchecked( Message::const_pointer msg )
+  {
+    uint32_t serial;
+    if ( m_high_watermark_messages > 0 ) this->track_outgoing( msg );
     if ( not dbus_connection_send( m_cobj, msg->cobj(), &serial ) ) throw ErrorNoMemory::create();
+    DBUSCXX_TRACE( MESSAGE_QUEUED, msg->cobj() );
+    m_metrics->count_out( msg->cobj() );
     return serial;
   }
 
@@ -394,9 +490,19 @@ namespace DBus
     DBusPendingCall* reply;
     if ( not this->is_valid() ) throw ErrorDisconnected::create();
     if ( not message or not *message ) return PendingCall::pointer();
+
+    if ( not this->admit_call() ) return PendingCall::pointer();
+
+    if ( m_high_watermark_messages > 0 ) this->track_outgoing( message );
     if ( not dbus_connection_send_with_reply( m_cobj, message->cobj(), &reply, timeout_milliseconds ) )
       throw ErrorNoMemory::create( "Unable to start asynchronous call" );
-    return PendingCall::create( reply );
+    DBUSCXX_TRACE( MESSAGE_QUEUED, message->cobj() );
+    m_metrics->count_out( message->cobj() );
+
+    PendingCall::pointer pending = PendingCall::create( reply );
+    pending->set_call_serial( dbus_message_get_serial( message->cobj() ) );
+    pending->set_metrics( m_metrics );
+    return pending;
   }
 
   ReturnMessage::const_pointer Connection::send_with_reply_blocking( Message::const_pointer message, int timeout_milliseconds ) const
@@ -410,7 +516,16 @@ namespace DBus
 
     dbus_message_set_no_reply(message->cobj(),FALSE);
 
+    if ( not this->admit_call() ) throw ErrorLimitsExceeded::create( "The outgoing queue is over its high watermark" );
+
+    if ( m_high_watermark_messages > 0 ) this->track_outgoing( message );
+
+    // The serial is only assigned inside libdbus, so this event has none
+    DBUSCXX_TRACE( MESSAGE_QUEUED, message->cobj() );
+    m_metrics->add_pending_reply();
     reply = dbus_connection_send_with_reply_and_block( m_cobj, message->cobj(), timeout_milliseconds, error->cobj() );
+    m_metrics->remove_pending_reply();
+    m_metrics->count_out( message->cobj() );
 
     if ( error->is_set() ){ 
 /*
@@ -424,6 +539,10 @@ namespace DBus
     }
 
     SIMPLELOGGER_DEBUG("dbus.Connection", "Reply signature: " << dbus_message_get_signature(reply) );
+
+    // Replies to blocking calls never pass through the filter
+    DBUSCXX_TRACE( REPLY_RECEIVED, reply );
+    m_metrics->count_in( reply );
     
     ReturnMessage::pointer retmsg = ReturnMessage::create(reply);
 
@@ -436,14 +555,31 @@ namespace DBus
 
   void Connection::flush()
   {
+    unsigned int held;
+
     if ( not this->is_valid() ) return;
     dbus_connection_flush( m_cobj );
+
+    // Held signals are sent as the queue drains, until none are left
+    while ( m_outgoing_congested ) {
+      held = this->held_signals();
+      this->process_outgoing();
+      dbus_connection_flush( m_cobj );
+      if ( m_outgoing_congested and this->held_signals() == held ) break;
+    }
   }
 
   bool Connection::read_write_dispatch( int timeout_milliseconds )
   {
     if ( not this->is_valid() ) return false;
-    return dbus_connection_read_write_dispatch( m_cobj, timeout_milliseconds );
+
+    ArenaScope arena;
+    DispatchDepth depth;
+    Message::pointer outer = dispatched_message;
+    bool result = dbus_connection_read_write_dispatch( m_cobj, timeout_milliseconds );
+    dispatched_message = outer;
+    if ( arena.is_outermost() ) m_metrics->dispatch_arena_bytes().record( (uint64_t)arena.bytes_allocated() );
+    return result;
   }
 
   bool Connection::read_write( int timeout_milliseconds )
@@ -487,10 +623,64 @@ namespace DBus
   DispatchStatus Connection::dispatch( )
   {
     if ( not this->is_valid() ) return DISPATCH_COMPLETE;
+
+    // Temporaries of handling the message come from the thread's arena
+    ArenaScope arena;
+    DispatchDepth depth;
+    Message::pointer outer = dispatched_message;
     dbus_connection_dispatch( m_cobj );
+    dispatched_message = outer;
+    if ( arena.is_outermost() ) m_metrics->dispatch_arena_bytes().record( (uint64_t)arena.bytes_allocated() );
+
     return static_cast<DispatchStatus>( dbus_connection_get_dispatch_status( m_cobj ) );
   }
 
+  HandlerResult Connection::deliver_incoming( Message::pointer message )
+  {
+    DBusHandlerResult filter_result;
+    HandlerResult result = NOT_HANDLED;
+    ObjectPathHandler* handler = NULL;
+    std::string path;
+
+    if ( not this->is_valid() or not message or not message->is_valid() ) return NOT_HANDLED;
+
+    // Handlers must not block on this thread as they would under dispatch()
+    ArenaScope arena;
+    DispatchDepth depth;
+    Message::pointer outer = dispatched_message;
+
+    filter_result = on_filter_callback( m_cobj, message->cobj(), this );
+
+    if ( filter_result == DBUS_HANDLER_RESULT_HANDLED ) result = HANDLED;
+    else if ( filter_result == DBUS_HANDLER_RESULT_NEED_MEMORY ) result = HANDLER_NEEDS_MEMORY;
+    else if ( m_path_router ) result = m_path_router->route( this->self(), message );
+    else if ( dbus_message_get_path( message->cobj() ) != NULL )
+    {
+      // As libdbus does: the handler on the path itself, else the nearest fallback
+      path = dbus_message_get_path( message->cobj() );
+      while ( true )
+      {
+        void* data = NULL;
+        if ( dbus_connection_get_object_path_data( m_cobj, path.c_str(), &data ) and data != NULL )
+        {
+          handler = static_cast<ObjectPathHandler*>( data );
+          if ( path == dbus_message_get_path( message->cobj() ) or handler->is_primary_or_fallback() == FALLBACK ) break;
+          handler = NULL;
+        }
+        if ( path == "/" ) break;
+        size_t slash = path.rfind( '/' );
+        path.resize( ( slash == 0 ) ? 1 : slash );
+      }
+
+      if ( handler ) result = handler->handle_message( this->self(), message );
+    }
+
+    dispatched_message = outer;
+    if ( arena.is_outermost() ) m_metrics->dispatch_arena_bytes().record( (uint64_t)arena.bytes_allocated() );
+
+    return result;
+  }
+
   int Connection::unix_fd() const
   {
     dbus_bool_t result;
@@ -579,6 +769,211 @@ namespace DBus
     return dbus_connection_has_messages_to_send(m_cobj);
   }
 
+  void Connection::set_outgoing_watermarks( long high_bytes, long low_bytes, unsigned int high_messages, unsigned int low_messages )
+  {
+    if ( low_bytes > high_bytes ) low_bytes = high_bytes;
+    if ( low_messages > high_messages ) low_messages = high_messages;
+    m_high_watermark_bytes = high_bytes;
+    m_low_watermark_bytes = low_bytes;
+    m_high_watermark_messages = high_messages;
+    m_low_watermark_messages = low_messages;
+  }
+
+  long Connection::outgoing_high_watermark_bytes() const
+  {
+    return m_high_watermark_bytes;
+  }
+
+  long Connection::outgoing_low_watermark_bytes() const
+  {
+    return m_low_watermark_bytes;
+  }
+
+  unsigned int Connection::outgoing_high_watermark_messages() const
+  {
+    return m_high_watermark_messages;
+  }
+
+  unsigned int Connection::outgoing_low_watermark_messages() const
+  {
+    return m_low_watermark_messages;
+  }
+
+  void Connection::set_flow_control_policy( FlowControlPolicy policy, unsigned int held_signal_limit )
+  {
+    std::lock_guard<std::mutex> lock( m_flow_control_mutex );
+    m_flow_control_policy = policy;
+    m_held_signal_limit = held_signal_limit;
+    while ( m_held_signals.size() > m_held_signal_limit ) {
+      m_held_signals.pop_front();
+      m_dropped_signals++;
+    }
+  }
+
+  FlowControlPolicy Connection::flow_control_policy() const
+  {
+    return static_cast<FlowControlPolicy>( m_flow_control_policy.load() );
+  }
+
+  void Connection::set_flow_control_timeout( int milliseconds )
+  {
+    m_flow_control_timeout = ( milliseconds < 0 ) ? 0 : milliseconds;
+  }
+
+  int Connection::flow_control_timeout() const
+  {
+    return m_flow_control_timeout;
+  }
+
+  unsigned int Connection::outgoing_messages() const
+  {
+    return *m_outgoing_messages;
+  }
+
+  unsigned int Connection::held_signals() const
+  {
+    std::lock_guard<std::mutex> lock( m_flow_control_mutex );
+    return m_held_signals.size();
+  }
+
+  unsigned long Connection::dropped_signals() const
+  {
+    std::lock_guard<std::mutex> lock( m_flow_control_mutex );
+    return m_dropped_signals;
+  }
+
+  bool Connection::is_outgoing_congested() const
+  {
+    return m_outgoing_congested;
+  }
+
+  sigc::signal<void>& Connection::signal_outgoing_drained()
+  {
+    return m_outgoing_drained_signal;
+  }
+
+  ConnectionMetrics& Connection::metrics()
+  {
+    return *m_metrics;
+  }
+
+  void Connection::process_outgoing()
+  {
+    if ( not m_outgoing_congested or not this->is_valid() ) return;
+
+    if ( not this->is_below_low_watermark() ) return;
+
+    // Sent one at a time without the lock held; signals sent meanwhile
+    // are held behind these so that their order is kept
+    while ( true ) {
+      Message::const_pointer held;
+      {
+        std::lock_guard<std::mutex> lock( m_flow_control_mutex );
+        if ( m_held_signals.empty() or this->is_above_high_watermark() ) {
+          m_sending_held_signals = false;
+          if ( not m_held_signals.empty() ) return;
+          break;
+        }
+        held = m_held_signals.front();
+        m_held_signals.pop_front();
+        m_sending_held_signals = true;
+      }
+      this->send_unchecked( held );
+    }
+
+    this->check_outgoing_drained();
+  }
+
+  bool Connection::is_above_high_watermark() const
+  {
+    long high_bytes = m_high_watermark_bytes;
+    unsigned int high_messages = m_high_watermark_messages;
+
+    if ( high_bytes > 0 and dbus_connection_get_outgoing_size( m_cobj ) >= high_bytes ) return true;
+    if ( high_messages > 0 and *m_outgoing_messages >= high_messages ) return true;
+    return false;
+  }
+
+  bool Connection::is_below_low_watermark() const
+  {
+    if ( m_high_watermark_bytes > 0 and dbus_connection_get_outgoing_size( m_cobj ) > m_low_watermark_bytes ) return false;
+    if ( m_high_watermark_messages > 0 and *m_outgoing_messages > m_low_watermark_messages ) return false;
+    return true;
+  }
+
+  struct OutgoingMessageToken
+  {
+    std::shared_ptr<std::atomic<unsigned int> > counter;
+  };
+
+  void outgoing_message_token_deleter( void* v )
+  {
+    OutgoingMessageToken* token = static_cast<OutgoingMessageToken*>( v );
+    (*token->counter)--;
+    delete token;
+  }
+
+  void Connection::track_outgoing( Message::const_pointer msg ) const
+  {
+    if ( m_outgoing_message_slot == -1 ) return;
+
+    OutgoingMessageToken* token = new OutgoingMessageToken;
+    token->counter = m_outgoing_messages;
+    (*m_outgoing_messages)++;
+
+    // Replacing the token of a message sent twice releases the old one
+    std::lock_guard<std::mutex> lock( m_outgoing_message_slot_mutex );
+    if ( not dbus_message_set_data( msg->cobj(), m_outgoing_message_slot, token, outgoing_message_token_deleter ) )
+      outgoing_message_token_deleter( token );
+  }
+
+  bool Connection::admit_call() const
+  {
+    // Calls are never held back, they either wait for room or fail
+    if ( not this->is_above_high_watermark() ) return true;
+
+    m_outgoing_congested = true;
+
+    switch ( m_flow_control_policy )
+    {
+      case FLOW_CONTROL_FAIL:
+        return false;
+      case FLOW_CONTROL_BLOCK:
+        return this->wait_for_outgoing_drain() or dispatch_depth > 0;
+      default:
+        return true;
+    }
+  }
+
+  bool Connection::wait_for_outgoing_drain() const
+  {
+    // Whatever holds the queue up may be waiting for this very thread
+    if ( dispatch_depth > 0 ) return this->is_below_low_watermark();
+
+    std::chrono::steady_clock::time_point deadline =
+      std::chrono::steady_clock::now() + std::chrono::milliseconds( m_flow_control_timeout.load() );
+
+    while ( not this->is_below_low_watermark() ) {
+      if ( not dbus_connection_get_is_connected( m_cobj ) ) throw ErrorDisconnected::create();
+      int remaining = std::chrono::duration_cast<std::chrono::milliseconds>( deadline - std::chrono::steady_clock::now() ).count();
+      if ( remaining <= 0 ) return false;
+      dbus_connection_read_write( m_cobj, std::min( remaining, 100 ) );
+    }
+
+    return true;
+  }
+
+  void Connection::check_outgoing_drained()
+  {
+    if ( not this->is_below_low_watermark() ) return;
+
+    bool was_congested = true;
+    if ( m_outgoing_congested.compare_exchange_strong( was_congested, false ) ) {
+      SIMPLELOGGER_DEBUG( "dbus.Connection", "Outgoing queue drained" );
+      m_outgoing_drained_signal.emit();
+    }
+  }
+
   Connection::AddWatchSignal& Connection::signal_add_watch()
   {
     return m_add_watch_signal;
@@ -624,6 +1019,56 @@ namespace DBus
     return m_filter_signal;
   }
 
+  void Connection::add_deferred_call( sigc::slot<void> slot, int delay_milliseconds )
+  {
+    std::chrono::steady_clock::time_point due = std::chrono::steady_clock::now();
+
+    if ( delay_milliseconds > 0 ) due += std::chrono::milliseconds( delay_milliseconds );
+
+    {
+      std::lock_guard<std::mutex> lock( m_deferred_calls_mutex );
+      m_deferred_calls.insert( std::make_pair( due, slot ) );
+      m_metrics->set_dispatch_queue_depth( m_deferred_calls.size() );
+    }
+
+    // Let the dispatcher recalculate how long it may sleep
+    m_wakeup_main_signal.emit();
+  }
+
+  int Connection::deferred_call_timeout() const
+  {
+    std::lock_guard<std::mutex> lock( m_deferred_calls_mutex );
+
+    if ( m_deferred_calls.empty() ) return -1;
+
+    std::chrono::steady_clock::duration remaining = m_deferred_calls.begin()->first - std::chrono::steady_clock::now();
+
+    if ( remaining <= std::chrono::steady_clock::duration::zero() ) return 0;
+
+    // Round up so that we never wake up before the call is due
+    return std::chrono::duration_cast<std::chrono::milliseconds>( remaining + std::chrono::milliseconds(1) - std::chrono::steady_clock::duration(1) ).count();
+  }
+
+  void Connection::process_deferred_calls()
+  {
+    std::vector<sigc::slot<void> > due;
+
+    {
+      std::lock_guard<std::mutex> lock( m_deferred_calls_mutex );
+      DeferredCalls::iterator last = m_deferred_calls.upper_bound( std::chrono::steady_clock::now() );
+      for ( DeferredCalls::iterator i = m_deferred_calls.begin(); i != last; i++ )
+        due.push_back( i->second );
+      m_deferred_calls.erase( m_deferred_calls.begin(), last );
+      m_metrics->set_dispatch_queue_depth( m_deferred_calls.size() );
+    }
+
+    DispatchDepth depth;
+
+    // The slots are called without the lock held so they may queue new calls
+    for ( size_t i = 0; i < due.size(); i++ )
+      if ( not due[i].empty() ) due[i]();
+  }
+
   void Connection::set_global_change_sigpipe(bool will_modify_sigpipe)
   {
     dbus_connection_set_change_sigpipe(will_modify_sigpipe);
@@ -705,6 +1150,37 @@ namespace DBus
     return false;
   }
 
+  bool Connection::enable_path_router()
+  {
+    dbus_bool_t result;
+    ObjectPathRouter::pointer router;
+
+    if ( m_path_router ) return true;
+    if ( not this->is_valid() ) return false;
+
+    router = ObjectPathRouter::create();
+
+#ifdef DBUS_CXX_HAVE_DBUS_12
+    Error::pointer error = Error::create();
+    result = dbus_connection_try_register_fallback( m_cobj, "/", &ObjectPathRouter::m_dbus_vtable, router.get(), error->cobj() );
+    if ( error->is_set() ) return false;
+#else
+    result = dbus_connection_register_fallback( m_cobj, "/", &ObjectPathRouter::m_dbus_vtable, router.get() );
+#endif
+
+    if ( not result ) return false;
+
+    SIMPLELOGGER_DEBUG("dbus.Connection", "Connection::enable_path_router: routing object paths through a single fallback at /");
+
+    m_path_router = router;
+    return true;
+  }
+
+  ObjectPathRouter::pointer Connection::path_router() const
+  {
+    return m_path_router;
+  }
+
   signal_proxy_simple::pointer Connection::create_signal_proxy(const std::string & interface, const std::string & name)
   {
     return this->add_signal_proxy( signal_proxy_simple::create(interface, name) );
@@ -733,6 +1209,7 @@ namespace DBus
     m_proxy_signal_interface_map[interface][name].push_back(signal);
     this->add_match( signal->match_rule() );
     signal->set_connection(this->self());
+    signal->set_batch_owner( signal );
 
     return signal;
   }
@@ -953,7 +1430,7 @@ namespace DBus
 
     // Erase the timeout if this connection handled it
     // Otherwise, this has no effect
-    conn->m_timeouts.erase(ctimeout);
+    if ( conn->m_timeouts.erase(ctimeout) ) timeout->arm(false);
 
     conn->signal_remove_timeout().emit(timeout);
   }
@@ -998,12 +1475,28 @@ namespace DBus
     Connection::pointer conn = static_cast<Connection*>(data)->self();
     FilterResult filter_result = DONT_FILTER;
     HandlerResult signal_result = NOT_HANDLED;
-    Message::pointer msg = Message::create(message);
+    Message::pointer msg = Message::create_cached(message);
+    dispatched_message = msg;
+
+    DBUSCXX_TRACE( MESSAGE_RECEIVED, message );
+    conn->m_metrics->count_in( message );
 
     filter_result = conn->signal_filter().emit(conn, msg);
 
     SIMPLELOGGER_DEBUG( "dbus.Connection", "Filter callback.  filter_result: " << filter_result );
 
+    // Answered at any path, as libdbus answers Peer.Ping
+    if ( filter_result != FILTER and dbus_message_is_method_call( message, DBUS_CXX_COMPRESSION_INTERFACE, "GetCodecs" ) )
+    {
+      if ( not dbus_message_get_no_reply( message ) )
+      {
+        ReturnMessage::pointer reply = ReturnMessage::create( msg );
+        *reply << CompressedBuffer::supported_codecs();
+        conn->send( reply );
+      }
+      return DBUS_HANDLER_RESULT_HANDLED;
+    }
+
     // Deliver signals to signal proxies
     if ( filter_result != FILTER and msg->type() == SIGNAL_MESSAGE )
     {
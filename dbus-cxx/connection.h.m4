@@ -95,15 +95,23 @@ dnl
  ***************************************************************************/]
 #include <list>
 #include <deque>
+#include <map>
+#include <mutex>
+#include <chrono>
+#include <atomic>
+#include <memory>
 
 #include <dbus-cxx/pointer.h>
 #include <dbus-cxx/message.h>
 #include <dbus-cxx/returnmessage.h>
+#include <dbus-cxx/errormessage.h>
 #include <dbus-cxx/pendingcall.h>
+#include <dbus-cxx/metrics.h>
 #include <dbus-cxx/watch.h>
 #include <dbus-cxx/timeout.h>
 #include <dbus-cxx/accumulators.h>
 #include <dbus-cxx/object.h>
+#include <dbus-cxx/objectpathrouter.h>
 #include <dbus-cxx/objectproxy.h>
 #include <dbus-cxx/signal_proxy.h>
 #include <dbus-cxx/dbus_signal.h>
@@ -172,6 +180,15 @@ namespace DBus
 
       static pointer create( const Connection& other );
 
+      /**
+       * Opens a private connection directly to a peer, such as a Server,
+       * without a bus daemon in between. No Hello is sent, so the
+       * connection has no unique name and messages need no destination.
+       *
+       * @throw Error if the peer could not be reached
+       */
+      static pointer create_peer( const std::string& address );
+
       virtual ~Connection();
 
       /** True if this is a valid connection; false otherwise */
@@ -233,6 +250,16 @@ namespace DBus
       // TODO dbus_connection_free_preallocated_send
       // TODO dbus_connection_send_preallocated
 
+      /**
+       * Queues the message and returns its serial.
+       *
+       * Returns 0 if the message was not queued: either it was empty, or the
+       * outgoing queue is over its high watermark under FLOW_CONTROL_FAIL,
+       * or it did not drain within the flow control timeout under
+       * FLOW_CONTROL_BLOCK.
+       * Under FLOW_CONTROL_DROP_OLDEST_SIGNAL a held signal is queued later and
+       * the serial is assigned then, so 0 is returned for it as well.
+       */
       uint32_t send( const Message::const_pointer );
 
       /**
@@ -240,10 +267,21 @@ namespace DBus
        */
       Connection& operator<<( Message::const_pointer msg );
 
+      /**
+       * Sends a call and returns the pending reply. Calls follow the flow
+       * control policy but are never held back: a null pointer is returned
+       * where send() would return 0.
+       */
       PendingCall::pointer send_with_reply_async( Message::const_pointer message, int timeout_milliseconds=-1 ) const;
 
+      /**
+       * Sends a call and waits for its reply. Calls follow the flow control
+       * policy as with send_with_reply_async(); ErrorLimitsExceeded is thrown
+       * where that returns a null pointer.
+       */
       ReturnMessage::const_pointer send_with_reply_blocking( Message::const_pointer msg, int timeout_milliseconds=-1 ) const;
 
+      /** Writes the outgoing queue, including any signals held by flow control */
       void flush();
 
       bool read_write_dispatch( int timeout_milliseconds=-1 );
@@ -262,6 +300,14 @@ namespace DBus
 
       DispatchStatus dispatch( );
 
+      /**
+       * Handles a message as if it had been read from the connection,
+       * without it going over the bus: the filters and signal proxies get
+       * it first, then the object path handler registered for its path.
+       * @return HANDLED if anything handled the message
+       */
+      HandlerResult deliver_incoming( Message::pointer message );
+
       int unix_fd() const;
 
       int socket() const;
@@ -302,6 +348,91 @@ namespace DBus
 
       bool has_messages_to_send();
 
+      /** @name Flow Control */
+      //@{
+
+      /**
+       * Sets the outgoing queue limits. Once either high watermark is reached
+       * send() applies the flow control policy until both the byte size and
+       * the message count have dropped back to their low watermarks.
+       *
+       * A high watermark of 0 disables that limit; both are disabled by default.
+       */
+      void set_outgoing_watermarks( long high_bytes, long low_bytes,
+                                    unsigned int high_messages=0, unsigned int low_messages=0 );
+
+      long outgoing_high_watermark_bytes() const;
+
+      long outgoing_low_watermark_bytes() const;
+
+      unsigned int outgoing_high_watermark_messages() const;
+
+      unsigned int outgoing_low_watermark_messages() const;
+
+      /**
+       * Sets what send() does while the outgoing queue is over its watermarks.
+       *
+       * The default is FLOW_CONTROL_FAIL.
+       *
+       * With FLOW_CONTROL_DROP_OLDEST_SIGNAL method calls and replies are still
+       * queued, but up to \c held_signal_limit signals are held back by the
+       * connection and sent once the queue drains. They are sent by
+       * process_outgoing(), which a Dispatcher calls on every iteration, by
+       * the next send() and by flush(); a connection without a Dispatcher
+       * has to call one of these.
+       *
+       * FLOW_CONTROL_BLOCK never waits on a thread that is dispatching a
+       * message or running deferred calls, as the queue could only drain
+       * once that thread returned; messages sent there, such as method
+       * replies, are queued over the watermark instead.
+       */
+      void set_flow_control_policy( FlowControlPolicy policy, unsigned int held_signal_limit=64 );
+
+      FlowControlPolicy flow_control_policy() const;
+
+      /**
+       * Sets the longest send() waits for the queue to drain under
+       * FLOW_CONTROL_BLOCK before giving up and returning 0.
+       */
+      void set_flow_control_timeout( int milliseconds );
+
+      int flow_control_timeout() const;
+
+      /**
+       * The number of messages queued by send() that libdbus has not yet
+       * written. A message counts until it is written and every
+       * Message::pointer to it has been released.
+       *
+       * Only counted while a message watermark is set.
+       */
+      unsigned int outgoing_messages() const;
+
+      /** The number of signals held back by FLOW_CONTROL_DROP_OLDEST_SIGNAL */
+      unsigned int held_signals() const;
+
+      /** The number of signals dropped by FLOW_CONTROL_DROP_OLDEST_SIGNAL */
+      unsigned long dropped_signals() const;
+
+      /** True while the outgoing queue is above its low watermarks after reaching a high watermark */
+      bool is_outgoing_congested() const;
+
+      /** Emitted once the outgoing queue drains below its low watermarks again */
+      sigc::signal<void>& signal_outgoing_drained();
+
+      /**
+       * Sends held signals and emits signal_outgoing_drained() when the queue
+       * has drained. Dispatchers call this on every iteration.
+       */
+      void process_outgoing();
+
+      //@}
+
+      /**
+       * Message counts, pending replies and the deferred call queue depth of
+       * this connection. Shared with the pending calls it creates.
+       */
+      ConnectionMetrics& metrics();
+
       typedef sigc::signal1<bool,Watch::pointer,InterruptablePredicateAccumulatorDefaultFalse> AddWatchSignal;
 
       /** Cannot call watch.handle() in a slot connected to this signal */
@@ -331,6 +462,27 @@ namespace DBus
        */
       FilterSignal& signal_filter();
 
+      /**
+       * Queues a slot to be called once from the dispatch loop after at least
+       * \c delay_milliseconds have passed. A delay of 0 runs the slot at the
+       * end of the current (or next) dispatch round.
+       *
+       * This is used to batch work that should not happen once per change,
+       * such as sending PropertiesChanged signals.
+       */
+      void add_deferred_call( sigc::slot<void> slot, int delay_milliseconds=0 );
+
+      /**
+       * Returns the number of milliseconds until the next deferred call is due,
+       * 0 if one is already due or -1 if none are queued.
+       *
+       * Dispatchers use this as their poll timeout.
+       */
+      int deferred_call_timeout() const;
+
+      /** Calls and removes all deferred calls that are due */
+      void process_deferred_calls();
+
       typedef std::deque<Watch::pointer> Watches;
       
       const Watches& unhandled_watches() const;
@@ -351,6 +503,21 @@ namespace DBus
 
       bool unregister_object( const std::string& path );
 
+      /**
+       * Routes every object path registered from now on through an
+       * ObjectPathRouter instead of registering each path with libdbus.
+       *
+       * The router itself is registered once as a fallback handler at "/".
+       * Paths registered before this call stay registered with libdbus, which
+       * prefers them over the router.
+       *
+       * @return \c false if the root fallback could not be registered
+       */
+      bool enable_path_router();
+
+      /** Returns the router object paths are registered with, or a null pointer */
+      ObjectPathRouter::pointer path_router() const;
+
       /**
        * Adds a signal with the given interface and name
        *
@@ -461,10 +628,84 @@ FOR(0, eval(CALL_SIZE),[[CREATE_SIGNAL_PIN(%1)
 
       static dbus_int32_t m_weak_pointer_slot;
 
+      static dbus_int32_t m_outgoing_message_slot;
+
+      /** The same message may be sent on several threads at once */
+      static std::mutex m_outgoing_message_slot_mutex;
+
       void initialize( bool is_private );
 
       std::map<std::string,ObjectPathHandler::pointer> m_created_objects;
 
+      ObjectPathRouter::pointer m_path_router;
+
+      typedef std::multimap<std::chrono::steady_clock::time_point,sigc::slot<void> > DeferredCalls;
+
+      DeferredCalls m_deferred_calls;
+
+      mutable std::mutex m_deferred_calls_mutex;
+
+      std::atomic<long> m_high_watermark_bytes { 0 };
+
+      std::atomic<long> m_low_watermark_bytes { 0 };
+
+      std::atomic<unsigned int> m_high_watermark_messages { 0 };
+
+      std::atomic<unsigned int> m_low_watermark_messages { 0 };
+
+      std::atomic<int> m_flow_control_policy { FLOW_CONTROL_FAIL };
+
+      std::atomic<int> m_flow_control_timeout { 1000 };
+
+      mutable std::atomic<bool> m_outgoing_congested { false };
+
+      /** Shared with the messages in flight so they can be counted down after we are gone */
+      std::shared_ptr<std::atomic<unsigned int> > m_outgoing_messages { std::make_shared<std::atomic<unsigned int> >( 0 ) };
+
+      std::deque<Message::const_pointer> m_held_signals;
+
+      /** Set while process_outgoing() sends held signals, so new ones still queue behind them */
+      bool m_sending_held_signals { false };
+
+      unsigned int m_held_signal_limit { 64 };
+
+      unsigned long m_dropped_signals { 0 };
+
+      mutable std::mutex m_flow_control_mutex;
+
+      sigc::signal<void> m_outgoing_drained_signal;
+
+      std::shared_ptr<ConnectionMetrics> m_metrics { std::make_shared<ConnectionMetrics>() };
+
+      /** True if either high watermark has been reached */
+      bool is_above_high_watermark() const;
+
+      /** True if both the byte size and message count are at or below the low watermarks */
+      bool is_below_low_watermark() const;
+
+      /** Hands a message to libdbus without any flow control */
+      uint32_t send_unchecked( Message::const_pointer msg );
+
+      /** Counts the message in outgoing_messages() until libdbus frees it */
+      void track_outgoing( Message::const_pointer msg ) const;
+
+      /**
+       * Runs libdbus I/O on this thread until the queue has drained.
+       *
+       * Returns false without waiting on a dispatching thread, and once the
+       * flow control timeout has passed.
+       */
+      bool wait_for_outgoing_drain() const;
+
+      /**
+       * Applies the flow control policy to a method call, marking the queue
+       * congested when it is over the high watermark. Returns false when
+       * the call has to be refused.
+       */
+      bool admit_call() const;
+
+      void check_outgoing_drained();
+
       InterfaceToNameProxySignalMap m_proxy_signal_interface_map;
 
 //       std::map<SignalReceiver::pointer, sigc::connection> m_sighandler_iface_conn;
@@ -533,6 +774,14 @@ DBus::Connection::pointer operator<<(DBus::Connection::pointer ptr, DBus::Return
   return ptr;
 }
 
+inline
+DBus::Connection::pointer operator<<(DBus::Connection::pointer ptr, DBus::ErrorMessage::pointer msg)
+{
+  if (not ptr) return ptr;
+  *ptr << msg;
+  return ptr;
+}
+
 inline
 DBus::Connection::pointer operator<<(DBus::Connection::pointer ptr, DBus::SignalMessage::pointer msg)
 {
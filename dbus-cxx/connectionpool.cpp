@@ -0,0 +1,210 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by agent                                           *
+ *   agent@local                                                           *
+ *                                                                         *
+ *   This file is part of the dbus-cxx library.                            *
+ *                                                                         *
+ *   The dbus-cxx library is free software; you can redistribute it and/or *
+ *   modify it under the terms of the GNU General Public License           *
+ *   version 3 as published by the Free Software Foundation.               *
+ *                                                                         *
+ *   The dbus-cxx library is distributed in the hope that it will be       *
+ *   useful, but WITHOUT ANY WARRANTY; without even the implied warranty   *
+ *   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU   *
+ *   General Public License for more details.                              *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this software. If not see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#include "connectionpool.h"
+#include "objectproxy.h"
+#include "dbus-cxx-private.h"
+
+namespace DBus
+{
+
+  namespace
+  {
+    /**
+     * Counts one unanswered call. The count drops when the reply arrives or,
+     * if the call is cancelled or dropped first, when the PendingCall and
+     * with it this object go away.
+     */
+    class OutstandingCall
+    {
+      public:
+        OutstandingCall( DBusCxxWeakPointer<ConnectionPool> pool, std::atomic<unsigned int>* counter ):
+          m_pool( pool ), m_counter( counter ), m_released( false )
+        {
+          (*m_counter)++;
+        }
+
+        ~OutstandingCall() { this->release(); }
+
+        void release()
+        {
+          if ( m_released.exchange( true ) ) return;
+          ConnectionPool::pointer pool = m_pool.lock();
+          if ( pool ) (*m_counter)--;
+        }
+
+        static void on_notify( DBusCxxPointer<OutstandingCall> call ) { call->release(); }
+
+      private:
+        DBusCxxWeakPointer<ConnectionPool> m_pool;
+        std::atomic<unsigned int>* m_counter;
+        std::atomic<bool> m_released;
+    };
+  }
+
+  ConnectionPool::ConnectionPool( PoolPolicy policy ):
+      m_next( 0 ),
+      m_policy( policy )
+  {
+  }
+
+  ConnectionPool::pointer ConnectionPool::create( Dispatcher::pointer dispatcher, BusType type, unsigned int size, PoolPolicy policy )
+  {
+    std::vector<Connection::pointer> connections;
+    pointer p;
+
+    if ( not dispatcher or size == 0 ) return pointer();
+
+    for ( unsigned int i = 0; i < size; i++ )
+      connections.push_back( Connection::create( type, true ) );
+
+    p = pointer( new ConnectionPool( policy ) );
+    p->m_self = p;
+    if ( not p->add_connections( dispatcher, connections ) ) return pointer();
+    return p;
+  }
+
+  ConnectionPool::pointer ConnectionPool::create( Dispatcher::pointer dispatcher, const std::string& address, unsigned int size, PoolPolicy policy )
+  {
+    std::vector<Connection::pointer> connections;
+    pointer p;
+
+    if ( not dispatcher or size == 0 ) return pointer();
+
+    for ( unsigned int i = 0; i < size; i++ )
+      connections.push_back( Connection::create( address, true ) );
+
+    p = pointer( new ConnectionPool( policy ) );
+    p->m_self = p;
+    if ( not p->add_connections( dispatcher, connections ) ) return pointer();
+    return p;
+  }
+
+  ConnectionPool::~ConnectionPool()
+  {
+  }
+
+  bool ConnectionPool::add_connections( Dispatcher::pointer dispatcher, const std::vector<Connection::pointer>& connections )
+  {
+    std::vector<Connection::pointer>::const_iterator i;
+
+    for ( i = connections.begin(); i != connections.end(); i++ )
+      if ( not dispatcher->add_connection( *i ) ) return false;
+
+    m_connections = connections;
+    m_outstanding.reset( new std::atomic<unsigned int>[ connections.size() ] );
+    for ( unsigned int n = 0; n < connections.size(); n++ ) m_outstanding[n] = 0;
+
+    SIMPLELOGGER_DEBUG("dbus.ConnectionPool", "Created a pool of " << connections.size() << " connections");
+    return true;
+  }
+
+  unsigned int ConnectionPool::size() const
+  {
+    return m_connections.size();
+  }
+
+  Connection::pointer ConnectionPool::connection( unsigned int index ) const
+  {
+    if ( index >= m_connections.size() ) return Connection::pointer();
+    return m_connections[index];
+  }
+
+  Connection::pointer ConnectionPool::primary() const
+  {
+    return m_connections.front();
+  }
+
+  PoolPolicy ConnectionPool::policy() const
+  {
+    return static_cast<PoolPolicy>( m_policy.load() );
+  }
+
+  void ConnectionPool::set_policy( PoolPolicy policy )
+  {
+    m_policy = policy;
+  }
+
+  unsigned int ConnectionPool::outstanding( unsigned int index ) const
+  {
+    if ( index >= m_connections.size() ) return 0;
+    return m_outstanding[index];
+  }
+
+  unsigned int ConnectionPool::select()
+  {
+    unsigned int start, best, least, count;
+
+    start = m_next++ % m_connections.size();
+
+    if ( m_policy != POOL_LEAST_OUTSTANDING ) return start;
+
+    // Start from the round robin choice so that ties still rotate
+    best = start;
+    least = m_outstanding[start];
+    for ( unsigned int i = 1; i < m_connections.size() and least > 0; i++ )
+    {
+      unsigned int index = ( start + i ) % m_connections.size();
+      count = m_outstanding[index];
+      if ( count < least )
+      {
+        best = index;
+        least = count;
+      }
+    }
+
+    return best;
+  }
+
+  Connection::pointer ConnectionPool::next()
+  {
+    return m_connections[ this->select() ];
+  }
+
+  bool ConnectionPool::send( Message::const_pointer message )
+  {
+    return this->next()->send( message );
+  }
+
+  ReturnMessage::const_pointer ConnectionPool::send_with_reply_blocking( Message::const_pointer message, int timeout_milliseconds )
+  {
+    unsigned int index = this->select();
+    OutstandingCall call( m_self, &m_outstanding[index] );
+
+    return m_connections[index]->send_with_reply_blocking( message, timeout_milliseconds );
+  }
+
+  PendingCall::pointer ConnectionPool::send_with_reply_async( Message::const_pointer message, int timeout_milliseconds )
+  {
+    unsigned int index = this->select();
+    DBusCxxPointer<OutstandingCall> call( new OutstandingCall( m_self, &m_outstanding[index] ) );
+    PendingCall::pointer pending;
+
+    pending = m_connections[index]->send_with_reply_async( message, timeout_milliseconds );
+    if ( not pending ) return pending;
+
+    pending->signal_notify().connect( sigc::bind( sigc::ptr_fun( &OutstandingCall::on_notify ), call ) );
+    return pending;
+  }
+
+  ObjectProxy::pointer ConnectionPool::create_object_proxy( const std::string& destination, const std::string& path )
+  {
+    return ObjectProxy::create( m_self.lock(), destination, path );
+  }
+
+}
@@ -0,0 +1,129 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by agent                                           *
+ *   agent@local                                                           *
+ *                                                                         *
+ *   This file is part of the dbus-cxx library.                            *
+ *                                                                         *
+ *   The dbus-cxx library is free software; you can redistribute it and/or *
+ *   modify it under the terms of the GNU General Public License           *
+ *   version 3 as published by the Free Software Foundation.               *
+ *                                                                         *
+ *   The dbus-cxx library is distributed in the hope that it will be       *
+ *   useful, but WITHOUT ANY WARRANTY; without even the implied warranty   *
+ *   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU   *
+ *   General Public License for more details.                              *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this software. If not see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <dbus-cxx/enums.h>
+#include <dbus-cxx/connection.h>
+#include <dbus-cxx/dispatcher.h>
+
+#ifndef DBUSCXX_CONNECTIONPOOL_H
+#define DBUSCXX_CONNECTIONPOOL_H
+
+namespace DBus
+{
+
+  /**
+   * A set of private connections to the same bus that share the load of
+   * outgoing method calls.
+   *
+   * Each libdbus connection serializes its I/O on one socket behind one
+   * lock, which limits clients that call from many threads. A pool opens
+   * several private connections, adds them to a Dispatcher, and spreads
+   * calls across them according to its PoolPolicy.
+   *
+   * Signals are only ever received on primary(). Match rules for proxy
+   * signals go there too, so signals stay in the order the bus sent them.
+   *
+   * Attach a pool to an ObjectProxy with ObjectProxy::create() or
+   * ObjectProxy::set_connection_pool(). Every MethodProxy on the object
+   * then calls through the pool.
+   *
+   * Each connection has its own unique name. Peers that track callers by
+   * sender will see a pooled client as several clients.
+   *
+   * @ingroup core
+   *
+   * @author agent <agent@local>
+   */
+  class ConnectionPool
+  {
+    protected:
+
+      ConnectionPool( PoolPolicy policy );
+
+    public:
+
+      typedef DBusCxxPointer<ConnectionPool> pointer;
+
+      /**
+       * Opens @p size private connections to the bus and adds them to the dispatcher
+       * @throw Error if a connection cannot be opened
+       */
+      static pointer create( Dispatcher::pointer dispatcher, BusType type, unsigned int size, PoolPolicy policy=POOL_ROUND_ROBIN );
+
+      /**
+       * Opens @p size private connections to the bus at @p address and adds them to the dispatcher
+       * @throw Error if a connection cannot be opened
+       */
+      static pointer create( Dispatcher::pointer dispatcher, const std::string& address, unsigned int size, PoolPolicy policy=POOL_ROUND_ROBIN );
+
+      virtual ~ConnectionPool();
+
+      unsigned int size() const;
+
+      Connection::pointer connection( unsigned int index ) const;
+
+      /** The connection used for signals and match rules */
+      Connection::pointer primary() const;
+
+      PoolPolicy policy() const;
+
+      void set_policy( PoolPolicy policy );
+
+      /** Calls sent on the connection at @p index that have not been answered yet */
+      unsigned int outstanding( unsigned int index ) const;
+
+      /** Returns the connection the next call would be sent on */
+      Connection::pointer next();
+
+      /** Sends a message that expects no reply on the next connection */
+      bool send( Message::const_pointer message );
+
+      ReturnMessage::const_pointer send_with_reply_blocking( Message::const_pointer message, int timeout_milliseconds=-1 );
+
+      PendingCall::pointer send_with_reply_async( Message::const_pointer message, int timeout_milliseconds=-1 );
+
+      /** Creates an object proxy that calls through this pool */
+      DBusCxxPointer<ObjectProxy> create_object_proxy( const std::string& destination, const std::string& path );
+
+    protected:
+
+      DBusCxxWeakPointer<ConnectionPool> m_self;
+
+      std::vector<Connection::pointer> m_connections;
+
+      std::unique_ptr<std::atomic<unsigned int>[]> m_outstanding;
+
+      std::atomic<unsigned int> m_next;
+
+      std::atomic<int> m_policy;
+
+      /** Picks a connection index according to the policy */
+      unsigned int select();
+
+      bool add_connections( Dispatcher::pointer dispatcher, const std::vector<Connection::pointer>& connections );
+
+  };
+
+}
+
+#endif
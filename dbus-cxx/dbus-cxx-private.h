@@ -22,9 +22,28 @@
 #define DBUSCXX_PRIVATE_H
 
 #define SIMPLELOGGER_LOG_FUNCTION_NAME dbuscxx_log_function
-#define SIMPLELOGGER_ENABLE_AUTO_MACROS
 
 #include "simplelogger_defs.h"
+#include "headerlog.h"
 #include "simplelogger.h"
 
+/*
+ * The library's own logging macros. Unlike simplelogger's auto macros the
+ * message is only formatted once the level has passed the compile time
+ * floor and the runtime thresholds.
+ */
+#define DBUSCXX_LOG_STDSTR( logger, message, level ) do{\
+    if( !DBUSCXX_LOG_ENABLED( logger, level ) ) break;\
+    std::ostringstream stream;\
+    stream << message;\
+    SIMPLELOGGER_LOG_CSTR( logger, stream.str().c_str(), level );\
+    } while(0)
+
+#define SIMPLELOGGER_TRACE( logger, message ) DBUSCXX_LOG_STDSTR( logger, message, SL_TRACE )
+#define SIMPLELOGGER_DEBUG( logger, message ) DBUSCXX_LOG_STDSTR( logger, message, SL_DEBUG )
+#define SIMPLELOGGER_INFO( logger, message )  DBUSCXX_LOG_STDSTR( logger, message, SL_INFO )
+#define SIMPLELOGGER_WARN( logger, message )  DBUSCXX_LOG_STDSTR( logger, message, SL_WARN )
+#define SIMPLELOGGER_ERROR( logger, message ) DBUSCXX_LOG_STDSTR( logger, message, SL_ERROR )
+#define SIMPLELOGGER_FATAL( logger, message ) DBUSCXX_LOG_STDSTR( logger, message, SL_FATAL )
+
 #endif
@@ -185,27 +185,38 @@ public:
 
   static pointer create(const std::string& interface, const std::string& name)
   {
-    return pointer( new signal(interface, name) );
+    return self_owned( new signal(interface, name) );
   }
 
   static pointer create(const std::string& path, const std::string& interface, const std::string& name)
   {
-    return pointer( new signal(path, interface, name) );
+    return self_owned( new signal(path, interface, name) );
   }
 
   static pointer create(const std::string& interface, const std::string& name, const signal& src)
   {
-    return pointer( new signal(interface, name, src) );
+    return self_owned( new signal(interface, name, src) );
   }
 
   static pointer create(const std::string& path, const std::string& interface, const std::string& name, const signal& src)
   {
-    return pointer( new signal(path, interface, name, src) );
+    return self_owned( new signal(path, interface, name, src) );
   }
 
   virtual signal_base::pointer clone()
   {
-    return signal_base::pointer( new signal(*this) );
+    return self_owned( new signal(*this) );
+  }
+
+  /**
+   * Emits the signal on the bus for path instead of the signal's own path,
+   * applying the emission policies for that path. Slots connected to the
+   * signal are not called. Unlike set_path() followed by emit(), this may
+   * be called from several threads at once.
+   */
+  void emit_on_path(LIST(const std::string& __path, LOOP(T_arg%1 arg%1, $1)))
+  {
+    this->apply_emission_policies(LIST(__path, LOOP(arg%1, $1)));
   }
 
   /** Returns a DBus XML description of this interface */
@@ -239,14 +250,43 @@ public:
 
   sigc::connection m_internal_callback_connection;
 
+  static pointer self_owned( signal* __signal )
+  {
+    pointer __pointer( __signal );
+    __pointer->m_self = __pointer;
+    return __pointer;
+  }
+
   T_return internal_callback(LIST(LOOP(T_arg%1 arg%1, $1)))
   {
     // DBUS_CXX_DEBUG( "signal::internal_callback: " FOR(1,$1,[ << arg%1]) );
-    SignalMessage::pointer __msg = SignalMessage::create(m_path, m_interface, m_name);
+    this->apply_emission_policies(LIST(m_path, LOOP(arg%1, $1)));
+  }
+
+  void apply_emission_policies(LIST(const std::string& __path, LOOP(T_arg%1 arg%1, $1)))
+  {
+    // Emission policies are applied before any message is built
+    if ( not this->is_rate_limited() or this->admit_emission( __path ) ) {
+      this->send_emission(LIST(__path, LOOP(arg%1, $1)));
+    }
+    else if ( this->trailing_flush() ) {
+      // The flush runs later on the dispatcher, so it holds the signal weakly
+      DBusCxxWeakPointer<signal_base> __weak_self = m_self;
+      std::string __held_path = __path;
+      this->hold_emission( __path, [[=]]() {
+        pointer __self = dbus_cxx_static_pointer_cast<signal>( __weak_self.lock() );
+        if ( __self ) __self->send_emission(LIST(__held_path, LOOP(arg%1, $1)));
+      } );
+    }
+  }
+
+  void send_emission(LIST(const std::string& __path, LOOP(T_arg%1 arg%1, $1)))
+  {
+    SignalMessage::pointer __msg = SignalMessage::create(__path, m_interface, m_name);
     if ( not m_destination.empty() ) __msg->set_destination(m_destination);
     ifelse(eval($1>0),1,[*__msg FOR(1, $1,[ << arg%1]);],[])
     bool result = this->handle_dbus_outgoing(__msg);
-    DBUSCXX_DEBUG_STDSTR( "dbus.signal", "signal::internal_callback: result=" << result );
+    DBUSCXX_DEBUG_STDSTR( "dbus.signal", "signal::send_emission: result=" << result );
   }
 
 };
@@ -19,7 +19,10 @@
 #include "utility.h"
 #include "dispatcher.h"
 #include "dbus-cxx-private.h"
+#include <algorithm>
 #include <iostream>
+#include <cstdlib>
+#include <cstring>
 #include <dbus/dbus.h>
 #include <dbus-cxx/error.h>
 
@@ -27,7 +30,11 @@
 
 #include <unistd.h>
 #include <errno.h>
+#include <signal.h>
 #include <sys/socket.h>
+#ifdef DBUS_CXX_HAVE_EXECINFO
+#include <execinfo.h>
+#endif
 
 namespace DBus
 {
@@ -40,10 +47,59 @@ namespace DBus
     "DISPATCH_NEED_MEMORY",
   };
 
+  static int64_t steady_nanoseconds()
+  {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch() ).count();
+  }
+
+  /** Fills in the message fields of a report; the strings are only built for slow handlers */
+  static void describe_message( Dispatcher::SlowHandler& report, DBusMessage* message )
+  {
+    if ( message == NULL ) return;
+
+    const char* path = dbus_message_get_path( message );
+    const char* interface = dbus_message_get_interface( message );
+    const char* member = dbus_message_get_member( message );
+
+    report.path = path ? path : "";
+    report.interface = interface ? interface : "";
+    report.member = member ? member : "";
+    report.type = static_cast<MessageType>( dbus_message_get_type( message ) );
+  }
+
+#ifdef DBUS_CXX_HAVE_EXECINFO
+  /* The stack of the thread that last received the backtrace signal */
+  static std::mutex backtrace_mutex;
+  static void* backtrace_frames[ 64 ];
+  static std::atomic<int> backtrace_depth( -1 );
+
+  /*
+   * backtrace() is not async-signal-safe in general: its first call loads
+   * the unwinder with dlopen() and malloc(). set_watchdog() makes that
+   * first call before installing this handler. After that glibc only walks
+   * the stack, which is safe here. Another thread's stack can't be walked
+   * without being on it, so the watchdog can't do this itself.
+   */
+  static void backtrace_signal_handler( int )
+  {
+    backtrace_depth = backtrace( backtrace_frames, 64 );
+  }
+#endif
+
   Dispatcher::Dispatcher(bool is_running):
       m_running(false),
       m_dispatch_thread(0),
-      m_dispatch_loop_limit(0)
+      m_dispatch_loop_limit(0),
+      m_watchdog_budget(0),
+      m_backtrace_signal(0),
+      m_backtrace_action_installed(false),
+      m_watchdog_thread(nullptr),
+      m_watchdog_running(false),
+      m_handler_start(0),
+      m_handler_count(0),
+      m_handler_reported(0),
+      m_current_message(NULL)
   {
     if( socketpair( AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, process_fd ) < 0 ){
         SIMPLELOGGER_ERROR( "dbus.Dispatcher", "error creating socket pair" );
@@ -60,7 +116,13 @@ namespace DBus
 
   Dispatcher::~Dispatcher()
   {
+    this->stop_watchdog();
     this->stop();
+
+    // Servers and private connections remove their watches as they close,
+    // which calls back into us; let them go while our members are intact
+    m_servers.clear();
+    m_connections.clear();
   }
 
   Connection::pointer Dispatcher::create_connection(DBusConnection * cobj, bool is_private)
@@ -105,6 +167,7 @@ namespace DBus
     connection->signal_timeout_toggled().connect(sigc::mem_fun(*this, &Dispatcher::on_timeout_toggled));
     connection->signal_wakeup_main().connect(sigc::bind(sigc::mem_fun(*this, &Dispatcher::on_wakeup_main), connection));
     connection->signal_dispatch_status_changed().connect(sigc::bind(sigc::mem_fun(*this, &Dispatcher::on_dispatch_status_changed), connection));
+    connection->signal_filter().connect(sigc::mem_fun(*this, &Dispatcher::on_watchdog_filter));
   
     Connection::Watches::iterator wi;
 //     Connection::Timeouts::iterator ti;
@@ -125,6 +188,37 @@ namespace DBus
     return true;
   }
 
+  bool Dispatcher::add_server( Server::pointer server )
+  {
+    if ( not server or not server->is_valid() ) return false;
+
+    m_servers.push_back(server);
+
+    server->signal_add_watch().connect(sigc::mem_fun(*this, &Dispatcher::on_add_watch));
+    server->signal_remove_watch().connect(sigc::mem_fun(*this, &Dispatcher::on_remove_watch));
+    server->signal_watch_toggled().connect(sigc::mem_fun(*this, &Dispatcher::on_watch_toggled));
+    server->signal_add_timeout().connect(sigc::mem_fun(*this, &Dispatcher::on_add_timeout));
+    server->signal_remove_timeout().connect(sigc::mem_fun(*this, &Dispatcher::on_remove_timeout));
+    server->signal_timeout_toggled().connect(sigc::mem_fun(*this, &Dispatcher::on_timeout_toggled));
+    server->signal_new_connection().connect(sigc::mem_fun(*this, &Dispatcher::add_connection));
+
+    Server::Watches watches = server->unhandled_watches();
+    for ( Server::Watches::iterator w = watches.begin(); w != watches.end(); w++ )
+    {
+      this->on_add_watch(*w);
+      server->remove_unhandled_watch(*w);
+    }
+
+    Server::Timeouts timeouts = server->unhandled_timeouts();
+    for ( Server::Timeouts::iterator t = timeouts.begin(); t != timeouts.end(); t++ )
+    {
+      this->on_add_timeout(*t);
+      server->remove_unhandled_timeout(*t);
+    }
+
+    return true;
+  }
+
   bool Dispatcher::start()
   {
     if ( m_running ) return false;
@@ -159,6 +253,211 @@ namespace DBus
     return m_running;
   }
 
+  void Dispatcher::set_watchdog( std::chrono::milliseconds budget, int backtrace_signal )
+  {
+    this->stop_watchdog();
+
+    if ( budget.count() <= 0 ) return;
+
+    m_backtrace_signal = backtrace_signal;
+
+#ifdef DBUS_CXX_HAVE_EXECINFO
+    if ( m_backtrace_signal != 0 ) {
+      struct sigaction action;
+      void* frame;
+
+      // Must come before the handler is installed: the first call loads the
+      // unwinder, which backtrace_signal_handler() can't safely do
+      backtrace( &frame, 1 );
+
+      memset( &action, 0, sizeof(action) );
+      action.sa_handler = backtrace_signal_handler;
+      action.sa_flags = SA_RESTART;
+      sigemptyset( &action.sa_mask );
+      m_backtrace_action_installed = ( sigaction( m_backtrace_signal, &action, &m_previous_backtrace_action ) == 0 );
+    }
+#else
+    if ( m_backtrace_signal != 0 )
+      SIMPLELOGGER_WARN( "dbus.Dispatcher", "backtraces are not supported on this platform" );
+#endif
+
+    m_watchdog_budget = std::chrono::duration_cast<std::chrono::nanoseconds>( budget ).count();
+    m_watchdog_running = true;
+    m_watchdog_thread = new std::thread( &Dispatcher::watchdog_thread_main, this );
+  }
+
+  std::chrono::milliseconds Dispatcher::watchdog_budget() const
+  {
+    return std::chrono::duration_cast<std::chrono::milliseconds>( std::chrono::nanoseconds( m_watchdog_budget ) );
+  }
+
+  Dispatcher::SlowHandlerSignal& Dispatcher::signal_slow_handler()
+  {
+    return m_slow_handler_signal;
+  }
+
+  void Dispatcher::stop_watchdog()
+  {
+    m_watchdog_budget = 0;
+
+    if ( m_watchdog_thread == nullptr ) return;
+
+    {
+      std::lock_guard<std::mutex> lock( m_mutex_watchdog );
+      m_watchdog_running = false;
+    }
+    m_watchdog_condition.notify_all();
+
+    m_watchdog_thread->join();
+    delete m_watchdog_thread;
+    m_watchdog_thread = nullptr;
+
+    if ( m_backtrace_action_installed ) {
+      sigaction( m_backtrace_signal, &m_previous_backtrace_action, NULL );
+      m_backtrace_action_installed = false;
+    }
+  }
+
+  void Dispatcher::watchdog_thread_main()
+  {
+    std::unique_lock<std::mutex> lock( m_mutex_watchdog );
+    int64_t budget = m_watchdog_budget;
+
+    // Check often enough to catch a handler soon after it overruns
+    std::chrono::nanoseconds interval( std::max<int64_t>( budget / 4, 1000000 ) );
+
+    while ( m_watchdog_running )
+    {
+      m_watchdog_condition.wait_for( lock, interval );
+      if ( not m_watchdog_running ) break;
+
+      int64_t start = m_handler_start;
+      if ( start == 0 or m_handler_reported == m_handler_count ) continue;
+
+      int64_t duration = steady_nanoseconds() - start;
+      if ( duration <= budget ) continue;
+
+      uint64_t count = m_handler_count;
+      DBusMessage* message = m_current_message;
+      m_handler_reported = count;
+      if ( message ) dbus_message_ref( message );
+
+      lock.unlock();
+
+      SlowHandler report;
+      describe_message( report, message );
+      if ( message ) dbus_message_unref( message );
+      report.duration = std::chrono::nanoseconds( duration );
+      report.finished = false;
+
+      if ( m_backtrace_signal != 0 ) {
+        this->capture_backtrace( report.backtrace );
+        // The handler returned while we waited, so the stack is of something else
+        lock.lock();
+        if ( m_handler_count != count or m_handler_start == 0 ) report.backtrace.clear();
+        lock.unlock();
+      }
+
+      this->emit_slow_handler( report );
+      lock.lock();
+    }
+  }
+
+  void Dispatcher::emit_slow_handler( const SlowHandler& report )
+  {
+    std::lock_guard<std::mutex> lock( m_mutex_slow_handler_signal );
+    m_slow_handler_signal.emit( report );
+  }
+
+  void Dispatcher::set_current_message( DBusMessage* message )
+  {
+    DBusMessage* previous = m_current_message.exchange( message );
+    if ( previous == NULL ) return;
+
+    // Wait out a watchdog that may be taking its reference to it
+    { std::lock_guard<std::mutex> lock( m_mutex_watchdog ); }
+    dbus_message_unref( previous );
+  }
+
+  void Dispatcher::handler_begin()
+  {
+    if ( m_watchdog_budget.load( std::memory_order_relaxed ) == 0 ) return;
+
+    std::lock_guard<std::mutex> lock( m_mutex_watchdog );
+    m_handler_count++;
+    m_handler_start = steady_nanoseconds();
+  }
+
+  void Dispatcher::handler_end()
+  {
+    if ( m_handler_start.load( std::memory_order_relaxed ) == 0 ) return;
+
+    SlowHandler report;
+    int64_t budget = m_watchdog_budget;
+    int64_t duration;
+
+    {
+      std::lock_guard<std::mutex> lock( m_mutex_watchdog );
+      duration = steady_nanoseconds() - m_handler_start;
+      m_handler_start = 0;
+    }
+
+    if ( budget != 0 and duration > budget ) {
+      describe_message( report, m_current_message );
+      report.duration = std::chrono::nanoseconds( duration );
+      report.finished = true;
+    }
+
+    this->set_current_message( NULL );
+
+    if ( not report.finished ) return;
+
+    SIMPLELOGGER_WARN( "dbus.Dispatcher", "slow handler: " << report.path << " " << report.interface << "." << report.member
+                       << " took " << report.duration.count() / 1000 << "us" );
+
+    this->emit_slow_handler( report );
+  }
+
+  FilterResult Dispatcher::on_watchdog_filter( Connection::pointer connection, Message::pointer message )
+  {
+    if ( m_handler_start.load( std::memory_order_relaxed ) == 0 or not message ) return DONT_FILTER;
+
+    // Only a reference is taken here; a report is described when it is made
+    this->set_current_message( dbus_message_ref( message->cobj() ) );
+
+    return DONT_FILTER;
+  }
+
+  void Dispatcher::capture_backtrace( std::vector<std::string>& stack )
+  {
+#ifdef DBUS_CXX_HAVE_EXECINFO
+    std::lock_guard<std::mutex> lock( backtrace_mutex );
+    char** symbols;
+    int depth;
+
+    // The caller checks afterwards that the thread was still in the same handler
+    if ( m_dispatch_thread == nullptr ) return;
+
+    // The handler relies on set_watchdog() having loaded the unwinder
+    // beforehand; backtrace_symbols() allocates, so it is called from here
+    backtrace_depth = -1;
+    if ( pthread_kill( m_dispatch_thread->native_handle(), m_backtrace_signal ) != 0 ) return;
+
+    for ( int i = 0; i < 100 and backtrace_depth < 0; i++ )
+      std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+
+    depth = backtrace_depth;
+    if ( depth <= 0 ) return;
+
+    symbols = backtrace_symbols( backtrace_frames, depth );
+    if ( symbols == NULL ) return;
+
+    stack.clear();
+    for ( int i = 0; i < depth; i++ ) stack.push_back( symbols[i] );
+    free( symbols );
+#endif
+  }
+
   void Dispatcher::dispatch_thread_main()
   {
     int selresult;
@@ -174,8 +473,8 @@ namespace DBus
 
       add_read_and_write_watches( &fds );
 
-      // wait forever until some file descriptor has events
-      selresult = poll( fds.data(), fds.size(), -1 );
+      // wait until some file descriptor has events or a deferred call is due
+      selresult = poll( fds.data(), fds.size(), poll_timeout() );
 
       // Oops, poll had a serious error
       if ( selresult == -1 && errno == EINTR ){
@@ -191,39 +490,160 @@ namespace DBus
 
       handle_read_and_write_watches( &fds );
 
+      process_timeouts();
+
       dispatch_connections();
+
+      process_deferred_calls();
+
+      process_outgoing();
+    }
+  }
+
+  void Dispatcher::process_timeouts()
+  {
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    std::vector<Timeout::pointer> due;
+    std::map<Timeout::pointer,TimeoutDue>::iterator i;
+
+    {
+      std::lock_guard<std::mutex> lock( m_mutex_timeouts );
+      i = m_timeouts.begin();
+      while ( i != m_timeouts.end() )
+      {
+        if ( not i->first->is_valid() ) {
+          m_timeouts.erase( i++ );
+          continue;
+        }
+        if ( i->second.due <= now ) {
+          due.push_back( i->first );
+          i->second.due = now + i->second.interval;
+        }
+        i++;
+      }
+    }
+
+    // Handled without the lock, as libdbus may remove or toggle timeouts
+    for ( size_t t = 0; t < due.size(); t++ )
+      due[t]->handle();
+  }
+
+  int Dispatcher::timeouts_timeout()
+  {
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    std::map<Timeout::pointer,TimeoutDue>::iterator i;
+    int64_t timeout = -1;
+
+    std::lock_guard<std::mutex> lock( m_mutex_timeouts );
+    for ( i = m_timeouts.begin(); i != m_timeouts.end(); i++ )
+    {
+      int64_t due = std::chrono::duration_cast<std::chrono::milliseconds>( i->second.due - now ).count() + 1;
+      if ( due < 0 ) due = 0;
+      if ( timeout < 0 or due < timeout ) timeout = due;
+    }
+
+    return timeout;
+  }
+
+  int Dispatcher::poll_timeout()
+  {
+    int timeout = deferred_call_timeout();
+    int timeouts = timeouts_timeout();
+    Connections::iterator ci;
+
+    if ( timeouts >= 0 and ( timeout < 0 or timeouts < timeout ) ) timeout = timeouts;
+
+    // A congested queue can drain without any I/O when its message count
+    // drops as messages are released, so keep checking on it
+    for ( ci = m_connections.begin(); ci != m_connections.end(); ci++ )
+    {
+      if ( (*ci)->is_outgoing_congested() ) {
+        if ( timeout < 0 or timeout > 100 ) timeout = 100;
+        break;
+      }
+    }
+
+    return timeout;
+  }
+
+  int Dispatcher::deferred_call_timeout()
+  {
+    int timeout = -1;
+    Connections::iterator ci;
+
+    for ( ci = m_connections.begin(); ci != m_connections.end(); ci++ )
+    {
+      int conn_timeout = (*ci)->deferred_call_timeout();
+      if ( conn_timeout >= 0 and ( timeout < 0 or conn_timeout < timeout ) )
+        timeout = conn_timeout;
+    }
+
+    return timeout;
+  }
+
+  void Dispatcher::process_deferred_calls()
+  {
+    Connections::iterator ci;
+
+    for ( ci = m_connections.begin(); ci != m_connections.end(); ci++ )
+    {
+      this->handler_begin();
+      (*ci)->process_deferred_calls();
+      this->handler_end();
     }
   }
 
+  void Dispatcher::process_outgoing()
+  {
+    Connections::iterator ci;
+
+    for ( ci = m_connections.begin(); ci != m_connections.end(); ci++ )
+      (*ci)->process_outgoing();
+  }
+
   void Dispatcher::add_read_and_write_watches( std::vector<struct pollfd>* fds ){
       std::lock_guard<std::mutex> watch_lock( m_mutex_watches );
+      fds->insert( fds->end(), m_poll_fds.begin(), m_poll_fds.end() );
+  }
 
-      for( std::pair<int,WatchPair> entry : m_watches_map ){
-        struct pollfd newfd;
-        newfd.fd = entry.first;
-        newfd.events = 0;
+  short Dispatcher::update_poll_fd( int fd )
+  {
+    std::vector<struct pollfd>::iterator pi;
+    std::map<int,WatchPair>::iterator wi = m_watches_map.find( fd );
+    short events = 0;
 
-        Watch::pointer read = entry.second.read_watch;
-        Watch::pointer write = entry.second.write_watch;
+    if ( wi != m_watches_map.end() ) {
+      if ( wi->second.read_watch != nullptr and wi->second.read_watch->is_enabled() ) events |= POLLIN;
+      if ( wi->second.write_watch != nullptr and wi->second.write_watch->is_enabled() ) events |= POLLOUT;
+    }
 
-        if( read != nullptr && 
-            read->is_enabled() ){
-          newfd.events |= POLLIN;
-        }
-        if( write != nullptr &&
-            write->is_enabled() ){
-          newfd.events |= POLLOUT;
-        }
-        fds->push_back( newfd );
-      }
+    for ( pi = m_poll_fds.begin(); pi != m_poll_fds.end(); pi++ )
+      if ( pi->fd == fd ) break;
+
+    if ( wi == m_watches_map.end() ) {
+      if ( pi != m_poll_fds.end() ) m_poll_fds.erase( pi );
+      return 0;
+    }
+
+    if ( pi == m_poll_fds.end() ) {
+      struct pollfd newfd;
+      newfd.fd = fd;
+      newfd.events = 0;
+      newfd.revents = 0;
+      pi = m_poll_fds.insert( m_poll_fds.end(), newfd );
+    }
+
+    short added = events & ~pi->events;
+    pi->events = events;
+    return added;
   }
 
   void Dispatcher::handle_read_and_write_watches( std::vector<struct pollfd>* fds ){
     std::map<int,WatchPair>::iterator witer;
 
     for ( const struct pollfd& fd : *fds ){
-      std::lock_guard<std::mutex> watch_lock( m_mutex_watches );
-      witer = m_watches_map.find( fd.fd );
+      Watch::pointer read_watch;
+      Watch::pointer write_watch;
 
       if( fd.revents & POLLERR ){
         SIMPLELOGGER_ERROR( "dbus.Dispatcher", "got POLLERR back from fd" );
@@ -235,21 +655,29 @@ namespace DBus
         SIMPLELOGGER_ERROR( "dbus.Dispatcher", "got POLLNVAL back from fd" );
       }
 
-      if( witer == m_watches_map.end() ) continue;
-      
-      bool read_good = witer->second.read_watch != nullptr && 
-                       witer->second.read_watch->is_enabled();
-      bool write_good = witer->second.write_watch != nullptr && 
-                        witer->second.write_watch->is_enabled();
+      {
+        std::lock_guard<std::mutex> watch_lock( m_mutex_watches );
+        witer = m_watches_map.find( fd.fd );
+        if( witer == m_watches_map.end() ) continue;
+        read_watch = witer->second.read_watch;
+        write_watch = witer->second.write_watch;
+      }
+
+      // Handling a watch may add or remove watches (a server accepting a
+      // client, a peer hanging up), so it must happen without the lock held.
+      // Only report an error or hangup when poll() saw one; libdbus drops
+      // connections that are still authenticating otherwise.
+      bool read_good = read_watch != nullptr && read_watch->is_valid() && read_watch->is_enabled();
+      bool write_good = write_watch != nullptr && write_watch->is_valid() && write_watch->is_enabled();
 
       if( (fd.events & POLLIN) && 
           (fd.revents & POLLIN ) &&
           read_good ){
-          witer->second.read_watch->handle_read( true, true );
+          read_watch->handle_read( fd.revents & POLLERR, fd.revents & POLLHUP );
       }else if( (fd.events & POLLOUT) && 
              (fd.revents & POLLOUT ) &&
               write_good ){
-          witer->second.write_watch->handle_write( true, true );
+          write_watch->handle_write( fd.revents & POLLERR, fd.revents & POLLHUP );
       }
 
     }
@@ -266,7 +694,11 @@ namespace DBus
       {
         SIMPLELOGGER_DEBUG( "dbus.Dispatcher", "Dispatch Status: " << dispatch_status_string[ (*ci)->dispatch_status() ] );
         while ( (*ci)->dispatch_status() == DISPATCH_DATA_REMAINS )
+        {
+          this->handler_begin();
           (*ci)->dispatch();
+          this->handler_end();
+        }
       }
       // Otherwise, we will only perform a number of dispatches up to the loop limit
       else
@@ -274,7 +706,12 @@ namespace DBus
         for ( loop_count = 0; loop_count < m_dispatch_loop_limit; loop_count++ )
         {
           // Make sure we need to dispatch before calling it
-          if ( (*ci)->dispatch_status() != DISPATCH_COMPLETE ) (*ci)->dispatch();
+          if ( (*ci)->dispatch_status() != DISPATCH_COMPLETE )
+          {
+            this->handler_begin();
+            (*ci)->dispatch();
+            this->handler_end();
+          }
 
           // Are we done? If so, let's break out of the loop.
           if ( (*ci)->dispatch_status() != DISPATCH_DATA_REMAINS ) break;
@@ -309,6 +746,7 @@ namespace DBus
       watchPair.write_watch = watch;
     }
 
+    update_poll_fd( watch->unix_fd() );
     wakeup_thread();
 
     return true;
@@ -338,6 +776,8 @@ namespace DBus
           it->second.write_watch == nullptr ){
         m_watches_map.erase( it );
       }
+
+      update_poll_fd( watch->unix_fd() );
     }
   
     wakeup_thread();
@@ -351,7 +791,14 @@ namespace DBus
 
     SIMPLELOGGER_DEBUG( "dbus.Dispatcher", "toggle watch  fd:" << watch->unix_fd() << "  enabled: " << watch->is_enabled() );
 
-    wakeup_thread();
+    std::lock_guard<std::mutex> watch_lock( m_mutex_watches );
+    short added = update_poll_fd( watch->unix_fd() );
+
+    // The dispatch thread picks up the change before it polls again, and
+    // polling for less than needed only costs one spurious wakeup; only
+    // a watch enabled from another thread has to interrupt the poll
+    if ( added and not ( m_dispatch_thread and std::this_thread::get_id() == m_dispatch_thread->get_id() ) )
+      wakeup_thread();
 
     return;
   }
@@ -361,14 +808,19 @@ namespace DBus
     if ( not timeout or not timeout->is_valid() ) return false;
     
     SIMPLELOGGER_DEBUG( "dbus.Dispatcher", "add timeout  enabled:" << timeout->is_enabled() << "  interval: " << timeout->interval() );
+
+    this->on_timeout_toggled( timeout );
     return true;
   }
 
   bool Dispatcher::on_remove_timeout(Timeout::pointer timeout)
   {
-    if ( not timeout or not timeout->is_valid() ) return false;
+    if ( not timeout ) return false;
     
-    SIMPLELOGGER_DEBUG( "dbus.Dispatcher", "remove timeout  enabled:" << timeout->is_enabled() << "  interval: " << timeout->interval() );
+    SIMPLELOGGER_DEBUG( "dbus.Dispatcher", "remove timeout" );
+
+    std::lock_guard<std::mutex> lock( m_mutex_timeouts );
+    m_timeouts.erase( timeout );
     return true;
   }
 
@@ -377,6 +829,22 @@ namespace DBus
     if ( not timeout or not timeout->is_valid() ) return false;
     
     SIMPLELOGGER_DEBUG( "dbus.Dispatcher", "timeout toggled  enabled:" << timeout->is_enabled() << "  interval: " << timeout->interval() );
+
+    {
+      std::lock_guard<std::mutex> lock( m_mutex_timeouts );
+      if ( timeout->is_enabled() ) {
+        TimeoutDue& entry = m_timeouts[ timeout ];
+        entry.interval = std::chrono::milliseconds( timeout->interval() );
+        entry.due = std::chrono::steady_clock::now() + entry.interval;
+      }
+      else
+        m_timeouts.erase( timeout );
+    }
+
+    // The dispatch thread recomputes its poll timeout before polling again
+    if ( not ( m_dispatch_thread and std::this_thread::get_id() == m_dispatch_thread->get_id() ) )
+      wakeup_thread();
+
     return true;
   }
 
@@ -16,16 +16,23 @@
  *   You should have received a copy of the GNU General Public License     *
  *   along with this software. If not see <http://www.gnu.org/licenses/>.  *
  ***************************************************************************/
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <map>
 #include <list>
 #include <set>
+#include <string>
 #include <thread>
 #include <mutex>
+#include <vector>
 
 #include <poll.h>
+#include <signal.h>
 
 #include <dbus/dbus.h>
 #include <dbus-cxx/connection.h>
+#include <dbus-cxx/server.h>
 #include <dbus-cxx/watch.h>
 #include <dbus-cxx/timeout.h>
 
@@ -79,16 +86,89 @@ namespace DBus
 
       //@}
 
+      /** @name Managing Servers */
+      //@{
+
+      /**
+       * Watches the server's listening sockets. Every connection the server
+       * accepts is added to this dispatcher.
+       */
+      bool add_server( Server::pointer server );
+
+      //@}
+
       bool start();
       
       bool stop();
       
       bool is_running();
 
+      /** @name Watching for Slow Handlers */
+      //@{
+
+      /**
+       * A message whose handlers, or a round of deferred calls, kept the
+       * dispatch thread busy for longer than the watchdog budget. The
+       * message fields are empty for deferred calls.
+       */
+      struct SlowHandler
+      {
+        SlowHandler(): type( INVALID_MESSAGE ), finished( false ) {}
+
+        std::string path;
+
+        std::string interface;
+
+        std::string member;
+
+        MessageType type;
+
+        /** How long the handlers had run when they were reported */
+        std::chrono::nanoseconds duration;
+
+        /** False when reported by the watchdog while the handlers were still running */
+        bool finished;
+
+        /** The dispatch thread's stack when the watchdog caught it, if requested */
+        std::vector<std::string> backtrace;
+      };
+
+      typedef sigc::signal<void,const SlowHandler&> SlowHandlerSignal;
+
+      /**
+       * Starts a watchdog that reports every dispatch running longer than
+       * budget through signal_slow_handler(). It is reported once by the
+       * watchdog thread as soon as the budget is exceeded, and again by the
+       * dispatch thread with the full duration when it returns.
+       *
+       * If backtrace_signal is not 0 the watchdog sends that signal to the
+       * dispatch thread to capture its stack in the first report. The signal
+       * must not be used otherwise by the application; system calls a handler
+       * is blocked in may fail with EINTR when it arrives. The stack is
+       * walked with backtrace() inside the signal handler, which is only
+       * safe because set_watchdog() calls it once first to load the unwinder.
+       *
+       * A budget of 0 stops the watchdog.
+       */
+      void set_watchdog( std::chrono::milliseconds budget, int backtrace_signal=0 );
+
+      std::chrono::milliseconds watchdog_budget() const;
+
+      /**
+       * Emitted from the watchdog thread or the dispatch thread; see
+       * set_watchdog(). Emissions never overlap.
+       */
+      SlowHandlerSignal& signal_slow_handler();
+
+      //@}
+
     protected:
       
       typedef std::list<Connection::pointer> Connections;
       Connections m_connections;
+
+      typedef std::list<Server::pointer> Servers;
+      Servers m_servers;
       
       volatile bool m_running;
       
@@ -106,6 +186,25 @@ namespace DBus
       };
       std::mutex m_mutex_watches;
       std::map<int,WatchPair> m_watches_map;
+
+      /**
+       * The descriptors of m_watches_map with the events their enabled
+       * watches wait for. Kept up to date as watches are added, removed
+       * and toggled, so the dispatch thread only copies it before polling.
+       */
+      std::vector<struct pollfd> m_poll_fds;
+
+      /**
+       * The enabled timeouts of the connections and servers, with when each
+       * is next due. libdbus adds and toggles them from any thread.
+       */
+      struct TimeoutDue {
+          std::chrono::steady_clock::time_point due;
+          /** Copied as libdbus may free the timeout while it is being handled */
+          std::chrono::milliseconds interval;
+      };
+      std::mutex m_mutex_timeouts;
+      std::map<Timeout::pointer,TimeoutDue> m_timeouts;
       
       std::mutex m_mutex_exception_fd_set;
       std::vector<int> m_exception_fd_set;
@@ -121,8 +220,71 @@ namespace DBus
        * as long as its status remains DISPATCH_DATA_REMAINS.
        */
       unsigned int m_dispatch_loop_limit;
+
+      /** The watchdog budget in nanoseconds, 0 if there is no watchdog */
+      std::atomic<int64_t> m_watchdog_budget;
+
+      int m_backtrace_signal;
+
+      /** The handler of m_backtrace_signal before set_watchdog() replaced it */
+      struct sigaction m_previous_backtrace_action;
+
+      bool m_backtrace_action_installed;
+
+      std::thread* m_watchdog_thread;
+
+      bool m_watchdog_running;
+
+      /** Guards the handler counts and wakes the watchdog thread */
+      std::mutex m_mutex_watchdog;
+
+      std::condition_variable m_watchdog_condition;
+
+      /** When the current dispatch started, in steady clock nanoseconds; 0 while idle */
+      std::atomic<int64_t> m_handler_start;
+
+      /** Counts dispatches, so the watchdog reports each one once */
+      uint64_t m_handler_count;
+
+      uint64_t m_handler_reported;
+
+      /**
+       * The message being dispatched, with a reference held, or NULL.
+       *
+       * Only the dispatch thread stores it. The watchdog takes its own
+       * reference under m_mutex_watchdog, and the dispatch thread takes
+       * the mutex before releasing a message it swapped out, so the
+       * message can't be freed between the two.
+       */
+      std::atomic<DBusMessage*> m_current_message;
+
+      SlowHandlerSignal m_slow_handler_signal;
+
+      /** Serializes emissions of m_slow_handler_signal from the two threads */
+      std::mutex m_mutex_slow_handler_signal;
       
       virtual void dispatch_thread_main();
+
+      void watchdog_thread_main();
+
+      void stop_watchdog();
+
+      /** Starts timing a dispatch if the watchdog is running */
+      void handler_begin();
+
+      /** Stops timing a dispatch and reports it if it ran too long */
+      void handler_end();
+
+      /** Records which message the current dispatch is handling */
+      FilterResult on_watchdog_filter( Connection::pointer, Message::pointer );
+
+      /** Replaces the current message, releasing the one it replaces */
+      void set_current_message( DBusMessage* message );
+
+      void emit_slow_handler( const SlowHandler& report );
+
+      /** Fills in the dispatch thread's stack; m_mutex_watchdog must not be held */
+      void capture_backtrace( std::vector<std::string>& stack );
       
       bool on_add_watch(Watch::pointer);
       
@@ -142,6 +304,13 @@ namespace DBus
 
       void wakeup_thread();
 
+      /**
+       * Sets the events polled for on fd from its watches, adding or
+       * removing its entry in m_poll_fds as needed; m_mutex_watches must be
+       * held. Returns the events that were not polled for before.
+       */
+      short update_poll_fd( int fd );
+
       /**
        * Add all read and write watch FDs to the given vector to watch.
        */
@@ -156,6 +325,39 @@ namespace DBus
        * Dispatch all of our connections
        */
       void dispatch_connections();
+
+      /**
+       * The poll timeout needed to run the earliest deferred call of any
+       * connection, or -1 if there are none.
+       */
+      int deferred_call_timeout();
+
+      /**
+       * Run the deferred calls that are due on all of our connections
+       */
+      void process_deferred_calls();
+
+      /**
+       * Let congested connections send their held signals
+       */
+      void process_outgoing();
+
+      /**
+       * Handle the timeouts that are due, each of which is then due again
+       * an interval later until libdbus removes or disables it
+       */
+      void process_timeouts();
+
+      /**
+       * The poll timeout needed to handle the earliest timeout, or -1 if
+       * there are none
+       */
+      int timeouts_timeout();
+
+      /**
+       * The timeout for the next poll, covering timeouts, deferred calls and congested connections
+       */
+      int poll_timeout();
   };
 
 }
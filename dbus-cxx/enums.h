@@ -119,6 +119,48 @@ namespace DBus {
     FALLBACK
   } PrimaryFallback;
 
+  typedef enum PropertyAccess
+  {
+    PROPERTY_READ,
+    PROPERTY_WRITE,
+    PROPERTY_READWRITE
+  } PropertyAccess;
+
+  /**
+   * How changes to a property are announced; maps onto the
+   * org.freedesktop.DBus.Property.EmitsChangedSignal annotation.
+   */
+  typedef enum PropertyUpdateType
+  {
+    PROPERTY_UPDATE_EMITS_CHANGE,       /**< PropertiesChanged carries the new value */
+    PROPERTY_UPDATE_EMITS_INVALIDATION, /**< PropertiesChanged only names the property */
+    PROPERTY_UPDATE_CONST,              /**< The value never changes */
+    PROPERTY_UPDATE_NONE                /**< Changes are not announced */
+  } PropertyUpdateType;
+
+  /** How a ConnectionPool chooses the connection for the next call */
+  typedef enum PoolPolicy
+  {
+    POOL_ROUND_ROBIN,       /**< Each call goes to the next connection in turn */
+    POOL_LEAST_OUTSTANDING  /**< Each call goes to the connection with the fewest unanswered calls */
+  } PoolPolicy;
+
+  /** What Connection::send() does once an outgoing high watermark is reached */
+  typedef enum FlowControlPolicy
+  {
+    FLOW_CONTROL_BLOCK,              /**< Wait, at most the flow control timeout, until the queue drains below the low watermark */
+    FLOW_CONTROL_FAIL,               /**< Refuse the message; send() returns 0 */
+    FLOW_CONTROL_DROP_OLDEST_SIGNAL  /**< Hold signals back, dropping the oldest held signal when full */
+  } FlowControlPolicy;
+
+  /** The codecs a CompressedBuffer can be sent with */
+  typedef enum CompressionCodec
+  {
+    COMPRESSION_NONE,  /**< Sent as is */
+    COMPRESSION_LZ4,   /**< LZ4 block, preceded by the 32 bit little endian uncompressed size */
+    COMPRESSION_ZSTD   /**< Zstandard frame */
+  } CompressionCodec;
+
 }
 
 #endif
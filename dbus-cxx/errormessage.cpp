@@ -69,11 +69,15 @@ namespace DBus
 
   ErrorMessage::pointer ErrorMessage::create(DBusMessage * cobj)
   {
+    ErrorMessage::pointer cached_error = dbus_cxx_dynamic_pointer_cast<ErrorMessage>( Message::cached( cobj ) );
+    if ( cached_error ) return cached_error;
     return pointer(new ErrorMessage(cobj) );
   }
 
   ErrorMessage::pointer ErrorMessage::create(Message::pointer msg)
   {
+    ErrorMessage::pointer error = dbus_cxx_dynamic_pointer_cast<ErrorMessage>( msg );
+    if ( error ) return error;
     return pointer(new ErrorMessage(msg) );
   }
 
@@ -0,0 +1,122 @@
+/***************************************************************************
+ *   Copyright (C) 2009,2010 by Rick L. Vinyard, Jr.                       *
+ *   rvinyard@cs.nmsu.edu                                                  *
+ *   Copyright (C) 2014- by Robert Middleton                               *
+ *                                                                         *
+ *   This file is part of the dbus-cxx library.                            *
+ *                                                                         *
+ *   The dbus-cxx library is free software; you can redistribute it and/or *
+ *   modify it under the terms of the GNU General Public License           *
+ *   version 3 as published by the Free Software Foundation.               *
+ *                                                                         *
+ *   The dbus-cxx library is distributed in the hope that it will be       *
+ *   useful, but WITHOUT ANY WARRANTY; without even the implied warranty   *
+ *   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU   *
+ *   General Public License for more details.                              *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this software. If not see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#include "filedescriptor.h"
+#include "dbus-cxx-private.h"
+
+#include <cstring>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace DBus
+{
+
+  FileDescriptor::FileDescriptor():
+      m_fd( -1 ),
+      m_owned( false )
+  {
+  }
+
+  FileDescriptor::FileDescriptor( int fd, bool owned ):
+      m_fd( fd ),
+      m_owned( owned )
+  {
+  }
+
+  FileDescriptor::FileDescriptor( FileDescriptor&& other ):
+      m_fd( other.m_fd ),
+      m_owned( other.m_owned )
+  {
+    other.m_fd = -1;
+    other.m_owned = false;
+  }
+
+  FileDescriptor& FileDescriptor::operator=( FileDescriptor&& other )
+  {
+    if ( this != &other ) {
+      bool owned = other.m_owned;
+      this->reset( other.release() );
+      m_owned = owned;
+    }
+    return *this;
+  }
+
+  FileDescriptor::~FileDescriptor()
+  {
+    this->reset();
+  }
+
+  FileDescriptor::pointer FileDescriptor::create( int fd )
+  {
+    return pointer( new FileDescriptor( fd, false ) );
+  }
+
+  FileDescriptor::pointer FileDescriptor::adopt( int fd )
+  {
+    return pointer( new FileDescriptor( fd, true ) );
+  }
+
+  FileDescriptor::pointer FileDescriptor::duplicate( int fd )
+  {
+    int copy = -1;
+
+    if ( fd >= 0 ) copy = fcntl( fd, F_DUPFD_CLOEXEC, 0 );
+    if ( fd >= 0 and copy < 0 )
+      SIMPLELOGGER_ERROR("dbus.FileDescriptor", "Unable to duplicate file descriptor " << fd << ": " << strerror( errno ) );
+
+    return pointer( new FileDescriptor( copy, true ) );
+  }
+
+  int FileDescriptor::getDescriptor() const
+  {
+    return m_fd;
+  }
+
+  bool FileDescriptor::is_valid() const
+  {
+    return m_fd >= 0;
+  }
+
+  bool FileDescriptor::is_owned() const
+  {
+    return m_owned;
+  }
+
+  int FileDescriptor::release()
+  {
+    int fd = m_fd;
+    m_fd = -1;
+    m_owned = false;
+    return fd;
+  }
+
+  void FileDescriptor::reset( int fd )
+  {
+    if ( m_owned and m_fd >= 0 and m_fd != fd ) close( m_fd );
+    m_fd = fd;
+    m_owned = ( fd >= 0 );
+  }
+
+  FileDescriptor::pointer FileDescriptor::dup() const
+  {
+    return duplicate( m_fd );
+  }
+
+}
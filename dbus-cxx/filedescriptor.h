@@ -18,6 +18,8 @@
  *   along with this software. If not see <http://www.gnu.org/licenses/>.  *
  ***************************************************************************/
 
+#include <dbus-cxx/pointer.h>
+
 #ifndef DBUS_CXX_FILEDESCRIPTOR
 #define DBUS_CXX_FILEDESCRIPTOR
 
@@ -26,50 +28,68 @@ namespace DBus{
 /**
  * A FileDescriptor holds a UNIX file descriptor that can be passed between processes.
  *
+ * One made with create() only borrows the descriptor, which stays the
+ * caller's to close. One made with adopt(), duplicate() or dup() owns its
+ * descriptor and closes it when destroyed, unless ownership has been given
+ * up with release(). FileDescriptors cannot be copied; share the pointer,
+ * or use dup() for a second descriptor.
+ *
+ * Appending a FileDescriptor to a message leaves it untouched, since libdbus
+ * sends a duplicate. Extracting one from a message gives an owning
+ * FileDescriptor around the duplicate libdbus returns, so received
+ * descriptors are closed once nothing refers to them.
  */
 class FileDescriptor{
 protected:
-	FileDescriptor(){
-		m_fd = -1;
-	}
+	FileDescriptor();
+
+        FileDescriptor( int fd, bool owned );
 
-        explicit FileDescriptor( int fd ){
-            m_fd = fd;
-        }
+        FileDescriptor( const FileDescriptor& other ) = delete;
 
-        explicit FileDescriptor( const FileDescriptor& other ){
-            m_fd = other.m_fd;
-        }
+        FileDescriptor& operator=( const FileDescriptor& other ) = delete;
 
 public:
       typedef DBusCxxPointer<FileDescriptor> pointer;
 
-      static pointer create( int fd ){
-          pointer p = pointer(new FileDescriptor( fd ));
-          return p;
-      }
+      /** Borrows @p fd, which is not closed when the FileDescriptor is destroyed */
+      static pointer create( int fd );
+
+      /** Takes ownership of @p fd, which is closed when the FileDescriptor is destroyed */
+      static pointer adopt( int fd );
+
+      /**
+       * Duplicates @p fd, leaving the original with the caller
+       * @return An invalid FileDescriptor if the descriptor could not be duplicated
+       */
+      static pointer duplicate( int fd );
+
+      FileDescriptor( FileDescriptor&& other );
 
-	~FileDescriptor(){}
+      FileDescriptor& operator=( FileDescriptor&& other );
 
-/*
-    FileDescriptor& operator=( int fd ){
-		m_fd = fd;
-		return *this;
-	}
-*/
+	~FileDescriptor();
 
-	int getDescriptor() const{
-		return m_fd;
-	}
+	int getDescriptor() const;
 
-/*
-	void setDescriptor( int fd ){
-		m_fd = fd;
-	}
-*/
+	bool is_valid() const;
+
+	/** True if the descriptor is closed when the FileDescriptor is destroyed */
+	bool is_owned() const;
+
+	/** Gives up the descriptor and returns it; the caller must close it if it was owned */
+	int release();
+
+	/** Closes the current descriptor if it is owned, and takes ownership of @p fd */
+	void reset( int fd = -1 );
+
+	/** Returns a FileDescriptor owning a duplicate of this descriptor */
+	pointer dup() const;
 
 private:
 	int m_fd;
+
+	bool m_owned;
 };
 
 }
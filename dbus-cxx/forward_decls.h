@@ -29,6 +29,8 @@ namespace DBus {
 
   class InterfaceProxy;
   
+  class MethodBase;
+
   class Object;
 
   class ObjectProxy;
@@ -55,6 +57,9 @@ namespace DBus {
            >
   class MethodProxy; 
 
+  template <class T_type>
+  class Property;
+
 };
 
 #endif
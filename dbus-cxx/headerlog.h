@@ -21,22 +21,54 @@
 #ifndef DBUSCXX_HEADERLOG_H
 #define DBUSCXX_HEADERLOG_H
 
+#include <atomic>
 #include <sstream>
+#include <dbus-cxx/dbus-cxx-config.h>
 #include <dbus-cxx/simplelogger_defs.h>
 
-extern simplelogger_log_function dbuscxx_log_function;
+/* A config that doesn't set the floor, such as one installed by an older
+ * release, compiles in every level */
+#ifndef DBUS_CXX_LOG_FLOOR
+#define DBUS_CXX_LOG_FLOOR SL_TRACE
+#endif
+
+/** Set from the logging setters while other threads log */
+extern std::atomic<simplelogger_log_function> dbuscxx_log_function;
+
+/**
+ * The lowest level any logger currently accepts; above SL_FATAL when no
+ * logging function is installed. Kept up to date by the logging setters.
+ */
+extern std::atomic<int> dbuscxx_log_gate;
+
+namespace DBus
+{
+  bool logEnabled( const char* logger, const enum ::SL_LogLevel level );
+}
+
+/**
+ * True if a message is wanted. The compile time floor is checked first so
+ * that the whole statement can be discarded, then the global gate, and
+ * only then the threshold of the logger.
+ */
+#define DBUSCXX_LOG_ENABLED( logger, level ) \
+    ( (level) >= DBUS_CXX_LOG_FLOOR and \
+      (level) >= dbuscxx_log_gate.load( std::memory_order_relaxed ) and \
+      DBus::logEnabled( logger, level ) )
 
 #define DBUSCXX_LOG_CSTR_HEADER( logger, message, level ) do{\
-    if( !dbuscxx_log_function ) break;\
+    simplelogger_log_function log_function = dbuscxx_log_function;\
+    if( !log_function ) break;\
     struct SL_LogLocation location;\
     location.line_number = __LINE__;\
     location.file = __FILE__;\
     location.function = __func__;\
-    dbuscxx_log_function( logger, &location, level, message );\
+    log_function( logger, &location, level, message );\
     } while(0)
 
 #define DBUSCXX_DEBUG_STDSTR( logger, message ) do{\
-    std::stringstream stream;\
+    if( !DBUSCXX_LOG_ENABLED( logger, SL_DEBUG ) ) break;\
+    std::ostringstream stream;\
     stream << message;\
     DBUSCXX_LOG_CSTR_HEADER( logger, stream.str().c_str(), SL_DEBUG);\
     } while(0)
@@ -29,11 +29,16 @@ namespace DBus
 
   Interface::Interface( const std::string& name ):
       m_object(NULL),
-      m_name(name)
+      m_name(name),
+      m_method_table(new MethodTable()),
+      m_properties_changed_pending(false),
+      m_properties_changed_interval(0)
   {
     pthread_rwlock_init( &m_methods_rwlock, NULL );
     pthread_rwlock_init( &m_signals_rwlock, NULL );
+    pthread_rwlock_init( &m_properties_rwlock, NULL );
     pthread_mutex_init( &m_name_mutex, NULL );
+    pthread_mutex_init( &m_properties_changed_mutex, NULL );
   }
 
   Interface::pointer Interface::create(const std::string& name)
@@ -43,9 +48,14 @@ namespace DBus
 
   Interface::~ Interface( )
   {
+    for ( Properties::iterator i = m_properties.begin(); i != m_properties.end(); i++ )
+      i->second->set_interface( NULL );
+
     pthread_rwlock_destroy( &m_methods_rwlock );
     pthread_rwlock_destroy( &m_signals_rwlock );
+    pthread_rwlock_destroy( &m_properties_rwlock );
     pthread_mutex_destroy( &m_name_mutex );
+    pthread_mutex_destroy( &m_properties_changed_mutex );
   }
 
   Object* Interface::object() const
@@ -89,21 +99,39 @@ namespace DBus
     return m_methods;
   }
 
-  MethodBase::pointer Interface::method( const std::string& name ) const
+  Interface::Methods Interface::copy_methods() const
   {
-    Methods::const_iterator iter;
+    Methods result;
 
     // ========== READ LOCK ==========
     pthread_rwlock_rdlock( &m_methods_rwlock );
-    
-    iter = m_methods.find( name );
+
+    result = m_methods;
 
     // ========== UNLOCK ==========
     pthread_rwlock_unlock( &m_methods_rwlock );
 
-    if ( iter == m_methods.end() ) return MethodBase::pointer();
+    return result;
+  }
+
+  MethodBase::pointer Interface::method( const std::string& name ) const
+  {
+    DBusCxxPointer<const MethodTable> table = std::atomic_load( &m_method_table );
+    MethodTable::const_iterator iter = table->find( name );
+
+    if ( iter == table->end() ) return MethodBase::pointer();
 
-    return iter->second;
+    return iter->second.front();
+  }
+
+  void Interface::publish_methods()
+  {
+    DBusCxxPointer<MethodTable> table( new MethodTable() );
+
+    for ( Methods::iterator i = m_methods.begin(); i != m_methods.end(); i++ )
+      (*table)[ i->first ].push_back( i->second );
+
+    std::atomic_store( &m_method_table, DBusCxxPointer<const MethodTable>( table ) );
   }
 
   bool Interface::add_method( MethodBase::pointer method )
@@ -125,6 +153,7 @@ namespace DBus
           method->signal_name_changed().connect(sigc::bind(sigc::mem_fun(*this,&Interface::on_method_name_changed),method));
 
       m_methods.insert(std::make_pair(method->name(), method));
+      this->publish_methods();
     }
     else
     {
@@ -152,6 +181,7 @@ namespace DBus
     if ( iter != m_methods.end() ) {
       method = iter->second;
       m_methods.erase( iter );
+      this->publish_methods();
     }
 
     if ( method )
@@ -172,17 +202,8 @@ namespace DBus
 
   bool Interface::has_method( const std::string & name ) const
   {
-    Methods::const_iterator iter;
-    
-    // ========== READ LOCK ==========
-    pthread_rwlock_rdlock( &m_methods_rwlock );
-
-    iter = m_methods.find( name );
-
-    // ========== UNLOCK ==========
-    pthread_rwlock_unlock( &m_methods_rwlock );
-
-    return ( iter != m_methods.end() );
+    DBusCxxPointer<const MethodTable> table = std::atomic_load( &m_method_table );
+    return table->find( name ) != table->end();
   }
 
   bool Interface::add_signal( signal_base::pointer sig )
@@ -216,6 +237,8 @@ namespace DBus
     // ========== UNLOCK ==========
     pthread_rwlock_unlock( &m_signals_rwlock );
 
+    if ( result ) this->invalidate_introspection();
+
     return result;
   }
 
@@ -237,6 +260,8 @@ namespace DBus
     // ========== UNLOCK ==========
     pthread_rwlock_unlock( &m_signals_rwlock );
 
+    if ( result ) this->invalidate_introspection();
+
     return result;
   }
 
@@ -254,6 +279,7 @@ namespace DBus
       {
         Signals::iterator temp = i++;
         m_signals.erase(temp);
+        result = true;
       }
       else
       {
@@ -264,6 +290,8 @@ namespace DBus
     // ========== UNLOCK ==========
     pthread_rwlock_unlock( &m_signals_rwlock );
 
+    if ( result ) this->invalidate_introspection();
+
     return result;
   }
 
@@ -331,6 +359,247 @@ namespace DBus
     return sig;
   }
 
+  bool Interface::add_property( PropertyBase::pointer property )
+  {
+    bool result = false;
+
+    if ( not property or property->interface() != NULL ) return false;
+
+    // ========== WRITE LOCK ==========
+    pthread_rwlock_wrlock( &m_properties_rwlock );
+
+    if ( m_properties.find( property->name() ) == m_properties.end() )
+    {
+      m_properties[ property->name() ] = property;
+      property->set_interface( this );
+      result = true;
+    }
+
+    // ========== UNLOCK ==========
+    pthread_rwlock_unlock( &m_properties_rwlock );
+
+    if ( result ) this->invalidate_introspection();
+
+    return result;
+  }
+
+  bool Interface::remove_property( const std::string& name )
+  {
+    bool result = false;
+    Properties::iterator i;
+
+    // ========== WRITE LOCK ==========
+    pthread_rwlock_wrlock( &m_properties_rwlock );
+
+    i = m_properties.find( name );
+    if ( i != m_properties.end() )
+    {
+      i->second->set_interface( NULL );
+      m_properties.erase( i );
+      result = true;
+    }
+
+    // ========== UNLOCK ==========
+    pthread_rwlock_unlock( &m_properties_rwlock );
+
+    if ( result ) this->invalidate_introspection();
+
+    return result;
+  }
+
+  bool Interface::has_property( const std::string& name ) const
+  {
+    bool result;
+
+    // ========== READ LOCK ==========
+    pthread_rwlock_rdlock( &m_properties_rwlock );
+
+    result = m_properties.find( name ) != m_properties.end();
+
+    // ========== UNLOCK ==========
+    pthread_rwlock_unlock( &m_properties_rwlock );
+
+    return result;
+  }
+
+  PropertyBase::pointer Interface::property( const std::string& name ) const
+  {
+    PropertyBase::pointer result;
+    Properties::const_iterator i;
+
+    // ========== READ LOCK ==========
+    pthread_rwlock_rdlock( &m_properties_rwlock );
+
+    i = m_properties.find( name );
+    if ( i != m_properties.end() ) result = i->second;
+
+    // ========== UNLOCK ==========
+    pthread_rwlock_unlock( &m_properties_rwlock );
+
+    return result;
+  }
+
+  Interface::Properties Interface::properties() const
+  {
+    Properties result;
+
+    // ========== READ LOCK ==========
+    pthread_rwlock_rdlock( &m_properties_rwlock );
+
+    result = m_properties;
+
+    // ========== UNLOCK ==========
+    pthread_rwlock_unlock( &m_properties_rwlock );
+
+    return result;
+  }
+
+  bool Interface::has_properties() const
+  {
+    bool result;
+
+    // ========== READ LOCK ==========
+    pthread_rwlock_rdlock( &m_properties_rwlock );
+
+    result = not m_properties.empty();
+
+    // ========== UNLOCK ==========
+    pthread_rwlock_unlock( &m_properties_rwlock );
+
+    return result;
+  }
+
+  bool Interface::append_properties( MessageAppendIterator& iter ) const
+  {
+    Properties::const_iterator i;
+    MessageAppendIterator* dict;
+
+    if ( not iter.open_container( CONTAINER_ARRAY, "{sv}" ) ) return false;
+    dict = iter.sub_iterator();
+
+    // ========== READ LOCK ==========
+    pthread_rwlock_rdlock( &m_properties_rwlock );
+
+    for ( i = m_properties.begin(); i != m_properties.end(); i++ )
+    {
+      if ( not i->second->is_readable() ) continue;
+      dict->open_container( CONTAINER_DICT_ENTRY, std::string() );
+      dict->sub_iterator()->append( i->first );
+      i->second->append_variant( *dict->sub_iterator() );
+      dict->close_container();
+    }
+
+    // ========== UNLOCK ==========
+    pthread_rwlock_unlock( &m_properties_rwlock );
+
+    return iter.close_container();
+  }
+
+  void Interface::set_properties_changed_interval( int milliseconds )
+  {
+    pthread_mutex_lock( &m_properties_changed_mutex );
+    m_properties_changed_interval = ( milliseconds < 0 ) ? 0 : milliseconds;
+    pthread_mutex_unlock( &m_properties_changed_mutex );
+  }
+
+  int Interface::properties_changed_interval() const
+  {
+    int result;
+    pthread_mutex_lock( &m_properties_changed_mutex );
+    result = m_properties_changed_interval;
+    pthread_mutex_unlock( &m_properties_changed_mutex );
+    return result;
+  }
+
+  void Interface::on_property_changed( PropertyBase* property )
+  {
+    bool schedule = false;
+    int interval = 0;
+    Connection::pointer conn;
+
+    if ( property->update_type() == PROPERTY_UPDATE_CONST or
+         property->update_type() == PROPERTY_UPDATE_NONE ) return;
+
+    // Nobody can be listening if we aren't exported on a connection
+    conn = this->connection();
+    if ( not conn ) return;
+
+    pthread_mutex_lock( &m_properties_changed_mutex );
+
+    if ( property->update_type() == PROPERTY_UPDATE_EMITS_CHANGE )
+      m_changed_properties.insert( property->name() );
+    else
+      m_invalidated_properties.insert( property->name() );
+
+    if ( not m_properties_changed_pending )
+    {
+      m_properties_changed_pending = true;
+      schedule = true;
+      interval = m_properties_changed_interval;
+    }
+
+    pthread_mutex_unlock( &m_properties_changed_mutex );
+
+    if ( schedule )
+      conn->add_deferred_call( sigc::mem_fun(*this, &Interface::flush_properties_changed), interval );
+  }
+
+  void Interface::flush_properties_changed()
+  {
+    std::set<std::string> changed;
+    std::set<std::string> invalidated;
+    std::set<std::string>::iterator i;
+    std::vector<std::string> invalidated_names;
+    Connection::pointer conn;
+    SignalMessage::pointer msg;
+
+    pthread_mutex_lock( &m_properties_changed_mutex );
+    changed.swap( m_changed_properties );
+    invalidated.swap( m_invalidated_properties );
+    m_properties_changed_pending = false;
+    pthread_mutex_unlock( &m_properties_changed_mutex );
+
+    if ( changed.empty() and invalidated.empty() ) return;
+
+    conn = this->connection();
+    if ( not conn ) return;
+
+    SIMPLELOGGER_DEBUG("dbus.Interface", "Interface(" << this->name() << ")::flush_properties_changed " << changed.size() << " changed, " << invalidated.size() << " invalidated");
+
+    msg = SignalMessage::create( this->path(), DBUS_CXX_PROPERTIES_INTERFACE, "PropertiesChanged" );
+
+    MessageAppendIterator iter( *msg );
+    iter << m_name;
+
+    // The values are read now, so a property changed many times since the
+    // last signal is only sent once with its latest value
+    iter.open_container( CONTAINER_ARRAY, "{sv}" );
+    MessageAppendIterator* dict = iter.sub_iterator();
+
+    // ========== READ LOCK ==========
+    pthread_rwlock_rdlock( &m_properties_rwlock );
+
+    for ( i = changed.begin(); i != changed.end(); i++ )
+    {
+      Properties::iterator prop = m_properties.find( *i );
+      if ( prop == m_properties.end() ) continue;
+      dict->open_container( CONTAINER_DICT_ENTRY, std::string() );
+      dict->sub_iterator()->append( *i );
+      prop->second->append_variant( *dict->sub_iterator() );
+      dict->close_container();
+    }
+
+    // ========== UNLOCK ==========
+    pthread_rwlock_unlock( &m_properties_rwlock );
+
+    iter.close_container();
+
+    invalidated_names.assign( invalidated.begin(), invalidated.end() );
+    iter << invalidated_names;
+
+    conn << msg;
+  }
+
   sigc::signal< void, const std::string &, const std::string & > Interface::signal_name_changed()
   {
     return m_signal_name_changed;
@@ -352,12 +621,15 @@ namespace DBus
     std::string spaces;
     Methods::const_iterator miter;
     Signals::const_iterator siter;
+    Properties::const_iterator piter;
     for ( int i=0; i < space_depth; i++) spaces += " ";
     sout << spaces << "<interface name=\"" << this->name() << "\">\n";
     for ( miter = m_methods.begin(); miter != m_methods.end(); miter++ )
       sout << miter->second->introspect(space_depth+2);
     for ( siter = m_signals.begin(); siter != m_signals.end(); siter++ )
       sout << (*siter)->introspect(space_depth+2);
+    for ( piter = m_properties.begin(); piter != m_properties.end(); piter++ )
+      sout << piter->second->introspect(space_depth+2);
     sout << spaces << "</interface>\n";
     return sout.str();
   }
@@ -366,38 +638,21 @@ namespace DBus
   {
     SIMPLELOGGER_DEBUG( "dbus.Interface", "handle_call_message  interface=" << m_name );
     
-    Methods::iterator current, upper;
-    MethodBase::pointer method;
-    HandlerResult result = NOT_HANDLED;
+    if ( message->member() == NULL ) return NOT_HANDLED;
 
-    // ========== READ LOCK ==========
-//     pthread_rwlock_rdlock( &m_methods_rwlock );
+    // Methods added or removed by a handler take effect for the next call
+    DBusCxxPointer<const MethodTable> table = std::atomic_load( &m_method_table );
+    MethodTable::const_iterator overloads = table->find( message->member() );
 
-    current = m_methods.lower_bound( message->member() );
+    if ( overloads == table->end() ) return NOT_HANDLED;
 
-    if ( current == m_methods.end() )
+    for ( size_t i = 0; i < overloads->second.size(); i++ )
     {
-      // ========== UNLOCK ==========
-//       pthread_rwlock_unlock( &m_methods_rwlock );
-
-      return NOT_HANDLED;
+      const MethodBase::pointer& method = overloads->second[i];
+      if ( method and method->handle_call_message( connection, message ) == HANDLED ) return HANDLED;
     }
-    
-    upper = m_methods.upper_bound( message->member() );
 
-    for ( ; current != upper; current++ )
-    {
-      if ( current->second and current->second->handle_call_message( connection, message ) == HANDLED )
-      {
-        result = HANDLED;
-        break;
-      }
-    }
-    
-    // ========== UNLOCK ==========
-//     pthread_rwlock_unlock( &m_methods_rwlock );
-
-    return result;
+    return NOT_HANDLED;
   }
 
   void Interface::on_method_name_changed(const std::string & oldname, const std::string & newname, MethodBase::pointer method)
@@ -425,6 +680,8 @@ namespace DBus
 
     m_methods.insert( std::make_pair(newname, method) );
 
+    this->publish_methods();
+
     MethodSignalNameConnections::iterator i;
     i = m_method_signal_name_connections.find(method);
     if ( i == m_method_signal_name_connections.end() )
@@ -435,6 +692,14 @@ namespace DBus
     
     // ========== UNLOCK ==========
     pthread_rwlock_unlock( &m_methods_rwlock );
+
+    this->invalidate_introspection();
+  }
+
+  void Interface::invalidate_introspection()
+  {
+    // The object caches our introspection XML along with its own
+    if ( m_object ) m_object->invalidate_introspection();
   }
 
   void Interface::set_connection(Connection::pointer conn)
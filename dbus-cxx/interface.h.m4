@@ -119,11 +119,15 @@ dnl
 
 #include <string>
 #include <map>
+#include <memory>
 #include <set>
+#include <unordered_map>
+#include <vector>
 
 #include <dbus-cxx/forward_decls.h>
 #include <dbus-cxx/methodbase.h>
 #include <dbus-cxx/dbus_signal.h>
+#include <dbus-cxx/property.h>
 
 #ifndef DBUSCXX_INTERFACE_H
 #define DBUSCXX_INTERFACE_H
@@ -138,7 +142,7 @@ namespace DBus {
    * 
    * @author Rick L Vinyard Jr <rvinyard@cs.nmsu.edu>
    */
-  class Interface
+  class Interface : public sigc::trackable
   {
     protected:
       /**
@@ -182,6 +186,16 @@ namespace DBus {
        */
       typedef std::set<signal_base::pointer> Signals;
 
+      /**
+       * Typedef to the storage structure for properties.
+       *
+       * \b Key - property name
+       * \b Value - smart pointer to a property.
+       *
+       * Can access \e type as \c Interface::Properties
+       */
+      typedef std::map<std::string, PropertyBase::pointer> Properties;
+
       /**
        * Creates a named Interface
        * @param name The name of this interface
@@ -227,6 +241,9 @@ namespace DBus {
       /** Returns the methods associated with this interface */
       const Methods& methods() const;
 
+      /** Returns a copy of the methods, taken under the lock, to iterate while they change */
+      Methods copy_methods() const;
+
       /** Returns the first method with the given name */
       MethodBase::pointer method( const std::string& name ) const;
 
@@ -284,6 +301,57 @@ FOR(0, eval(CALL_SIZE),[[DECLARE_CREATE_SIGNAL(%1)
        */
       signal_base::pointer signal(const std::string& signal_name);
 
+      /**
+       * Creates a property with the given name and access
+       * @return A smart pointer to the newly created property, or a null pointer if a property with that name exists
+       */
+      template <class T_type>
+      DBusCxxPointer<Property<T_type> >
+      create_property( const std::string& name,
+                       PropertyAccess access=PROPERTY_READ,
+                       PropertyUpdateType update=PROPERTY_UPDATE_EMITS_CHANGE );
+
+      /**
+       * Adds the given property
+       * @return true if the property was added, false if a property with the same name already exists
+       */
+      bool add_property( PropertyBase::pointer property );
+
+      /** Removes the property with the given name */
+      bool remove_property( const std::string& name );
+
+      /** True if the interface has a property with the given name */
+      bool has_property( const std::string& name ) const;
+
+      /** Returns the property with the given name or a null pointer */
+      PropertyBase::pointer property( const std::string& name ) const;
+
+      /** Returns a copy of the properties associated with this interface */
+      Properties properties() const;
+
+      /** True if the interface has any properties */
+      bool has_properties() const;
+
+      /**
+       * Appends every readable property as an \c a{sv} dictionary, in
+       * the form used by org.freedesktop.DBus.Properties.GetAll
+       */
+      bool append_properties( MessageAppendIterator& iter ) const;
+
+      /**
+       * Sets how long property changes are collected before being sent as
+       * one PropertiesChanged signal.
+       *
+       * With the default of 0 the signal is sent at the end of the dispatch
+       * round in which the first change was made.
+       */
+      void set_properties_changed_interval( int milliseconds );
+
+      int properties_changed_interval() const;
+
+      /** Sends any pending property changes immediately */
+      void flush_properties_changed();
+
       /** Signal emitted when the name is changed */
       sigc::signal<void,const std::string&/*old name*/,const std::string&/*new name*/> signal_name_changed();
 
@@ -304,18 +372,53 @@ FOR(0, eval(CALL_SIZE),[[DECLARE_CREATE_SIGNAL(%1)
 
       friend class Object;
 
+      friend class PropertyBase;
+
       void set_object( Object* object );
 
       std::string m_name;
       
       Methods m_methods;
 
+      /**
+       * The methods by name, in the order they were added, as looked up by
+       * handle_call_message().
+       *
+       * A table is never changed once published. Writers build a new one
+       * under the write lock and swap it in; calls being dispatched keep
+       * the table they loaded alive until they are done with it.
+       */
+      typedef std::unordered_map<std::string, std::vector<MethodBase::pointer> > MethodTable;
+
+      /** Only accessed through std::atomic_load() and std::atomic_store() */
+      DBusCxxPointer<const MethodTable> m_method_table;
+
+      /** Publishes a table built from m_methods; the write lock must be held */
+      void publish_methods();
+
       Signals m_signals;
 
+      /** Serializes changes to the methods; lookups take no lock */
       mutable pthread_rwlock_t m_methods_rwlock;
 
       mutable pthread_rwlock_t m_signals_rwlock;
 
+      Properties m_properties;
+
+      mutable pthread_rwlock_t m_properties_rwlock;
+
+      /** Names of the properties changed since the last PropertiesChanged signal */
+      std::set<std::string> m_changed_properties;
+
+      std::set<std::string> m_invalidated_properties;
+
+      bool m_properties_changed_pending;
+
+      int m_properties_changed_interval;
+
+      /** Protects the pending property change sets and the interval */
+      mutable pthread_mutex_t m_properties_changed_mutex;
+
       /** Ensures that the name doesn't change while the name changed signal is emitting */
       pthread_mutex_t m_name_mutex;
 
@@ -335,6 +438,15 @@ FOR(0, eval(CALL_SIZE),[[DECLARE_CREATE_SIGNAL(%1)
        */
       void on_method_name_changed(const std::string& oldname, const std::string& newname, MethodBase::pointer method);
 
+      /** Discards the introspection XML cached by the object we belong to */
+      void invalidate_introspection();
+
+      /**
+       * Callback point for properties when their value changes. Records the
+       * change and schedules the PropertiesChanged signal on the connection.
+       */
+      void on_property_changed( PropertyBase* property );
+
       void set_connection(DBusCxxPointer<Connection> conn);
 
       void set_path( const std::string& new_path );
@@ -356,6 +468,16 @@ FOR(0, eval(CALL_SIZE),[[DEFINE_CREATE_METHOD_SLOT(%1)
 FOR(0, eval(CALL_SIZE),[[DEFINE_CREATE_SIGNAL(%1)
 ]])
 
+      template <class T_type>
+      DBusCxxPointer<Property<T_type> >
+      Interface::create_property( const std::string& name, PropertyAccess access, PropertyUpdateType update )
+      {
+        DBusCxxPointer<Property<T_type> > property;
+        property = Property<T_type>::create(name, access, update);
+        if ( this->add_property(property) ) return property;
+        return DBusCxxPointer<Property<T_type> >();
+      }
+
 } /* namespace DBus */
 
 #endif /* DBUS_CXX_INTERFACE_H */
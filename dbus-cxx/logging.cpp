@@ -0,0 +1,353 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by agent                                           *
+ *   agent@local                                                           *
+ *                                                                         *
+ *   This file is part of the dbus-cxx library.                            *
+ *                                                                         *
+ *   The dbus-cxx library is free software; you can redistribute it and/or *
+ *   modify it under the terms of the GNU General Public License           *
+ *   version 3 as published by the Free Software Foundation.               *
+ *                                                                         *
+ *   The dbus-cxx library is distributed in the hope that it will be       *
+ *   useful, but WITHOUT ANY WARRANTY; without even the implied warranty   *
+ *   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU   *
+ *   General Public License for more details.                              *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this software. If not see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "utility.h"
+#include "dbus-cxx-private.h"
+
+std::atomic<simplelogger_log_function> dbuscxx_log_function( nullptr );
+
+std::atomic<int> dbuscxx_log_gate( SL_FATAL + 1 );
+
+namespace DBus
+{
+
+  namespace priv
+  {
+
+    /**
+     * A bounded multi-producer, single-consumer ring of log messages.
+     *
+     * Each slot carries a sequence number that tells producers whether it
+     * is free and the consumer whether it is filled, so neither side takes
+     * a lock. The consumer thread polls the ring and calls the logging
+     * function.
+     */
+    class AsyncLogSink
+    {
+      public:
+
+        AsyncLogSink( unsigned int capacity );
+
+        ~AsyncLogSink();
+
+        /** @return false if the ring is full */
+        bool push( const char* logger, const struct SL_LogLocation* location,
+                   enum SL_LogLevel level, const char* message );
+
+      protected:
+
+        struct Record
+        {
+          std::atomic<size_t> sequence;
+          char logger[64];
+          struct SL_LogLocation location;
+          enum SL_LogLevel level;
+          char message[512];
+        };
+
+        std::unique_ptr<Record[]> m_records;
+
+        size_t m_mask;
+
+        std::atomic<size_t> m_enqueue;
+
+        size_t m_dequeue;
+
+        std::atomic<bool> m_running;
+
+        std::thread m_thread;
+
+        /** Logs the oldest message, if any */
+        bool pop();
+
+        void run();
+    };
+
+  }
+
+  /** The function set with setLoggingFunction(); the asynchronous sink forwards to it */
+  static std::atomic<simplelogger_log_function> user_log_function( nullptr );
+
+  static enum SL_LogLevel log_level = SL_INFO;
+
+  static std::mutex log_mutex;
+
+  static std::atomic<int> log_threshold( SL_TRACE );
+
+  static std::map<std::string,int> logger_thresholds;
+
+  struct LoggerThreshold
+  {
+    std::string name;
+    int level;
+  };
+
+  typedef std::vector<LoggerThreshold> LoggerThresholds;
+
+  /**
+   * A read only copy of logger_thresholds for logEnabled(), replaced as a
+   * whole by the setters; null when no logger has a threshold.
+   */
+  static std::shared_ptr<const LoggerThresholds> published_thresholds;
+
+  static std::shared_ptr<priv::AsyncLogSink> async_sink;
+
+  static std::atomic<uint64_t> dropped_log_messages( 0 );
+
+  /** Recomputes the lowest level anybody wants; log_mutex must be held */
+  static void update_log_gate()
+  {
+    int gate = log_threshold;
+
+    for ( std::map<std::string,int>::iterator i = logger_thresholds.begin(); i != logger_thresholds.end(); i++ )
+      gate = std::min( gate, i->second );
+
+    // logStdErr drops everything up to its own level anyway
+    if ( user_log_function == logStdErr ) gate = std::max( gate, (int)log_level + 1 );
+
+    if ( user_log_function == nullptr ) gate = SL_FATAL + 1;
+
+    dbuscxx_log_gate = gate;
+  }
+
+  /** Publishes logger_thresholds to logEnabled(); log_mutex must be held */
+  static void publish_logger_thresholds()
+  {
+    std::shared_ptr<LoggerThresholds> table;
+
+    if ( not logger_thresholds.empty() ) {
+      table = std::make_shared<LoggerThresholds>();
+      for ( std::map<std::string,int>::iterator i = logger_thresholds.begin(); i != logger_thresholds.end(); i++ )
+        table->push_back( LoggerThreshold{ i->first, i->second } );
+    }
+
+    std::atomic_store( &published_thresholds, std::shared_ptr<const LoggerThresholds>( table ) );
+  }
+
+  static void async_log( const char* logger_name, const struct SL_LogLocation* location,
+      const enum SL_LogLevel level,
+      const char* log_string )
+  {
+    std::shared_ptr<priv::AsyncLogSink> sink = std::atomic_load( &async_sink );
+
+    if ( not sink or not sink->push( logger_name, location, level, log_string ) ) dropped_log_messages++;
+  }
+
+  void setLoggingFunction( simplelogger_log_function function ){
+    std::lock_guard<std::mutex> lock( log_mutex );
+    user_log_function = function;
+    if ( not async_sink ) dbuscxx_log_function = function;
+    update_log_gate();
+  }
+
+  void logStdErr( const char* logger_name, const struct SL_LogLocation* location,
+      const enum SL_LogLevel level,
+      const char* log_string ){
+    if( level <= log_level ) return;
+
+    char buffer[ 4096 ];
+    const char* stringLevel;
+    std::thread::id this_id = std::this_thread::get_id();
+
+    SL_LOGLEVEL_TO_STRING( stringLevel, level );
+
+    snprintf( buffer, 4096, "0x%08X %s [%s] - %s(%s:%d)", this_id, logger_name, stringLevel, log_string, 
+      location->file,
+      location->line_number );
+    std::cerr << buffer << std::endl;
+  }
+
+  void setLogLevel( const enum SL_LogLevel level ){
+    std::lock_guard<std::mutex> lock( log_mutex );
+    log_level = level;
+    update_log_gate();
+  }
+
+  void setLogThreshold( const enum SL_LogLevel level )
+  {
+    std::lock_guard<std::mutex> lock( log_mutex );
+    log_threshold = level;
+    update_log_gate();
+  }
+
+  void setLogThreshold( const std::string& logger, const enum SL_LogLevel level )
+  {
+    std::lock_guard<std::mutex> lock( log_mutex );
+    logger_thresholds[ logger ] = level;
+    publish_logger_thresholds();
+    update_log_gate();
+  }
+
+  void clearLogThresholds()
+  {
+    std::lock_guard<std::mutex> lock( log_mutex );
+    logger_thresholds.clear();
+    publish_logger_thresholds();
+    update_log_gate();
+  }
+
+  bool logEnabled( const char* logger, const enum SL_LogLevel level )
+  {
+    if ( level < dbuscxx_log_gate.load( std::memory_order_relaxed ) ) return false;
+
+    std::shared_ptr<const LoggerThresholds> table = std::atomic_load( &published_thresholds );
+    if ( not table ) return level >= log_threshold;
+
+    const char* name = logger ? logger : "";
+    size_t length = strlen( name );
+    const LoggerThreshold* found = NULL;
+
+    // The most specific logger with a threshold decides: the longest one
+    // that is the name itself or one of its dotted prefixes
+    for ( LoggerThresholds::const_iterator i = table->begin(); i != table->end(); i++ )
+    {
+      size_t size = i->name.size();
+      if ( size > length or i->name.compare( 0, size, name, size ) != 0 ) continue;
+      if ( size < length and name[size] != '.' ) continue;
+      if ( found == NULL or size > found->name.size() ) found = &(*i);
+    }
+
+    if ( found ) return level >= found->level;
+    return level >= log_threshold;
+  }
+
+  void setAsyncLogging( bool enabled, unsigned int capacity )
+  {
+    std::shared_ptr<priv::AsyncLogSink> stopped;
+
+    {
+      std::lock_guard<std::mutex> lock( log_mutex );
+
+      if ( enabled and not async_sink ) {
+        std::atomic_store( &async_sink, std::make_shared<priv::AsyncLogSink>( capacity ) );
+        dbuscxx_log_function = async_log;
+      }
+      else if ( not enabled and async_sink ) {
+        dbuscxx_log_function = user_log_function.load();
+        stopped = async_sink;
+        std::atomic_store( &async_sink, std::shared_ptr<priv::AsyncLogSink>() );
+      }
+    }
+
+    // The sink drains what is left once the last writer lets go of it
+    stopped.reset();
+  }
+
+  uint64_t droppedLogMessages()
+  {
+    return dropped_log_messages;
+  }
+
+  namespace priv
+  {
+
+    AsyncLogSink::AsyncLogSink( unsigned int capacity ):
+      m_enqueue( 0 ),
+      m_dequeue( 0 ),
+      m_running( true )
+    {
+      size_t size = 2;
+      while ( size < capacity ) size <<= 1;
+
+      m_records.reset( new Record[size] );
+      m_mask = size - 1;
+      for ( size_t i = 0; i < size; i++ ) m_records[i].sequence.store( i, std::memory_order_relaxed );
+
+      m_thread = std::thread( &AsyncLogSink::run, this );
+    }
+
+    AsyncLogSink::~AsyncLogSink()
+    {
+      m_running = false;
+      m_thread.join();
+    }
+
+    bool AsyncLogSink::push( const char* logger, const struct SL_LogLocation* location,
+                             enum SL_LogLevel level, const char* message )
+    {
+      size_t position = m_enqueue.load( std::memory_order_relaxed );
+      Record* record;
+
+      // Claim a free slot
+      while ( true )
+      {
+        record = &m_records[ position & m_mask ];
+        size_t sequence = record->sequence.load( std::memory_order_acquire );
+        intptr_t difference = (intptr_t)sequence - (intptr_t)position;
+
+        if ( difference == 0 ) {
+          if ( m_enqueue.compare_exchange_weak( position, position + 1, std::memory_order_relaxed ) ) break;
+        }
+        else if ( difference < 0 ) {
+          return false;
+        }
+        else {
+          position = m_enqueue.load( std::memory_order_relaxed );
+        }
+      }
+
+      // File and function names are literals and outlive the record
+      std::strncpy( record->logger, logger ? logger : "", sizeof(record->logger) - 1 );
+      record->logger[ sizeof(record->logger) - 1 ] = '\0';
+      record->location = *location;
+      record->level = level;
+      std::strncpy( record->message, message ? message : "", sizeof(record->message) - 1 );
+      record->message[ sizeof(record->message) - 1 ] = '\0';
+
+      record->sequence.store( position + 1, std::memory_order_release );
+      return true;
+    }
+
+    bool AsyncLogSink::pop()
+    {
+      Record* record = &m_records[ m_dequeue & m_mask ];
+
+      if ( record->sequence.load( std::memory_order_acquire ) != m_dequeue + 1 ) return false;
+
+      simplelogger_log_function function = user_log_function;
+      if ( function ) function( record->logger, &record->location, record->level, record->message );
+
+      record->sequence.store( m_dequeue + m_mask + 1, std::memory_order_release );
+      m_dequeue++;
+      return true;
+    }
+
+    void AsyncLogSink::run()
+    {
+      while ( m_running )
+      {
+        if ( not this->pop() ) std::this_thread::sleep_for( std::chrono::milliseconds( 2 ) );
+      }
+
+      while ( this->pop() ) { }
+    }
+
+  }
+
+}
@@ -0,0 +1,537 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by agent                                           *
+ *   agent@local                                                           *
+ *                                                                         *
+ *   This file is part of the dbus-cxx library.                            *
+ *                                                                         *
+ *   The dbus-cxx library is free software; you can redistribute it and/or *
+ *   modify it under the terms of the GNU General Public License           *
+ *   version 3 as published by the Free Software Foundation.               *
+ *                                                                         *
+ *   The dbus-cxx library is distributed in the hope that it will be       *
+ *   useful, but WITHOUT ANY WARRANTY; without even the implied warranty   *
+ *   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU   *
+ *   General Public License for more details.                              *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this software. If not see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#include "loopbackbus.h"
+#include "returnmessage.h"
+#include "errormessage.h"
+#include "signalmessage.h"
+#include "dbus-cxx-private.h"
+
+#include <atomic>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <unistd.h>
+
+namespace DBus
+{
+
+  LoopbackBus::LoopbackBus( Dispatcher::pointer dispatcher ):
+      m_dispatcher( dispatcher ),
+      m_next_id( 1 )
+  {
+    static std::atomic<unsigned int> instance( 0 );
+    std::ostringstream address;
+
+    address << "unix:abstract=dbus-cxx-loopback-" << getpid() << "-" << instance++;
+
+    m_server = Server::create( address.str() );
+    m_address = m_server->address();
+
+    // The GUID of the listening socket is as unique as a bus id needs to be
+    m_id = m_server->id();
+
+    // The dispatcher adopts each new connection before the bus filters it
+    if ( not m_dispatcher->add_server( m_server ) ) throw ErrorFailed::create( "LoopbackBus: unable to add the server to the dispatcher" );
+
+    m_new_connection = m_server->signal_new_connection().connect( sigc::mem_fun( *this, &LoopbackBus::on_new_connection ) );
+  }
+
+  LoopbackBus::pointer LoopbackBus::create( Dispatcher::pointer dispatcher )
+  {
+    if ( not dispatcher ) throw ErrorInvalidArgs::create( "LoopbackBus: a dispatcher is required" );
+    return pointer( new LoopbackBus( dispatcher ) );
+  }
+
+  LoopbackBus::~LoopbackBus()
+  {
+    std::lock_guard<std::mutex> lock( m_mutex );
+
+    m_new_connection.disconnect();
+    m_server->disconnect();
+
+    for ( Peers::iterator i = m_peers.begin(); i != m_peers.end(); i++ )
+    {
+      i->second.filter.disconnect();
+      dbus_connection_close( i->first );
+    }
+  }
+
+  const std::string& LoopbackBus::address() const
+  {
+    return m_address;
+  }
+
+  Connection::pointer LoopbackBus::create_connection()
+  {
+    Error::pointer error = Error::create();
+    DBusConnection* cobj;
+
+    cobj = dbus_connection_open_private( m_address.c_str(), error->cobj() );
+    if ( error->is_set() ) throw error;
+    if ( cobj == NULL ) throw ErrorFailed::create();
+
+    // Hello is answered from the dispatcher's thread
+    if ( not dbus_bus_register( cobj, error->cobj() ) ) {
+      dbus_connection_close( cobj );
+      dbus_connection_unref( cobj );
+      throw error;
+    }
+
+    Connection::pointer connection = Connection::create( cobj, true );
+    dbus_connection_unref( cobj );
+
+    m_dispatcher->add_connection( connection );
+    return connection;
+  }
+
+  std::vector<std::string> LoopbackBus::names() const
+  {
+    std::lock_guard<std::mutex> lock( m_mutex );
+    std::vector<std::string> result;
+
+    result.push_back( DBUS_SERVICE_DBUS );
+    for ( std::map<std::string,DBusConnection*>::const_iterator i = m_unique_names.begin(); i != m_unique_names.end(); i++ )
+      result.push_back( i->first );
+    for ( std::map<std::string,std::string>::const_iterator i = m_owners.begin(); i != m_owners.end(); i++ )
+      result.push_back( i->first );
+
+    return result;
+  }
+
+  void LoopbackBus::on_new_connection( Connection::pointer connection )
+  {
+    std::lock_guard<std::mutex> lock( m_mutex );
+
+    Peer& peer = m_peers[ connection->cobj() ];
+    peer.connection = connection;
+    peer.filter = connection->signal_filter().connect( sigc::mem_fun( *this, &LoopbackBus::on_message ) );
+  }
+
+  FilterResult LoopbackBus::on_message( Connection::pointer connection, Message::pointer message )
+  {
+    std::lock_guard<std::mutex> lock( m_mutex );
+    Peers::iterator i = m_peers.find( connection->cobj() );
+
+    if ( i == m_peers.end() ) return FILTER;
+
+    if ( dbus_message_is_signal( message->cobj(), DBUS_INTERFACE_LOCAL, "Disconnected" ) ) {
+      SIMPLELOGGER_DEBUG( "dbus.LoopbackBus", "Peer " << i->second.unique_name << " disconnected" );
+      this->remove_peer( i );
+      return FILTER;
+    }
+
+    const char* destination = message->destination();
+
+    if ( destination and strcmp( destination, DBUS_SERVICE_DBUS ) == 0 )
+      this->handle_bus_call( i->second, message );
+    else if ( i->second.unique_name.empty() )
+      connection->send( ErrorMessage::create( message, DBUS_ERROR_ACCESS_DENIED, "Hello must be the first message on the bus" ) );
+    else
+      this->route( i->second, message );
+
+    // Nothing on the bus side of a connection is dispatched to objects
+    return FILTER;
+  }
+
+  void LoopbackBus::handle_bus_call( Peer& peer, Message::pointer message )
+  {
+    DBusMessage* cmessage = message->cobj();
+    ReturnMessage::pointer reply;
+    std::string name;
+
+    if ( message->type() != CALL_MESSAGE ) return;
+
+    try {
+      if ( dbus_message_is_method_call( cmessage, DBUS_INTERFACE_DBUS, "Hello" ) )
+      {
+        if ( not peer.unique_name.empty() ) {
+          peer.connection->send( ErrorMessage::create( message, DBUS_ERROR_FAILED, "Already handled an Hello message" ) );
+          return;
+        }
+        std::ostringstream unique_name;
+        unique_name << ":1." << m_next_id++;
+        peer.unique_name = unique_name.str();
+        m_unique_names[ peer.unique_name ] = peer.connection->cobj();
+
+        reply = message->create_reply();
+        *reply << peer.unique_name;
+        reply->set_sender( DBUS_SERVICE_DBUS );
+        peer.connection->send( reply );
+        this->send_bus_signal( peer, "NameAcquired", peer.unique_name );
+        return;
+      }
+
+      if ( peer.unique_name.empty() ) {
+        peer.connection->send( ErrorMessage::create( message, DBUS_ERROR_ACCESS_DENIED, "Hello must be the first message on the bus" ) );
+        return;
+      }
+
+      reply = message->create_reply();
+      reply->set_sender( DBUS_SERVICE_DBUS );
+
+      if ( dbus_message_is_method_call( cmessage, DBUS_INTERFACE_DBUS, "RequestName" ) )
+      {
+        uint32_t flags;
+        message->begin() >> name >> flags;
+
+        if ( name.empty() or name[0] == ':' or name == DBUS_SERVICE_DBUS ) {
+          peer.connection->send( ErrorMessage::create( message, DBUS_ERROR_INVALID_ARGS, "Cannot acquire the name '" + name + "'" ) );
+          return;
+        }
+
+        std::map<std::string,std::string>::iterator owner = m_owners.find( name );
+        if ( owner == m_owners.end() ) {
+          m_owners[ name ] = peer.unique_name;
+          *reply << (uint32_t)DBUS_REQUEST_NAME_REPLY_PRIMARY_OWNER;
+          peer.connection->send( reply );
+          this->send_bus_signal( peer, "NameAcquired", name );
+        }
+        else {
+          *reply << (uint32_t)( owner->second == peer.unique_name ? DBUS_REQUEST_NAME_REPLY_ALREADY_OWNER : DBUS_REQUEST_NAME_REPLY_EXISTS );
+          peer.connection->send( reply );
+        }
+      }
+      else if ( dbus_message_is_method_call( cmessage, DBUS_INTERFACE_DBUS, "ReleaseName" ) )
+      {
+        message->begin() >> name;
+
+        std::map<std::string,std::string>::iterator owner = m_owners.find( name );
+        if ( owner == m_owners.end() ) {
+          *reply << (uint32_t)DBUS_RELEASE_NAME_REPLY_NON_EXISTENT;
+        }
+        else if ( owner->second != peer.unique_name ) {
+          *reply << (uint32_t)DBUS_RELEASE_NAME_REPLY_NOT_OWNER;
+        }
+        else {
+          m_owners.erase( owner );
+          *reply << (uint32_t)DBUS_RELEASE_NAME_REPLY_RELEASED;
+        }
+        peer.connection->send( reply );
+      }
+      else if ( dbus_message_is_method_call( cmessage, DBUS_INTERFACE_DBUS, "AddMatch" ) )
+      {
+        message->begin() >> name;
+        MatchRule rule = parse_match_rule( name );
+        if ( not is_supported( rule ) ) {
+          peer.connection->send( ErrorMessage::create( message, DBUS_ERROR_MATCH_RULE_INVALID, "The loopback bus can't evaluate the given match rule" ) );
+          return;
+        }
+        peer.rules.push_back( rule );
+        peer.connection->send( reply );
+      }
+      else if ( dbus_message_is_method_call( cmessage, DBUS_INTERFACE_DBUS, "RemoveMatch" ) )
+      {
+        message->begin() >> name;
+        MatchRule rule = parse_match_rule( name );
+        for ( std::vector<MatchRule>::iterator i = peer.rules.begin(); i != peer.rules.end(); i++ )
+        {
+          if ( *i == rule ) {
+            peer.rules.erase( i );
+            peer.connection->send( reply );
+            return;
+          }
+        }
+        peer.connection->send( ErrorMessage::create( message, DBUS_ERROR_MATCH_RULE_NOT_FOUND, "The given match rule wasn't found" ) );
+      }
+      else if ( dbus_message_is_method_call( cmessage, DBUS_INTERFACE_DBUS, "GetNameOwner" ) )
+      {
+        message->begin() >> name;
+        Peer* owner = this->find_peer( name );
+        if ( name == DBUS_SERVICE_DBUS ) {
+          *reply << name;
+        }
+        else if ( owner == NULL ) {
+          peer.connection->send( ErrorMessage::create( message, DBUS_ERROR_NAME_HAS_NO_OWNER, "The name '" + name + "' has no owner" ) );
+          return;
+        }
+        else {
+          *reply << owner->unique_name;
+        }
+        peer.connection->send( reply );
+      }
+      else if ( dbus_message_is_method_call( cmessage, DBUS_INTERFACE_DBUS, "NameHasOwner" ) )
+      {
+        message->begin() >> name;
+        *reply << (bool)( name == DBUS_SERVICE_DBUS or this->find_peer( name ) != NULL );
+        peer.connection->send( reply );
+      }
+      else if ( dbus_message_is_method_call( cmessage, DBUS_INTERFACE_DBUS, "ListNames" ) )
+      {
+        std::vector<std::string> result;
+        result.push_back( DBUS_SERVICE_DBUS );
+        for ( std::map<std::string,DBusConnection*>::iterator i = m_unique_names.begin(); i != m_unique_names.end(); i++ )
+          result.push_back( i->first );
+        for ( std::map<std::string,std::string>::iterator i = m_owners.begin(); i != m_owners.end(); i++ )
+          result.push_back( i->first );
+        *reply << result;
+        peer.connection->send( reply );
+      }
+      else if ( dbus_message_is_method_call( cmessage, DBUS_INTERFACE_DBUS, "GetId" ) )
+      {
+        *reply << m_id;
+        peer.connection->send( reply );
+      }
+      else if ( dbus_message_has_interface( cmessage, DBUS_INTERFACE_PEER ) and dbus_message_has_member( cmessage, "Ping" ) )
+      {
+        peer.connection->send( reply );
+      }
+      else
+      {
+        const char* member = dbus_message_get_member( cmessage );
+        peer.connection->send( ErrorMessage::create( message, DBUS_ERROR_UNKNOWN_METHOD,
+                                                     std::string( "The loopback bus does not implement " ) + ( member ? member : "" ) ) );
+      }
+    }
+    catch ( ErrorInvalidTypecast::pointer e ) {
+      peer.connection->send( ErrorMessage::create( message, DBUS_ERROR_INVALID_ARGS, "Invalid arguments" ) );
+    }
+  }
+
+  void LoopbackBus::route( Peer& peer, Message::pointer message )
+  {
+    const char* destination = message->destination();
+    DBusMessage* copy;
+    Message::pointer forward;
+
+    // Forward a copy that carries the sender, keeping the serial replies refer to
+    copy = dbus_message_copy( message->cobj() );
+    if ( copy == NULL ) return;
+    dbus_message_set_serial( copy, dbus_message_get_serial( message->cobj() ) );
+    dbus_message_set_sender( copy, peer.unique_name.c_str() );
+    forward = Message::create( copy );
+    dbus_message_unref( copy );
+
+    if ( destination )
+    {
+      Peer* target = this->find_peer( destination );
+
+      if ( target ) {
+        target->connection->send( forward );
+      }
+      else if ( message->type() == CALL_MESSAGE and not dbus_message_get_no_reply( message->cobj() ) ) {
+        peer.connection->send( ErrorMessage::create( message, DBUS_ERROR_SERVICE_UNKNOWN,
+                                                     std::string( "The name " ) + destination + " was not provided by any .service files" ) );
+      }
+      return;
+    }
+
+    for ( Peers::iterator i = m_peers.begin(); i != m_peers.end(); i++ )
+    {
+      if ( i->second.unique_name.empty() ) continue;
+
+      for ( size_t r = 0; r < i->second.rules.size(); r++ )
+      {
+        if ( this->matches( i->second.rules[r], peer, message ) ) {
+          i->second.connection->send( forward );
+          break;
+        }
+      }
+    }
+  }
+
+  void LoopbackBus::remove_peer( Peers::iterator peer )
+  {
+    std::map<std::string,std::string>::iterator i;
+
+    peer->second.filter.disconnect();
+    m_unique_names.erase( peer->second.unique_name );
+
+    for ( i = m_owners.begin(); i != m_owners.end(); )
+    {
+      if ( i->second == peer->second.unique_name ) m_owners.erase( i++ );
+      else i++;
+    }
+
+    m_peers.erase( peer );
+  }
+
+  LoopbackBus::Peer* LoopbackBus::find_peer( const std::string& name )
+  {
+    std::string unique_name = name;
+
+    if ( name.empty() ) return NULL;
+
+    if ( name[0] != ':' ) {
+      std::map<std::string,std::string>::iterator owner = m_owners.find( name );
+      if ( owner == m_owners.end() ) return NULL;
+      unique_name = owner->second;
+    }
+
+    std::map<std::string,DBusConnection*>::iterator i = m_unique_names.find( unique_name );
+    if ( i == m_unique_names.end() ) return NULL;
+
+    Peers::iterator peer = m_peers.find( i->second );
+    if ( peer == m_peers.end() ) return NULL;
+    return &peer->second;
+  }
+
+  void LoopbackBus::send_bus_signal( Peer& peer, const std::string& member, const std::string& name )
+  {
+    SignalMessage::pointer signal = SignalMessage::create( DBUS_PATH_DBUS, DBUS_INTERFACE_DBUS, member );
+    signal->set_sender( DBUS_SERVICE_DBUS );
+    signal->set_destination( peer.unique_name );
+    *signal << name;
+    peer.connection->send( signal );
+  }
+
+  LoopbackBus::MatchRule LoopbackBus::parse_match_rule( const std::string& rule )
+  {
+    MatchRule result;
+    size_t position = 0;
+
+    while ( position < rule.size() )
+    {
+      size_t equals = rule.find( '=', position );
+      if ( equals == std::string::npos ) break;
+
+      std::string key = rule.substr( position, equals - position );
+      std::string value;
+
+      position = equals + 1;
+      if ( position < rule.size() and rule[position] == '\'' ) {
+        size_t end = rule.find( '\'', position + 1 );
+        if ( end == std::string::npos ) end = rule.size();
+        value = rule.substr( position + 1, end - position - 1 );
+        position = end + 1;
+      }
+      else {
+        size_t end = rule.find( ',', position );
+        if ( end == std::string::npos ) end = rule.size();
+        value = rule.substr( position, end - position );
+        position = end;
+      }
+
+      result[ key ] = value;
+
+      // Skip the separator
+      if ( position < rule.size() and rule[position] == ',' ) position++;
+    }
+
+    return result;
+  }
+
+  bool LoopbackBus::parse_arg_key( const std::string& key, unsigned int& index, std::string& suffix )
+  {
+    size_t digits = 3;
+
+    if ( key.compare( 0, 3, "arg" ) != 0 ) return false;
+    while ( digits < key.size() and isdigit( key[digits] ) ) digits++;
+    if ( digits == 3 or digits > 5 ) return false;
+
+    index = atoi( key.c_str() + 3 );
+    suffix = key.substr( digits );
+
+    if ( index > DBUS_MAXIMUM_MATCH_RULE_ARG_NUMBER ) return false;
+    if ( suffix.empty() or suffix == "path" ) return true;
+    return suffix == "namespace" and index == 0;
+  }
+
+  bool LoopbackBus::is_supported( const MatchRule& rule )
+  {
+    static const char* keys[] = { "type", "sender", "interface", "member", "path",
+                                  "path_namespace", "destination", "eavesdrop", NULL };
+    unsigned int index;
+    std::string suffix;
+
+    for ( MatchRule::const_iterator i = rule.begin(); i != rule.end(); i++ )
+    {
+      bool known = parse_arg_key( i->first, index, suffix );
+      for ( const char** key = keys; *key != NULL and not known; key++ )
+        known = ( i->first == *key );
+      if ( not known ) return false;
+    }
+
+    return true;
+  }
+
+  bool LoopbackBus::arg_matches( Message::pointer message, unsigned int index, const std::string& suffix, const std::string& value )
+  {
+    MessageIterator iter = message->begin();
+    std::string arg;
+
+    for ( unsigned int i = 0; i < index and iter.is_valid(); i++ ) iter.next();
+    if ( not iter.is_valid() ) return false;
+
+    // Only argNpath also looks at object paths
+    if ( iter.arg_type() == TYPE_STRING or ( suffix == "path" and iter.arg_type() == TYPE_OBJECT_PATH ) )
+      arg = iter.get_string();
+    else
+      return false;
+
+    if ( suffix == "path" )
+    {
+      if ( arg == value ) return true;
+      if ( not value.empty() and value[value.size()-1] == '/' and arg.compare( 0, value.size(), value ) == 0 ) return true;
+      return not arg.empty() and arg[arg.size()-1] == '/' and value.compare( 0, arg.size(), arg ) == 0;
+    }
+
+    if ( suffix == "namespace" )
+      return arg == value or arg.compare( 0, value.size() + 1, value + "." ) == 0;
+
+    return arg == value;
+  }
+
+  bool LoopbackBus::matches( const MatchRule& rule, const Peer& sender, Message::pointer message ) const
+  {
+    DBusMessage* cmessage = message->cobj();
+    unsigned int index;
+    std::string suffix;
+
+    for ( MatchRule::const_iterator i = rule.begin(); i != rule.end(); i++ )
+    {
+      const std::string& key = i->first;
+      const std::string& value = i->second;
+
+      if ( key == "type" ) {
+        if ( dbus_message_type_from_string( value.c_str() ) != dbus_message_get_type( cmessage ) ) return false;
+      }
+      else if ( key == "sender" ) {
+        if ( value != sender.unique_name ) {
+          std::map<std::string,std::string>::const_iterator owner = m_owners.find( value );
+          if ( owner == m_owners.end() or owner->second != sender.unique_name ) return false;
+        }
+      }
+      else if ( key == "interface" ) {
+        if ( not dbus_message_has_interface( cmessage, value.c_str() ) ) return false;
+      }
+      else if ( key == "member" ) {
+        if ( not dbus_message_has_member( cmessage, value.c_str() ) ) return false;
+      }
+      else if ( key == "path" ) {
+        if ( not dbus_message_has_path( cmessage, value.c_str() ) ) return false;
+      }
+      else if ( key == "path_namespace" ) {
+        const char* path = dbus_message_get_path( cmessage );
+        if ( path == NULL ) return false;
+        std::string p( path );
+        if ( value != "/" and p != value and p.compare( 0, value.size() + 1, value + "/" ) != 0 ) return false;
+      }
+      else if ( key == "destination" ) {
+        if ( not dbus_message_has_destination( cmessage, value.c_str() ) ) return false;
+      }
+      else if ( parse_arg_key( key, index, suffix ) ) {
+        if ( not arg_matches( message, index, suffix, value ) ) return false;
+      }
+    }
+
+    return true;
+  }
+
+}
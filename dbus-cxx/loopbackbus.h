@@ -0,0 +1,168 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by agent                                           *
+ *   agent@local                                                           *
+ *                                                                         *
+ *   This file is part of the dbus-cxx library.                            *
+ *                                                                         *
+ *   The dbus-cxx library is free software; you can redistribute it and/or *
+ *   modify it under the terms of the GNU General Public License           *
+ *   version 3 as published by the Free Software Foundation.               *
+ *                                                                         *
+ *   The dbus-cxx library is distributed in the hope that it will be       *
+ *   useful, but WITHOUT ANY WARRANTY; without even the implied warranty   *
+ *   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU   *
+ *   General Public License for more details.                              *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this software. If not see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <dbus-cxx/connection.h>
+#include <dbus-cxx/dispatcher.h>
+#include <dbus-cxx/server.h>
+
+#ifndef DBUSCXX_LOOPBACKBUS_H
+#define DBUSCXX_LOOPBACKBUS_H
+
+namespace DBus
+{
+
+  /**
+   * A message bus that runs inside the process, for tests and benchmarks
+   * that must not depend on a dbus-daemon.
+   *
+   * The bus listens on a private abstract unix socket through a Server.
+   * Connections from create_connection() are ordinary dbus-cxx connections
+   * on a Dispatcher, so objects, proxies, signals and the dispatcher itself
+   * behave as they do on a real bus.
+   *
+   * The bus implements the part of org.freedesktop.DBus that dbus-cxx uses:
+   * Hello, RequestName, ReleaseName, GetNameOwner, NameHasOwner, ListNames,
+   * GetId, AddMatch and RemoveMatch. Messages with a destination go to its
+   * owner and signals without one go to every connection with a matching
+   * rule. Match rules understand type, sender, interface, member, path,
+   * path_namespace, destination, argN, argNpath and arg0namespace; eavesdrop
+   * is accepted and ignored, and AddMatch refuses rules with any other key
+   * with DBUS_ERROR_MATCH_RULE_INVALID. Names are never
+   * queued: RequestName for a name that has an owner returns
+   * DBUS_REQUEST_NAME_REPLY_EXISTS. Activation, policies and
+   * NameOwnerChanged are not implemented.
+   *
+   * @ingroup core
+   *
+   * @author agent <agent@local>
+   */
+  class LoopbackBus
+  {
+    protected:
+
+      LoopbackBus( Dispatcher::pointer dispatcher );
+
+    public:
+
+      typedef DBusCxxPointer<LoopbackBus> pointer;
+
+      /**
+       * Starts a bus whose connections are serviced by the dispatcher
+       * @throw Error if the bus cannot listen
+       */
+      static pointer create( Dispatcher::pointer dispatcher );
+
+      virtual ~LoopbackBus();
+
+      const std::string& address() const;
+
+      /**
+       * Opens a connection to the bus, says Hello and adds it to the dispatcher.
+       *
+       * Blocks until the bus has answered, so it must not be called from the
+       * dispatcher's thread.
+       *
+       * @throw Error if the connection cannot be opened
+       */
+      Connection::pointer create_connection();
+
+      /** The unique and well-known names on the bus */
+      std::vector<std::string> names() const;
+
+    protected:
+
+      typedef std::map<std::string,std::string> MatchRule;
+
+      /** The bus side of one client connection */
+      struct Peer
+      {
+        std::string unique_name;
+        Connection::pointer connection;
+        std::vector<MatchRule> rules;
+        sigc::connection filter;
+      };
+
+      typedef std::map<DBusConnection*,Peer> Peers;
+
+      Dispatcher::pointer m_dispatcher;
+
+      Server::pointer m_server;
+
+      std::string m_address;
+
+      std::string m_id;
+
+      unsigned int m_next_id;
+
+      Peers m_peers;
+
+      /** Unique name to the bus side connection */
+      std::map<std::string,DBusConnection*> m_unique_names;
+
+      /** Well-known name to the unique name of its owner */
+      std::map<std::string,std::string> m_owners;
+
+      sigc::connection m_new_connection;
+
+      mutable std::mutex m_mutex;
+
+      void on_new_connection( Connection::pointer connection );
+
+      FilterResult on_message( Connection::pointer connection, Message::pointer message );
+
+      /** Answers a call to org.freedesktop.DBus; m_mutex must be held */
+      void handle_bus_call( Peer& peer, Message::pointer message );
+
+      /** Forwards a message from the peer to its destination or subscribers; m_mutex must be held */
+      void route( Peer& peer, Message::pointer message );
+
+      /** Drops the peer and its names; m_mutex must be held */
+      void remove_peer( Peers::iterator peer );
+
+      /** The bus side connection for a unique or well-known name, or NULL */
+      Peer* find_peer( const std::string& name );
+
+      /** Sends a signal from the bus to one peer */
+      void send_bus_signal( Peer& peer, const std::string& member, const std::string& name );
+
+      static MatchRule parse_match_rule( const std::string& rule );
+
+      /**
+       * Splits an argN, argNpath or arg0namespace key into N and the suffix
+       * @return \c false if key is not one of them
+       */
+      static bool parse_arg_key( const std::string& key, unsigned int& index, std::string& suffix );
+
+      /** False if the rule has a key matches() can't evaluate */
+      static bool is_supported( const MatchRule& rule );
+
+      /** Checks the argument at index against an argN, argNpath or arg0namespace value */
+      static bool arg_matches( Message::pointer message, unsigned int index, const std::string& suffix, const std::string& value );
+
+      bool matches( const MatchRule& rule, const Peer& sender, Message::pointer message ) const;
+
+  };
+
+}
+
+#endif
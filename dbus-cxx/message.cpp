@@ -17,7 +17,10 @@
  *   along with this software. If not see <http://www.gnu.org/licenses/>.  *
  ***************************************************************************/
 #include "message.h"
+#include "callmessage.h"
+#include "errormessage.h"
 #include "returnmessage.h"
+#include "signalmessage.h"
 #include <dbus/dbus.h>
 
 #include <cstring>
@@ -26,6 +29,8 @@
 namespace DBus
 {
 
+  dbus_int32_t Message::m_wrapper_slot = -1;
+
   Message::Message( MessageType type ): m_valid(false)
   {
     m_cobj = dbus_message_new( type );
@@ -95,7 +100,35 @@ namespace DBus
 
   Message::pointer Message::create(DBusMessage * cobj, CreateMethod m)
   {
-    return pointer(new Message(cobj, m) );
+    if ( cobj == NULL or m != CREATE_ALIAS ) return pointer(new Message(cobj, m) );
+
+    pointer wrapper = cached( cobj );
+    if ( wrapper ) return wrapper;
+
+    switch ( dbus_message_get_type( cobj ) )
+    {
+      case DBUS_MESSAGE_TYPE_METHOD_CALL:   wrapper = CallMessage::create( cobj ); break;
+      case DBUS_MESSAGE_TYPE_METHOD_RETURN: wrapper = ReturnMessage::create( cobj ); break;
+      case DBUS_MESSAGE_TYPE_ERROR:         wrapper = ErrorMessage::create( cobj ); break;
+      case DBUS_MESSAGE_TYPE_SIGNAL:        wrapper = SignalMessage::create( cobj ); break;
+      default:                              wrapper = pointer(new Message(cobj, m) ); break;
+    }
+
+    return wrapper;
+  }
+
+  Message::pointer Message::create_cached( DBusMessage* cobj )
+  {
+    pointer wrapper = cached( cobj );
+    if ( wrapper or cobj == NULL ) return wrapper;
+
+    wrapper = create( cobj );
+
+    // libdbus frees the weak pointer along with the message
+    if ( m_wrapper_slot != -1 )
+      dbus_message_set_data( cobj, m_wrapper_slot, new weak_pointer( wrapper ), wp_deleter );
+
+    return wrapper;
   }
 
   Message::pointer Message::create(Message::pointer other, CreateMethod m)
@@ -108,6 +141,15 @@ namespace DBus
     return pointer(new Message(other, m) );
   }
 
+  Message::pointer Message::cached( DBusMessage* cobj )
+  {
+    if ( cobj == NULL or m_wrapper_slot == -1 ) return pointer();
+
+    weak_pointer* wp = static_cast<weak_pointer*>( dbus_message_get_data( cobj, m_wrapper_slot ) );
+    if ( wp == NULL ) return pointer();
+    return wp->lock();
+  }
+
   ReturnMessage::pointer Message::create_reply() const
   {
     if ( not this->is_valid() ) return ReturnMessage::pointer();
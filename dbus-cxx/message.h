@@ -81,6 +81,17 @@ namespace DBus
 
       static pointer create( MessageType type );
 
+      /**
+       * Aliasing a message that is being dispatched returns the wrapper the
+       * connection made for it, if that is still alive. A new wrapper is of the class matching the message
+       * type, so that CallMessage::create() and the other casts return it
+       * as is instead of wrapping the message again.
+       *
+       * The result may therefore be a CallMessage, ReturnMessage,
+       * ErrorMessage or SignalMessage shared with the handlers of the
+       * same DBusMessage, not a fresh Message. Use CREATE_COPY for a
+       * wrapper of one's own.
+       */
       static pointer create( DBusMessage* cobj=NULL, CreateMethod m = CREATE_ALIAS );
 
       static pointer create( Message::pointer other, CreateMethod m = CREATE_ALIAS );
@@ -157,10 +168,28 @@ namespace DBus
 
       friend void init(bool);
 
+      friend class Connection;
+
+      /**
+       * Wraps an incoming message and remembers the wrapper in the message,
+       * so the handlers it is dispatched to share it.
+       *
+       * libdbus does not lock a message's data slots. Only the connection's
+       * filter calls this, before the message is handed to anything else,
+       * so cached() can read the slot without a lock.
+       */
+      static pointer create_cached( DBusMessage* cobj );
+
+      /** The wrapper of cobj made by create_cached(), if it is still alive */
+      static pointer cached( DBusMessage* cobj );
+
       DBusMessage* m_cobj;
 
       bool m_valid;
 
+      /** The libdbus data slot holding a weak pointer to a message's wrapper */
+      static dbus_int32_t m_wrapper_slot;
+
   };
 
 }
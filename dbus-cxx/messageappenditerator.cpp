@@ -83,9 +83,11 @@ namespace DBus
 
   bool MessageAppendIterator::protected_append( const FileDescriptor::pointer& fd ){
     bool result;
-    int raw_fd = fd->getDescriptor();
+    int raw_fd;
 
-    if ( not this->is_valid() ) return false;
+    if ( not this->is_valid() or not fd ) return false;
+
+    raw_fd = fd->getDescriptor();
 
     result = dbus_message_iter_append_basic( &m_cobj, DBus::type( *fd ), &raw_fd );
 
@@ -95,20 +97,20 @@ namespace DBus
   }
 
   MessageAppendIterator::MessageAppendIterator():
-      m_message( NULL ), m_subiter( NULL )
+      m_message( NULL ), m_subiter( NULL ), m_subiter_arena( NULL )
   {
     memset( &m_cobj, 0x00, sizeof( DBusMessageIter ) );
   }
 
   MessageAppendIterator::MessageAppendIterator( Message& message ):
-      m_message( NULL ), m_subiter( NULL )
+      m_message( NULL ), m_subiter( NULL ), m_subiter_arena( NULL )
   {
     memset( &m_cobj, 0x00, sizeof( DBusMessageIter ) );
     this->init( message );
   }
 
   MessageAppendIterator::MessageAppendIterator( Message::pointer message ):
-      m_message( NULL ), m_subiter( NULL )
+      m_message( NULL ), m_subiter( NULL ), m_subiter_arena( NULL )
   {
     memset( &m_cobj, 0x00, sizeof( DBusMessageIter ) );
     if ( message ) this->init( *message );
@@ -129,14 +131,12 @@ namespace DBus
     if ( message ) {
       dbus_message_iter_init_append( message.cobj(), &m_cobj );
       m_message = &message;
-      if ( m_subiter ) free( m_subiter );
-      m_subiter = NULL;
+      this->release_subiter();
       return true;
     }
 
     m_message = NULL;
-    if ( m_subiter ) free( m_subiter );
-    m_subiter = NULL;
+    this->release_subiter();
     return false;
   }
 
@@ -213,6 +213,11 @@ namespace DBus
     return this->protected_append( v );
   }
 
+  bool MessageAppendIterator::append( const ArenaString& v )
+  {
+    return this->protected_append( v.c_str() );
+  }
+
   bool MessageAppendIterator::append( const Signature& v )
   {
     return this->protected_append( v );
@@ -243,6 +248,90 @@ namespace DBus
     return this->protected_append( fd );
   }
 
+  bool MessageAppendIterator::append( const std::vector<FileDescriptor::pointer>& fds )
+  {
+    DBusMessageIter* array;
+    int raw_fd;
+    size_t i;
+
+    if ( not this->is_valid() ) return false;
+    if ( not this->open_container( CONTAINER_ARRAY, DBUS_TYPE_UNIX_FD_AS_STRING ) ) return false;
+
+    array = m_subiter->cobj();
+    for ( i = 0; i < fds.size(); i++ )
+    {
+      raw_fd = fds[i] ? fds[i]->getDescriptor() : -1;
+      if ( not dbus_message_iter_append_basic( array, DBUS_TYPE_UNIX_FD, &raw_fd ) )
+      {
+        m_message->invalidate();
+        break;
+      }
+    }
+
+    return this->close_container() and i == fds.size();
+  }
+
+  bool MessageAppendIterator::append( const SharedBuffer::pointer& buffer )
+  {
+    const uint8_t* bytes;
+    size_t length;
+
+    if ( not this->is_valid() or not buffer ) return false;
+
+    // Inline bytes go in a D-Bus array, which has a hard limit
+    length = buffer->size();
+    if ( not buffer->is_shared() and length > DBUS_MAXIMUM_ARRAY_LENGTH ) return false;
+
+    if ( not buffer->seal() ) return false;
+
+    if ( buffer->is_shared() )
+    {
+      if ( not this->open_container( CONTAINER_VARIANT, "(htt)" ) ) return false;
+      m_subiter->open_container( CONTAINER_STRUCT, std::string() );
+      // libdbus duplicates the descriptor; the buffer keeps its own
+      int raw_fd = buffer->unix_fd();
+      dbus_message_iter_append_basic( m_subiter->sub_iterator()->cobj(), DBUS_TYPE_UNIX_FD, &raw_fd );
+      m_subiter->sub_iterator()->append( (uint64_t)buffer->offset() );
+      m_subiter->sub_iterator()->append( (uint64_t)buffer->size() );
+      m_subiter->close_container();
+      return this->close_container();
+    }
+
+    if ( not this->open_container( CONTAINER_VARIANT, "ay" ) ) return false;
+    m_subiter->open_container( CONTAINER_ARRAY, DBUS_TYPE_BYTE_AS_STRING );
+
+    // One copy of the whole block rather than an append per byte
+    bytes = buffer->data();
+    if ( not dbus_message_iter_append_fixed_array( m_subiter->sub_iterator()->cobj(), DBUS_TYPE_BYTE, &bytes, (int)length ) )
+      m_message->invalidate();
+
+    m_subiter->close_container();
+    return this->close_container();
+  }
+
+  bool MessageAppendIterator::append( const CompressedBuffer::pointer& buffer )
+  {
+    std::vector<uint8_t> payload;
+    std::string codec;
+    const uint8_t* bytes;
+
+    if ( not this->is_valid() or not buffer ) return false;
+
+    codec = buffer->encode( payload );
+    if ( payload.size() > DBUS_MAXIMUM_ARRAY_LENGTH ) return false;
+
+    if ( not this->open_container( CONTAINER_STRUCT, std::string() ) ) return false;
+    m_subiter->append( codec );
+    m_subiter->open_container( CONTAINER_ARRAY, DBUS_TYPE_BYTE_AS_STRING );
+
+    bytes = payload.data();
+    if ( not dbus_message_iter_append_fixed_array( m_subiter->sub_iterator()->cobj(), DBUS_TYPE_BYTE, &bytes, (int)payload.size() ) )
+      m_message->invalidate();
+
+    m_subiter->close_container();
+    return this->close_container();
+  }
+
 #if DBUS_CXX_SIZEOF_LONG_INT == 4
   
   bool MessageAppendIterator::append( long int v )
@@ -264,10 +353,16 @@ namespace DBus
 
     if ( m_subiter ) this->close_container();
 
+    // While dispatching, the sub iterator comes from the dispatch arena
+    m_subiter_arena = Arena::current();
+    void* storage = m_subiter_arena ?
+                    m_subiter_arena->allocate( sizeof(MessageAppendIterator), alignof(MessageAppendIterator) ) :
+                    ::operator new( sizeof(MessageAppendIterator) );
+
     if ( m_message )
-      m_subiter = new MessageAppendIterator( *m_message );
+      m_subiter = new ( storage ) MessageAppendIterator( *m_message );
     else
-      m_subiter = new MessageAppendIterator();
+      m_subiter = new ( storage ) MessageAppendIterator();
 
     if ( t == CONTAINER_STRUCT || t == CONTAINER_DICT_ENTRY )
       success = dbus_message_iter_open_container( &m_cobj, t, NULL, m_subiter->cobj() );
@@ -282,8 +377,7 @@ namespace DBus
     bool success;
     if ( ! m_subiter ) return false;
     success = dbus_message_iter_close_container( &m_cobj, m_subiter->cobj() );
-    delete m_subiter;
-    m_subiter = NULL;
+    this->release_subiter();
     if ( ! success ) throw ErrorNoMemory::create( "MessageAppendIterator::close_container: No memory to close the container" );
     return success;
   }
@@ -293,5 +387,14 @@ namespace DBus
     return m_subiter;
   }
 
+  void MessageAppendIterator::release_subiter()
+  {
+    if ( not m_subiter ) return;
+    m_subiter->~MessageAppendIterator();
+    if ( not m_subiter_arena ) ::operator delete( m_subiter );
+    m_subiter = NULL;
+    m_subiter_arena = NULL;
+  }
+
 }
 
@@ -23,7 +23,10 @@
 #include <dbus/dbus.h>
 
 #include <dbus-cxx/types.h>
+#include <dbus-cxx/arena.h>
 #include <dbus-cxx/filedescriptor.h>
+#include <dbus-cxx/sharedbuffer.h>
+#include <dbus-cxx/compressedbuffer.h>
 
 #ifndef DBUSCXX_MESSAGEAPPENDITERATOR_H
 #define DBUSCXX_MESSAGEAPPENDITERATOR_H
@@ -84,9 +87,25 @@ namespace DBus
       bool append( double v );
       bool append( const char* v );
       bool append( const std::string& v );
+      bool append( const ArenaString& v );
       bool append( const Signature& v );
       bool append( const Path& v );
       bool append( const FileDescriptor::pointer& fd);
+
+      /**
+       * Appends an array of descriptors (ah) in a single container.
+       * libdbus cannot take unix fds as a fixed array, so each descriptor is
+       * still duplicated into the message individually.
+       */
+      bool append( const std::vector<FileDescriptor::pointer>& fds );
+
+      /**
+       * Seals the buffer and appends it as a variant holding either its
+       * memfd, offset and length or, for inline buffers, its bytes
+       */
+      bool append( const SharedBuffer::pointer& buffer );
+
+      bool append( const CompressedBuffer::pointer& buffer );
       
       bool append( char v );
       bool append( int8_t v );
@@ -96,8 +115,8 @@ namespace DBus
         bool append( long unsigned int v );
       #endif
 
-      template <typename T>
-      bool append( const std::vector<T>& v){
+      template <typename T, typename Alloc>
+      bool append( const std::vector<T,Alloc>& v){
         bool success;
         T type;
         success = this->open_container( CONTAINER_ARRAY, DBus::signature(type).c_str() );
@@ -228,6 +247,11 @@ namespace DBus
       DBusMessageIter m_cobj;
       MessageAppendIterator* m_subiter;
 
+      /** The arena m_subiter was placed in, or NULL if it is on the heap */
+      Arena* m_subiter_arena;
+
+      void release_subiter();
+
       template <typename T> bool protected_append( const T& v );
       bool protected_append( const bool& v );
       bool protected_append( const std::string& v );
@@ -420,6 +420,14 @@ namespace DBus
     }
   }
 
+  MessageIterator::operator SharedBuffer::pointer(){
+    return get_sharedbuffer();
+  }
+
+  MessageIterator::operator CompressedBuffer::pointer(){
+    return get_compressedbuffer();
+  }
+
   MessageIterator::operator FileDescriptor::pointer(){
     switch ( this->arg_type() )
     {
@@ -574,11 +582,104 @@ namespace DBus
     int raw_fd;
     if( this->arg_type() != TYPE_UNIX_FD )
       throw ErrorInvalidTypecast::create("MessageIterator: getting FileDescriptor and type is not TYPE_UNIX_FD");
+    // The descriptor is a duplicate made for us; adopt it rather than dup again
     dbus_message_iter_get_basic( &m_cobj, &raw_fd );
-    fd = FileDescriptor::create( raw_fd );
+    fd = FileDescriptor::adopt( raw_fd );
     return fd;
   }
 
+  template <>
+  void MessageIterator::get_array_simple<FileDescriptor::pointer>( std::vector<FileDescriptor::pointer>& array ){
+    MessageIterator subiter;
+    int raw_fd;
+
+    if ( this->element_type() != TYPE_UNIX_FD )
+      throw ErrorInvalidTypecast::create("MessageIterator: Extracting non unix fd array into std::vector<FileDescriptor::pointer>");
+
+    array.clear();
+    for ( subiter = this->recurse(); subiter.is_valid(); subiter.next() )
+    {
+      // libdbus hands out a fresh duplicate for every call; adopt it as is
+      dbus_message_iter_get_basic( subiter.cobj(), &raw_fd );
+      array.push_back( FileDescriptor::adopt( raw_fd ) );
+    }
+  }
+
+  template <>
+  std::vector<FileDescriptor::pointer> MessageIterator::get_array_simple<FileDescriptor::pointer>(){
+    std::vector<FileDescriptor::pointer> array;
+    this->get_array_simple<FileDescriptor::pointer>( array );
+    return array;
+  }
+
+  SharedBuffer::pointer MessageIterator::get_sharedbuffer(){
+    MessageIterator subiter;
+    MessageIterator fields;
+    std::string sig;
+    const uint8_t* bytes;
+    int length;
+    int raw_fd;
+    uint64_t offset, size;
+
+    if ( this->arg_type() != TYPE_VARIANT )
+      throw ErrorInvalidTypecast::create("MessageIterator: getting SharedBuffer and type is not TYPE_VARIANT");
+
+    subiter = this->recurse();
+    sig = subiter.signature();
+
+    if ( sig == "ay" )
+    {
+      fields = subiter.recurse();
+      dbus_message_iter_get_fixed_array( fields.cobj(), &bytes, &length );
+      return SharedBuffer::create( bytes, length );
+    }
+
+    if ( sig != "(htt)" )
+      throw ErrorInvalidTypecast::create("MessageIterator: getting SharedBuffer and variant holds neither ay nor (htt)");
+
+    fields = subiter.recurse();
+    // We own the descriptor libdbus hands back and pass it on to the buffer
+    dbus_message_iter_get_basic( fields.cobj(), &raw_fd );
+    fields.next();
+    offset = fields.get_uint64();
+    fields.next();
+    size = fields.get_uint64();
+
+    try {
+      return SharedBuffer::create_from_fd( raw_fd, offset, size );
+    }
+    catch ( ErrorInvalidArgs::pointer e ) {
+      throw ErrorInvalidTypecast::create( e->message() );
+    }
+    catch ( ErrorNoMemory::pointer e ) {
+      throw ErrorInvalidTypecast::create( e->message() );
+    }
+  }
+
+  CompressedBuffer::pointer MessageIterator::get_compressedbuffer(){
+    MessageIterator fields;
+    MessageIterator array;
+    std::string codec;
+    const uint8_t* bytes;
+    int length;
+
+    if ( this->arg_type() != TYPE_STRUCT or this->signature() != "(say)" )
+      throw ErrorInvalidTypecast::create("MessageIterator: getting CompressedBuffer and type is not (say)");
+
+    fields = this->recurse();
+    codec = fields.get_string();
+    fields.next();
+    array = fields.recurse();
+    dbus_message_iter_get_fixed_array( array.cobj(), &bytes, &length );
+
+    try {
+      return CompressedBuffer::decode( codec, bytes, length );
+    }
+    catch ( ErrorInvalidArgs::pointer e ) {
+      throw ErrorInvalidTypecast::create( e->message() );
+    }
+  }
+
 //   void MessageIterator::value( Variant& temp )
 //   {
 // 
@@ -238,6 +238,8 @@ namespace DBus
         operator unsigned long int();
       #endif
       operator FileDescriptor::pointer();
+      operator SharedBuffer::pointer();
+      operator CompressedBuffer::pointer();
         
       template <typename T>
       operator std::vector<T>() {
@@ -270,9 +272,11 @@ namespace DBus
       double      get_double();
       const char* get_string();
       FileDescriptor::pointer get_filedescriptor();
+      SharedBuffer::pointer get_sharedbuffer();
+      CompressedBuffer::pointer get_compressedbuffer();
 
-      template <typename T>
-      void get_array_simple( std::vector<T>& array ) {
+      template <typename T, typename Alloc>
+      void get_array_simple( std::vector<T,Alloc>& array ) {
         if ( not this->is_fixed() ) /* This should never happen */
           throw ErrorInvalidTypecast::create( "MessageIterator: Extracting non fixed array into std::vector" );
         
@@ -330,8 +334,8 @@ namespace DBus
         return array;
       }
       
-      template <typename T>
-      void get_array_complex(std::vector<T> &array) {
+      template <typename T, typename Alloc>
+      void get_array_complex(std::vector<T,Alloc> &array) {
         if ( not this->is_array() ) /* Should never happen */
           throw ErrorInvalidTypecast::create( "MessageIterator: Extracting non array into std::vector" );
 
@@ -497,8 +501,8 @@ DBUS_CXX_DEBUG( "ERR: " << __FILE__ << __LINE__ );
       }
        
 
-      template <typename T>
-      MessageIterator& operator>>( std::vector<T>& v )
+      template <typename T, typename Alloc>
+      MessageIterator& operator>>( std::vector<T,Alloc>& v )
       {
         if ( not this->is_array() )
           throw ErrorInvalidTypecast::create( "MessageIterator: Extracting non array into std::vector" );
@@ -540,6 +544,19 @@ DBUS_CXX_DEBUG( "ERR: " << __FILE__ << __LINE__ );
         }
       }
       
+      /**
+       * Extracts a value and moves to the next field only if the field has
+       * exactly the value's signature. Unlike operator>> no conversion is
+       * made, and a mismatch returns false instead of throwing, so it is
+       * cheap to use on arguments that are often wrong.
+       */
+      template <typename T>
+      bool try_get( T& v ) {
+        if ( not this->is_valid() or this->signature() != DBus::signature( v ) ) return false;
+        *this >> v;
+        return true;
+      }
+
       template <typename T>
       void value( T& temp ) {
         if ( this->arg_type() != DBus::type( temp ) ) {
@@ -558,6 +575,16 @@ DBUS_CXX_DEBUG( "ERR: " << __FILE__ << __LINE__ );
 
   };
 
+  /**
+   * Arrays of unix fds cannot be read as fixed arrays; each descriptor is
+   * adopted from libdbus as an owning FileDescriptor
+   */
+  template <>
+  void MessageIterator::get_array_simple<FileDescriptor::pointer>( std::vector<FileDescriptor::pointer>& array );
+
+  template <>
+  std::vector<FileDescriptor::pointer> MessageIterator::get_array_simple<FileDescriptor::pointer>();
+
 /*
   template<>
   void inline MessageIterator::get_array(std::vector<std::string> &array) {
@@ -0,0 +1,193 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by agent                                           *
+ *   agent@local                                                           *
+ *                                                                         *
+ *   This file is part of the dbus-cxx library.                            *
+ *                                                                         *
+ *   The dbus-cxx library is free software; you can redistribute it and/or *
+ *   modify it under the terms of the GNU General Public License           *
+ *   version 3 as published by the Free Software Foundation.               *
+ *                                                                         *
+ *   The dbus-cxx library is distributed in the hope that it will be       *
+ *   useful, but WITHOUT ANY WARRANTY; without even the implied warranty   *
+ *   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU   *
+ *   General Public License for more details.                              *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this software. If not see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#include "messageplayer.h"
+#include "messagerecorder.h"
+#include "dbus-cxx-private.h"
+
+#include <chrono>
+#include <cstring>
+#include <thread>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace DBus
+{
+
+  MessagePlayer::MessagePlayer( const std::string& filename ):
+      m_filename( filename ),
+      m_map( NULL ),
+      m_map_size( 0 ),
+      m_suppress_replies( true )
+  {
+    struct stat info;
+    const uint8_t* bytes;
+    size_t offset;
+    int fd;
+
+    fd = ::open( filename.c_str(), O_RDONLY | O_CLOEXEC );
+    if ( fd < 0 ) throw ErrorIOError::create( ( "MessagePlayer: unable to open " + filename ).c_str() );
+
+    if ( fstat( fd, &info ) < 0 or info.st_size < 8 ) {
+      ::close( fd );
+      throw ErrorInvalidFileContent::create( ( "MessagePlayer: " + filename + " is not a capture file" ).c_str() );
+    }
+
+    m_map_size = info.st_size;
+    m_map = mmap( NULL, m_map_size, PROT_READ, MAP_PRIVATE, fd, 0 );
+    ::close( fd );
+    if ( m_map == MAP_FAILED ) {
+      m_map = NULL;
+      throw ErrorIOError::create( ( "MessagePlayer: unable to map " + filename ).c_str() );
+    }
+
+    bytes = static_cast<const uint8_t*>( m_map );
+    if ( memcmp( bytes, DBUS_CXX_CAPTURE_MAGIC, 8 ) != 0 ) {
+      munmap( m_map, m_map_size );
+      throw ErrorInvalidFileContent::create( ( "MessagePlayer: " + filename + " is not a capture file" ).c_str() );
+    }
+
+    // A record cut short by a crash while recording ends the capture
+    for ( offset = 8; offset + 16 <= m_map_size; ) {
+      uint32_t length = *reinterpret_cast<const uint32_t*>( bytes + offset + 8 );
+      size_t next = offset + 16 + ( ( length + 7 ) & ~(size_t)7 );
+      if ( next > m_map_size ) break;
+      m_records.push_back( offset );
+      offset = next;
+    }
+
+    SIMPLELOGGER_DEBUG( "dbus.MessagePlayer", "Indexed " << m_records.size() << " messages in " << filename );
+  }
+
+  MessagePlayer::pointer MessagePlayer::create( const std::string& filename )
+  {
+    return pointer( new MessagePlayer( filename ) );
+  }
+
+  MessagePlayer::~MessagePlayer()
+  {
+    if ( m_map ) munmap( m_map, m_map_size );
+  }
+
+  size_t MessagePlayer::size() const
+  {
+    return m_records.size();
+  }
+
+  uint64_t MessagePlayer::timestamp( size_t i ) const
+  {
+    if ( i >= m_records.size() ) return 0;
+    return *reinterpret_cast<const uint64_t*>( static_cast<const uint8_t*>( m_map ) + m_records[i] );
+  }
+
+  Message::pointer MessagePlayer::message( size_t i ) const
+  {
+    const uint8_t* record;
+    uint32_t length;
+    DBusMessage* cmessage;
+    Error::pointer error = Error::create();
+
+    if ( i >= m_records.size() ) return Message::pointer();
+
+    record = static_cast<const uint8_t*>( m_map ) + m_records[i];
+    length = *reinterpret_cast<const uint32_t*>( record + 8 );
+
+    cmessage = dbus_message_demarshal( reinterpret_cast<const char*>( record + 16 ), length, error->cobj() );
+    if ( cmessage == NULL ) throw ErrorInvalidFileContent::create( error->message() );
+
+    // Their descriptors were never recorded, so the message cannot be rebuilt
+    if ( dbus_message_contains_unix_fds( cmessage ) ) {
+      dbus_message_unref( cmessage );
+      throw ErrorNotSupported::create( "MessagePlayer: messages carrying unix file descriptors cannot be replayed" );
+    }
+
+    // Message::create() took its own reference
+    Message::pointer msg = Message::create( cmessage );
+    dbus_message_unref( cmessage );
+    return msg;
+  }
+
+  bool MessagePlayer::suppress_replies() const
+  {
+    return m_suppress_replies;
+  }
+
+  void MessagePlayer::set_suppress_replies( bool suppress )
+  {
+    m_suppress_replies = suppress;
+  }
+
+  Message::pointer MessagePlayer::replay_message( size_t i, bool suppress ) const
+  {
+    Message::pointer msg = this->message( i );
+
+    // Demarshalled afresh for every replay, so nothing else sees the flag
+    if ( suppress and msg->type() == CALL_MESSAGE ) dbus_message_set_no_reply( msg->cobj(), TRUE );
+
+    return msg;
+  }
+
+  size_t MessagePlayer::play( Connection::pointer connection, double speed ) const
+  {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    size_t handled = 0;
+
+    if ( not connection ) return 0;
+
+    for ( size_t i = 0; i < m_records.size(); i++ )
+    {
+      this->wait_for( i, speed, start );
+      if ( connection->deliver_incoming( this->replay_message( i, m_suppress_replies ) ) == HANDLED ) handled++;
+    }
+
+    return handled;
+  }
+
+  size_t MessagePlayer::play( Object::pointer object, Connection::pointer connection, double speed ) const
+  {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    size_t handled = 0;
+
+    if ( not object ) return 0;
+
+    for ( size_t i = 0; i < m_records.size(); i++ )
+    {
+      this->wait_for( i, speed, start );
+      if ( object->handle_message( connection, this->replay_message( i, m_suppress_replies or not connection ) ) == HANDLED ) handled++;
+    }
+
+    return handled;
+  }
+
+  size_t MessagePlayer::play( Object::pointer object, double speed ) const
+  {
+    return this->play( object, Connection::pointer(), speed );
+  }
+
+  void MessagePlayer::wait_for( size_t i, double speed, std::chrono::steady_clock::time_point start ) const
+  {
+    if ( speed <= 0.0 ) return;
+
+    // Times are relative to the first message, so replay starts right away
+    double elapsed = ( this->timestamp( i ) - this->timestamp( 0 ) ) / speed;
+    std::this_thread::sleep_until( start + std::chrono::nanoseconds( (int64_t)elapsed ) );
+  }
+
+}
@@ -0,0 +1,135 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by agent                                           *
+ *   agent@local                                                           *
+ *                                                                         *
+ *   This file is part of the dbus-cxx library.                            *
+ *                                                                         *
+ *   The dbus-cxx library is free software; you can redistribute it and/or *
+ *   modify it under the terms of the GNU General Public License           *
+ *   version 3 as published by the Free Software Foundation.               *
+ *                                                                         *
+ *   The dbus-cxx library is distributed in the hope that it will be       *
+ *   useful, but WITHOUT ANY WARRANTY; without even the implied warranty   *
+ *   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU   *
+ *   General Public License for more details.                              *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this software. If not see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#include <chrono>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include <dbus-cxx/connection.h>
+#include <dbus-cxx/object.h>
+
+#ifndef DBUSCXX_MESSAGEPLAYER_H
+#define DBUSCXX_MESSAGEPLAYER_H
+
+namespace DBus
+{
+
+  /**
+   * Replays a capture file written by MessageRecorder.
+   *
+   * The file is mapped read-only and indexed once; messages are demarshalled
+   * as they are played. Replay runs at the recorded pace scaled by a speed
+   * factor, or with a speed of 0 as fast as possible.
+   *
+   * The senders of recorded calls are usually gone by the time they are
+   * replayed, so by default replayed calls are marked as expecting no reply
+   * and handlers send none; set_suppress_replies() turns this off.
+   *
+   * @ingroup core
+   *
+   * @author agent <agent@local>
+   */
+  class MessagePlayer
+  {
+    protected:
+
+      MessagePlayer( const std::string& filename );
+
+    public:
+
+      typedef DBusCxxPointer<MessagePlayer> pointer;
+
+      /**
+       * Maps and indexes a capture file
+       * @throw ErrorIOError if the file cannot be read,
+       *        ErrorInvalidFileContent if it is not a capture file
+       */
+      static pointer create( const std::string& filename );
+
+      virtual ~MessagePlayer();
+
+      /** The number of messages in the capture */
+      size_t size() const;
+
+      /** When message @p i was recorded, in nanoseconds since the recorder was created */
+      uint64_t timestamp( size_t i ) const;
+
+      /**
+       * Demarshals message @p i
+       * @throw ErrorInvalidFileContent if the record is not a valid message,
+       *        ErrorNotSupported if it carries unix file descriptors
+       */
+      Message::pointer message( size_t i ) const;
+
+      /** True if replayed calls are sent without expecting a reply; the default */
+      bool suppress_replies() const;
+
+      void set_suppress_replies( bool suppress );
+
+      /**
+       * Delivers every message to the connection as if it had been read
+       * from the bus, through Connection::deliver_incoming(). Nothing is
+       * sent except the replies of the handlers, unless they are suppressed.
+       *
+       * @return the number of messages that were handled
+       */
+      size_t play( Connection::pointer connection, double speed=1.0 ) const;
+
+      /**
+       * Hands every message straight to the object's handle_message(),
+       * without going through a bus. Replies and errors are sent on
+       * the connection, unless they are suppressed.
+       *
+       * @return the number of messages the object handled
+       */
+      size_t play( Object::pointer object, Connection::pointer connection, double speed=1.0 ) const;
+
+      /**
+       * Hands every message straight to the object's handle_message()
+       * with no connection at all. Replies are always suppressed, so
+       * this needs neither a bus nor a peer.
+       *
+       * @return the number of messages the object handled
+       */
+      size_t play( Object::pointer object, double speed=1.0 ) const;
+
+    protected:
+
+      std::string m_filename;
+
+      void* m_map;
+
+      size_t m_map_size;
+
+      /** Offset of each record in the mapping */
+      std::vector<size_t> m_records;
+
+      bool m_suppress_replies;
+
+      /** Demarshals message @p i, marked as expecting no reply if @p suppress is set */
+      Message::pointer replay_message( size_t i, bool suppress ) const;
+
+      /** Sleeps until message @p i is due, relative to when playing began */
+      void wait_for( size_t i, double speed, std::chrono::steady_clock::time_point start ) const;
+
+  };
+
+}
+
+#endif
@@ -0,0 +1,134 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by agent                                           *
+ *   agent@local                                                           *
+ *                                                                         *
+ *   This file is part of the dbus-cxx library.                            *
+ *                                                                         *
+ *   The dbus-cxx library is free software; you can redistribute it and/or *
+ *   modify it under the terms of the GNU General Public License           *
+ *   version 3 as published by the Free Software Foundation.               *
+ *                                                                         *
+ *   The dbus-cxx library is distributed in the hope that it will be       *
+ *   useful, but WITHOUT ANY WARRANTY; without even the implied warranty   *
+ *   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU   *
+ *   General Public License for more details.                              *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this software. If not see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#include "messagerecorder.h"
+#include "dbus-cxx-private.h"
+
+
+namespace DBus
+{
+
+  MessageRecorder::MessageRecorder( const std::string& filename ):
+      m_filename( filename ),
+      m_file( NULL ),
+      m_message_count( 0 ),
+      m_start( std::chrono::steady_clock::now() )
+  {
+    m_file = std::fopen( filename.c_str(), "wb" );
+    if ( m_file == NULL ) throw ErrorIOError::create( ( "MessageRecorder: unable to open " + filename ).c_str() );
+
+    if ( std::fwrite( DBUS_CXX_CAPTURE_MAGIC, 1, 8, m_file ) != 8 ) {
+      std::fclose( m_file );
+      throw ErrorIOError::create( ( "MessageRecorder: unable to write " + filename ).c_str() );
+    }
+  }
+
+  MessageRecorder::pointer MessageRecorder::create( const std::string& filename )
+  {
+    return pointer( new MessageRecorder( filename ) );
+  }
+
+  MessageRecorder::~MessageRecorder()
+  {
+    this->close();
+  }
+
+  void MessageRecorder::attach( Connection::pointer connection )
+  {
+    this->detach();
+    if ( not connection ) return;
+    m_filter_connection = connection->signal_filter().connect( sigc::mem_fun( *this, &MessageRecorder::on_filter ) );
+  }
+
+  void MessageRecorder::detach()
+  {
+    m_filter_connection.disconnect();
+  }
+
+  bool MessageRecorder::record( Message::const_pointer message )
+  {
+    static const char padding[8] = { 0 };
+    char* marshalled;
+    int length;
+    uint64_t timestamp;
+    uint32_t header[2];
+    bool result;
+
+    if ( not message or not *message ) return false;
+
+    if ( dbus_message_contains_unix_fds( message->cobj() ) )
+      throw ErrorNotSupported::create( "MessageRecorder: messages carrying unix file descriptors cannot be recorded" );
+
+    timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now() - m_start ).count();
+
+    if ( not dbus_message_marshal( message->cobj(), &marshalled, &length ) ) return false;
+
+    header[0] = length;
+    header[1] = 0;
+
+    {
+      std::lock_guard<std::mutex> lock( m_mutex );
+
+      result = m_file != NULL
+               and std::fwrite( &timestamp, sizeof(timestamp), 1, m_file ) == 1
+               and std::fwrite( header, sizeof(header), 1, m_file ) == 1
+               and std::fwrite( marshalled, 1, length, m_file ) == (size_t)length
+               and std::fwrite( padding, 1, ( 8 - length % 8 ) % 8, m_file ) == (size_t)( ( 8 - length % 8 ) % 8 );
+
+      if ( result ) m_message_count++;
+    }
+
+    dbus_free( marshalled );
+
+    if ( not result ) SIMPLELOGGER_ERROR( "dbus.MessageRecorder", "Unable to record a message to " << m_filename );
+
+    return result;
+  }
+
+  size_t MessageRecorder::message_count() const
+  {
+    std::lock_guard<std::mutex> lock( m_mutex );
+    return m_message_count;
+  }
+
+  const std::string& MessageRecorder::filename() const
+  {
+    return m_filename;
+  }
+
+  void MessageRecorder::close()
+  {
+    this->detach();
+
+    std::lock_guard<std::mutex> lock( m_mutex );
+    if ( m_file == NULL ) return;
+    std::fclose( m_file );
+    m_file = NULL;
+  }
+
+  FilterResult MessageRecorder::on_filter( Connection::pointer connection, Message::pointer message )
+  {
+    try {
+      this->record( message );
+    } catch ( ErrorNotSupported::pointer ) {
+      SIMPLELOGGER_WARN( "dbus.MessageRecorder", "Not recording a message with unix file descriptors to " << m_filename );
+    }
+    return DONT_FILTER;
+  }
+
+}
@@ -0,0 +1,118 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by agent                                           *
+ *   agent@local                                                           *
+ *                                                                         *
+ *   This file is part of the dbus-cxx library.                            *
+ *                                                                         *
+ *   The dbus-cxx library is free software; you can redistribute it and/or *
+ *   modify it under the terms of the GNU General Public License           *
+ *   version 3 as published by the Free Software Foundation.               *
+ *                                                                         *
+ *   The dbus-cxx library is distributed in the hope that it will be       *
+ *   useful, but WITHOUT ANY WARRANTY; without even the implied warranty   *
+ *   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU   *
+ *   General Public License for more details.                              *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this software. If not see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <stdint.h>
+#include <string>
+
+#include <dbus-cxx/connection.h>
+
+#ifndef DBUSCXX_MESSAGERECORDER_H
+#define DBUSCXX_MESSAGERECORDER_H
+
+/** The first eight bytes of a capture file */
+#define DBUS_CXX_CAPTURE_MAGIC "DBXCAP01"
+
+namespace DBus
+{
+
+  /**
+   * Records messages to a capture file that MessagePlayer can replay.
+   *
+   * A capture file starts with the eight bytes of DBUS_CXX_CAPTURE_MAGIC,
+   * followed by one record per message in host byte order:
+   *
+   * - uint64_t nanoseconds since the recorder was created
+   * - uint32_t length of the message
+   * - uint32_t reserved, always 0
+   * - the message in the wire format of dbus_message_marshal(), padded
+   *   with zeros to a multiple of eight bytes
+   *
+   * Every record starts eight byte aligned, so a player can map the file
+   * and read it in place.
+   *
+   * @ingroup core
+   *
+   * @author agent <agent@local>
+   */
+  class MessageRecorder
+  {
+    protected:
+
+      MessageRecorder( const std::string& filename );
+
+    public:
+
+      typedef DBusCxxPointer<MessageRecorder> pointer;
+
+      /**
+       * Creates or truncates the capture file
+       * @throw ErrorIOError if the file cannot be written
+       */
+      static pointer create( const std::string& filename );
+
+      virtual ~MessageRecorder();
+
+      /**
+       * Records every message the connection receives, through its
+       * signal_filter(). Messages are never filtered; those carrying unix
+       * file descriptors are logged and left out of the capture.
+       */
+      void attach( Connection::pointer connection );
+
+      /** Stops recording the attached connection */
+      void detach();
+
+      /**
+       * Appends one message; returns false if it could not be written
+       * @throw ErrorNotSupported if the message carries unix file
+       *        descriptors, which a capture cannot hold
+       */
+      bool record( Message::const_pointer message );
+
+      /** The number of messages recorded so far */
+      size_t message_count() const;
+
+      const std::string& filename() const;
+
+      /** Flushes and closes the file; later messages are not recorded */
+      void close();
+
+    protected:
+
+      std::string m_filename;
+
+      std::FILE* m_file;
+
+      size_t m_message_count;
+
+      std::chrono::steady_clock::time_point m_start;
+
+      sigc::connection m_filter_connection;
+
+      mutable std::mutex m_mutex;
+
+      FilterResult on_filter( Connection::pointer connection, Message::pointer message );
+
+  };
+
+}
+
+#endif
@@ -45,7 +45,20 @@ FOR(1, $1,[dnl
     T_arg%1 _val_%1;
 ])dnl
 
+    std::chrono::steady_clock::time_point _start = std::chrono::steady_clock::now();
+    std::chrono::steady_clock::time_point _handler_start;
+    bool _replying = false;
+    // A caller that sets NO_REPLY_EXPECTED never reads a reply or error, so
+    // none is built or sent; the handler still runs and errors are counted
+    bool _wants_reply = not dbus_message_get_no_reply( message->cobj() );
+
 ifelse(eval($1>0),1,[dnl
+    // Calls meant for an overload with other argument types are turned
+    // away here instead of by a failed extraction
+    if ( not dbus_message_has_signature( message->cobj(), m_arg_signature.c_str() ) and
+         not arguments_may_convert( dbus_message_get_signature( message->cobj() ), m_arg_signature ) )
+      return NOT_HANDLED;
+
     try {
       Message::iterator i = message->begin();
       i FOR(1, $1,[ >> _val_%1]);
@@ -55,19 +68,44 @@ ifelse(eval($1>0),1,[dnl
     }
 ],[])dnl
 
+    DBUSCXX_TRACE( DEMARSHALLED, message->cobj() );
+    _handler_start = std::chrono::steady_clock::now();
+    m_metrics.count_call();
+    m_metrics.demarshal_time().record( _handler_start - _start );
+
     try {
+      DBUSCXX_TRACE( HANDLER_BEGIN, message->cobj() );
       ifelse(RETURN_TYPE,[void],,[_retval = ])m_slot(LIST(LOOP(_val_%1, $1)));
-      ReturnMessage::pointer retmsg = message->create_reply();
-
-      if ( not retmsg ) return NOT_HANDLED;
+      DBUSCXX_TRACE( HANDLER_END, message->cobj() );
+      _start = std::chrono::steady_clock::now();
+      m_metrics.handler_time().record( _start - _handler_start );
+      _replying = true;
 
 ifelse(RETURN_TYPE,[void],,[dnl
-      *retmsg << _retval;
+      if ( priv::is_error_result( _retval ) ) m_metrics.count_error();
 ])dnl
+      if ( not _wants_reply ) return HANDLED;
+
+ifelse(RETURN_TYPE,[void],[dnl
+      Message::pointer retmsg = message->create_reply();
+],[dnl
+      Message::pointer retmsg = priv::create_method_reply( message, _retval );
+])dnl
+
+      if ( not retmsg ) return NOT_HANDLED;
 
       connection->send(retmsg);
+      m_metrics.reply_time().record( std::chrono::steady_clock::now() - _start );
     }
     catch ( const std::exception &e ) {
+      m_metrics.count_error();
+      if ( not _replying ) {
+        DBUSCXX_TRACE( HANDLER_END, message->cobj() );
+        m_metrics.handler_time().record( std::chrono::steady_clock::now() - _handler_start );
+      }
+
+      if ( not _wants_reply ) return HANDLED;
+
       ErrorMessage::pointer errmsg = ErrorMessage::create( message, DBUS_ERROR_FAILED, e.what() );
 
       if ( not errmsg ) return NOT_HANDLED;
@@ -75,6 +113,14 @@ ifelse(RETURN_TYPE,[void],,[dnl
       connection->send(errmsg);
     }
     catch ( ... ) {
+      m_metrics.count_error();
+      if ( not _replying ) {
+        DBUSCXX_TRACE( HANDLER_END, message->cobj() );
+        m_metrics.handler_time().record( std::chrono::steady_clock::now() - _handler_start );
+      }
+
+      if ( not _wants_reply ) return HANDLED;
+
       std::ostringstream stream;
       stream << "DBus-cxx " << DBUS_CXX_PACKAGE_MAJOR_VERSION << "." << 
            DBUS_CXX_PACKAGE_MINOR_VERSION << "." << DBUS_CXX_PACKAGE_MICRO_VERSION << " unknown error.";
@@ -106,7 +152,13 @@ define([RETURN_TYPE],ifelse($3,[void],[void],[T_return]))dnl
 
     typedef DBusCxxPointer<Method> pointer;
 
-    Method(const std::string& name): MethodBase(name) {  }
+    Method(const std::string& name): MethodBase(name)
+    {
+FOR(1,$1,[dnl
+      T_arg%1 arg%1;
+      m_arg_signature += signature(arg%1);
+],[])dnl
+    }
     
     virtual ~Method() { }
 
@@ -137,9 +189,10 @@ ifelse(RETURN_TYPE,[void],[dnl
       sout << spaces << "<method name=\"" << name() << "\">\n";
 ifelse(RETURN_TYPE,[void],,[dnl
       T_return type;
-      sout << spaces << "  <arg name=\"" << m_arg_names[[0]]
-           << "\" type=\"" << signature(type)
-           << "\" direction=\"out\"/>\n";
+      if ( not signature(type).empty() )
+        sout << spaces << "  <arg name=\"" << m_arg_names[[0]]
+             << "\" type=\"" << signature(type)
+             << "\" direction=\"out\"/>\n";
 ])dnl
 FOR(1,$1,[dnl
       T_arg%1 arg%1;
@@ -164,6 +217,9 @@ FOR(1,$1,[dnl
 
     std::string m_arg_names[[$1+1]];
 
+    /** The signature of the in arguments, which calls are checked against */
+    std::string m_arg_signature;
+
     sigc::slot$1<LIST(RETURN_TYPE, LOOP(T_arg%1, $1))> m_slot;
 
   };
@@ -198,11 +254,14 @@ dnl
  *   along with this software. If not see <http://www.gnu.org/licenses/>.  *
  ***************************************************************************/]
 #include <sstream>
+#include <chrono>
 #include <dbus-cxx/utility.h>
 #include <dbus-cxx/forward_decls.h>
 #include <dbus-cxx/methodbase.h>
 #include <dbus-cxx/errormessage.h>
+#include <dbus-cxx/result.h>
 #include <dbus-cxx/headerlog.h>
+#include <dbus-cxx/tracing.h>
 #include <exception>
 #include <ostream>
     
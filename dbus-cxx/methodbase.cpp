@@ -20,6 +20,8 @@
 #include "methodbase.h"
 #include "dbus-cxx-private.h"
 
+#include <cstring>
+
 namespace DBus
 {
 
@@ -73,5 +75,77 @@ namespace DBus
   void MethodBase::set_arg_name(size_t i, const std::string& name)
   {
   }
-}
 
+  MethodMetrics& MethodBase::metrics()
+  {
+    return m_metrics;
+  }
+
+  const MethodMetrics& MethodBase::metrics() const
+  {
+    return m_metrics;
+  }
+
+  /** Types that extract into each other share a class; 0 for types that convert into nothing else */
+  static int conversion_class( int type )
+  {
+    switch ( type )
+    {
+      case DBUS_TYPE_BYTE:
+      case DBUS_TYPE_BOOLEAN:
+      case DBUS_TYPE_INT16:
+      case DBUS_TYPE_UINT16:
+      case DBUS_TYPE_INT32:
+      case DBUS_TYPE_UINT32:
+      case DBUS_TYPE_INT64:
+      case DBUS_TYPE_UINT64:
+      case DBUS_TYPE_DOUBLE:
+        return 1;
+      case DBUS_TYPE_STRING:
+      case DBUS_TYPE_OBJECT_PATH:
+      case DBUS_TYPE_SIGNATURE:
+        return 2;
+      default:
+        return 0;
+    }
+  }
+
+  bool MethodBase::arguments_may_convert( const char* signature, const std::string& expected )
+  {
+    DBusSignatureIter have;
+    DBusSignatureIter want;
+
+    if ( signature == NULL ) return false;
+    if ( expected.empty() ) return true;
+    if ( *signature == '\0' ) return false;
+
+    dbus_signature_iter_init( &have, signature );
+    dbus_signature_iter_init( &want, expected.c_str() );
+
+    while ( true )
+    {
+      int have_type = dbus_signature_iter_get_current_type( &have );
+      int want_type = dbus_signature_iter_get_current_type( &want );
+
+      if ( have_type != want_type )
+      {
+        if ( conversion_class( have_type ) == 0 or conversion_class( have_type ) != conversion_class( want_type ) )
+          return false;
+      }
+      else if ( dbus_type_is_container( have_type ) )
+      {
+        // Containers are only extracted from exactly their own type
+        char* have_signature = dbus_signature_iter_get_signature( &have );
+        char* want_signature = dbus_signature_iter_get_signature( &want );
+        bool same = have_signature and want_signature and strcmp( have_signature, want_signature ) == 0;
+        dbus_free( have_signature );
+        dbus_free( want_signature );
+        if ( not same ) return false;
+      }
+
+      if ( not dbus_signature_iter_next( &want ) ) return true;
+      if ( not dbus_signature_iter_next( &have ) ) return false;
+    }
+  }
+
+}
@@ -17,6 +17,7 @@
  *   along with this software. If not see <http://www.gnu.org/licenses/>.  *
  ***************************************************************************/
 #include <dbus-cxx/callmessage.h>
+#include <dbus-cxx/metrics.h>
 
 #ifndef DBUSCXX_METHODBASE_H
 #define DBUSCXX_METHODBASE_H
@@ -71,6 +72,20 @@ namespace DBus
 
       virtual void set_arg_name(size_t i, const std::string& name);
 
+      /** Call counts and demarshal, handler and reply latencies of this method */
+      MethodMetrics& metrics();
+
+      const MethodMetrics& metrics() const;
+
+      /**
+       * False if arguments with the given signature can't be extracted into
+       * arguments with the expected one. Only top level numbers, strings,
+       * object paths and signatures convert into each other, and extra
+       * arguments are ignored, matching what MessageIterator extraction
+       * accepts.
+       */
+      static bool arguments_may_convert( const char* signature, const std::string& expected );
+
     protected:
 
       std::string m_name;
@@ -80,6 +95,8 @@ namespace DBus
 
       sigc::signal<void,const std::string&, const std::string&> m_signal_name_changed;
 
+      MethodMetrics m_metrics;
+
   };
 
   /**
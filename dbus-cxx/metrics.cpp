@@ -0,0 +1,394 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by agent                                           *
+ *   agent@local                                                           *
+ *                                                                         *
+ *   This file is part of the dbus-cxx library.                            *
+ *                                                                         *
+ *   The dbus-cxx library is free software; you can redistribute it and/or *
+ *   modify it under the terms of the GNU General Public License           *
+ *   version 3 as published by the Free Software Foundation.               *
+ *                                                                         *
+ *   The dbus-cxx library is distributed in the hope that it will be       *
+ *   useful, but WITHOUT ANY WARRANTY; without even the implied warranty   *
+ *   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU   *
+ *   General Public License for more details.                              *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this software. If not see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#include "metrics.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace DBus
+{
+
+  Histogram::Histogram():
+      m_count( 0 ),
+      m_sum( 0 ),
+      m_max( 0 )
+  {
+    for ( unsigned int i = 0; i < BUCKETS; i++ ) m_buckets[i] = 0;
+  }
+
+  void Histogram::record( uint64_t nanoseconds )
+  {
+    unsigned int i = 0;
+    uint64_t value = nanoseconds;
+    uint64_t current;
+
+    while ( value != 0 and i < BUCKETS - 1 ) {
+      value >>= 1;
+      i++;
+    }
+
+    m_buckets[i].fetch_add( 1, std::memory_order_relaxed );
+    m_sum.fetch_add( nanoseconds, std::memory_order_relaxed );
+    m_count.fetch_add( 1, std::memory_order_relaxed );
+
+    current = m_max.load( std::memory_order_relaxed );
+    while ( nanoseconds > current and
+            not m_max.compare_exchange_weak( current, nanoseconds, std::memory_order_relaxed ) );
+  }
+
+  void Histogram::record( std::chrono::steady_clock::duration duration )
+  {
+    int64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>( duration ).count();
+    this->record( ns < 0 ? 0 : (uint64_t)ns );
+  }
+
+  uint64_t Histogram::count() const
+  {
+    return m_count.load( std::memory_order_relaxed );
+  }
+
+  uint64_t Histogram::sum() const
+  {
+    return m_sum.load( std::memory_order_relaxed );
+  }
+
+  uint64_t Histogram::max() const
+  {
+    return m_max.load( std::memory_order_relaxed );
+  }
+
+  uint64_t Histogram::mean() const
+  {
+    uint64_t n = this->count();
+    if ( n == 0 ) return 0;
+    return this->sum() / n;
+  }
+
+  uint64_t Histogram::bucket( unsigned int i ) const
+  {
+    if ( i >= BUCKETS ) return 0;
+    return m_buckets[i].load( std::memory_order_relaxed );
+  }
+
+  uint64_t Histogram::bucket_limit( unsigned int i )
+  {
+    if ( i >= BUCKETS - 1 ) return std::numeric_limits<uint64_t>::max();
+    return (uint64_t)1 << i;
+  }
+
+  uint64_t Histogram::percentile( double p ) const
+  {
+    uint64_t total = 0;
+    uint64_t target;
+    uint64_t seen = 0;
+    uint64_t counts[BUCKETS];
+    uint64_t maximum = this->max();
+
+    // Work from one copy of the buckets so the target can't outgrow them
+    for ( unsigned int i = 0; i < BUCKETS; i++ ) {
+      counts[i] = this->bucket( i );
+      total += counts[i];
+    }
+    if ( total == 0 ) return 0;
+
+    if ( p < 0.0 ) p = 0.0;
+    if ( p > 100.0 ) p = 100.0;
+    target = (uint64_t)( p / 100.0 * total + 0.5 );
+    if ( target == 0 ) target = 1;
+
+    for ( unsigned int i = 0; i < BUCKETS; i++ ) {
+      seen += counts[i];
+      if ( seen >= target ) return std::min( bucket_limit( i ), maximum );
+    }
+    return maximum;
+  }
+
+  void Histogram::reset()
+  {
+    for ( unsigned int i = 0; i < BUCKETS; i++ ) m_buckets[i] = 0;
+    m_count = 0;
+    m_sum = 0;
+    m_max = 0;
+  }
+
+  ConnectionMetrics::ConnectionMetrics():
+      m_bytes_in( 0 ),
+      m_bytes_out( 0 ),
+      m_pending_replies( 0 ),
+      m_dispatch_queue_depth( 0 ),
+      m_count_bytes( false )
+  {
+    for ( unsigned int i = 0; i < TYPES; i++ ) {
+      m_messages_in[i] = 0;
+      m_messages_out[i] = 0;
+    }
+  }
+
+  uint64_t ConnectionMetrics::messages_in( MessageType type ) const
+  {
+    if ( (unsigned int)type >= TYPES ) return 0;
+    return m_messages_in[type].load( std::memory_order_relaxed );
+  }
+
+  uint64_t ConnectionMetrics::messages_out( MessageType type ) const
+  {
+    if ( (unsigned int)type >= TYPES ) return 0;
+    return m_messages_out[type].load( std::memory_order_relaxed );
+  }
+
+  uint64_t ConnectionMetrics::messages_in() const
+  {
+    uint64_t total = 0;
+    for ( unsigned int i = 0; i < TYPES; i++ ) total += m_messages_in[i].load( std::memory_order_relaxed );
+    return total;
+  }
+
+  uint64_t ConnectionMetrics::messages_out() const
+  {
+    uint64_t total = 0;
+    for ( unsigned int i = 0; i < TYPES; i++ ) total += m_messages_out[i].load( std::memory_order_relaxed );
+    return total;
+  }
+
+  uint64_t ConnectionMetrics::bytes_in() const
+  {
+    return m_bytes_in.load( std::memory_order_relaxed );
+  }
+
+  uint64_t ConnectionMetrics::bytes_out() const
+  {
+    return m_bytes_out.load( std::memory_order_relaxed );
+  }
+
+  int64_t ConnectionMetrics::pending_replies() const
+  {
+    return m_pending_replies.load( std::memory_order_relaxed );
+  }
+
+  int64_t ConnectionMetrics::dispatch_queue_depth() const
+  {
+    return m_dispatch_queue_depth.load( std::memory_order_relaxed );
+  }
+
+  Histogram& ConnectionMetrics::dispatch_arena_bytes()
+  {
+    return m_dispatch_arena_bytes;
+  }
+
+  const Histogram& ConnectionMetrics::dispatch_arena_bytes() const
+  {
+    return m_dispatch_arena_bytes;
+  }
+
+  void ConnectionMetrics::set_count_bytes( bool count )
+  {
+    m_count_bytes = count;
+  }
+
+  bool ConnectionMetrics::count_bytes() const
+  {
+    return m_count_bytes;
+  }
+
+  void ConnectionMetrics::count_in( DBusMessage* message )
+  {
+    if ( message == NULL ) return;
+    int type = dbus_message_get_type( message );
+    if ( type >= 0 and (unsigned int)type < TYPES )
+      m_messages_in[type].fetch_add( 1, std::memory_order_relaxed );
+    if ( m_count_bytes.load( std::memory_order_relaxed ) )
+      m_bytes_in.fetch_add( message_size( message ), std::memory_order_relaxed );
+  }
+
+  void ConnectionMetrics::count_out( DBusMessage* message )
+  {
+    if ( message == NULL ) return;
+    int type = dbus_message_get_type( message );
+    if ( type >= 0 and (unsigned int)type < TYPES )
+      m_messages_out[type].fetch_add( 1, std::memory_order_relaxed );
+    if ( m_count_bytes.load( std::memory_order_relaxed ) )
+      m_bytes_out.fetch_add( message_size( message ), std::memory_order_relaxed );
+  }
+
+  void ConnectionMetrics::add_pending_reply()
+  {
+    m_pending_replies.fetch_add( 1, std::memory_order_relaxed );
+  }
+
+  void ConnectionMetrics::remove_pending_reply()
+  {
+    m_pending_replies.fetch_sub( 1, std::memory_order_relaxed );
+  }
+
+  void ConnectionMetrics::set_dispatch_queue_depth( int64_t depth )
+  {
+    m_dispatch_queue_depth.store( depth, std::memory_order_relaxed );
+  }
+
+  std::map<std::string,uint64_t> ConnectionMetrics::to_map() const
+  {
+    std::map<std::string,uint64_t> values;
+    int64_t pending = this->pending_replies();
+    int64_t depth = this->dispatch_queue_depth();
+
+    values["calls_in"] = this->messages_in( CALL_MESSAGE );
+    values["returns_in"] = this->messages_in( RETURN_MESSAGE );
+    values["errors_in"] = this->messages_in( ERROR_MESSAGE );
+    values["signals_in"] = this->messages_in( SIGNAL_MESSAGE );
+    values["calls_out"] = this->messages_out( CALL_MESSAGE );
+    values["returns_out"] = this->messages_out( RETURN_MESSAGE );
+    values["errors_out"] = this->messages_out( ERROR_MESSAGE );
+    values["signals_out"] = this->messages_out( SIGNAL_MESSAGE );
+    values["bytes_in"] = this->bytes_in();
+    values["bytes_out"] = this->bytes_out();
+    values["pending_replies"] = pending < 0 ? 0 : pending;
+    values["dispatch_queue_depth"] = depth < 0 ? 0 : depth;
+    values["dispatch_arena_bytes_mean"] = m_dispatch_arena_bytes.mean();
+    values["dispatch_arena_bytes_p99"] = m_dispatch_arena_bytes.percentile( 99.0 );
+    values["dispatch_arena_bytes_max"] = m_dispatch_arena_bytes.max();
+    return values;
+  }
+
+  void ConnectionMetrics::reset()
+  {
+    for ( unsigned int i = 0; i < TYPES; i++ ) {
+      m_messages_in[i] = 0;
+      m_messages_out[i] = 0;
+    }
+    m_bytes_in = 0;
+    m_bytes_out = 0;
+    m_dispatch_arena_bytes.reset();
+  }
+
+  uint64_t ConnectionMetrics::message_size( DBusMessage* message )
+  {
+    char* marshalled;
+    int length;
+
+    // Only locked messages can be marshalled without disturbing their serial
+    if ( not dbus_message_marshal( message, &marshalled, &length ) ) return 0;
+    dbus_free( marshalled );
+    return length;
+  }
+
+  MethodMetrics::MethodMetrics():
+      m_calls( 0 ),
+      m_errors( 0 )
+  {
+  }
+
+  uint64_t MethodMetrics::calls() const
+  {
+    return m_calls.load( std::memory_order_relaxed );
+  }
+
+  uint64_t MethodMetrics::errors() const
+  {
+    return m_errors.load( std::memory_order_relaxed );
+  }
+
+  Histogram& MethodMetrics::demarshal_time()
+  {
+    return m_demarshal_time;
+  }
+
+  Histogram& MethodMetrics::handler_time()
+  {
+    return m_handler_time;
+  }
+
+  Histogram& MethodMetrics::reply_time()
+  {
+    return m_reply_time;
+  }
+
+  const Histogram& MethodMetrics::demarshal_time() const
+  {
+    return m_demarshal_time;
+  }
+
+  const Histogram& MethodMetrics::handler_time() const
+  {
+    return m_handler_time;
+  }
+
+  const Histogram& MethodMetrics::reply_time() const
+  {
+    return m_reply_time;
+  }
+
+  void MethodMetrics::count_call()
+  {
+    m_calls.fetch_add( 1, std::memory_order_relaxed );
+  }
+
+  void MethodMetrics::count_error()
+  {
+    m_errors.fetch_add( 1, std::memory_order_relaxed );
+  }
+
+  static void add_histogram( std::map<std::string,uint64_t>& values, const std::string& prefix, const Histogram& histogram )
+  {
+    values[prefix + "_count"] = histogram.count();
+    values[prefix + "_mean_ns"] = histogram.mean();
+    values[prefix + "_p99_ns"] = histogram.percentile( 99.0 );
+    values[prefix + "_max_ns"] = histogram.max();
+  }
+
+  std::map<std::string,uint64_t> MethodMetrics::to_map() const
+  {
+    std::map<std::string,uint64_t> values;
+    values["calls"] = this->calls();
+    values["errors"] = this->errors();
+    add_histogram( values, "demarshal", m_demarshal_time );
+    add_histogram( values, "handler", m_handler_time );
+    add_histogram( values, "reply", m_reply_time );
+    return values;
+  }
+
+  void MethodMetrics::reset()
+  {
+    m_calls = 0;
+    m_errors = 0;
+    m_demarshal_time.reset();
+    m_handler_time.reset();
+    m_reply_time.reset();
+  }
+
+  SignalProxyMetrics::SignalProxyMetrics():
+      m_deliveries( 0 )
+  {
+  }
+
+  uint64_t SignalProxyMetrics::deliveries() const
+  {
+    return m_deliveries.load( std::memory_order_relaxed );
+  }
+
+  void SignalProxyMetrics::count_delivery()
+  {
+    m_deliveries.fetch_add( 1, std::memory_order_relaxed );
+  }
+
+  void SignalProxyMetrics::reset()
+  {
+    m_deliveries = 0;
+  }
+
+}
@@ -0,0 +1,296 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by agent                                           *
+ *   agent@local                                                           *
+ *                                                                         *
+ *   This file is part of the dbus-cxx library.                            *
+ *                                                                         *
+ *   The dbus-cxx library is free software; you can redistribute it and/or *
+ *   modify it under the terms of the GNU General Public License           *
+ *   version 3 as published by the Free Software Foundation.               *
+ *                                                                         *
+ *   The dbus-cxx library is distributed in the hope that it will be       *
+ *   useful, but WITHOUT ANY WARRANTY; without even the implied warranty   *
+ *   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU   *
+ *   General Public License for more details.                              *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this software. If not see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <string>
+#include <stdint.h>
+
+#include <dbus-cxx/enums.h>
+
+#ifndef DBUSCXX_METRICS_H
+#define DBUSCXX_METRICS_H
+
+namespace DBus
+{
+
+  /**
+   * A histogram of durations with power of two buckets.
+   *
+   * Bucket i counts the durations of at least 2^(i-1) and less than 2^i
+   * nanoseconds; bucket 0 counts zero length durations and the last
+   * bucket everything that is longer. Recording and reading are lock free,
+   * so a reader may see a count that is briefly ahead of the buckets.
+   *
+   * @ingroup core
+   *
+   * @author agent <agent@local>
+   */
+  class Histogram
+  {
+    public:
+
+      static const unsigned int BUCKETS = 40;
+
+      Histogram();
+
+      void record( uint64_t nanoseconds );
+
+      void record( std::chrono::steady_clock::duration duration );
+
+      uint64_t count() const;
+
+      /** The sum of all recorded durations in nanoseconds */
+      uint64_t sum() const;
+
+      /** The longest recorded duration in nanoseconds */
+      uint64_t max() const;
+
+      /** The mean duration in nanoseconds, or 0 if nothing was recorded */
+      uint64_t mean() const;
+
+      uint64_t bucket( unsigned int i ) const;
+
+      /** The exclusive upper bound of bucket i in nanoseconds */
+      static uint64_t bucket_limit( unsigned int i );
+
+      /**
+       * An upper estimate of the given percentile (0 to 100) in nanoseconds;
+       * the limit of the bucket it falls in, capped at max().
+       */
+      uint64_t percentile( double p ) const;
+
+      void reset();
+
+    protected:
+
+      std::atomic<uint64_t> m_buckets[BUCKETS];
+
+      std::atomic<uint64_t> m_count;
+
+      std::atomic<uint64_t> m_sum;
+
+      std::atomic<uint64_t> m_max;
+
+    private:
+
+      Histogram( const Histogram& );
+
+      Histogram& operator=( const Histogram& );
+  };
+
+  /**
+   * The traffic counters of a Connection.
+   *
+   * Counts every message that passes the connection's filter on the way in
+   * and every message handed to libdbus on the way out. Byte counts need
+   * each message to be serialized a second time and are only kept once
+   * set_count_bytes() has been called.
+   *
+   * @ingroup core
+   *
+   * @author agent <agent@local>
+   */
+  class ConnectionMetrics
+  {
+    public:
+
+      ConnectionMetrics();
+
+      uint64_t messages_in( MessageType type ) const;
+
+      uint64_t messages_out( MessageType type ) const;
+
+      /** Messages of all types received */
+      uint64_t messages_in() const;
+
+      /** Messages of all types sent */
+      uint64_t messages_out() const;
+
+      uint64_t bytes_in() const;
+
+      uint64_t bytes_out() const;
+
+      /** Calls sent with a reply expected that have not been answered, timed out or cancelled */
+      int64_t pending_replies() const;
+
+      /** Deferred calls, including batched signal deliveries, waiting to be run */
+      int64_t dispatch_queue_depth() const;
+
+      /**
+       * Bytes taken from the dispatch arena while handling each dispatched
+       * message. The histogram's buckets count bytes instead of nanoseconds.
+       *
+       * Only ArenaAllocator memory is counted: message wrappers and the
+       * strings and containers that handlers build on the heap are not, so
+       * this is not the total a message costs to handle.
+       */
+      Histogram& dispatch_arena_bytes();
+
+      const Histogram& dispatch_arena_bytes() const;
+
+      void set_count_bytes( bool count=true );
+
+      bool count_bytes() const;
+
+      void count_in( DBusMessage* message );
+
+      void count_out( DBusMessage* message );
+
+      void add_pending_reply();
+
+      void remove_pending_reply();
+
+      void set_dispatch_queue_depth( int64_t depth );
+
+      /** The counters keyed by name, in the form exported by MetricsObject */
+      std::map<std::string,uint64_t> to_map() const;
+
+      /** Zeroes the counters; the pending reply and queue gauges are kept */
+      void reset();
+
+    protected:
+
+      static const unsigned int TYPES = 5;
+
+      std::atomic<uint64_t> m_messages_in[TYPES];
+
+      std::atomic<uint64_t> m_messages_out[TYPES];
+
+      std::atomic<uint64_t> m_bytes_in;
+
+      std::atomic<uint64_t> m_bytes_out;
+
+      std::atomic<int64_t> m_pending_replies;
+
+      std::atomic<int64_t> m_dispatch_queue_depth;
+
+      std::atomic<bool> m_count_bytes;
+
+      Histogram m_dispatch_arena_bytes;
+
+      static uint64_t message_size( DBusMessage* message );
+
+    private:
+
+      ConnectionMetrics( const ConnectionMetrics& );
+
+      ConnectionMetrics& operator=( const ConnectionMetrics& );
+  };
+
+  /**
+   * Call counts and latencies of a local method.
+   *
+   * Each call records the time taken to demarshal the arguments, to run
+   * the handler and to build and send the reply. Calls whose arguments do
+   * not match the method's signature are left to other overloads and are
+   * not counted. Calls whose handler throws count as errors and record no
+   * reply time.
+   *
+   * @ingroup objects
+   *
+   * @author agent <agent@local>
+   */
+  class MethodMetrics
+  {
+    public:
+
+      MethodMetrics();
+
+      uint64_t calls() const;
+
+      uint64_t errors() const;
+
+      Histogram& demarshal_time();
+
+      Histogram& handler_time();
+
+      Histogram& reply_time();
+
+      const Histogram& demarshal_time() const;
+
+      const Histogram& handler_time() const;
+
+      const Histogram& reply_time() const;
+
+      void count_call();
+
+      void count_error();
+
+      /** Call and error counts plus the count, mean, 99th percentile and max of each histogram */
+      std::map<std::string,uint64_t> to_map() const;
+
+      void reset();
+
+    protected:
+
+      std::atomic<uint64_t> m_calls;
+
+      std::atomic<uint64_t> m_errors;
+
+      Histogram m_demarshal_time;
+
+      Histogram m_handler_time;
+
+      Histogram m_reply_time;
+
+    private:
+
+      MethodMetrics( const MethodMetrics& );
+
+      MethodMetrics& operator=( const MethodMetrics& );
+  };
+
+  /**
+   * Delivery counts of a signal proxy.
+   *
+   * @ingroup proxy
+   *
+   * @author agent <agent@local>
+   */
+  class SignalProxyMetrics
+  {
+    public:
+
+      SignalProxyMetrics();
+
+      /**
+       * Signals passed on to the slots of the proxy, counted as each is
+       * delivered; queued signals replaced by batch coalescing are not counted
+       */
+      uint64_t deliveries() const;
+
+      void count_delivery();
+
+      void reset();
+
+    protected:
+
+      std::atomic<uint64_t> m_deliveries;
+
+    private:
+
+      SignalProxyMetrics( const SignalProxyMetrics& );
+
+      SignalProxyMetrics& operator=( const SignalProxyMetrics& );
+  };
+
+}
+
+#endif
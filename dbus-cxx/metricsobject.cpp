@@ -0,0 +1,163 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by agent                                           *
+ *   agent@local                                                           *
+ *                                                                         *
+ *   This file is part of the dbus-cxx library.                            *
+ *                                                                         *
+ *   The dbus-cxx library is free software; you can redistribute it and/or *
+ *   modify it under the terms of the GNU General Public License           *
+ *   version 3 as published by the Free Software Foundation.               *
+ *                                                                         *
+ *   The dbus-cxx library is distributed in the hope that it will be       *
+ *   useful, but WITHOUT ANY WARRANTY; without even the implied warranty   *
+ *   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU   *
+ *   General Public License for more details.                              *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this software. If not see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#include "metricsobject.h"
+#include "connection.h"
+#include "dbus-cxx-private.h"
+
+#include <algorithm>
+
+namespace DBus
+{
+
+  MetricsObject::MetricsObject( const std::string& path ):
+      Object( path, PRIMARY )
+  {
+  }
+
+  MetricsObject::pointer MetricsObject::create( const std::string& path )
+  {
+    return pointer( new MetricsObject( path ) );
+  }
+
+  MetricsObject::~MetricsObject()
+  {
+  }
+
+  void MetricsObject::add_object( Object::pointer object )
+  {
+    if ( not object ) return;
+    std::lock_guard<std::mutex> lock( m_objects_mutex );
+    if ( std::find( m_objects.begin(), m_objects.end(), object ) == m_objects.end() )
+      m_objects.push_back( object );
+  }
+
+  void MetricsObject::remove_object( Object::pointer object )
+  {
+    std::lock_guard<std::mutex> lock( m_objects_mutex );
+    m_objects.erase( std::remove( m_objects.begin(), m_objects.end(), object ), m_objects.end() );
+  }
+
+  std::map<std::string,std::map<std::string,uint64_t> > MetricsObject::method_metrics() const
+  {
+    std::map<std::string,std::map<std::string,uint64_t> > metrics;
+    std::lock_guard<std::mutex> lock( m_objects_mutex );
+
+    for ( size_t i = 0; i < m_objects.size(); i++ )
+      add_method_metrics( metrics, m_objects[i] );
+
+    return metrics;
+  }
+
+  void MetricsObject::add_method_metrics( std::map<std::string,std::map<std::string,uint64_t> >& metrics, Object::pointer object )
+  {
+    // Copies, as the handlers may add and remove these while we report
+    Interfaces interfaces = object->copy_interfaces();
+    Children children = object->copy_children();
+    Interface::Methods methods;
+    Interfaces::const_iterator i;
+    Interface::Methods::const_iterator m;
+    Children::const_iterator c;
+
+    for ( i = interfaces.begin(); i != interfaces.end(); i++ )
+    {
+      methods = i->second->copy_methods();
+      for ( m = methods.begin(); m != methods.end(); m++ )
+      {
+        std::string key = object->path() + " ";
+        if ( not i->first.empty() ) key += i->first + ".";
+        key += m->first;
+
+        // Overloads of the same name are reported together
+        std::map<std::string,uint64_t> values = m->second->metrics().to_map();
+        std::map<std::string,uint64_t>& entry = metrics[key];
+        if ( entry.empty() ) entry = values;
+        else {
+          entry["calls"] += values["calls"];
+          entry["errors"] += values["errors"];
+        }
+      }
+    }
+
+    for ( c = children.begin(); c != children.end(); c++ )
+      add_method_metrics( metrics, c->second );
+  }
+
+  std::map<std::string,uint64_t> MetricsObject::signal_metrics( Connection::pointer connection )
+  {
+    std::map<std::string,uint64_t> metrics;
+    Connection::InterfaceToNameProxySignalMap::const_iterator i;
+    Connection::NameToProxySignalMap::const_iterator n;
+    Connection::ProxySignals::const_iterator p;
+
+    if ( not connection ) return metrics;
+
+    const Connection::InterfaceToNameProxySignalMap& proxies = connection->get_signal_proxies();
+    for ( i = proxies.begin(); i != proxies.end(); i++ )
+      for ( n = i->second.begin(); n != i->second.end(); n++ )
+        for ( p = n->second.begin(); p != n->second.end(); p++ )
+          metrics[ (*p)->path() + " " + (*p)->interface() + "." + (*p)->name() ] += (*p)->metrics().deliveries();
+
+    return metrics;
+  }
+
+  HandlerResult MetricsObject::handle_message( Connection::pointer connection, Message::const_pointer message )
+  {
+    ReturnMessage::pointer return_message;
+
+    if ( not message ) return Object::handle_message( connection, message );
+
+    if ( message->is_call( DBUS_CXX_METRICS_INTERFACE, "GetConnectionMetrics" ) ) {
+      return_message = CallMessage::create( message )->create_reply();
+      *return_message << connection->metrics().to_map();
+    }
+    else if ( message->is_call( DBUS_CXX_METRICS_INTERFACE, "GetMethodMetrics" ) ) {
+      return_message = CallMessage::create( message )->create_reply();
+      *return_message << this->method_metrics();
+    }
+    else if ( message->is_call( DBUS_CXX_METRICS_INTERFACE, "GetSignalMetrics" ) ) {
+      return_message = CallMessage::create( message )->create_reply();
+      *return_message << signal_metrics( connection );
+    }
+    else {
+      return Object::handle_message( connection, message );
+    }
+
+    SIMPLELOGGER_DEBUG("dbus.MetricsObject","MetricsObject::handle_message: metrics requested from " << this->path());
+
+    connection << return_message;
+    return HANDLED;
+  }
+
+  void MetricsObject::introspect_standard_interfaces( std::ostream& sout, const std::string& spaces ) const
+  {
+    Object::introspect_standard_interfaces( sout, spaces );
+    sout << spaces << "  <interface name=\"" << DBUS_CXX_METRICS_INTERFACE << "\">\n"
+         << spaces << "    <method name=\"GetConnectionMetrics\">\n"
+         << spaces << "      <arg name=\"metrics\" type=\"a{st}\" direction=\"out\"/>\n"
+         << spaces << "    </method>\n"
+         << spaces << "    <method name=\"GetMethodMetrics\">\n"
+         << spaces << "      <arg name=\"metrics\" type=\"a{sa{st}}\" direction=\"out\"/>\n"
+         << spaces << "    </method>\n"
+         << spaces << "    <method name=\"GetSignalMetrics\">\n"
+         << spaces << "      <arg name=\"metrics\" type=\"a{st}\" direction=\"out\"/>\n"
+         << spaces << "    </method>\n"
+         << spaces << "  </interface>\n";
+  }
+
+}
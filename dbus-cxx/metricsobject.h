@@ -0,0 +1,90 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by agent                                           *
+ *   agent@local                                                           *
+ *                                                                         *
+ *   This file is part of the dbus-cxx library.                            *
+ *                                                                         *
+ *   The dbus-cxx library is free software; you can redistribute it and/or *
+ *   modify it under the terms of the GNU General Public License           *
+ *   version 3 as published by the Free Software Foundation.               *
+ *                                                                         *
+ *   The dbus-cxx library is distributed in the hope that it will be       *
+ *   useful, but WITHOUT ANY WARRANTY; without even the implied warranty   *
+ *   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU   *
+ *   General Public License for more details.                              *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this software. If not see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#include <mutex>
+#include <vector>
+
+#include <dbus-cxx/object.h>
+
+#ifndef DBUSCXX_METRICSOBJECT_H
+#define DBUSCXX_METRICSOBJECT_H
+
+#define DBUS_CXX_METRICS_INTERFACE "org.dbus_cxx.Metrics"
+
+namespace DBus
+{
+
+  /**
+   * @ingroup local
+   * @ingroup objects
+   *
+   * An object exporting the metrics of the connection it is registered on
+   * through the org.dbus_cxx.Metrics interface:
+   *
+   * - GetConnectionMetrics returns the connection's counters as @c a{st}
+   * - GetMethodMetrics returns @c a{sa{st}}, the counters of every method of
+   *   the objects added with add_object() and their descendants, keyed by
+   *   "path interface.method"
+   * - GetSignalMetrics returns @c a{st}, the delivery counts of the
+   *   connection's signal proxies keyed by "path interface.member"
+   *
+   * @author agent <agent@local>
+   */
+  class MetricsObject: public Object
+  {
+    protected:
+
+      MetricsObject( const std::string& path );
+
+    public:
+
+      typedef DBusCxxPointer<MetricsObject> pointer;
+
+      static pointer create( const std::string& path = "/org/dbus_cxx/Metrics" );
+
+      virtual ~MetricsObject();
+
+      /** Reports the methods of the object and its descendants */
+      void add_object( Object::pointer object );
+
+      void remove_object( Object::pointer object );
+
+      /** The counters GetMethodMetrics returns */
+      std::map<std::string,std::map<std::string,uint64_t> > method_metrics() const;
+
+      /** The counters GetSignalMetrics returns for the given connection */
+      static std::map<std::string,uint64_t> signal_metrics( DBusCxxPointer<Connection> connection );
+
+      /** Extends the base version to answer the org.dbus_cxx.Metrics methods */
+      virtual HandlerResult handle_message( DBusCxxPointer<Connection> conn, Message::const_pointer msg );
+
+    protected:
+
+      virtual void introspect_standard_interfaces( std::ostream& sout, const std::string& spaces ) const;
+
+      static void add_method_metrics( std::map<std::string,std::map<std::string,uint64_t> >& metrics, Object::pointer object );
+
+      std::vector<Object::pointer> m_objects;
+
+      mutable std::mutex m_objects_mutex;
+
+  };
+
+}
+
+#endif
@@ -29,10 +29,15 @@ namespace DBus
 {
 
   Object::Object( const std::string& path, PrimaryFallback pf ):
-      ObjectPathHandler( path, pf )
+      ObjectPathHandler( path, pf ),
+      m_interface_table( new InterfaceTable() ),
+      m_introspection_generation( 0 ),
+      m_introspection_valid( false )
   {
     pthread_mutex_init( &m_name_mutex, NULL );
+    pthread_mutex_init( &m_introspection_mutex, NULL );
     pthread_rwlock_init( &m_interfaces_rwlock, NULL );
+    pthread_rwlock_init( &m_children_rwlock, NULL );
   }
 
   Object::pointer Object::create( const std::string& path, PrimaryFallback pf )
@@ -43,7 +48,9 @@ namespace DBus
   Object::~ Object( )
   {
     pthread_mutex_destroy( &m_name_mutex );
+    pthread_mutex_destroy( &m_introspection_mutex );
     pthread_rwlock_destroy( &m_interfaces_rwlock );
+    pthread_rwlock_destroy( &m_children_rwlock );
   }
 
   bool Object::register_with_connection(Connection::pointer conn)
@@ -51,35 +58,78 @@ namespace DBus
     SIMPLELOGGER_DEBUG("dbus.Object","Object::register_with_connection");
     if ( not ObjectPathHandler::register_with_connection(conn) ) return false;
 
-    for (Interfaces::iterator i = m_interfaces.begin(); i != m_interfaces.end(); i++)
+    Interfaces interfaces = this->copy_interfaces();
+    for (Interfaces::iterator i = interfaces.begin(); i != interfaces.end(); i++)
       i->second->set_connection(conn);
 
-    for (Children::iterator c = m_children.begin(); c != m_children.end(); c++)
+    Children children = this->copy_children();
+    for (Children::iterator c = children.begin(); c != children.end(); c++)
       c->second->register_with_connection(conn);
 
     return true;
   }
 
+  bool Object::attach_connection(Connection::pointer conn)
+  {
+    SIMPLELOGGER_DEBUG("dbus.Object","Object::attach_connection");
+    if ( not ObjectPathHandler::attach_connection(conn) ) return false;
+
+    Children children = this->copy_children();
+    for (Children::iterator c = children.begin(); c != children.end(); c++)
+      c->second->attach_connection(conn);
+
+    return true;
+  }
+
+  bool Object::detach_connection(Connection::pointer conn)
+  {
+    SIMPLELOGGER_DEBUG("dbus.Object","Object::detach_connection");
+    Children children = this->copy_children();
+    for (Children::iterator c = children.begin(); c != children.end(); c++)
+      c->second->detach_connection(conn);
+
+    return ObjectPathHandler::detach_connection(conn);
+  }
+
   const Object::Interfaces & Object::interfaces() const
   {
     return m_interfaces;
   }
 
-  Interface::pointer Object::interface( const std::string & name ) const
+  Object::Interfaces Object::copy_interfaces() const
   {
-    Interfaces::const_iterator iter;
+    Interfaces result;
 
     // ========== READ LOCK ==========
     pthread_rwlock_rdlock( &m_interfaces_rwlock );
 
-    iter = m_interfaces.find( name );
+    result = m_interfaces;
 
     // ========== UNLOCK ==========
     pthread_rwlock_unlock( &m_interfaces_rwlock );
 
-    if ( iter == m_interfaces.end() ) return Interface::pointer();
+    return result;
+  }
+
+  Interface::pointer Object::interface( const std::string & name ) const
+  {
+    DBusCxxPointer<const InterfaceTable> table = std::atomic_load( &m_interface_table );
+    InterfaceTable::ByName::const_iterator iter = table->interfaces.find( name );
+
+    if ( iter == table->interfaces.end() ) return Interface::pointer();
+
+    return iter->second.front();
+  }
+
+  void Object::publish_interfaces()
+  {
+    DBusCxxPointer<InterfaceTable> table( new InterfaceTable() );
 
-    return iter->second;
+    for ( Interfaces::iterator i = m_interfaces.begin(); i != m_interfaces.end(); i++ )
+      table->interfaces[ i->first ].push_back( i->second );
+    table->default_interface = m_default_interface;
+
+    std::atomic_store( &m_interface_table, DBusCxxPointer<const InterfaceTable>( table ) );
   }
 
   bool Object::add_interface( Interface::pointer interface )
@@ -101,9 +151,15 @@ namespace DBus
     {
       m_interface_signal_name_connections[interface] = interface->signal_name_changed().connect( sigc::bind(sigc::mem_fun(*this, &Object::on_interface_name_changed), interface));
 
+      std::vector<sigc::connection>& connections = m_interface_introspection_connections[interface];
+      connections.push_back( interface->signal_method_added().connect( sigc::mem_fun(*this, &Object::on_interface_method_changed) ) );
+      connections.push_back( interface->signal_method_removed().connect( sigc::mem_fun(*this, &Object::on_interface_method_changed) ) );
+
       m_interfaces.insert(std::make_pair(interface->name(), interface));
 
       interface->set_object(this);
+
+      this->publish_interfaces();
     }
     else
     {
@@ -113,6 +169,8 @@ namespace DBus
     // ========== UNLOCK ==========
     pthread_rwlock_unlock( &m_interfaces_rwlock );
 
+    if ( result ) this->invalidate_introspection();
+
     m_signal_interface_added.emit( interface );
 
     // TODO allow control over this
@@ -161,6 +219,14 @@ namespace DBus
         m_interface_signal_name_connections.erase(i);
         interface->set_object(NULL);
       }
+
+      InterfaceIntrospectionConnections::iterator c = m_interface_introspection_connections.find(interface);
+      if ( c != m_interface_introspection_connections.end() )
+      {
+        for ( std::vector<sigc::connection>::iterator conn = c->second.begin(); conn != c->second.end(); conn++ )
+          conn->disconnect();
+        m_interface_introspection_connections.erase(c);
+      }
     
       if ( m_default_interface == interface ) {
         old_default = m_default_interface;
@@ -168,11 +234,14 @@ namespace DBus
         need_emit_default_changed = true;
       }
 
+      this->publish_interfaces();
     }
 
     // ========== UNLOCK ==========
     pthread_rwlock_unlock( &m_interfaces_rwlock );
 
+    if ( interface ) this->invalidate_introspection();
+
     if ( interface ) m_signal_interface_removed.emit( interface );
 
     if ( need_emit_default_changed ) m_signal_default_interface_changed.emit( old_default, m_default_interface );
@@ -180,17 +249,8 @@ namespace DBus
 
   bool Object::has_interface( const std::string & name )
   {
-    Interfaces::const_iterator i;
-    
-    // ========== READ LOCK ==========
-    pthread_rwlock_rdlock( &m_interfaces_rwlock );
-
-    i = m_interfaces.find( name );
-
-    // ========== UNLOCK ==========
-    pthread_rwlock_unlock( &m_interfaces_rwlock );
-
-    return ( i != m_interfaces.end() );
+    DBusCxxPointer<const InterfaceTable> table = std::atomic_load( &m_interface_table );
+    return table->interfaces.find( name ) != table->interfaces.end();
   }
 
   Interface::pointer Object::default_interface() const
@@ -204,8 +264,8 @@ namespace DBus
     Interface::pointer old_default;
     bool result = false;
 
-    // ========== READ LOCK ==========
-    pthread_rwlock_rdlock( &m_interfaces_rwlock );
+    // ========== WRITE LOCK ==========
+    pthread_rwlock_wrlock( &m_interfaces_rwlock );
 
     iter = m_interfaces.find( new_default_name );
 
@@ -214,6 +274,7 @@ namespace DBus
       result = true;
       old_default = m_default_interface;
       m_default_interface = iter->second;
+      this->publish_interfaces();
     }
     
     // ========== UNLOCK ==========
@@ -226,11 +287,19 @@ namespace DBus
 
   void Object::remove_default_interface()
   {
-    if ( not m_default_interface ) return;
+    Interface::pointer old_default;
+
+    // ========== WRITE LOCK ==========
+    pthread_rwlock_wrlock( &m_interfaces_rwlock );
 
-    Interface::pointer old_default = m_default_interface;
+    old_default = m_default_interface;
     m_default_interface = Interface::pointer();
-    m_signal_default_interface_changed.emit( old_default, m_default_interface );
+    if ( old_default ) this->publish_interfaces();
+
+    // ========== UNLOCK ==========
+    pthread_rwlock_unlock( &m_interfaces_rwlock );
+
+    if ( old_default ) m_signal_default_interface_changed.emit( old_default, m_default_interface );
   }
 
   const Object::Children& Object::children() const
@@ -238,56 +307,206 @@ namespace DBus
     return m_children;
   }
 
+  Object::Children Object::copy_children() const
+  {
+    Children result;
+
+    // ========== READ LOCK ==========
+    pthread_rwlock_rdlock( &m_children_rwlock );
+
+    result = m_children;
+
+    // ========== UNLOCK ==========
+    pthread_rwlock_unlock( &m_children_rwlock );
+
+    return result;
+  }
+
   Object::pointer Object::child(const std::string& name) const
   {
+    Object::pointer result;
+
+    // ========== READ LOCK ==========
+    pthread_rwlock_rdlock( &m_children_rwlock );
+
     Children::const_iterator i = m_children.find(name);
-    if ( i == m_children.end() ) return Object::pointer();
-    return i->second;
+    if ( i != m_children.end() ) result = i->second;
+
+    // ========== UNLOCK ==========
+    pthread_rwlock_unlock( &m_children_rwlock );
+
+    return result;
   }
 
   bool Object::add_child(const std::string& name, Object::pointer child, bool force)
   {
+    Object::pointer old_child;
+
     if ( not child ) return false;
-    if ( not force and this->has_child(name) ) return false;
-    m_children[name] = child;
+
+    // ========== WRITE LOCK ==========
+    pthread_rwlock_wrlock( &m_children_rwlock );
+
+    Children::iterator i = m_children.find(name);
+    if ( i != m_children.end() ) old_child = i->second;
+    if ( force or not old_child ) m_children[name] = child;
+
+    // ========== UNLOCK ==========
+    pthread_rwlock_unlock( &m_children_rwlock );
+
+    if ( old_child and not force ) return false;
+
     if ( m_connection ) child->register_with_connection(m_connection);
+    this->invalidate_introspection();
+    if ( old_child ) m_signal_child_removed.emit( name, old_child );
+    m_signal_child_added.emit( name, child );
     return true;
   }
 
   bool Object::remove_child(const std::string& name)
   {
+    Object::pointer old_child;
+
+    // ========== WRITE LOCK ==========
+    pthread_rwlock_wrlock( &m_children_rwlock );
+
     Children::iterator i = m_children.find(name);
-    if ( i == m_children.end() ) return false;
-    m_children.erase(i);
+    if ( i != m_children.end() ) {
+      old_child = i->second;
+      m_children.erase(i);
+    }
+
+    // ========== UNLOCK ==========
+    pthread_rwlock_unlock( &m_children_rwlock );
+
+    if ( not old_child ) return false;
+
+    this->invalidate_introspection();
+    m_signal_child_removed.emit( name, old_child );
     return true;
   }
 
   bool Object::has_child(const std::string& name) const
   {
-    return m_children.find(name) != m_children.end();
+    return bool( this->child(name) );
   }
 
   std::string Object::introspect(int space_depth) const
+  {
+    std::string xml;
+    unsigned long generation;
+
+    // Only the top level document is ever served to peers
+    if ( space_depth != 0 ) return this->generate_introspection( space_depth );
+
+    pthread_mutex_lock( &m_introspection_mutex );
+    if ( m_introspection_valid ) xml = m_introspection;
+    generation = m_introspection_generation;
+    pthread_mutex_unlock( &m_introspection_mutex );
+
+    if ( not xml.empty() ) return xml;
+
+    xml = this->generate_introspection( 0 );
+
+    // Something changed while we were generating, so don't keep the result
+    pthread_mutex_lock( &m_introspection_mutex );
+    if ( generation == m_introspection_generation )
+    {
+      m_introspection = xml;
+      m_introspection_valid = true;
+    }
+    pthread_mutex_unlock( &m_introspection_mutex );
+
+    return xml;
+  }
+
+  void Object::invalidate_introspection()
+  {
+    pthread_mutex_lock( &m_introspection_mutex );
+    m_introspection_valid = false;
+    m_introspection_generation++;
+    m_introspection.clear();
+    pthread_mutex_unlock( &m_introspection_mutex );
+  }
+
+  unsigned long Object::introspection_generation() const
+  {
+    unsigned long result;
+    pthread_mutex_lock( &m_introspection_mutex );
+    result = m_introspection_generation;
+    pthread_mutex_unlock( &m_introspection_mutex );
+    return result;
+  }
+
+  bool Object::is_introspection_cached() const
+  {
+    bool result;
+    pthread_mutex_lock( &m_introspection_mutex );
+    result = m_introspection_valid;
+    pthread_mutex_unlock( &m_introspection_mutex );
+    return result;
+  }
+
+  std::string Object::generate_introspection(int space_depth) const
   {
     std::ostringstream sout;
     std::string spaces;
+    Interfaces interfaces = this->copy_interfaces();
+    Children children = this->copy_children();
     Interfaces::const_iterator i;
     Children::const_iterator c;
     for (int i=0; i < space_depth; i++ ) spaces += " ";
-    sout << spaces << "<node name=\"" << this->path() << "\">\n"
-         << spaces << "  <interface name=\"" << DBUS_CXX_INTROSPECTABLE_INTERFACE << "\">\n"
-         << spaces << "    <method name=\"Introspect\">\n"
-         << spaces << "      <arg name=\"data\" type=\"s\" direction=\"out\"/>\n"
-         << spaces << "    </method>\n"
-         << spaces << "  </interface>\n";
-    for ( i = m_interfaces.begin(); i != m_interfaces.end(); i++ )
+    sout << spaces << "<node name=\"" << this->path() << "\">\n";
+    this->introspect_standard_interfaces( sout, spaces );
+    for ( i = interfaces.begin(); i != interfaces.end(); i++ )
       sout << i->second->introspect(space_depth+2);
-    for ( c = m_children.begin(); c != m_children.end(); c++ )
+    for ( c = children.begin(); c != children.end(); c++ )
       sout << spaces << "  <node name=\"" << c->first << "\"/>\n";
     sout << spaces << "</node>\n";
     return sout.str();
   }
 
+  void Object::introspect_standard_interfaces( std::ostream& sout, const std::string& spaces ) const
+  {
+    Interfaces interfaces = this->copy_interfaces();
+    Interfaces::const_iterator i;
+    bool has_properties = false;
+
+    sout << spaces << "  <interface name=\"" << DBUS_CXX_INTROSPECTABLE_INTERFACE << "\">\n"
+         << spaces << "    <method name=\"Introspect\">\n"
+         << spaces << "      <arg name=\"data\" type=\"s\" direction=\"out\"/>\n"
+         << spaces << "    </method>\n"
+         << spaces << "  </interface>\n";
+
+    for ( i = interfaces.begin(); i != interfaces.end() and not has_properties; i++ )
+      has_properties = i->second->has_properties();
+
+    // Only objects with properties advertise the properties interface
+    if ( not has_properties ) return;
+
+    sout << spaces << "  <interface name=\"" << DBUS_CXX_PROPERTIES_INTERFACE << "\">\n"
+         << spaces << "    <method name=\"Get\">\n"
+         << spaces << "      <arg name=\"interface_name\" type=\"s\" direction=\"in\"/>\n"
+         << spaces << "      <arg name=\"property_name\" type=\"s\" direction=\"in\"/>\n"
+         << spaces << "      <arg name=\"value\" type=\"v\" direction=\"out\"/>\n"
+         << spaces << "    </method>\n"
+         << spaces << "    <method name=\"GetAll\">\n"
+         << spaces << "      <arg name=\"interface_name\" type=\"s\" direction=\"in\"/>\n"
+         << spaces << "      <arg name=\"properties\" type=\"a{sv}\" direction=\"out\"/>\n"
+         << spaces << "    </method>\n"
+         << spaces << "    <method name=\"Set\">\n"
+         << spaces << "      <arg name=\"interface_name\" type=\"s\" direction=\"in\"/>\n"
+         << spaces << "      <arg name=\"property_name\" type=\"s\" direction=\"in\"/>\n"
+         << spaces << "      <arg name=\"value\" type=\"v\" direction=\"in\"/>\n"
+         << spaces << "    </method>\n"
+         << spaces << "    <signal name=\"PropertiesChanged\">\n"
+         << spaces << "      <arg name=\"interface_name\" type=\"s\"/>\n"
+         << spaces << "      <arg name=\"changed_properties\" type=\"a{sv}\"/>\n"
+         << spaces << "      <arg name=\"invalidated_properties\" type=\"as\"/>\n"
+         << spaces << "    </signal>\n"
+         << spaces << "  </interface>\n";
+  }
+
   sigc::signal< void, Interface::pointer > Object::signal_interface_added()
   {
     return m_signal_interface_added;
@@ -303,86 +522,158 @@ namespace DBus
     return m_signal_default_interface_changed;
   }
 
+  sigc::signal< void, const std::string&, Object::pointer > Object::signal_child_added()
+  {
+    return m_signal_child_added;
+  }
+
+  sigc::signal< void, const std::string&, Object::pointer > Object::signal_child_removed()
+  {
+    return m_signal_child_removed;
+  }
+
   HandlerResult Object::handle_message( Connection::pointer connection , Message::const_pointer message )
   {
-    Interfaces::iterator current, upper;
-    Interface::pointer interface;
+    DBusCxxPointer<const InterfaceTable> table;
     HandlerResult result = NOT_HANDLED;
 
     SIMPLELOGGER_DEBUG("dbus.Object","Object::handle_message: before call message test");
 
-    CallMessage::const_pointer callmessage;
-    try{
-      callmessage = CallMessage::create( message );
-    }catch(DBusCxxPointer<DBus::ErrorInvalidMessageType> err){
-      return NOT_HANDLED;
-    }
+    if ( not message or message->type() != CALL_MESSAGE ) return NOT_HANDLED;
 
+    CallMessage::const_pointer callmessage = CallMessage::create( message );
     if ( not callmessage ) return NOT_HANDLED;
 
-    SIMPLELOGGER_DEBUG("dbus.Object","Object::handle_message: message is good (it's a call message) for interface '" << callmessage->interface() << "'");
+    // The interface is optional in a call; without one only the default interface is tried
+    const char* interface_name = callmessage->interface();
 
-    if ( callmessage->interface() == NULL ){
-        //If for some reason the message that we are getting has a NULL interface, we will segfault.
-        return NOT_HANDLED;
-    }
+    SIMPLELOGGER_DEBUG("dbus.Object","Object::handle_message: message is good (it's a call message) for interface '" << (interface_name ? interface_name : "") << "'");
 
     // Handle the introspection interface
-    if ( strcmp(callmessage->interface(), DBUS_CXX_INTROSPECTABLE_INTERFACE) == 0 )
+    if ( interface_name and strcmp(interface_name, DBUS_CXX_INTROSPECTABLE_INTERFACE) == 0 )
     {
       SIMPLELOGGER_DEBUG("dbus.Object","Object::handle_message: introspection interface called");
       ReturnMessage::pointer return_message = callmessage->create_reply();
       std::string introspection = DBUS_INTROSPECT_1_0_XML_DOCTYPE_DECL_NODE;
       introspection += this->introspect();
       *return_message << introspection;
-      connection << return_message;
+      if ( callmessage->expects_reply() ) connection << return_message;
       return HANDLED;
     }
 
-    // ========== READ LOCK ==========
-    pthread_rwlock_rdlock( &m_interfaces_rwlock );
+    // Handle the properties interface
+    if ( interface_name and strcmp(interface_name, DBUS_CXX_PROPERTIES_INTERFACE) == 0 )
+    {
+      SIMPLELOGGER_DEBUG("dbus.Object","Object::handle_message: properties interface called");
+      return this->handle_properties_message( connection, callmessage );
+    }
+
+    // No lock is held while the handlers run, so they may add and remove
+    // interfaces; the changes take effect for the next call
+    table = std::atomic_load( &m_interface_table );
 
-    current = m_interfaces.lower_bound( callmessage->interface() );
+    InterfaceTable::ByName::const_iterator named = table->interfaces.end();
+    if ( interface_name ) named = table->interfaces.find( interface_name );
 
-    // Do we have an interface or do we need to use the default???
-    if ( current == m_interfaces.end() )
+    if ( named != table->interfaces.end() )
+    {
+      // Iterate through each interface with a matching name
+      for ( size_t i = 0; i < named->second.size() and result == NOT_HANDLED; i++ )
+      {
+        SIMPLELOGGER_DEBUG("dbus.Object","Object::handle_message: trying to handle with interface " << named->second[i]->name() );
+        result = named->second[i]->handle_call_message(connection, callmessage);
+      }
+    }
+
+    if ( result == NOT_HANDLED and table->default_interface )
     {
       SIMPLELOGGER_DEBUG("dbus.Object","Object::handle_message: trying to handle with the default interface");
-      // Do we have have a default to use, if so use it to try and handle the message
-      if ( m_default_interface )
-        result = m_default_interface->handle_call_message(connection, callmessage);
+      result = table->default_interface->handle_call_message(connection, callmessage);
     }
-    else
+
+    SIMPLELOGGER_DEBUG("dbus.Object","Object::handle_message: message was " << ((result==HANDLED)?"handled":"not handled"));
+
+    return result;
+  }
+
+  HandlerResult Object::handle_properties_message( Connection::pointer connection, CallMessage::const_pointer callmessage )
+  {
+    std::string member;
+    std::string interface_name;
+    std::string property_name;
+    Interface::pointer iface;
+    PropertyBase::pointer property;
+    ReturnMessage::pointer return_message;
+    Connection::pointer replies;
+
+    if ( callmessage->member() == NULL ) return NOT_HANDLED;
+
+    // Sending to a null pointer is a no-op, so calls that expect no reply get none
+    if ( callmessage->expects_reply() ) replies = connection;
+    member = callmessage->member();
+
+    if ( member != "Get" and member != "GetAll" and member != "Set" ) return NOT_HANDLED;
+
+    Message::iterator i = callmessage->begin();
+
+    if ( not i.try_get( interface_name ) or ( member != "GetAll" and not i.try_get( property_name ) ) )
     {
-      // Set up the upper limit of interfaces
-      upper = m_interfaces.upper_bound( callmessage->interface() );
+      replies << ErrorMessage::create( callmessage, DBUS_ERROR_INVALID_ARGS, "Expected interface and property names" );
+      return HANDLED;
+    }
 
+    iface = this->interface( interface_name );
+    if ( not iface )
+    {
+      replies << ErrorMessage::create( callmessage, DBUS_ERROR_UNKNOWN_INTERFACE, "No such interface '" + interface_name + "'" );
+      return HANDLED;
+    }
 
-    SIMPLELOGGER_DEBUG("dbus.Object","Object::handle_message: before handling lower bound interface is " << current->second->name() );
-    SIMPLELOGGER_DEBUG("dbus.Object","Object::handle_message: before handling upper bound interface is " << (upper->second ? upper->second->name() : ""));
+    if ( member == "GetAll" )
+    {
+      return_message = callmessage->create_reply();
+      MessageAppendIterator append( *return_message );
+      iface->append_properties( append );
+      replies << return_message;
+      return HANDLED;
+    }
 
-      // Iterate through each interface with a matching name
-      for ( ; current != upper; current++ )
+    property = iface->property( property_name );
+    if ( not property )
+    {
+      replies << ErrorMessage::create( callmessage, DBUS_ERROR_UNKNOWN_PROPERTY, "No such property '" + property_name + "'" );
+      return HANDLED;
+    }
+
+    if ( member == "Get" )
+    {
+      if ( not property->is_readable() )
       {
-        SIMPLELOGGER_DEBUG("dbus.Object","Object::handle_message: trying to handle with interface " << current->second->name() );
-        // If an interface handled the message unlock and return
-        if ( current->second->handle_call_message(connection, callmessage) == HANDLED )
-        {
-          result = HANDLED;
-          break;
-        }
+        replies << ErrorMessage::create( callmessage, DBUS_ERROR_ACCESS_DENIED, "Property '" + property_name + "' is not readable" );
+        return HANDLED;
       }
+      return_message = callmessage->create_reply();
+      MessageAppendIterator append( *return_message );
+      property->append_variant( append );
+      replies << return_message;
+      return HANDLED;
     }
 
-    if (result == NOT_HANDLED and m_default_interface)
-      result = m_default_interface->handle_call_message(connection, callmessage);
+    if ( not property->is_writable() )
+    {
+      replies << ErrorMessage::create( callmessage, DBUS_ERROR_PROPERTY_READ_ONLY, "Property '" + property_name + "' is read-only" );
+      return HANDLED;
+    }
 
-    // ========== UNLOCK ==========
-    pthread_rwlock_unlock( &m_interfaces_rwlock );
+    if ( not property->set_variant( i ) )
+    {
+      replies << ErrorMessage::create( callmessage, DBUS_ERROR_INVALID_ARGS, "Expected a variant of type '" + property->signature() + "'" );
+      return HANDLED;
+    }
 
-    SIMPLELOGGER_DEBUG("dbus.Object","Object::handle_message: message was " << ((result==HANDLED)?"handled":"not handled"));
+    replies << callmessage->create_reply();
 
-    return result;
+    return HANDLED;
   }
 
   void Object::on_interface_name_changed(const std::string & oldname, const std::string & newname, Interface::pointer interface)
@@ -410,6 +701,10 @@ namespace DBus
 
     m_interfaces.insert( std::make_pair(newname, interface) );
 
+    this->publish_interfaces();
+
+    this->invalidate_introspection();
+
     InterfaceSignalNameConnections::iterator i;
     i = m_interface_signal_name_connections.find(interface);
     if ( i == m_interface_signal_name_connections.end() )
@@ -422,6 +717,10 @@ namespace DBus
     pthread_rwlock_unlock( &m_interfaces_rwlock );
   }
 
+  void Object::on_interface_method_changed( MethodBase::pointer method )
+  {
+    this->invalidate_introspection();
+  }
 
 }
 
@@ -163,9 +163,14 @@ dnl
 
 #include <string>
 #include <map>
+#include <memory>
+#include <ostream>
+#include <unordered_map>
+#include <vector>
 
 #include <dbus-cxx/forward_decls.h>
 #include <dbus-cxx/objectpathhandler.h>
+#include <dbus-cxx/callmessage.h>
 #include <dbus-cxx/dbus_signal.h>
 
 #ifndef DBUSCXXOBJECT_H
@@ -287,9 +292,18 @@ namespace DBus
       /** Extends base version to include registering signals */
       virtual bool register_with_connection(DBusCxxPointer<Connection> conn);
 
+      /** Extends base version to attach the children as well */
+      virtual bool attach_connection(DBusCxxPointer<Connection> conn);
+
+      /** Extends base version to detach the children as well */
+      virtual bool detach_connection(DBusCxxPointer<Connection> conn);
+
       /** Get all the interfaces associated with this Object instance */
       const Interfaces& interfaces() const;
 
+      /** Returns a copy of the interfaces, taken under the lock, to iterate while they change */
+      Interfaces copy_interfaces() const;
+
       /** Returns the first interface with the given name */
       DBusCxxPointer<Interface> interface( const std::string& name ) const;
 
@@ -345,9 +359,24 @@ FOR(0, eval(CALL_SIZE),[[DECLARE_CREATE_SIGNAL_N(%1)
 FOR(0, eval(CALL_SIZE),[[DECLARE_CREATE_SIGNAL_IN(%1)
 ]])
 
+      /**
+       * Creates a property and adds it to the named interface, creating the
+       * interface if necessary.
+       * @return A smart pointer to the newly created property
+       */
+      template <class T_type>
+      DBusCxxPointer<Property<T_type> >
+      create_property( const std::string& interface_name,
+                       const std::string& property_name,
+                       PropertyAccess access=PROPERTY_READ,
+                       PropertyUpdateType update=PROPERTY_UPDATE_EMITS_CHANGE );
+
       /** Get the children associated with this object instance */
       const Children& children() const;
 
+      /** Returns a copy of the children, taken under the lock, to iterate while they change */
+      Children copy_children() const;
+
       /**
        * Get a named child of this object
        * @return A smart pointer to a child with the specified name, or a null smart pointer if no child found.
@@ -380,9 +409,33 @@ FOR(0, eval(CALL_SIZE),[[DECLARE_CREATE_SIGNAL_IN(%1)
        */
       bool has_child(const std::string& name) const;
 
-      /** Returns a DBus XML description of this interface */
+      /**
+       * Returns a DBus XML description of this object
+       *
+       * The description at depth 0 is generated once and served from a
+       * cache until an interface, method, signal, property or child is
+       * added, removed or renamed.
+       */
       std::string introspect(int space_depth=0) const;
 
+      /**
+       * Discards the cached introspection XML.
+       *
+       * Changes made through this object and its interfaces do this
+       * automatically; call it after changing something that isn't tracked,
+       * such as the argument names of an exported method.
+       */
+      void invalidate_introspection();
+
+      /**
+       * Counts the changes that have discarded the cached introspection XML.
+       * introspect() leaves it alone while it serves the cache.
+       */
+      unsigned long introspection_generation() const;
+
+      /** True if the next introspect() will be served from the cache */
+      bool is_introspection_cached() const;
+
       /**
        * Signal emitted when an interface is added to this object.
        *
@@ -406,12 +459,29 @@ FOR(0, eval(CALL_SIZE),[[DECLARE_CREATE_SIGNAL_IN(%1)
        */
       sigc::signal<void,DBusCxxPointer<Interface> /*old default*/,DBusCxxPointer<Interface> /*new default*/> signal_default_interface_changed();
 
+      /**
+       * Signal emitted when a child is added to this object.
+       *
+       * The parameters of the callback are the child's name and a pointer to the child.
+       */
+      sigc::signal<void,const std::string&,Object::pointer> signal_child_added();
+
+      /**
+       * Signal emitted when a child is removed from this object.
+       *
+       * The parameters of the callback are the child's name and a pointer to the removed child.
+       */
+      sigc::signal<void,const std::string&,Object::pointer> signal_child_removed();
+
       /**
        * Handles the specified message on the specified connection
        *
        * If \c msg is an introspection message, the object will rely on its
        * \c introspection() method to provide a reply.
        *
+       * Calls to org.freedesktop.DBus.Properties are answered from the
+       * properties of the interface named in the call.
+       *
        * Looks for interfaces specified in the message first. If the message
        * does not specify an interface or the specified interface is not found
        * the default interface will be used.
@@ -432,7 +502,11 @@ FOR(0, eval(CALL_SIZE),[[DECLARE_CREATE_SIGNAL_IN(%1)
     protected:
 
       Children m_children;
+
+      /** Serializes access to the children */
+      mutable pthread_rwlock_t m_children_rwlock;
       
+      /** Serializes changes to the interfaces; lookups take no lock */
       mutable pthread_rwlock_t m_interfaces_rwlock;
 
       pthread_mutex_t m_name_mutex;
@@ -441,6 +515,26 @@ FOR(0, eval(CALL_SIZE),[[DECLARE_CREATE_SIGNAL_IN(%1)
 
       DBusCxxPointer<Interface>  m_default_interface;
 
+      /**
+       * The interfaces by name and the default interface, as looked up by
+       * handle_message().
+       *
+       * Like Interface::MethodTable, a table is never changed once
+       * published; writers swap in a new one under the write lock.
+       */
+      struct InterfaceTable
+      {
+        typedef std::unordered_map<std::string, std::vector<DBusCxxPointer<Interface> > > ByName;
+        ByName interfaces;
+        DBusCxxPointer<Interface> default_interface;
+      };
+
+      /** Only accessed through std::atomic_load() and std::atomic_store() */
+      DBusCxxPointer<const InterfaceTable> m_interface_table;
+
+      /** Publishes a table built from m_interfaces; the write lock must be held */
+      void publish_interfaces();
+
       sigc::signal<void,DBusCxxPointer<Interface> ,DBusCxxPointer<Interface> > m_signal_default_interface_changed;
 
       sigc::signal<void,DBusCxxPointer<Interface> > m_signal_interface_added;
@@ -451,12 +545,44 @@ FOR(0, eval(CALL_SIZE),[[DECLARE_CREATE_SIGNAL_IN(%1)
 
       InterfaceSignalNameConnections m_interface_signal_name_connections;
 
+      sigc::signal<void,const std::string&,Object::pointer> m_signal_child_added;
+
+      sigc::signal<void,const std::string&,Object::pointer> m_signal_child_removed;
+
+      typedef std::map<DBusCxxPointer<Interface>,std::vector<sigc::connection> > InterfaceIntrospectionConnections;
+
+      InterfaceIntrospectionConnections m_interface_introspection_connections;
+
+      mutable pthread_mutex_t m_introspection_mutex;
+
+      mutable std::string m_introspection;
+
+      /** Bumped on every invalidation so a stale result is never cached */
+      mutable unsigned long m_introspection_generation;
+
+      mutable bool m_introspection_valid;
+
+      /** Generates the XML that introspect() caches */
+      std::string generate_introspection(int space_depth) const;
+
+      void on_interface_method_changed( DBusCxxPointer<MethodBase> method );
+
+      /**
+       * Writes the XML of the standard interfaces this object answers itself,
+       * such as org.freedesktop.DBus.Introspectable. Derived classes that
+       * answer further interfaces in handle_message() extend this.
+       */
+      virtual void introspect_standard_interfaces( std::ostream& sout, const std::string& spaces ) const;
+
       /**
        * Callback point that updates the interface name map when an interface
        * changes its name.
        */
       void on_interface_name_changed(const std::string& oldname, const std::string& newname, DBusCxxPointer<Interface>  interface);
 
+      /** Answers Get, GetAll and Set on the org.freedesktop.DBus.Properties interface */
+      HandlerResult handle_properties_message( DBusCxxPointer<Connection> conn, CallMessage::const_pointer msg );
+
   };
 
 }
@@ -478,6 +604,16 @@ FOR(0, eval(CALL_SIZE),[[DEFINE_CREATE_SIGNAL_N(%1)
 FOR(0, eval(CALL_SIZE),[[DEFINE_CREATE_SIGNAL_IN(%1)
 ]])
 
+  template <class T_type>
+  DBusCxxPointer<Property<T_type> >
+  Object::create_property( const std::string& interface_name, const std::string& property_name, PropertyAccess access, PropertyUpdateType update )
+  {
+    Interface::pointer iface;
+    iface = this->interface(interface_name);
+    if ( not iface ) iface = this->create_interface(interface_name);
+    return iface->create_property<T_type>(property_name, access, update);
+  }
+
 }
 
 
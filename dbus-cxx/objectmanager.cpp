@@ -0,0 +1,294 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by agent                                           *
+ *   agent@local                                                           *
+ *                                                                         *
+ *   This file is part of the dbus-cxx library.                            *
+ *                                                                         *
+ *   The dbus-cxx library is free software; you can redistribute it and/or *
+ *   modify it under the terms of the GNU General Public License           *
+ *   version 3 as published by the Free Software Foundation.               *
+ *                                                                         *
+ *   The dbus-cxx library is distributed in the hope that it will be       *
+ *   useful, but WITHOUT ANY WARRANTY; without even the implied warranty   *
+ *   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU   *
+ *   General Public License for more details.                              *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this software. If not see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#include "objectmanager.h"
+#include "connection.h"
+#include "dbus-cxx-private.h"
+
+namespace DBus
+{
+
+  ObjectManager::ObjectManager( const std::string& path, PrimaryFallback pf ):
+      Object( path, pf )
+  {
+    m_signal_child_added.connect( sigc::mem_fun(*this, &ObjectManager::on_child_added) );
+    m_signal_child_removed.connect( sigc::mem_fun(*this, &ObjectManager::on_child_removed) );
+  }
+
+  ObjectManager::pointer ObjectManager::create( const std::string& path, PrimaryFallback pf )
+  {
+    return pointer( new ObjectManager( path, pf ) );
+  }
+
+  ObjectManager::~ObjectManager()
+  {
+    TrackedObjects::iterator i;
+    std::vector<sigc::connection>::iterator c;
+
+    for ( i = m_tracked_objects.begin(); i != m_tracked_objects.end(); i++ )
+      for ( c = i->second.begin(); c != i->second.end(); c++ )
+        c->disconnect();
+  }
+
+  std::vector<Object::pointer> ObjectManager::managed_objects() const
+  {
+    std::vector<Object::pointer> objects;
+    Children children = this->copy_children();
+    Children::const_iterator c;
+    size_t current;
+
+    for ( c = children.begin(); c != children.end(); c++ )
+      objects.push_back( c->second );
+
+    // Breadth first, so the vector grows as we walk it
+    for ( current = 0; current < objects.size(); current++ )
+    {
+      children = objects[current]->copy_children();
+      for ( c = children.begin(); c != children.end(); c++ )
+        objects.push_back( c->second );
+    }
+
+    return objects;
+  }
+
+  HandlerResult ObjectManager::handle_message( Connection::pointer connection, Message::const_pointer message )
+  {
+    CallMessage::const_pointer callmessage;
+    ReturnMessage::pointer return_message;
+    Children children;
+    Children::iterator c;
+
+    if ( not message or not message->is_call( DBUS_CXX_OBJECT_MANAGER_INTERFACE, "GetManagedObjects" ) )
+      return Object::handle_message( connection, message );
+
+    SIMPLELOGGER_DEBUG("dbus.ObjectManager","ObjectManager::handle_message: GetManagedObjects called on " << this->path());
+
+    callmessage = CallMessage::create( message );
+    return_message = callmessage->create_reply();
+
+    children = this->copy_children();
+    MessageAppendIterator iter( *return_message );
+    iter.open_container( CONTAINER_ARRAY, "{oa{sa{sv}}}" );
+    for ( c = children.begin(); c != children.end(); c++ )
+      append_managed_object( *iter.sub_iterator(), c->second );
+    iter.close_container();
+
+    connection << return_message;
+    return HANDLED;
+  }
+
+  void ObjectManager::introspect_standard_interfaces( std::ostream& sout, const std::string& spaces ) const
+  {
+    Object::introspect_standard_interfaces( sout, spaces );
+    sout << spaces << "  <interface name=\"" << DBUS_CXX_OBJECT_MANAGER_INTERFACE << "\">\n"
+         << spaces << "    <method name=\"GetManagedObjects\">\n"
+         << spaces << "      <arg name=\"objpath_interfaces_and_properties\" type=\"a{oa{sa{sv}}}\" direction=\"out\"/>\n"
+         << spaces << "    </method>\n"
+         << spaces << "    <signal name=\"InterfacesAdded\">\n"
+         << spaces << "      <arg name=\"object_path\" type=\"o\"/>\n"
+         << spaces << "      <arg name=\"interfaces_and_properties\" type=\"a{sa{sv}}\"/>\n"
+         << spaces << "    </signal>\n"
+         << spaces << "    <signal name=\"InterfacesRemoved\">\n"
+         << spaces << "      <arg name=\"object_path\" type=\"o\"/>\n"
+         << spaces << "      <arg name=\"interfaces\" type=\"as\"/>\n"
+         << spaces << "    </signal>\n"
+         << spaces << "  </interface>\n";
+  }
+
+  bool ObjectManager::append_interfaces( MessageAppendIterator& iter, Object::pointer object )
+  {
+    Interfaces interfaces = object->copy_interfaces();
+    Interfaces::const_iterator i;
+    MessageAppendIterator* dict;
+
+    if ( not iter.open_container( CONTAINER_ARRAY, "{sa{sv}}" ) ) return false;
+    dict = iter.sub_iterator();
+
+    // Methods added without an interface name can't be named to peers
+    for ( i = interfaces.begin(); i != interfaces.end(); i++ )
+    {
+      if ( i->first.empty() ) continue;
+      dict->open_container( CONTAINER_DICT_ENTRY, std::string() );
+      dict->sub_iterator()->append( i->first );
+      i->second->append_properties( *dict->sub_iterator() );
+      dict->close_container();
+    }
+
+    return iter.close_container();
+  }
+
+  void ObjectManager::append_managed_object( MessageAppendIterator& dict, Object::pointer object )
+  {
+    Children children = object->copy_children();
+    Children::const_iterator c;
+
+    dict.open_container( CONTAINER_DICT_ENTRY, std::string() );
+    dict.sub_iterator()->append( object->path() );
+    append_interfaces( *dict.sub_iterator(), object );
+    dict.close_container();
+
+    for ( c = children.begin(); c != children.end(); c++ )
+      append_managed_object( dict, c->second );
+  }
+
+  void ObjectManager::track( Object::pointer object, bool announce )
+  {
+    std::vector<sigc::connection> connections;
+    std::vector<Interface::pointer> interfaces;
+    Interfaces object_interfaces;
+    Interfaces::const_iterator i;
+    Children children;
+    Children::const_iterator c;
+
+    if ( not object ) return;
+
+    {
+      std::lock_guard<std::mutex> lock( m_tracked_objects_mutex );
+      if ( m_tracked_objects.find( object.get() ) != m_tracked_objects.end() ) return;
+
+      connections.push_back( object->signal_interface_added().connect( sigc::bind( sigc::mem_fun(*this, &ObjectManager::on_interface_added), object.get() ) ) );
+      connections.push_back( object->signal_interface_removed().connect( sigc::bind( sigc::mem_fun(*this, &ObjectManager::on_interface_removed), object.get() ) ) );
+      connections.push_back( object->signal_child_added().connect( sigc::mem_fun(*this, &ObjectManager::on_child_added) ) );
+      connections.push_back( object->signal_child_removed().connect( sigc::mem_fun(*this, &ObjectManager::on_child_removed) ) );
+      m_tracked_objects[object.get()] = connections;
+    }
+
+    // Copies, as the tree may change under us from another thread
+    object_interfaces = object->copy_interfaces();
+    children = object->copy_children();
+
+    if ( announce )
+    {
+      for ( i = object_interfaces.begin(); i != object_interfaces.end(); i++ )
+        if ( not i->first.empty() ) interfaces.push_back( i->second );
+      if ( not interfaces.empty() ) this->send_interfaces_added( object->path(), interfaces );
+    }
+
+    for ( c = children.begin(); c != children.end(); c++ )
+      this->track( c->second, announce );
+  }
+
+  void ObjectManager::untrack( Object::pointer object, bool announce )
+  {
+    TrackedObjects::iterator t;
+    std::vector<sigc::connection>::iterator conn;
+    std::vector<std::string> interfaces;
+    Interfaces object_interfaces;
+    Interfaces::const_iterator i;
+    Children children;
+    Children::const_iterator c;
+
+    if ( not object ) return;
+
+    {
+      std::lock_guard<std::mutex> lock( m_tracked_objects_mutex );
+      t = m_tracked_objects.find( object.get() );
+      if ( t == m_tracked_objects.end() ) return;
+      for ( conn = t->second.begin(); conn != t->second.end(); conn++ )
+        conn->disconnect();
+      m_tracked_objects.erase( t );
+    }
+
+    // Copies, as the tree may change under us from another thread
+    object_interfaces = object->copy_interfaces();
+    children = object->copy_children();
+
+    if ( announce )
+    {
+      for ( i = object_interfaces.begin(); i != object_interfaces.end(); i++ )
+        if ( not i->first.empty() ) interfaces.push_back( i->first );
+      if ( not interfaces.empty() ) this->send_interfaces_removed( object->path(), interfaces );
+    }
+
+    for ( c = children.begin(); c != children.end(); c++ )
+      this->untrack( c->second, announce );
+  }
+
+  void ObjectManager::on_child_added( const std::string& name, Object::pointer child )
+  {
+    this->track( child, true );
+  }
+
+  void ObjectManager::on_child_removed( const std::string& name, Object::pointer child )
+  {
+    this->untrack( child, true );
+  }
+
+  void ObjectManager::on_interface_added( Interface::pointer interface, Object* object )
+  {
+    std::vector<Interface::pointer> interfaces;
+
+    if ( not interface or interface->name().empty() ) return;
+
+    interfaces.push_back( interface );
+    this->send_interfaces_added( object->path(), interfaces );
+  }
+
+  void ObjectManager::on_interface_removed( Interface::pointer interface, Object* object )
+  {
+    std::vector<std::string> interfaces;
+
+    if ( not interface or interface->name().empty() ) return;
+
+    interfaces.push_back( interface->name() );
+    this->send_interfaces_removed( object->path(), interfaces );
+  }
+
+  void ObjectManager::send_interfaces_added( const std::string& path, const std::vector<Interface::pointer>& interfaces )
+  {
+    std::vector<Interface::pointer>::const_iterator i;
+    MessageAppendIterator* dict;
+    SignalMessage::pointer msg;
+
+    if ( not m_connection ) return;
+
+    SIMPLELOGGER_DEBUG("dbus.ObjectManager","ObjectManager::send_interfaces_added " << path << " (" << interfaces.size() << " interfaces)");
+
+    msg = SignalMessage::create( this->path(), DBUS_CXX_OBJECT_MANAGER_INTERFACE, "InterfacesAdded" );
+
+    MessageAppendIterator iter( *msg );
+    iter << Path( path );
+    iter.open_container( CONTAINER_ARRAY, "{sa{sv}}" );
+    dict = iter.sub_iterator();
+    for ( i = interfaces.begin(); i != interfaces.end(); i++ )
+    {
+      dict->open_container( CONTAINER_DICT_ENTRY, std::string() );
+      dict->sub_iterator()->append( (*i)->name() );
+      (*i)->append_properties( *dict->sub_iterator() );
+      dict->close_container();
+    }
+    iter.close_container();
+
+    m_connection << msg;
+  }
+
+  void ObjectManager::send_interfaces_removed( const std::string& path, const std::vector<std::string>& interfaces )
+  {
+    SignalMessage::pointer msg;
+
+    if ( not m_connection ) return;
+
+    SIMPLELOGGER_DEBUG("dbus.ObjectManager","ObjectManager::send_interfaces_removed " << path << " (" << interfaces.size() << " interfaces)");
+
+    msg = SignalMessage::create( this->path(), DBUS_CXX_OBJECT_MANAGER_INTERFACE, "InterfacesRemoved" );
+    *msg << Path( path ) << interfaces;
+
+    m_connection << msg;
+  }
+
+}
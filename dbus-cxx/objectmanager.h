@@ -0,0 +1,109 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by agent                                           *
+ *   agent@local                                                           *
+ *                                                                         *
+ *   This file is part of the dbus-cxx library.                            *
+ *                                                                         *
+ *   The dbus-cxx library is free software; you can redistribute it and/or *
+ *   modify it under the terms of the GNU General Public License           *
+ *   version 3 as published by the Free Software Foundation.               *
+ *                                                                         *
+ *   The dbus-cxx library is distributed in the hope that it will be       *
+ *   useful, but WITHOUT ANY WARRANTY; without even the implied warranty   *
+ *   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU   *
+ *   General Public License for more details.                              *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this software. If not see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#include <map>
+#include <mutex>
+#include <vector>
+
+#include <dbus-cxx/object.h>
+
+#ifndef DBUSCXX_OBJECTMANAGER_H
+#define DBUSCXX_OBJECTMANAGER_H
+
+#define DBUS_CXX_OBJECT_MANAGER_INTERFACE "org.freedesktop.DBus.ObjectManager"
+
+namespace DBus
+{
+
+  /**
+   * @ingroup local
+   * @ingroup objects
+   *
+   * An object implementing org.freedesktop.DBus.ObjectManager for the
+   * objects below it in the child tree.
+   *
+   * GetManagedObjects is answered with every descendant, its interfaces
+   * and their readable properties in a single reply. Afterwards the
+   * manager follows the tree and emits InterfacesAdded and
+   * InterfacesRemoved for just the objects and interfaces that changed,
+   * so peers never need to walk the tree with Introspect.
+   *
+   * @author agent <agent@local>
+   */
+  class ObjectManager: public Object
+  {
+    protected:
+
+      ObjectManager( const std::string& path, PrimaryFallback pf=PRIMARY );
+
+    public:
+
+      typedef DBusCxxPointer<ObjectManager> pointer;
+
+      static pointer create( const std::string& path = std::string(), PrimaryFallback pf=PRIMARY );
+
+      virtual ~ObjectManager();
+
+      /** Returns every object below this one in the child tree */
+      std::vector<Object::pointer> managed_objects() const;
+
+      /**
+       * Extends the base version to answer GetManagedObjects on the
+       * org.freedesktop.DBus.ObjectManager interface.
+       */
+      virtual HandlerResult handle_message( DBusCxxPointer<Connection> conn, Message::const_pointer msg );
+
+    protected:
+
+      virtual void introspect_standard_interfaces( std::ostream& sout, const std::string& spaces ) const;
+
+      /** Appends the a{sa{sv}} description of the object's named interfaces */
+      static bool append_interfaces( MessageAppendIterator& iter, Object::pointer object );
+
+      /** Appends a dict entry for the object and recurses into its children */
+      static void append_managed_object( MessageAppendIterator& dict, Object::pointer object );
+
+      /** Follows the object and its descendants, announcing them if requested */
+      void track( Object::pointer object, bool announce );
+
+      /** Stops following the object and its descendants, announcing their removal if requested */
+      void untrack( Object::pointer object, bool announce );
+
+      void on_child_added( const std::string& name, Object::pointer child );
+
+      void on_child_removed( const std::string& name, Object::pointer child );
+
+      void on_interface_added( DBusCxxPointer<Interface> interface, Object* object );
+
+      void on_interface_removed( DBusCxxPointer<Interface> interface, Object* object );
+
+      void send_interfaces_added( const std::string& path, const std::vector<DBusCxxPointer<Interface> >& interfaces );
+
+      void send_interfaces_removed( const std::string& path, const std::vector<std::string>& interfaces );
+
+      typedef std::map<Object*,std::vector<sigc::connection> > TrackedObjects;
+
+      TrackedObjects m_tracked_objects;
+
+      std::mutex m_tracked_objects_mutex;
+
+  };
+
+}
+
+#endif
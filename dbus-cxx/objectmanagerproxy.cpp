@@ -0,0 +1,275 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by agent                                           *
+ *   agent@local                                                           *
+ *                                                                         *
+ *   This file is part of the dbus-cxx library.                            *
+ *                                                                         *
+ *   The dbus-cxx library is free software; you can redistribute it and/or *
+ *   modify it under the terms of the GNU General Public License           *
+ *   version 3 as published by the Free Software Foundation.               *
+ *                                                                         *
+ *   The dbus-cxx library is distributed in the hope that it will be       *
+ *   useful, but WITHOUT ANY WARRANTY; without even the implied warranty   *
+ *   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU   *
+ *   General Public License for more details.                              *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this software. If not see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#include "objectmanagerproxy.h"
+#include "objectmanager.h"
+#include "connection.h"
+#include "dbus-cxx-private.h"
+
+namespace DBus
+{
+
+  ObjectManagerProxy::ObjectManagerProxy( Connection::pointer conn, const std::string& destination, const std::string& path ):
+      ObjectProxy( conn, destination, path ),
+      m_loaded( false ),
+      m_refresh_handled( true )
+  {
+  }
+
+  ObjectManagerProxy::pointer ObjectManagerProxy::create( Connection::pointer conn, const std::string& destination, const std::string& path )
+  {
+    pointer proxy( new ObjectManagerProxy( conn, destination, path ) );
+    proxy->refresh();
+    return proxy;
+  }
+
+  ObjectManagerProxy::~ObjectManagerProxy()
+  {
+    if ( not m_connection ) return;
+    if ( m_interfaces_added_proxy ) m_connection->remove_signal_proxy( m_interfaces_added_proxy );
+    if ( m_interfaces_removed_proxy ) m_connection->remove_signal_proxy( m_interfaces_removed_proxy );
+  }
+
+  bool ObjectManagerProxy::refresh( int timeout_milliseconds )
+  {
+    CallMessage::pointer call;
+    PendingCall::pointer pending;
+
+    // Subscribe before asking for the tree so no change can fall in between
+    this->subscribe();
+
+    call = this->create_call_message( DBUS_CXX_OBJECT_MANAGER_INTERFACE, "GetManagedObjects" );
+    pending = this->call_async( call, timeout_milliseconds );
+    if ( not pending ) return false;
+
+    {
+      std::lock_guard<std::mutex> lock( m_objects_mutex );
+      m_refresh_call = pending;
+      m_refresh_handled = false;
+    }
+
+    pending->signal_notify().connect( sigc::mem_fun(*this, &ObjectManagerProxy::on_refresh_reply) );
+
+    // The reply may have arrived before we were connected to the notification
+    if ( pending->completed() ) this->on_refresh_reply();
+
+    return true;
+  }
+
+  bool ObjectManagerProxy::is_loaded() const
+  {
+    std::lock_guard<std::mutex> lock( m_objects_mutex );
+    return m_loaded;
+  }
+
+  ObjectManagerProxy::ManagedObjects ObjectManagerProxy::managed_objects() const
+  {
+    std::lock_guard<std::mutex> lock( m_objects_mutex );
+    return m_objects;
+  }
+
+  bool ObjectManagerProxy::has_object( const Path& path ) const
+  {
+    std::lock_guard<std::mutex> lock( m_objects_mutex );
+    return m_objects.find( path ) != m_objects.end();
+  }
+
+  std::set<std::string> ObjectManagerProxy::object_interfaces( const Path& path ) const
+  {
+    std::lock_guard<std::mutex> lock( m_objects_mutex );
+    ManagedObjects::const_iterator i = m_objects.find( path );
+    if ( i == m_objects.end() ) return std::set<std::string>();
+    return i->second;
+  }
+
+  sigc::signal<void> ObjectManagerProxy::signal_refreshed()
+  {
+    return m_signal_refreshed;
+  }
+
+  sigc::signal<void,const Path&,const std::set<std::string>&> ObjectManagerProxy::signal_interfaces_added()
+  {
+    return m_signal_interfaces_added;
+  }
+
+  sigc::signal<void,const Path&,const std::set<std::string>&> ObjectManagerProxy::signal_interfaces_removed()
+  {
+    return m_signal_interfaces_removed;
+  }
+
+  std::string ObjectManagerProxy::name_owner() const
+  {
+    PendingCall::pointer pending;
+    Message::pointer reply;
+    std::string owner;
+
+    // Unique names and peer connections need no lookup
+    if ( m_destination.empty() or m_destination[0] == ':' ) return m_destination;
+
+    CallMessage::pointer msg = CallMessage::create( DBUS_SERVICE_DBUS, DBUS_PATH_DBUS, DBUS_INTERFACE_DBUS, "GetNameOwner" );
+    msg << m_destination;
+
+    pending = m_connection->send_with_reply_async( msg );
+    if ( not pending ) return m_destination;
+    m_connection->flush();
+    pending->block();
+    reply = pending->steal_reply();
+
+    if ( not reply or reply->type() != RETURN_MESSAGE or not dbus_message_has_signature( reply->cobj(), "s" ) )
+      return m_destination;
+
+    reply >> owner;
+    return owner;
+  }
+
+  void ObjectManagerProxy::subscribe()
+  {
+    std::string owner;
+
+    if ( not m_connection ) return;
+
+    // Signals carry the unique name of the sender, so a well known
+    // destination is resolved to its current owner before matching
+    owner = this->name_owner();
+    if ( m_interfaces_added_proxy and m_interfaces_added_proxy->sender() == owner ) return;
+
+    if ( m_interfaces_added_proxy ) m_connection->remove_signal_proxy( m_interfaces_added_proxy );
+    if ( m_interfaces_removed_proxy ) m_connection->remove_signal_proxy( m_interfaces_removed_proxy );
+
+    // The sender has to be set before the proxy adds its match rule
+    m_interfaces_added_proxy = signal_proxy_simple::create( m_path, DBUS_CXX_OBJECT_MANAGER_INTERFACE, "InterfacesAdded" );
+    m_interfaces_added_proxy->set_sender( owner );
+    m_interfaces_added_proxy->signal_dbus_incoming().connect( sigc::mem_fun(*this, &ObjectManagerProxy::on_interfaces_added) );
+    m_connection->add_signal_proxy( m_interfaces_added_proxy );
+
+    m_interfaces_removed_proxy = signal_proxy_simple::create( m_path, DBUS_CXX_OBJECT_MANAGER_INTERFACE, "InterfacesRemoved" );
+    m_interfaces_removed_proxy->set_sender( owner );
+    m_interfaces_removed_proxy->signal_dbus_incoming().connect( sigc::mem_fun(*this, &ObjectManagerProxy::on_interfaces_removed) );
+    m_connection->add_signal_proxy( m_interfaces_removed_proxy );
+  }
+
+  void ObjectManagerProxy::on_refresh_reply()
+  {
+    PendingCall::pointer pending;
+    Message::pointer reply;
+    ManagedObjects objects;
+
+    {
+      std::lock_guard<std::mutex> lock( m_objects_mutex );
+      if ( m_refresh_handled or not m_refresh_call ) return;
+      if ( not m_refresh_call->completed() ) return;
+      m_refresh_handled = true;
+      pending = m_refresh_call;
+    }
+
+    reply = pending->steal_reply();
+    if ( not reply or reply->type() != RETURN_MESSAGE )
+    {
+      SIMPLELOGGER_DEBUG("dbus.ObjectManagerProxy","ObjectManagerProxy::on_refresh_reply: GetManagedObjects on " << m_path << " failed");
+      return;
+    }
+
+    MessageIterator iter = reply->begin();
+    if ( iter.arg_type() != TYPE_ARRAY ) return;
+
+    for ( MessageIterator entries = iter.recurse(); entries.is_valid(); entries.next() )
+    {
+      MessageIterator entry = entries.recurse();
+      if ( entry.arg_type() != TYPE_OBJECT_PATH ) continue;
+      Path path( entry.get_string() );
+      entry.next();
+      objects[path] = read_interface_names( entry );
+    }
+
+    SIMPLELOGGER_DEBUG("dbus.ObjectManagerProxy","ObjectManagerProxy::on_refresh_reply: " << objects.size() << " objects below " << m_path);
+
+    {
+      std::lock_guard<std::mutex> lock( m_objects_mutex );
+      m_objects.swap( objects );
+      m_loaded = true;
+    }
+
+    m_signal_refreshed.emit();
+  }
+
+  HandlerResult ObjectManagerProxy::on_interfaces_added( SignalMessage::const_pointer msg )
+  {
+    std::set<std::string> interfaces;
+
+    MessageIterator iter = msg->begin();
+    if ( iter.arg_type() != TYPE_OBJECT_PATH ) return NOT_HANDLED;
+    Path path( iter.get_string() );
+    iter.next();
+    interfaces = read_interface_names( iter );
+
+    {
+      std::lock_guard<std::mutex> lock( m_objects_mutex );
+      m_objects[path].insert( interfaces.begin(), interfaces.end() );
+    }
+
+    m_signal_interfaces_added.emit( path, interfaces );
+
+    return HANDLED;
+  }
+
+  HandlerResult ObjectManagerProxy::on_interfaces_removed( SignalMessage::const_pointer msg )
+  {
+    std::set<std::string> interfaces;
+    std::set<std::string>::iterator i;
+
+    MessageIterator iter = msg->begin();
+    if ( iter.arg_type() != TYPE_OBJECT_PATH ) return NOT_HANDLED;
+    Path path( iter.get_string() );
+    iter.next();
+    if ( iter.arg_type() != TYPE_ARRAY ) return NOT_HANDLED;
+
+    for ( MessageIterator names = iter.recurse(); names.is_valid(); names.next() )
+      interfaces.insert( names.get_string() );
+
+    {
+      std::lock_guard<std::mutex> lock( m_objects_mutex );
+      ManagedObjects::iterator object = m_objects.find( path );
+      if ( object != m_objects.end() )
+      {
+        for ( i = interfaces.begin(); i != interfaces.end(); i++ )
+          object->second.erase( *i );
+        if ( object->second.empty() ) m_objects.erase( object );
+      }
+    }
+
+    m_signal_interfaces_removed.emit( path, interfaces );
+
+    return HANDLED;
+  }
+
+  std::set<std::string> ObjectManagerProxy::read_interface_names( MessageIterator iter )
+  {
+    std::set<std::string> names;
+
+    if ( iter.arg_type() != TYPE_ARRAY ) return names;
+
+    for ( MessageIterator entries = iter.recurse(); entries.is_valid(); entries.next() )
+    {
+      MessageIterator entry = entries.recurse();
+      if ( entry.arg_type() == TYPE_STRING ) names.insert( entry.get_string() );
+    }
+
+    return names;
+  }
+
+}
@@ -0,0 +1,155 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by agent                                           *
+ *   agent@local                                                           *
+ *                                                                         *
+ *   This file is part of the dbus-cxx library.                            *
+ *                                                                         *
+ *   The dbus-cxx library is free software; you can redistribute it and/or *
+ *   modify it under the terms of the GNU General Public License           *
+ *   version 3 as published by the Free Software Foundation.               *
+ *                                                                         *
+ *   The dbus-cxx library is distributed in the hope that it will be       *
+ *   useful, but WITHOUT ANY WARRANTY; without even the implied warranty   *
+ *   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU   *
+ *   General Public License for more details.                              *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this software. If not see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+
+#include <sigc++/sigc++.h>
+
+#include <dbus-cxx/objectproxy.h>
+#include <dbus-cxx/signal_proxy_base.h>
+
+#ifndef DBUSCXX_OBJECTMANAGERPROXY_H
+#define DBUSCXX_OBJECTMANAGERPROXY_H
+
+namespace DBus
+{
+
+  /**
+   * @ingroup proxy
+   * @ingroup objects
+   *
+   * Proxy for a remote org.freedesktop.DBus.ObjectManager that keeps a local
+   * mirror of the objects below it and the interfaces they implement.
+   *
+   * The mirror is loaded with one GetManagedObjects call and then kept up to
+   * date from the InterfacesAdded and InterfacesRemoved signals, so the
+   * remote tree never has to be walked with Introspect.
+   *
+   * refresh() does not block; signal_refreshed() is emitted once the reply
+   * has been loaded into the mirror.
+   *
+   * @author agent <agent@local>
+   */
+  class ObjectManagerProxy: public ObjectProxy, public sigc::trackable
+  {
+    protected:
+
+      ObjectManagerProxy( DBusCxxPointer<Connection> conn, const std::string& destination, const std::string& path );
+
+    public:
+
+      typedef DBusCxxPointer<ObjectManagerProxy> pointer;
+
+      /**
+       * Typedef to the mirror of the remote tree.
+       *
+       * \b Key - object path
+       * \b Value - names of the interfaces the object implements
+       */
+      typedef std::map<Path, std::set<std::string> > ManagedObjects;
+
+      /**
+       * Creates a proxy for the manager at the given path and starts loading
+       * the mirror.
+       */
+      static pointer create( DBusCxxPointer<Connection> conn, const std::string& destination, const std::string& path );
+
+      virtual ~ObjectManagerProxy();
+
+      /**
+       * Asks the remote manager for the whole tree again.
+       * Signals are only accepted from the current owner of the destination,
+       * which is looked up again here in case the service was restarted.
+       * @return \c false if the call could not be sent
+       */
+      bool refresh( int timeout_milliseconds=-1 );
+
+      /** True once the mirror has been loaded from a GetManagedObjects reply */
+      bool is_loaded() const;
+
+      /** Returns a copy of the mirror */
+      ManagedObjects managed_objects() const;
+
+      bool has_object( const Path& path ) const;
+
+      /** Returns the interfaces the remote object implements, or an empty set if it is unknown */
+      std::set<std::string> object_interfaces( const Path& path ) const;
+
+      /** Emitted after the mirror has been replaced with the result of a refresh() */
+      sigc::signal<void> signal_refreshed();
+
+      /**
+       * Emitted when a remote object gains interfaces.
+       *
+       * The parameters are the object's path and the names of the new interfaces.
+       */
+      sigc::signal<void,const Path&,const std::set<std::string>&> signal_interfaces_added();
+
+      /**
+       * Emitted when a remote object loses interfaces.
+       *
+       * The parameters are the object's path and the names of the removed interfaces.
+       * An object that loses its last interface is dropped from the mirror.
+       */
+      sigc::signal<void,const Path&,const std::set<std::string>&> signal_interfaces_removed();
+
+    protected:
+
+      /** Returns the unique name that owns the destination, or the destination itself if it can't be looked up */
+      std::string name_owner() const;
+
+      /** Listens for the manager's signals, again if the destination has changed owner since the last call */
+      void subscribe();
+
+      void on_refresh_reply();
+
+      HandlerResult on_interfaces_added( SignalMessage::const_pointer msg );
+
+      HandlerResult on_interfaces_removed( SignalMessage::const_pointer msg );
+
+      /** Reads the names out of an a{sa{sv}} argument */
+      static std::set<std::string> read_interface_names( MessageIterator iter );
+
+      mutable std::mutex m_objects_mutex;
+
+      ManagedObjects m_objects;
+
+      bool m_loaded;
+
+      PendingCall::pointer m_refresh_call;
+
+      bool m_refresh_handled;
+
+      signal_proxy_base::pointer m_interfaces_added_proxy;
+
+      signal_proxy_base::pointer m_interfaces_removed_proxy;
+
+      sigc::signal<void> m_signal_refreshed;
+
+      sigc::signal<void,const Path&,const std::set<std::string>&> m_signal_interfaces_added;
+
+      sigc::signal<void,const Path&,const std::set<std::string>&> m_signal_interfaces_removed;
+
+  };
+
+}
+
+#endif
@@ -21,6 +21,7 @@
 #include "connection.h"
 #include "dbus-cxx-config.h"
 #include "dbus-cxx-private.h"
+#include "tracing.h"
 
 namespace DBus
 {
@@ -62,9 +63,6 @@ namespace DBus
 
   bool ObjectPathHandler::register_with_connection(Connection::pointer conn)
   {
-    dbus_bool_t result;
-    Error::pointer error = Error::create();
-
     SIMPLELOGGER_DEBUG("dbus.ObjectPathHandler","Registering path " << m_path << " with connection");
 
     if ( not conn or not conn->is_valid() ) return false;
@@ -73,6 +71,30 @@ namespace DBus
     {
       this->unregister( conn );
     }
+
+    if ( not this->register_path( conn ) ) return false;
+
+    m_connection = conn;
+    
+    return true;
+  }
+
+  bool ObjectPathHandler::attach_connection(Connection::pointer conn)
+  {
+    SIMPLELOGGER_DEBUG("dbus.ObjectPathHandler","Attaching path " << m_path << " to an additional connection");
+
+    if ( not conn or not conn->is_valid() ) return false;
+
+    return this->register_path( conn );
+  }
+
+  bool ObjectPathHandler::register_path(Connection::pointer conn)
+  {
+    dbus_bool_t result;
+    Error::pointer error = Error::create();
+
+    // Connections with a path router only register "/" with libdbus
+    if ( conn->path_router() ) return conn->path_router()->add( this );
     
 #ifdef DBUS_CXX_HAVE_DBUS_12
     if ( m_primary_fallback == PRIMARY )
@@ -87,17 +109,25 @@ namespace DBus
       result = dbus_connection_register_fallback( conn->cobj(), m_path.c_str(), &m_dbus_vtable, this );
 #endif
     
-    if ( not result ) return false;
+    return result;
+  }
 
-    m_connection = conn;
-    
-    return true;
+  bool ObjectPathHandler::detach_connection(Connection::pointer conn)
+  {
+    if ( not conn or not conn->is_valid() ) return false;
+    if ( conn->path_router() and conn->path_router()->remove( m_path, this ) ) return true;
+    return dbus_connection_unregister_object_path( conn->cobj(), m_path.c_str() );
   }
 
   bool ObjectPathHandler::unregister(Connection::pointer conn)
   {
     dbus_bool_t result;
     if ( not conn or not conn->is_valid() ) return false;
+    if ( conn->path_router() and conn->path_router()->remove( m_path, this ) )
+    {
+      m_connection.reset();
+      return true;
+    }
     result = dbus_connection_unregister_object_path( conn->cobj(), m_path.c_str() );
     if ( result ) m_connection.reset();
     return result;
@@ -118,6 +148,7 @@ namespace DBus
     bool result;
     if ( user_data == NULL ) return DBUS_HANDLER_RESULT_NOT_YET_HANDLED;
     ObjectPathHandler* handler = static_cast<ObjectPathHandler*>(user_data);
+    DBUSCXX_TRACE( MESSAGE_ROUTED, message );
     result = handler->handle_message(Connection::self(connection), Message::create(message));
     SIMPLELOGGER_DEBUG("dbus.ObjectPathHandler","ObjectPathHandler::message_handler_callback: result = " << result );
     if ( result == HANDLED ) return DBUS_HANDLER_RESULT_HANDLED;
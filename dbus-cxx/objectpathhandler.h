@@ -35,7 +35,7 @@ namespace DBus
    * 
    * @author Rick L Vinyard Jr <rvinyard@cs.nmsu.edu>
    */
-  class ObjectPathHandler: public MessageHandler
+  class ObjectPathHandler: public MessageHandler, public DBusCxxEnableSharedFromThis<ObjectPathHandler>
   {
     protected:
       ObjectPathHandler(const std::string& path, PrimaryFallback pf);
@@ -62,6 +62,16 @@ namespace DBus
       /** Tries to register the handler using the provided connection and with the currently set path and primary/fallback setting */
       virtual bool register_with_connection(DBusCxxPointer<Connection> conn);
 
+      /**
+       * Registers the handler's path on another connection as well, such as
+       * a peer accepted by a Server. Messages arriving there are handled and
+       * answered on that connection, but connection() does not change.
+       */
+      virtual bool attach_connection(DBusCxxPointer<Connection> conn);
+
+      /** Removes the handler's path from a connection it was attached to */
+      virtual bool detach_connection(DBusCxxPointer<Connection> conn);
+
       /** Unregisters the handler */
       bool unregister(DBusCxxPointer<Connection> conn);
 
@@ -87,6 +97,9 @@ namespace DBus
 
       static struct DBusObjectPathVTable m_dbus_vtable;
 
+      /** Registers our path with the connection's router, or with libdbus if it has none */
+      bool register_path(DBusCxxPointer<Connection> conn);
+
       static DBusHandlerResult message_handler_callback(DBusConnection* connection, DBusMessage* message, void* user_data);
 
       static void path_unregister_callback(DBusConnection* connection, void* user_data);
@@ -0,0 +1,365 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by agent                                           *
+ *   agent@local                                                           *
+ *                                                                         *
+ *   This file is part of the dbus-cxx library.                            *
+ *                                                                         *
+ *   The dbus-cxx library is free software; you can redistribute it and/or *
+ *   modify it under the terms of the GNU General Public License           *
+ *   version 3 as published by the Free Software Foundation.               *
+ *                                                                         *
+ *   The dbus-cxx library is distributed in the hope that it will be       *
+ *   useful, but WITHOUT ANY WARRANTY; without even the implied warranty   *
+ *   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU   *
+ *   General Public License for more details.                              *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this software. If not see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#include "objectpathrouter.h"
+#include "objectpathhandler.h"
+#include "connection.h"
+#include "dbus-cxx-private.h"
+#include "tracing.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace DBus
+{
+  struct DBusObjectPathVTable ObjectPathRouter::m_dbus_vtable = {
+    path_unregister_callback,
+    message_handler_callback
+  };
+
+  ObjectPathRouter::Node::~Node()
+  {
+    for ( Children::iterator i = children.begin(); i != children.end(); i++ )
+      delete i->second;
+  }
+
+  size_t ObjectPathRouter::Node::count() const
+  {
+    size_t result = ( handler ) ? 1 : 0;
+    for ( Children::const_iterator i = children.begin(); i != children.end(); i++ )
+      result += i->second->count();
+    return result;
+  }
+
+  /** Orders a child against a segment compared in place */
+  struct SegmentLess
+  {
+    typedef std::pair<const char*,size_t> Segment;
+
+    template <typename Child>
+    bool operator()( const Child& child, const Segment& segment ) const
+    {
+      return child.first.compare( 0, std::string::npos, segment.first, segment.second ) < 0;
+    }
+  };
+
+  ObjectPathRouter::Node* ObjectPathRouter::Node::child( const char* segment, size_t length ) const
+  {
+    Children::const_iterator i;
+    i = std::lower_bound( children.begin(), children.end(), SegmentLess::Segment( segment, length ), SegmentLess() );
+    if ( i == children.end() or i->first.compare( 0, std::string::npos, segment, length ) != 0 ) return NULL;
+    return i->second;
+  }
+
+  ObjectPathRouter::Node* ObjectPathRouter::Node::make_child( const std::string& segment )
+  {
+    Children::iterator i;
+    i = std::lower_bound( children.begin(), children.end(), SegmentLess::Segment( segment.data(), segment.size() ), SegmentLess() );
+    if ( i != children.end() and i->first == segment ) return i->second;
+    return children.insert( i, std::make_pair( segment, new Node() ) )->second;
+  }
+
+  void ObjectPathRouter::Node::erase_child( const std::string& segment )
+  {
+    Children::iterator i;
+    i = std::lower_bound( children.begin(), children.end(), SegmentLess::Segment( segment.data(), segment.size() ), SegmentLess() );
+    if ( i != children.end() and i->first == segment ) children.erase( i );
+  }
+
+  ObjectPathRouter::ObjectPathRouter():
+      m_size( 0 )
+  {
+    pthread_rwlock_init( &m_rwlock, NULL );
+  }
+
+  ObjectPathRouter::pointer ObjectPathRouter::create()
+  {
+    return pointer( new ObjectPathRouter() );
+  }
+
+  ObjectPathRouter::~ObjectPathRouter()
+  {
+    pthread_rwlock_destroy( &m_rwlock );
+  }
+
+  bool ObjectPathRouter::add( ObjectPathHandler* handler )
+  {
+    Path::Decomposed segments;
+    Path::Decomposed::iterator s;
+    Node* node = &m_root;
+    ObjectPathHandler::pointer owner;
+    bool result = false;
+
+    if ( not handler or not handler->path().is_valid() ) return false;
+
+    // route() needs a pointer to keep the handler alive while delivering
+    try {
+      owner = handler->shared_from_this();
+    } catch ( DBusCxxBadWeakPointer& ) {
+      return false;
+    }
+
+    segments = handler->path().decomposed();
+
+    // ========== WRITE LOCK ==========
+    pthread_rwlock_wrlock( &m_rwlock );
+
+    // The root path decomposes to a single empty segment
+    if ( handler->path().size() > 1 )
+    {
+      for ( s = segments.begin(); s != segments.end(); s++ )
+        node = node->make_child( *s );
+    }
+
+    if ( node->handler == NULL )
+    {
+      node->handler = handler;
+      node->owner = owner;
+      node->primary_fallback = handler->is_primary_or_fallback();
+      m_size++;
+      result = true;
+    }
+
+    // ========== UNLOCK ==========
+    pthread_rwlock_unlock( &m_rwlock );
+
+    SIMPLELOGGER_DEBUG("dbus.ObjectPathRouter","ObjectPathRouter::add " << handler->path() << " " << (result?"succeeded":"failed"));
+
+    return result;
+  }
+
+  bool ObjectPathRouter::remove( const Path& path, ObjectPathHandler* handler )
+  {
+    Path::Decomposed segments;
+    Path::Decomposed::iterator s;
+    std::vector<Node*> nodes;
+    Node* node = &m_root;
+    bool result = false;
+
+    if ( not path.is_valid() ) return false;
+
+    segments = path.decomposed();
+    if ( path.size() == 1 ) segments.clear();
+
+    // ========== WRITE LOCK ==========
+    pthread_rwlock_wrlock( &m_rwlock );
+
+    nodes.push_back( node );
+    for ( s = segments.begin(); s != segments.end() and node; s++ )
+    {
+      node = node->child( s->data(), s->size() );
+      if ( node ) nodes.push_back( node );
+    }
+
+    if ( node and node->handler and ( handler == NULL or node->handler == handler ) )
+    {
+      node->handler = NULL;
+      node->owner.reset();
+      m_size--;
+      result = true;
+
+      // Prune the branch back to the nearest node that is still in use
+      for ( size_t i = nodes.size() - 1; i > 0; i-- )
+      {
+        if ( nodes[i]->handler or not nodes[i]->children.empty() ) break;
+        nodes[i-1]->erase_child( segments[i-1] );
+        delete nodes[i];
+      }
+    }
+
+    // ========== UNLOCK ==========
+    pthread_rwlock_unlock( &m_rwlock );
+
+    return result;
+  }
+
+  size_t ObjectPathRouter::remove_subtree( const Path& path )
+  {
+    Path::Decomposed segments;
+    Node* node = &m_root;
+    Node* parent = NULL;
+    size_t removed = 0;
+
+    if ( not path.is_valid() ) return 0;
+
+    if ( path.size() == 1 )
+    {
+      // ========== WRITE LOCK ==========
+      pthread_rwlock_wrlock( &m_rwlock );
+      removed = m_size;
+      for ( Node::Children::iterator i = m_root.children.begin(); i != m_root.children.end(); i++ )
+        delete i->second;
+      m_root.children.clear();
+      m_root.handler = NULL;
+      m_root.owner.reset();
+      m_size = 0;
+      // ========== UNLOCK ==========
+      pthread_rwlock_unlock( &m_rwlock );
+      return removed;
+    }
+
+    segments = path.decomposed();
+
+    // ========== WRITE LOCK ==========
+    pthread_rwlock_wrlock( &m_rwlock );
+
+    for ( Path::Decomposed::iterator s = segments.begin(); s != segments.end() and node; s++ )
+    {
+      parent = node;
+      node = node->child( s->data(), s->size() );
+    }
+
+    if ( node )
+    {
+      removed = node->count();
+      parent->erase_child( segments.back() );
+      delete node;
+      m_size -= removed;
+    }
+
+    // ========== UNLOCK ==========
+    pthread_rwlock_unlock( &m_rwlock );
+
+    return removed;
+  }
+
+  void ObjectPathRouter::clear()
+  {
+    this->remove_subtree( "/" );
+  }
+
+  ObjectPathHandler* ObjectPathRouter::handler( const Path& path ) const
+  {
+    ObjectPathHandler* result = NULL;
+
+    if ( not path.is_valid() ) return NULL;
+
+    // ========== READ LOCK ==========
+    pthread_rwlock_rdlock( &m_rwlock );
+
+    const Node* node = this->lookup( path.c_str() );
+    if ( node and node->handler->path() == path ) result = node->handler;
+
+    // ========== UNLOCK ==========
+    pthread_rwlock_unlock( &m_rwlock );
+
+    return result;
+  }
+
+  ObjectPathHandler* ObjectPathRouter::find( const char* path ) const
+  {
+    ObjectPathHandler* result = NULL;
+
+    // ========== READ LOCK ==========
+    pthread_rwlock_rdlock( &m_rwlock );
+
+    const Node* node = this->lookup( path );
+    if ( node ) result = node->handler;
+
+    // ========== UNLOCK ==========
+    pthread_rwlock_unlock( &m_rwlock );
+
+    return result;
+  }
+
+  const ObjectPathRouter::Node* ObjectPathRouter::lookup( const char* path ) const
+  {
+    const Node* node = &m_root;
+    const Node* fallback = NULL;
+    const char* segment_start;
+    const char* segment_end;
+
+    if ( path == NULL or path[0] != '/' ) return NULL;
+
+    if ( m_root.handler and m_root.primary_fallback == FALLBACK ) fallback = &m_root;
+
+    // Walk the path in place rather than decomposing it for every message
+    segment_start = path + 1;
+    while ( *segment_start != '\0' )
+    {
+      segment_end = strchr( segment_start, '/' );
+      if ( segment_end == NULL ) segment_end = segment_start + strlen( segment_start );
+
+      node = node->child( segment_start, segment_end - segment_start );
+      if ( node == NULL ) return fallback;
+
+      if ( node->handler and node->primary_fallback == FALLBACK ) fallback = node;
+
+      if ( *segment_end == '\0' ) break;
+      segment_start = segment_end + 1;
+    }
+
+    if ( node->handler ) return node;
+    return fallback;
+  }
+
+  size_t ObjectPathRouter::size() const
+  {
+    size_t result;
+
+    // ========== READ LOCK ==========
+    pthread_rwlock_rdlock( &m_rwlock );
+
+    result = m_size;
+
+    // ========== UNLOCK ==========
+    pthread_rwlock_unlock( &m_rwlock );
+
+    return result;
+  }
+
+  HandlerResult ObjectPathRouter::route( Connection::pointer conn, Message::const_pointer msg )
+  {
+    ObjectPathHandler::pointer handler;
+    const Node* node;
+
+    if ( not msg ) return NOT_HANDLED;
+
+    // ========== READ LOCK ==========
+    pthread_rwlock_rdlock( &m_rwlock );
+
+    // Held past the unlock, so the handler outlives a concurrent remove()
+    node = this->lookup( dbus_message_get_path( msg->cobj() ) );
+    if ( node ) handler = node->owner.lock();
+
+    // ========== UNLOCK ==========
+    pthread_rwlock_unlock( &m_rwlock );
+
+    if ( not handler ) return NOT_HANDLED;
+
+    return handler->handle_message( conn, msg );
+  }
+
+  DBusHandlerResult ObjectPathRouter::message_handler_callback(DBusConnection * connection, DBusMessage * message, void * user_data)
+  {
+    HandlerResult result;
+    if ( user_data == NULL ) return DBUS_HANDLER_RESULT_NOT_YET_HANDLED;
+    ObjectPathRouter* router = static_cast<ObjectPathRouter*>(user_data);
+    DBUSCXX_TRACE( MESSAGE_ROUTED, message );
+    result = router->route(Connection::self(connection), Message::create(message));
+    SIMPLELOGGER_DEBUG("dbus.ObjectPathRouter","ObjectPathRouter::message_handler_callback: result = " << result );
+    if ( result == HANDLED ) return DBUS_HANDLER_RESULT_HANDLED;
+    return DBUS_HANDLER_RESULT_NOT_YET_HANDLED;
+  }
+
+  void ObjectPathRouter::path_unregister_callback(DBusConnection * connection, void * user_data)
+  {
+  }
+
+}
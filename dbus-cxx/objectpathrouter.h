@@ -0,0 +1,158 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by agent                                           *
+ *   agent@local                                                           *
+ *                                                                         *
+ *   This file is part of the dbus-cxx library.                            *
+ *                                                                         *
+ *   The dbus-cxx library is free software; you can redistribute it and/or *
+ *   modify it under the terms of the GNU General Public License           *
+ *   version 3 as published by the Free Software Foundation.               *
+ *                                                                         *
+ *   The dbus-cxx library is distributed in the hope that it will be       *
+ *   useful, but WITHOUT ANY WARRANTY; without even the implied warranty   *
+ *   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU   *
+ *   General Public License for more details.                              *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this software. If not see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#include <string>
+#include <vector>
+
+#include <pthread.h>
+
+#include <dbus/dbus.h>
+#include <dbus-cxx/enums.h>
+#include <dbus-cxx/pointer.h>
+#include <dbus-cxx/path.h>
+#include <dbus-cxx/message.h>
+
+#ifndef DBUSCXX_OBJECTPATHROUTER_H
+#define DBUSCXX_OBJECTPATHROUTER_H
+
+namespace DBus
+{
+
+  class Connection;
+
+  class ObjectPathHandler;
+
+  /**
+   * Routes messages to object path handlers through a tree keyed on path
+   * segments.
+   *
+   * A connection with a router registers a single fallback handler at "/"
+   * with libdbus; object path handlers then add themselves to the router
+   * instead of registering their own path. Adding or removing a handler and
+   * finding the handler for a message all cost O(depth) of the path, and a
+   * whole subtree can be dropped at once with remove_subtree().
+   *
+   * As with libdbus registrations, the handler registered on a message's
+   * exact path is used if there is one; otherwise the deepest ancestor
+   * registered as a FALLBACK handler is used. The router does not own the
+   * handlers, but keeps one alive while a message is delivered to it; only
+   * handlers owned by a DBusCxxPointer can be added.
+   *
+   * @ingroup local
+   * @ingroup objects
+   *
+   * @author agent <agent@local>
+   */
+  class ObjectPathRouter
+  {
+    protected:
+
+      ObjectPathRouter();
+
+    public:
+
+      typedef DBusCxxPointer<ObjectPathRouter> pointer;
+
+      static pointer create();
+
+      virtual ~ObjectPathRouter();
+
+      /**
+       * Adds the handler at its path
+       * @return \c false if the path is invalid or already has a handler, or
+       *         if the handler is not owned by a DBusCxxPointer
+       */
+      bool add( ObjectPathHandler* handler );
+
+      /**
+       * Removes the handler at the path
+       * @param handler If not \c NULL, only removed if it is the handler at the path
+       * @return \c true if a handler was removed
+       */
+      bool remove( const Path& path, ObjectPathHandler* handler=NULL );
+
+      /**
+       * Removes the handler at the path and every handler below it
+       * @return The number of handlers removed
+       */
+      size_t remove_subtree( const Path& path );
+
+      /** Removes every handler */
+      void clear();
+
+      /** Returns the handler registered on exactly this path, or \c NULL */
+      ObjectPathHandler* handler( const Path& path ) const;
+
+      /** Returns the handler a message sent to the path would be delivered to, or \c NULL */
+      ObjectPathHandler* find( const char* path ) const;
+
+      /** The number of handlers in the tree */
+      size_t size() const;
+
+      /** Delivers the message to the handler for its path */
+      HandlerResult route( DBusCxxPointer<Connection> conn, Message::const_pointer msg );
+
+      /** The vtable used for the fallback registration at "/" */
+      static struct DBusObjectPathVTable m_dbus_vtable;
+
+    protected:
+
+      class Node
+      {
+        public:
+          Node(): handler( NULL ), primary_fallback( PRIMARY ) { }
+          ~Node();
+
+          /** Counts the handlers in this node and below */
+          size_t count() const;
+
+          /** Returns the child for a segment that need not be terminated, or \c NULL */
+          Node* child( const char* segment, size_t length ) const;
+
+          /** Returns the child for the segment, adding it if there is none */
+          Node* make_child( const std::string& segment );
+
+          /** Drops the child for the segment without deleting it */
+          void erase_child( const std::string& segment );
+
+          /** Sorted on the segment so a path can be looked up in place */
+          typedef std::vector< std::pair<std::string,Node*> > Children;
+          Children children;
+          ObjectPathHandler* handler;
+          DBusCxxWeakPointer<ObjectPathHandler> owner;
+          PrimaryFallback primary_fallback;
+      };
+
+      Node m_root;
+
+      /** The node whose handler gets messages sent to the path, or \c NULL; m_rwlock must be held */
+      const Node* lookup( const char* path ) const;
+
+      size_t m_size;
+
+      mutable pthread_rwlock_t m_rwlock;
+
+      static DBusHandlerResult message_handler_callback(DBusConnection* connection, DBusMessage* message, void* user_data);
+
+      static void path_unregister_callback(DBusConnection* connection, void* user_data);
+
+  };
+
+}
+
+#endif
@@ -18,6 +18,7 @@
  ***************************************************************************/
 #include "objectproxy.h"
 #include "connection.h"
+#include "connectionpool.h"
 #include "interface.h"
 
 #include <map>
@@ -54,6 +55,13 @@ namespace DBus
     return pointer( new ObjectProxy( conn, destination, path ) );
   }
 
+  ObjectProxy::pointer ObjectProxy::create( ConnectionPool::pointer pool, const std::string& destination, const std::string& path )
+  {
+    pointer p = pointer( new ObjectProxy( Connection::pointer(), destination, path ) );
+    p->set_connection_pool( pool );
+    return p;
+  }
+
   ObjectProxy::~ ObjectProxy( )
   {
     pthread_mutex_destroy( &m_name_mutex );
@@ -65,6 +73,17 @@ namespace DBus
     return m_connection;
   }
 
+  ConnectionPool::pointer ObjectProxy::connection_pool() const
+  {
+    return m_pool;
+  }
+
+  void ObjectProxy::set_connection_pool( ConnectionPool::pointer pool )
+  {
+    m_pool = pool;
+    if ( pool ) this->set_connection( pool->primary() );
+  }
+
   void ObjectProxy::set_connection( Connection::pointer conn )
   {
     m_connection = conn;
@@ -434,6 +453,8 @@ namespace DBus
 
   ReturnMessage::const_pointer ObjectProxy::call( CallMessage::const_pointer call_message, int timeout_milliseconds ) const
   {
+    if ( m_pool ) return m_pool->send_with_reply_blocking( call_message, timeout_milliseconds );
+
     if ( not m_connection or not m_connection->is_valid() ) return ReturnMessage::const_pointer();
 
 //     if ( not call_message->expects_reply() )
@@ -447,6 +468,8 @@ namespace DBus
 
   PendingCall::pointer ObjectProxy::call_async( CallMessage::const_pointer call_message, int timeout_milliseconds ) const
   {
+    if ( m_pool ) return m_pool->send_with_reply_async( call_message, timeout_milliseconds );
+
     if ( not m_connection or not m_connection->is_valid() ) return PendingCall::pointer();
 
     return m_connection->send_with_reply_async( call_message, timeout_milliseconds );
@@ -93,6 +93,8 @@ namespace DBus
 
   class Connection;
 
+  class ConnectionPool;
+
   /**
    * @example calculator_client.cpp
    *
@@ -267,12 +269,27 @@ namespace DBus
 
       static pointer create( DBusCxxPointer<Connection> conn, const std::string& destination, const std::string& path );
 
+      /**
+       * Creates an ObjectProxy whose calls are spread across the pool's
+       * connections; signals are received on the pool's primary connection
+       */
+      static pointer create( DBusCxxPointer<ConnectionPool> pool, const std::string& destination, const std::string& path );
+
       virtual ~ObjectProxy();
 
       DBusCxxPointer<Connection> connection() const;
 
       void set_connection( DBusCxxPointer<Connection> conn );
 
+      DBusCxxPointer<ConnectionPool> connection_pool() const;
+
+      /**
+       * Sends calls through @p pool and moves signal handling to its primary
+       * connection. Passing an empty pointer detaches the pool but keeps the
+       * current connection.
+       */
+      void set_connection_pool( DBusCxxPointer<ConnectionPool> pool );
+
       const std::string& destination() const;
 
       void set_destination( const std::string& destination );
@@ -345,6 +362,8 @@ FOR(0, eval(CALL_SIZE),[[CREATE_SIGNAL(%1)]])
 
       DBusCxxPointer<Connection> m_connection;
 
+      DBusCxxPointer<ConnectionPool> m_pool;
+
       std::string m_destination;
 
       Path m_path;
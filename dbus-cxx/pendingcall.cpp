@@ -18,6 +18,7 @@
  ***************************************************************************/
 #include "pendingcall.h"
 #include "utility.h"
+#include "tracing.h"
 
 namespace DBus
 {
@@ -57,6 +58,7 @@ namespace DBus
       //dbus_pending_call_unref( m_cobj );
       dbus_pending_call_cancel( m_cobj );
     }
+    this->finish_pending();
   }
 
   PendingCall& PendingCall::operator=( const PendingCall& other )
@@ -73,6 +75,7 @@ namespace DBus
   {
     if ( m_cobj )
       dbus_pending_call_cancel( m_cobj );
+    this->finish_pending();
   }
 
   bool PendingCall::completed()
@@ -84,8 +87,13 @@ namespace DBus
 
   Message::pointer PendingCall::steal_reply()
   {
-    if ( m_cobj ) return Message::create( dbus_pending_call_steal_reply( m_cobj ) );
-    return Message::pointer();
+    if ( not m_cobj ) return Message::pointer();
+
+    DBusMessage* reply = dbus_pending_call_steal_reply( m_cobj );
+
+    // Replies to pending calls never pass through the connection's filter
+    if ( m_metrics ) m_metrics->count_in( reply );
+    return Message::create( reply );
   }
 
   void PendingCall::block()
@@ -103,7 +111,31 @@ namespace DBus
   {
     PendingCall * pc = static_cast<PendingCall*>( data );
 
+    DBUSCXX_TRACE_SERIAL( REPLY_RECEIVED, pc->m_call_serial );
+    pc->finish_pending();
     pc->m_signal_notify.emit();
   }
 
+  void PendingCall::set_metrics( std::shared_ptr<ConnectionMetrics> metrics )
+  {
+    if ( not metrics or not m_cobj ) return;
+
+    m_metrics = metrics;
+    m_metrics->add_pending_reply();
+    m_awaiting_reply = true;
+
+    // The reply may have arrived before we started counting
+    if ( dbus_pending_call_get_completed( m_cobj ) ) this->finish_pending();
+  }
+
+  void PendingCall::set_call_serial( uint32_t serial )
+  {
+    m_call_serial = serial;
+  }
+
+  void PendingCall::finish_pending()
+  {
+    if ( m_awaiting_reply.exchange( false ) ) m_metrics->remove_pending_reply();
+  }
+
 }
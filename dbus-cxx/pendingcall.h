@@ -16,9 +16,12 @@
  *   You should have received a copy of the GNU General Public License     *
  *   along with this software. If not see <http://www.gnu.org/licenses/>.  *
  ***************************************************************************/
+#include <atomic>
+#include <memory>
 #include <dbus/dbus.h>
 #include <sigc++/sigc++.h>
 #include <dbus-cxx/message.h>
+#include <dbus-cxx/metrics.h>
 #include <dbus-cxx/pointer.h>
 
 #ifndef DBUSCXX_PENDING_CALL_H
@@ -38,6 +41,8 @@ namespace DBus
   {
     protected:
 
+      friend class Connection;
+
       PendingCall( DBusPendingCall* cobj = NULL );
 
       PendingCall( const PendingCall& );
@@ -66,12 +71,29 @@ namespace DBus
 
       DBusPendingCall* cobj();
 
+    protected:
+
+      /** Counts this call as a pending reply of the connection that sent it */
+      void set_metrics( std::shared_ptr<ConnectionMetrics> metrics );
+
+      /** Stops counting this call as pending; safe to call more than once */
+      void finish_pending();
+
+      /** The serial of the call, recorded with the trace event of its reply */
+      void set_call_serial( uint32_t serial );
+
     private:
 
       DBusPendingCall* m_cobj;
 
       sigc::signal<void> m_signal_notify;
 
+      std::shared_ptr<ConnectionMetrics> m_metrics;
+
+      std::atomic<bool> m_awaiting_reply { false };
+
+      std::atomic<uint32_t> m_call_serial { 0 };
+
       static void notify_callback( DBusPendingCall* pending, void* data );
   };
 
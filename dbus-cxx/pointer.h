@@ -24,8 +24,11 @@
   #if defined( DBUS_CXX_USE_BOOST_SMART_POINTER )
     #include <boost/shared_ptr.hpp>
     #include <boost/weak_ptr.hpp>
+    #include <boost/enable_shared_from_this.hpp>
     #define DBusCxxPointer boost::shared_ptr
     #define DBusCxxWeakPointer boost::weak_ptr
+    #define DBusCxxEnableSharedFromThis boost::enable_shared_from_this
+    #define DBusCxxBadWeakPointer boost::bad_weak_ptr
     #define dbus_cxx_static_pointer_cast  boost::static_pointer_cast
     #define dbus_cxx_const_pointer_cast   boost::const_pointer_cast
     #define dbus_cxx_dynamic_pointer_cast boost::dynamic_pointer_cast
@@ -33,6 +36,8 @@
     #include <memory>
     #define DBusCxxPointer std::shared_ptr
     #define DBusCxxWeakPointer std::weak_ptr
+    #define DBusCxxEnableSharedFromThis std::enable_shared_from_this
+    #define DBusCxxBadWeakPointer std::bad_weak_ptr
     #define dbus_cxx_static_pointer_cast  std::static_pointer_cast
     #define dbus_cxx_const_pointer_cast   std::const_pointer_cast
     #define dbus_cxx_dynamic_pointer_cast std::dynamic_pointer_cast
@@ -50,6 +55,8 @@
     #include <tr1/boost_shared_ptr.h>
     #define DBusCxxPointer std::tr1::shared_ptr
     #define DBusCxxWeakPointer std::tr1::weak_ptr
+    #define DBusCxxEnableSharedFromThis std::tr1::enable_shared_from_this
+    #define DBusCxxBadWeakPointer std::tr1::bad_weak_ptr
     #define dbus_cxx_static_pointer_cast  std::tr1::static_pointer_cast
     #define dbus_cxx_const_pointer_cast   std::tr1::const_pointer_cast
     #define dbus_cxx_dynamic_pointer_cast std::tr1::dynamic_pointer_cast
@@ -0,0 +1,156 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by agent                                           *
+ *   agent@local                                                           *
+ *                                                                         *
+ *   This file is part of the dbus-cxx library.                            *
+ *                                                                         *
+ *   The dbus-cxx library is free software; you can redistribute it and/or *
+ *   modify it under the terms of the GNU General Public License           *
+ *   version 3 as published by the Free Software Foundation.               *
+ *                                                                         *
+ *   The dbus-cxx library is distributed in the hope that it will be       *
+ *   useful, but WITHOUT ANY WARRANTY; without even the implied warranty   *
+ *   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU   *
+ *   General Public License for more details.                              *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this software. If not see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#include <mutex>
+
+#include <sigc++/sigc++.h>
+
+#include <dbus-cxx/error.h>
+#include <dbus-cxx/signature.h>
+#include <dbus-cxx/propertybase.h>
+
+#ifndef DBUSCXX_PROPERTY_H
+#define DBUSCXX_PROPERTY_H
+
+namespace DBus
+{
+
+  /**
+   * @ingroup objects
+   * @ingroup local
+   *
+   * A typed property that is readable (and optionally writable) by peers
+   * through org.freedesktop.DBus.Properties.
+   *
+   * Create properties with Interface::create_property() or Object::create_property().
+   *
+   * Calling set_value() at a high rate is cheap; the owning interface batches
+   * every change into one PropertiesChanged signal per dispatch round, or per
+   * Interface::set_properties_changed_interval() milliseconds.
+   *
+   * @author agent <agent@local>
+   */
+  template <class T_type>
+  class Property : public PropertyBase
+  {
+    protected:
+
+      Property( const std::string& name, PropertyAccess access, PropertyUpdateType update ):
+        PropertyBase( name, access, update ),
+        m_value()
+      { }
+
+      Property( const std::string& name, const T_type& value, PropertyAccess access, PropertyUpdateType update ):
+        PropertyBase( name, access, update ),
+        m_value( value )
+      { }
+
+    public:
+
+      typedef DBusCxxPointer<Property> pointer;
+
+      static pointer create( const std::string& name,
+                             PropertyAccess access=PROPERTY_READ,
+                             PropertyUpdateType update=PROPERTY_UPDATE_EMITS_CHANGE )
+      {
+        return pointer( new Property(name, access, update) );
+      }
+
+      static pointer create( const std::string& name,
+                             const T_type& value,
+                             PropertyAccess access=PROPERTY_READ,
+                             PropertyUpdateType update=PROPERTY_UPDATE_EMITS_CHANGE )
+      {
+        return pointer( new Property(name, value, access, update) );
+      }
+
+      virtual ~Property() { }
+
+      T_type value() const
+      {
+        std::lock_guard<std::mutex> lock( m_value_mutex );
+        return m_value;
+      }
+
+      /**
+       * Changes the value. If the value differs from the current value the
+       * change is queued for the next PropertiesChanged signal and
+       * signal_changed() is emitted.
+       */
+      void set_value( const T_type& value )
+      {
+        {
+          std::lock_guard<std::mutex> lock( m_value_mutex );
+          if ( m_value == value ) return;
+          m_value = value;
+        }
+
+        this->notify_changed();
+        m_signal_changed.emit( value );
+      }
+
+      /** Signal emitted after the value changes, whether locally or through Set */
+      sigc::signal<void,const T_type&> signal_changed() { return m_signal_changed; }
+
+      virtual std::string signature() const
+      {
+        T_type type;
+        return DBus::signature( type );
+      }
+
+      virtual bool append_variant( MessageAppendIterator& iter ) const
+      {
+        T_type current = this->value();
+        if ( not iter.open_container( CONTAINER_VARIANT, DBus::signature(current) ) ) return false;
+        *iter.sub_iterator() << current;
+        return iter.close_container();
+      }
+
+      virtual bool set_variant( MessageIterator& iter )
+      {
+        T_type value;
+
+        if ( iter.arg_type() != TYPE_VARIANT ) return false;
+
+        MessageIterator subiter = iter.recurse();
+        if ( subiter.signature() != this->signature() ) return false;
+
+        try {
+          subiter >> value;
+        }
+        catch ( ErrorInvalidTypecast& e ) {
+          return false;
+        }
+
+        this->set_value( value );
+        return true;
+      }
+
+    protected:
+
+      T_type m_value;
+
+      mutable std::mutex m_value_mutex;
+
+      sigc::signal<void,const T_type&> m_signal_changed;
+
+  };
+
+}
+
+#endif
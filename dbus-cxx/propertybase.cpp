@@ -0,0 +1,115 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by agent                                           *
+ *   agent@local                                                           *
+ *                                                                         *
+ *   This file is part of the dbus-cxx library.                            *
+ *                                                                         *
+ *   The dbus-cxx library is free software; you can redistribute it and/or *
+ *   modify it under the terms of the GNU General Public License           *
+ *   version 3 as published by the Free Software Foundation.               *
+ *                                                                         *
+ *   The dbus-cxx library is distributed in the hope that it will be       *
+ *   useful, but WITHOUT ANY WARRANTY; without even the implied warranty   *
+ *   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU   *
+ *   General Public License for more details.                              *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this software. If not see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#include "propertybase.h"
+#include "interface.h"
+#include "dbus-cxx-private.h"
+
+#include <sstream>
+
+namespace DBus
+{
+
+  PropertyBase::PropertyBase( const std::string& name, PropertyAccess access, PropertyUpdateType update ):
+      m_name(name),
+      m_access(access),
+      m_update_type(update),
+      m_interface(NULL)
+  {
+  }
+
+  PropertyBase::~PropertyBase()
+  {
+  }
+
+  const std::string& PropertyBase::name() const
+  {
+    return m_name;
+  }
+
+  PropertyAccess PropertyBase::access() const
+  {
+    return m_access;
+  }
+
+  PropertyUpdateType PropertyBase::update_type() const
+  {
+    return m_update_type;
+  }
+
+  bool PropertyBase::is_readable() const
+  {
+    return m_access != PROPERTY_WRITE;
+  }
+
+  bool PropertyBase::is_writable() const
+  {
+    return m_access != PROPERTY_READ;
+  }
+
+  Interface* PropertyBase::interface() const
+  {
+    return m_interface;
+  }
+
+  std::string PropertyBase::introspect( int space_depth ) const
+  {
+    std::ostringstream sout;
+    std::string spaces;
+    for ( int i=0; i < space_depth; i++ ) spaces += " ";
+    sout << spaces << "<property name=\"" << m_name
+         << "\" type=\"" << this->signature()
+         << "\" access=\"";
+    switch ( m_access )
+    {
+      case PROPERTY_READ:  sout << "read"; break;
+      case PROPERTY_WRITE: sout << "write"; break;
+      default:             sout << "readwrite"; break;
+    }
+    sout << "\"";
+
+    if ( m_update_type == PROPERTY_UPDATE_EMITS_CHANGE )
+    {
+      sout << "/>\n";
+      return sout.str();
+    }
+
+    sout << ">\n"
+         << spaces << "  <annotation name=\"org.freedesktop.DBus.Property.EmitsChangedSignal\" value=\"";
+    switch ( m_update_type )
+    {
+      case PROPERTY_UPDATE_EMITS_INVALIDATION: sout << "invalidates"; break;
+      case PROPERTY_UPDATE_CONST:              sout << "const"; break;
+      default:                                 sout << "false"; break;
+    }
+    sout << "\"/>\n"
+         << spaces << "</property>\n";
+    return sout.str();
+  }
+
+  void PropertyBase::set_interface( Interface* interface )
+  {
+    m_interface = interface;
+  }
+
+  void PropertyBase::notify_changed()
+  {
+    if ( m_interface ) m_interface->on_property_changed( this );
+  }
+
+}
@@ -0,0 +1,113 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by agent                                           *
+ *   agent@local                                                           *
+ *                                                                         *
+ *   This file is part of the dbus-cxx library.                            *
+ *                                                                         *
+ *   The dbus-cxx library is free software; you can redistribute it and/or *
+ *   modify it under the terms of the GNU General Public License           *
+ *   version 3 as published by the Free Software Foundation.               *
+ *                                                                         *
+ *   The dbus-cxx library is distributed in the hope that it will be       *
+ *   useful, but WITHOUT ANY WARRANTY; without even the implied warranty   *
+ *   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU   *
+ *   General Public License for more details.                              *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this software. If not see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#include <string>
+
+#include <dbus-cxx/enums.h>
+#include <dbus-cxx/pointer.h>
+#include <dbus-cxx/messageiterator.h>
+#include <dbus-cxx/messageappenditerator.h>
+
+#ifndef DBUSCXX_PROPERTYBASE_H
+#define DBUSCXX_PROPERTYBASE_H
+
+#define DBUS_CXX_PROPERTIES_INTERFACE "org.freedesktop.DBus.Properties"
+
+namespace DBus
+{
+
+  class Interface;
+
+  /**
+   * @ingroup objects
+   * @ingroup local
+   *
+   * Type independent base of a property exported through the
+   * org.freedesktop.DBus.Properties interface of the object that owns
+   * the property's interface.
+   *
+   * Changes made through set_value() are reported to the owning interface,
+   * which coalesces them into a single PropertiesChanged signal.
+   *
+   * @author agent <agent@local>
+   */
+  class PropertyBase
+  {
+    protected:
+
+      PropertyBase( const std::string& name, PropertyAccess access, PropertyUpdateType update );
+
+    public:
+
+      typedef DBusCxxPointer<PropertyBase> pointer;
+
+      virtual ~PropertyBase();
+
+      const std::string& name() const;
+
+      PropertyAccess access() const;
+
+      PropertyUpdateType update_type() const;
+
+      /** True if peers may read this property */
+      bool is_readable() const;
+
+      /** True if peers may change this property with Set */
+      bool is_writable() const;
+
+      /** Returns the interface this property has been added to, or NULL */
+      Interface* interface() const;
+
+      /** The DBus signature of the property's value */
+      virtual std::string signature() const = 0;
+
+      /** Appends the current value wrapped in a variant */
+      virtual bool append_variant( MessageAppendIterator& iter ) const = 0;
+
+      /**
+       * Sets the value from the variant the iterator points to
+       *
+       * @return false if the variant does not hold a value of this property's type
+       */
+      virtual bool set_variant( MessageIterator& iter ) = 0;
+
+      /** Returns a DBus XML description of this property */
+      virtual std::string introspect( int space_depth=0 ) const;
+
+    protected:
+
+      friend class Interface;
+
+      void set_interface( Interface* interface );
+
+      /** Tells the owning interface that the value has changed */
+      void notify_changed();
+
+      std::string m_name;
+
+      PropertyAccess m_access;
+
+      PropertyUpdateType m_update_type;
+
+      Interface* m_interface;
+
+  };
+
+}
+
+#endif
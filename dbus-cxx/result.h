@@ -0,0 +1,165 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by agent                                           *
+ *   agent@local                                                           *
+ *                                                                         *
+ *   This file is part of the dbus-cxx library.                            *
+ *                                                                         *
+ *   The dbus-cxx library is free software; you can redistribute it and/or *
+ *   modify it under the terms of the GNU General Public License           *
+ *   version 3 as published by the Free Software Foundation.               *
+ *                                                                         *
+ *   The dbus-cxx library is distributed in the hope that it will be       *
+ *   useful, but WITHOUT ANY WARRANTY; without even the implied warranty   *
+ *   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU   *
+ *   General Public License for more details.                              *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this software. If not see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#include <string>
+
+#include <dbus-cxx/signature.h>
+#include <dbus-cxx/callmessage.h>
+#include <dbus-cxx/returnmessage.h>
+#include <dbus-cxx/errormessage.h>
+
+#ifndef DBUSCXX_RESULT_H
+#define DBUSCXX_RESULT_H
+
+namespace DBus
+{
+
+  /**
+   * The value a method handler returns, or the D-Bus error to reply with
+   * instead.
+   *
+   * A handler of a Method<Result<T>,...> returns Result<T>::error() to
+   * reject a call. The error reply is sent without an exception being
+   * thrown, which matters for services that reject many calls. On the bus
+   * the method is described as returning T.
+   *
+   * @ingroup local
+   *
+   * @author agent <agent@local>
+   */
+  template <typename T>
+  class Result
+  {
+    public:
+
+      Result(): m_value(), m_is_error( false ) { }
+
+      Result( const T& value ): m_value( value ), m_is_error( false ) { }
+
+      /** An empty name is replaced by DBUS_ERROR_FAILED, as a reply needs one */
+      static Result error( const std::string& name, const std::string& message )
+      {
+        Result result;
+        result.m_is_error = true;
+        result.m_error_name = name.empty() ? std::string( DBUS_ERROR_FAILED ) : name;
+        result.m_error_message = message;
+        return result;
+      }
+
+      bool is_error() const { return m_is_error; }
+
+      explicit operator bool() const { return not this->is_error(); }
+
+      const T& value() const { return m_value; }
+
+      const std::string& error_name() const { return m_error_name; }
+
+      const std::string& error_message() const { return m_error_message; }
+
+    protected:
+
+      T m_value;
+
+      bool m_is_error;
+
+      std::string m_error_name;
+
+      std::string m_error_message;
+  };
+
+  /**
+   * The result of a handler that returns nothing on success; the method
+   * is described as having no out arguments.
+   *
+   * @ingroup local
+   */
+  template <>
+  class Result<void>
+  {
+    public:
+
+      Result(): m_is_error( false ) { }
+
+      /** An empty name is replaced by DBUS_ERROR_FAILED, as a reply needs one */
+      static Result error( const std::string& name, const std::string& message )
+      {
+        Result result;
+        result.m_is_error = true;
+        result.m_error_name = name.empty() ? std::string( DBUS_ERROR_FAILED ) : name;
+        result.m_error_message = message;
+        return result;
+      }
+
+      bool is_error() const { return m_is_error; }
+
+      explicit operator bool() const { return not this->is_error(); }
+
+      const std::string& error_name() const { return m_error_name; }
+
+      const std::string& error_message() const { return m_error_message; }
+
+    protected:
+
+      bool m_is_error;
+
+      std::string m_error_name;
+
+      std::string m_error_message;
+  };
+
+  template <typename T>
+  inline std::string signature( const Result<T>& ) { T t; return signature( t ); }
+
+  inline std::string signature( const Result<void>& ) { return std::string(); }
+
+  namespace priv
+  {
+
+    /** The reply to a call answered with value */
+    template <typename T>
+    inline Message::pointer create_method_reply( CallMessage::const_pointer call, const T& value )
+    {
+      ReturnMessage::pointer reply = call->create_reply();
+      if ( reply ) *reply << value;
+      return reply;
+    }
+
+    template <typename T>
+    inline Message::pointer create_method_reply( CallMessage::const_pointer call, const Result<T>& result )
+    {
+      if ( result.is_error() ) return ErrorMessage::create( call, result.error_name(), result.error_message() );
+      return create_method_reply( call, result.value() );
+    }
+
+    inline Message::pointer create_method_reply( CallMessage::const_pointer call, const Result<void>& result )
+    {
+      if ( result.is_error() ) return ErrorMessage::create( call, result.error_name(), result.error_message() );
+      return call->create_reply();
+    }
+
+    template <typename T>
+    inline bool is_error_result( const T& ) { return false; }
+
+    template <typename T>
+    inline bool is_error_result( const Result<T>& result ) { return result.is_error(); }
+
+  }
+
+}
+
+#endif
@@ -53,11 +53,15 @@ namespace DBus
 
   ReturnMessage::pointer ReturnMessage::create(DBusMessage * callee)
   {
+    ReturnMessage::pointer cached_return = dbus_cxx_dynamic_pointer_cast<ReturnMessage>( Message::cached( callee ) );
+    if ( cached_return ) return cached_return;
     return pointer(new ReturnMessage(callee) );
   }
 
   ReturnMessage::pointer ReturnMessage::create(Message::pointer callee)
   {
+    ReturnMessage::pointer ret = dbus_cxx_dynamic_pointer_cast<ReturnMessage>( callee );
+    if ( ret ) return ret;
     return pointer(new ReturnMessage(callee) );
   }
 
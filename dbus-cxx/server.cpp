@@ -0,0 +1,344 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by agent                                           *
+ *   agent@local                                                           *
+ *                                                                         *
+ *   This file is part of the dbus-cxx library.                            *
+ *                                                                         *
+ *   The dbus-cxx library is free software; you can redistribute it and/or *
+ *   modify it under the terms of the GNU General Public License           *
+ *   version 3 as published by the Free Software Foundation.               *
+ *                                                                         *
+ *   The dbus-cxx library is distributed in the hope that it will be       *
+ *   useful, but WITHOUT ANY WARRANTY; without even the implied warranty   *
+ *   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU   *
+ *   General Public License for more details.                              *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this software. If not see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#include "server.h"
+#include "dbus-cxx-private.h"
+
+#include <algorithm>
+
+namespace DBus
+{
+
+  Server::Server( const std::string& address ):
+      m_cobj( NULL )
+  {
+    Error::pointer error = Error::create();
+    dbus_bool_t result;
+
+    m_cobj = dbus_server_listen( address.c_str(), error->cobj() );
+    if ( error->is_set() ) throw error;
+    if ( m_cobj == NULL ) throw ErrorFailed::create();
+
+    dbus_server_set_new_connection_function( m_cobj, Server::on_new_connection_callback, this, NULL );
+
+    result = dbus_server_set_watch_functions( m_cobj,
+                                              Server::on_add_watch_callback,
+                                              Server::on_remove_watch_callback,
+                                              Server::on_watch_toggled_callback,
+                                              this,
+                                              NULL
+                                            );
+    if ( not result ) throw ErrorNoMemory::create();
+
+    result = dbus_server_set_timeout_functions( m_cobj,
+                                                Server::on_add_timeout_callback,
+                                                Server::on_remove_timeout_callback,
+                                                Server::on_timeout_toggled_callback,
+                                                this,
+                                                NULL
+                                              );
+    if ( not result ) throw ErrorNoMemory::create();
+
+    SIMPLELOGGER_DEBUG("dbus.Server", "Server listening on " << this->address());
+  }
+
+  Server::pointer Server::create( const std::string& address )
+  {
+    return pointer( new Server( address ) );
+  }
+
+  Server::~Server()
+  {
+    Connections::iterator c;
+    std::list<Object::pointer>::iterator o;
+
+    // Accepted connections may outlive us, but our objects must not stay
+    // registered on them once we let go of the objects
+    for ( c = m_connections.begin(); c != m_connections.end(); c++ )
+      for ( o = m_objects.begin(); o != m_objects.end(); o++ )
+        (*o)->detach_connection( *c );
+
+    if ( m_cobj == NULL ) return;
+
+    // Nothing may call back into us once we are gone
+    dbus_server_disconnect( m_cobj );
+    dbus_server_set_new_connection_function( m_cobj, NULL, NULL, NULL );
+    dbus_server_set_watch_functions( m_cobj, NULL, NULL, NULL, NULL, NULL );
+    dbus_server_set_timeout_functions( m_cobj, NULL, NULL, NULL, NULL, NULL );
+    dbus_server_unref( m_cobj );
+  }
+
+  DBusServer* Server::cobj()
+  {
+    return m_cobj;
+  }
+
+  bool Server::is_valid() const
+  {
+    return m_cobj != NULL;
+  }
+
+  bool Server::is_connected() const
+  {
+    if ( not this->is_valid() ) return false;
+    return dbus_server_get_is_connected( m_cobj );
+  }
+
+  void Server::disconnect()
+  {
+    if ( this->is_valid() ) dbus_server_disconnect( m_cobj );
+  }
+
+  std::string Server::address() const
+  {
+    std::string result;
+    char* address;
+
+    if ( not this->is_valid() ) return result;
+
+    address = dbus_server_get_address( m_cobj );
+    if ( address == NULL ) return result;
+    result = address;
+    dbus_free( address );
+    return result;
+  }
+
+  std::string Server::id() const
+  {
+    std::string result;
+    char* id;
+
+    if ( not this->is_valid() ) return result;
+
+    id = dbus_server_get_id( m_cobj );
+    if ( id == NULL ) return result;
+    result = id;
+    dbus_free( id );
+    return result;
+  }
+
+  bool Server::register_object( Object::pointer object )
+  {
+    Connections connections;
+    Connections::iterator i;
+
+    if ( not object ) return false;
+
+    {
+      std::lock_guard<std::mutex> lock( m_mutex );
+      m_objects.push_back( object );
+      connections = m_connections;
+    }
+
+    for ( i = connections.begin(); i != connections.end(); i++ )
+      object->attach_connection( *i );
+
+    return true;
+  }
+
+  Server::Connections Server::connections() const
+  {
+    Connections result;
+    Connections::const_iterator i;
+
+    std::lock_guard<std::mutex> lock( m_mutex );
+    for ( i = m_connections.begin(); i != m_connections.end(); i++ )
+      if ( (*i)->is_connected() ) result.push_back( *i );
+
+    return result;
+  }
+
+  int Server::send( Message::const_pointer msg )
+  {
+    Connections connections = this->connections();
+    Connections::iterator i;
+    int sent = 0;
+
+    for ( i = connections.begin(); i != connections.end(); i++ )
+      if ( (*i)->send( msg ) ) sent++;
+
+    return sent;
+  }
+
+  sigc::signal<void,Connection::pointer>& Server::signal_new_connection()
+  {
+    return m_signal_new_connection;
+  }
+
+  Connection::AddWatchSignal& Server::signal_add_watch()
+  {
+    return m_add_watch_signal;
+  }
+
+  sigc::signal<bool,Watch::pointer>& Server::signal_remove_watch()
+  {
+    return m_remove_watch_signal;
+  }
+
+  sigc::signal<void,Watch::pointer>& Server::signal_watch_toggled()
+  {
+    return m_watch_toggled_signal;
+  }
+
+  Server::Watches Server::unhandled_watches() const
+  {
+    std::lock_guard<std::mutex> lock( m_mutex );
+    return m_unhandled_watches;
+  }
+
+  void Server::remove_unhandled_watch( const Watch::pointer w )
+  {
+    Watches::iterator i;
+
+    if ( not w ) return;
+
+    std::lock_guard<std::mutex> lock( m_mutex );
+    for ( i = m_unhandled_watches.begin(); i != m_unhandled_watches.end(); i++ )
+    {
+      if ( (*i)->cobj() == w->cobj() )
+      {
+        m_unhandled_watches.erase( i );
+        break;
+      }
+    }
+  }
+
+  Connection::AddTimeoutSignal& Server::signal_add_timeout()
+  {
+    return m_add_timeout_signal;
+  }
+
+  sigc::signal<bool,Timeout::pointer>& Server::signal_remove_timeout()
+  {
+    return m_remove_timeout_signal;
+  }
+
+  sigc::signal<bool,Timeout::pointer>& Server::signal_timeout_toggled()
+  {
+    return m_timeout_toggled_signal;
+  }
+
+  Server::Timeouts Server::unhandled_timeouts() const
+  {
+    std::lock_guard<std::mutex> lock( m_mutex );
+    return m_unhandled_timeouts;
+  }
+
+  void Server::remove_unhandled_timeout( const Timeout::pointer t )
+  {
+    Timeouts::iterator i;
+
+    if ( not t ) return;
+
+    std::lock_guard<std::mutex> lock( m_mutex );
+    i = std::find( m_unhandled_timeouts.begin(), m_unhandled_timeouts.end(), t );
+    if ( i != m_unhandled_timeouts.end() ) m_unhandled_timeouts.erase( i );
+  }
+
+  void Server::on_new_connection_callback( DBusServer* server, DBusConnection* connection, void* data )
+  {
+    Server* self = static_cast<Server*>( data );
+    Connection::pointer conn;
+    std::list<Object::pointer> objects;
+    std::list<Object::pointer>::iterator o;
+    Connections::iterator i;
+
+    // Accepted connections are private; Connection takes its own reference
+    conn = Connection::create( connection, true );
+
+    SIMPLELOGGER_DEBUG("dbus.Server", "Server accepted a connection");
+
+    {
+      std::lock_guard<std::mutex> lock( self->m_mutex );
+
+      // Forget peers that have gone away
+      i = self->m_connections.begin();
+      while ( i != self->m_connections.end() )
+      {
+        if ( (*i)->is_connected() ) i++;
+        else i = self->m_connections.erase( i );
+      }
+
+      self->m_connections.push_back( conn );
+      objects = self->m_objects;
+    }
+
+    for ( o = objects.begin(); o != objects.end(); o++ )
+      (*o)->attach_connection( conn );
+
+    self->m_signal_new_connection.emit( conn );
+  }
+
+  dbus_bool_t Server::on_add_watch_callback( DBusWatch* cwatch, void* data )
+  {
+    bool result;
+    Server* server = static_cast<Server*>( data );
+    Watch::pointer watch = Watch::create( cwatch );
+    result = server->signal_add_watch().emit( watch );
+    if ( not result ) {
+      std::lock_guard<std::mutex> lock( server->m_mutex );
+      server->m_unhandled_watches.push_back( watch );
+    }
+    return true;
+  }
+
+  void Server::on_remove_watch_callback( DBusWatch* cwatch, void* data )
+  {
+    Server* server = static_cast<Server*>( data );
+    Watch::pointer watch = Watch::create( cwatch );
+
+    // A watch gone before a dispatcher took it must not be handed out later
+    server->remove_unhandled_watch( watch );
+    server->signal_remove_watch().emit( watch );
+  }
+
+  void Server::on_watch_toggled_callback( DBusWatch* cwatch, void* data )
+  {
+    Server* server = static_cast<Server*>( data );
+    server->signal_watch_toggled().emit( Watch::create( cwatch ) );
+  }
+
+  // Timeouts are driven by a Dispatcher, as those of a Connection are
+  dbus_bool_t Server::on_add_timeout_callback( DBusTimeout* ctimeout, void* data )
+  {
+    bool result;
+    Server* server = static_cast<Server*>( data );
+    Timeout::pointer timeout = Timeout::create( ctimeout );
+    result = server->signal_add_timeout().emit( timeout );
+    if ( not result ) {
+      std::lock_guard<std::mutex> lock( server->m_mutex );
+      server->m_unhandled_timeouts.push_back( timeout );
+    }
+    return true;
+  }
+
+  void Server::on_remove_timeout_callback( DBusTimeout* ctimeout, void* data )
+  {
+    Server* server = static_cast<Server*>( data );
+    Timeout::pointer timeout = Timeout::create( ctimeout );
+    server->remove_unhandled_timeout( timeout );
+    server->signal_remove_timeout().emit( timeout );
+  }
+
+  void Server::on_timeout_toggled_callback( DBusTimeout* ctimeout, void* data )
+  {
+    Server* server = static_cast<Server*>( data );
+    server->signal_timeout_toggled().emit( Timeout::create( ctimeout ) );
+  }
+
+}
@@ -0,0 +1,191 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by agent                                           *
+ *   agent@local                                                           *
+ *                                                                         *
+ *   This file is part of the dbus-cxx library.                            *
+ *                                                                         *
+ *   The dbus-cxx library is free software; you can redistribute it and/or *
+ *   modify it under the terms of the GNU General Public License           *
+ *   version 3 as published by the Free Software Foundation.               *
+ *                                                                         *
+ *   The dbus-cxx library is distributed in the hope that it will be       *
+ *   useful, but WITHOUT ANY WARRANTY; without even the implied warranty   *
+ *   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU   *
+ *   General Public License for more details.                              *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this software. If not see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#include <deque>
+#include <list>
+#include <mutex>
+#include <string>
+
+#include <sigc++/sigc++.h>
+
+#include <dbus/dbus.h>
+#include <dbus-cxx/connection.h>
+#include <dbus-cxx/watch.h>
+#include <dbus-cxx/timeout.h>
+
+#ifndef DBUSCXX_SERVER_H
+#define DBUSCXX_SERVER_H
+
+namespace DBus
+{
+
+  /**
+   * Listens for direct peer to peer connections, without a bus daemon.
+   *
+   * A server listens on one or more addresses in DBus address syntax, such
+   * as "unix:path=/tmp/socket", "unix:abstract=name" or
+   * "tcp:host=localhost,port=0". Each client it accepts becomes a private
+   * Connection. Objects passed to register_object() are served on every
+   * connection accepted before or after the call.
+   *
+   * Add the server to a Dispatcher with Dispatcher::add_server(). The
+   * dispatcher then watches the listening sockets and dispatches every
+   * accepted connection. Clients connect with Connection::create_peer().
+   *
+   * Signals emitted by a registered Object are sent on its own connection
+   * only. Use send() to deliver a message to every peer.
+   *
+   * @ingroup core
+   *
+   * @author agent <agent@local>
+   */
+  class Server
+  {
+    protected:
+
+      Server( const std::string& address );
+
+    public:
+
+      typedef DBusCxxPointer<Server> pointer;
+
+      typedef std::list<Connection::pointer> Connections;
+
+      /**
+       * Starts listening on the address
+       * @throw Error if the server could not listen on the address
+       */
+      static pointer create( const std::string& address );
+
+      virtual ~Server();
+
+      DBusServer* cobj();
+
+      bool is_valid() const;
+
+      bool is_connected() const;
+
+      /** Stops listening; connections already accepted stay open */
+      void disconnect();
+
+      /** The address clients can connect to, including any port or path chosen by the server */
+      std::string address() const;
+
+      /** The server's unique ID */
+      std::string id() const;
+
+      /**
+       * Serves the object on every connection accepted so far and on every
+       * connection accepted later
+       */
+      bool register_object( Object::pointer object );
+
+      /** Returns the connections accepted so far that are still connected */
+      Connections connections() const;
+
+      /**
+       * Sends the message on every connection
+       * @return The number of connections the message was queued on
+       */
+      int send( Message::const_pointer msg );
+
+      /**
+       * Emitted for each client accepted, after the registered objects have
+       * been attached to its connection
+       */
+      sigc::signal<void,Connection::pointer>& signal_new_connection();
+
+      /** Cannot call watch.handle() in a slot connected to this signal */
+      Connection::AddWatchSignal& signal_add_watch();
+
+      sigc::signal<bool,Watch::pointer>& signal_remove_watch();
+
+      sigc::signal<void,Watch::pointer>& signal_watch_toggled();
+
+      typedef std::deque<Watch::pointer> Watches;
+
+      /**
+       * Returns a copy of the watches that were added before anything was
+       * connected to signal_add_watch(); libdbus may add more from any thread
+       */
+      Watches unhandled_watches() const;
+
+      void remove_unhandled_watch( const Watch::pointer w );
+
+      /** Cannot call timeout.handle() in a slot connected to this signal */
+      Connection::AddTimeoutSignal& signal_add_timeout();
+
+      sigc::signal<bool,Timeout::pointer>& signal_remove_timeout();
+
+      sigc::signal<bool,Timeout::pointer>& signal_timeout_toggled();
+
+      typedef std::deque<Timeout::pointer> Timeouts;
+
+      /** Returns a copy of the timeouts that were added before anything was connected to signal_add_timeout() */
+      Timeouts unhandled_timeouts() const;
+
+      void remove_unhandled_timeout( const Timeout::pointer t );
+
+    protected:
+
+      DBusServer* m_cobj;
+
+      Connections m_connections;
+
+      std::list<Object::pointer> m_objects;
+
+      /** Serializes access to the connections, objects and unhandled watches and timeouts */
+      mutable std::mutex m_mutex;
+
+      Watches m_unhandled_watches;
+
+      Timeouts m_unhandled_timeouts;
+
+      sigc::signal<void,Connection::pointer> m_signal_new_connection;
+
+      Connection::AddWatchSignal m_add_watch_signal;
+
+      sigc::signal<bool,Watch::pointer> m_remove_watch_signal;
+
+      sigc::signal<void,Watch::pointer> m_watch_toggled_signal;
+
+      Connection::AddTimeoutSignal m_add_timeout_signal;
+
+      sigc::signal<bool,Timeout::pointer> m_remove_timeout_signal;
+
+      sigc::signal<bool,Timeout::pointer> m_timeout_toggled_signal;
+
+      static void on_new_connection_callback( DBusServer* server, DBusConnection* connection, void* data );
+
+      static dbus_bool_t on_add_watch_callback( DBusWatch* cwatch, void* data );
+
+      static void on_remove_watch_callback( DBusWatch* cwatch, void* data );
+
+      static void on_watch_toggled_callback( DBusWatch* cwatch, void* data );
+
+      static dbus_bool_t on_add_timeout_callback( DBusTimeout* ctimeout, void* data );
+
+      static void on_remove_timeout_callback( DBusTimeout* ctimeout, void* data );
+
+      static void on_timeout_toggled_callback( DBusTimeout* ctimeout, void* data );
+
+  };
+
+}
+
+#endif
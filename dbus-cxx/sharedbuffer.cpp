@@ -0,0 +1,274 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by agent                                           *
+ *   agent@local                                                           *
+ *                                                                         *
+ *   This file is part of the dbus-cxx library.                            *
+ *                                                                         *
+ *   The dbus-cxx library is free software; you can redistribute it and/or *
+ *   modify it under the terms of the GNU General Public License           *
+ *   version 3 as published by the Free Software Foundation.               *
+ *                                                                         *
+ *   The dbus-cxx library is distributed in the hope that it will be       *
+ *   useful, but WITHOUT ANY WARRANTY; without even the implied warranty   *
+ *   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU   *
+ *   General Public License for more details.                              *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this software. If not see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include "sharedbuffer.h"
+#include "error.h"
+#include "dbus-cxx-config.h"
+#include "dbus-cxx-private.h"
+
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace DBus
+{
+
+  std::atomic<size_t> SharedBuffer::m_inline_threshold( 64 * 1024 );
+
+  SharedBuffer::SharedBuffer( size_t size ):
+      m_fd( -1 ),
+      m_map( NULL ),
+      m_map_size( 0 ),
+      m_data( NULL ),
+      m_size( size ),
+      m_offset( 0 ),
+      m_sealed( false )
+  {
+#ifdef DBUS_CXX_HAVE_MEMFD
+    if ( size > 0 and size >= m_inline_threshold )
+    {
+      m_fd = memfd_create( "dbus-cxx-shared-buffer", MFD_CLOEXEC | MFD_ALLOW_SEALING );
+
+      if ( m_fd >= 0 and ftruncate( m_fd, size ) == 0 )
+      {
+        m_map = mmap( NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0 );
+        if ( m_map != MAP_FAILED )
+        {
+          m_map_size = size;
+          m_data = static_cast<uint8_t*>( m_map );
+          return;
+        }
+        m_map = NULL;
+      }
+
+      SIMPLELOGGER_WARN("dbus.SharedBuffer", "Unable to create a memfd of " << size << " bytes, keeping the buffer inline: " << strerror( errno ) );
+      if ( m_fd >= 0 ) close( m_fd );
+      m_fd = -1;
+    }
+#endif
+
+    m_inline.resize( size );
+    m_data = m_inline.data();
+  }
+
+  SharedBuffer::SharedBuffer( int fd, uint64_t offset, uint64_t length ):
+      m_fd( fd ),
+      m_map( NULL ),
+      m_map_size( 0 ),
+      m_data( NULL ),
+      m_size( length ),
+      m_offset( offset ),
+      m_sealed( true )
+  {
+    struct stat st;
+    uint64_t page = sysconf( _SC_PAGESIZE );
+    uint64_t map_offset = offset - ( offset % page );
+
+    if ( length == 0 ) return;
+
+#ifdef DBUS_CXX_HAVE_MEMFD
+    // Without these seals the sender could change the pages under us, or
+    // truncate the file and make every access to the mapping fault
+    int seals = fcntl( fd, F_GET_SEALS );
+    if ( seals < 0 or ( seals & ( F_SEAL_WRITE | F_SEAL_SHRINK ) ) != ( F_SEAL_WRITE | F_SEAL_SHRINK ) )
+    {
+      close( fd );
+      throw ErrorInvalidArgs::create( "SharedBuffer: received memfd is not sealed" );
+    }
+#endif
+
+    if ( fstat( fd, &st ) < 0 or offset + length < offset or (uint64_t)st.st_size < offset + length )
+    {
+      close( fd );
+      throw ErrorInvalidArgs::create( "SharedBuffer: received range is outside the memfd" );
+    }
+
+    m_map_size = offset + length - map_offset;
+    m_map = mmap( NULL, m_map_size, PROT_READ, MAP_SHARED, fd, map_offset );
+    if ( m_map == MAP_FAILED )
+    {
+      m_map = NULL;
+      close( fd );
+      throw ErrorNoMemory::create( "SharedBuffer: unable to map received memfd" );
+    }
+
+    m_data = static_cast<uint8_t*>( m_map ) + ( offset - map_offset );
+  }
+
+  SharedBuffer::SharedBuffer( pointer parent, size_t offset, size_t length ):
+      m_parent( parent ),
+      m_fd( -1 ),
+      m_map( NULL ),
+      m_map_size( 0 ),
+      m_data( NULL ),
+      m_size( length ),
+      m_offset( offset ),
+      m_sealed( false )
+  {
+  }
+
+  SharedBuffer::pointer SharedBuffer::create( size_t size )
+  {
+    pointer p = pointer( new SharedBuffer( size ) );
+    p->m_self = p;
+    return p;
+  }
+
+  SharedBuffer::pointer SharedBuffer::create( const void* data, size_t size )
+  {
+    pointer p = create( size );
+    if ( size > 0 ) memcpy( p->mutable_data(), data, size );
+    return p;
+  }
+
+  SharedBuffer::pointer SharedBuffer::create_from_fd( int fd, uint64_t offset, uint64_t length )
+  {
+    pointer p = pointer( new SharedBuffer( fd, offset, length ) );
+    p->m_self = p;
+    return p;
+  }
+
+  SharedBuffer::~SharedBuffer()
+  {
+    if ( m_map ) munmap( m_map, m_map_size );
+    if ( m_fd >= 0 ) close( m_fd );
+  }
+
+  SharedBuffer::pointer SharedBuffer::slice( size_t offset, size_t length )
+  {
+    pointer p;
+
+    if ( offset > m_size or length > m_size - offset ) return pointer();
+
+    // Slices always hang off the buffer that owns the memory
+    if ( m_parent ) return m_parent->slice( m_offset + offset, length );
+
+    p = pointer( new SharedBuffer( m_self.lock(), offset, length ) );
+    p->m_self = p;
+    return p;
+  }
+
+  const uint8_t* SharedBuffer::data() const
+  {
+    if ( m_parent ) return m_parent->data() + m_offset;
+    return m_data;
+  }
+
+  uint8_t* SharedBuffer::mutable_data()
+  {
+    uint8_t* parent_data;
+
+    if ( m_parent )
+    {
+      parent_data = m_parent->mutable_data();
+      return parent_data ? parent_data + m_offset : NULL;
+    }
+
+    if ( m_sealed ) return NULL;
+    return m_data;
+  }
+
+  size_t SharedBuffer::size() const
+  {
+    return m_size;
+  }
+
+  bool SharedBuffer::is_shared() const
+  {
+    return this->unix_fd() >= 0;
+  }
+
+  bool SharedBuffer::is_sealed() const
+  {
+    if ( m_parent ) return m_parent->is_sealed();
+    return m_sealed;
+  }
+
+  bool SharedBuffer::seal()
+  {
+    if ( m_parent ) return m_parent->seal();
+    if ( m_sealed ) return true;
+
+#ifdef DBUS_CXX_HAVE_MEMFD
+    if ( m_fd >= 0 )
+    {
+      void* readable;
+      void* writable;
+
+      // Mapped read-only first, so that failing here leaves the buffer as it was
+      readable = mmap( NULL, m_map_size, PROT_READ, MAP_SHARED, m_fd, 0 );
+      if ( readable == MAP_FAILED )
+      {
+        SIMPLELOGGER_ERROR("dbus.SharedBuffer", "Unable to map memfd for sealing: " << strerror( errno ) );
+        return false;
+      }
+
+      // The kernel refuses a write seal while writable mappings exist
+      munmap( m_map, m_map_size );
+      m_map = readable;
+      m_data = static_cast<uint8_t*>( m_map );
+
+      if ( fcntl( m_fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE | F_SEAL_SEAL ) < 0 )
+      {
+        SIMPLELOGGER_ERROR("dbus.SharedBuffer", "Unable to seal memfd: " << strerror( errno ) );
+
+        // Still unsealed, so the buffer gets its writable mapping back
+        writable = mmap( NULL, m_map_size, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0 );
+        if ( writable == MAP_FAILED )
+          throw ErrorNoMemory::create( "SharedBuffer: unable to remap memfd after failing to seal it" );
+        munmap( m_map, m_map_size );
+        m_map = writable;
+        m_data = static_cast<uint8_t*>( m_map );
+        return false;
+      }
+    }
+#endif
+
+    m_sealed = true;
+    return true;
+  }
+
+  int SharedBuffer::unix_fd() const
+  {
+    if ( m_parent ) return m_parent->unix_fd();
+    return m_fd;
+  }
+
+  uint64_t SharedBuffer::offset() const
+  {
+    if ( m_parent ) return m_parent->offset() + m_offset;
+    return m_offset;
+  }
+
+  size_t SharedBuffer::inline_threshold()
+  {
+    return m_inline_threshold;
+  }
+
+  void SharedBuffer::set_inline_threshold( size_t bytes )
+  {
+    m_inline_threshold = bytes;
+  }
+
+}
@@ -0,0 +1,162 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by agent                                           *
+ *   agent@local                                                           *
+ *                                                                         *
+ *   This file is part of the dbus-cxx library.                            *
+ *                                                                         *
+ *   The dbus-cxx library is free software; you can redistribute it and/or *
+ *   modify it under the terms of the GNU General Public License           *
+ *   version 3 as published by the Free Software Foundation.               *
+ *                                                                         *
+ *   The dbus-cxx library is distributed in the hope that it will be       *
+ *   useful, but WITHOUT ANY WARRANTY; without even the implied warranty   *
+ *   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU   *
+ *   General Public License for more details.                              *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this software. If not see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#include <atomic>
+#include <cstddef>
+#include <stdint.h>
+#include <vector>
+
+#include <dbus-cxx/pointer.h>
+
+#ifndef DBUSCXX_SHAREDBUFFER_H
+#define DBUSCXX_SHAREDBUFFER_H
+
+namespace DBus
+{
+
+  /**
+   * A block of bytes for bulk transfers that does not travel inside the message.
+   *
+   * Buffers of at least inline_threshold() bytes live in a memfd. When the
+   * buffer is appended to a message the memfd is sealed against writing and
+   * resizing and only its file descriptor, offset and length are sent. The
+   * receiver maps the same pages read-only, so the bytes are never copied
+   * through the socket or the bus daemon.
+   *
+   * Smaller buffers, and all buffers on systems without memfd_create(), are
+   * kept on the heap and sent inline as an array of bytes.
+   *
+   * On the wire a SharedBuffer is a variant holding either @c (htt) (memfd,
+   * offset, length) or @c ay, so a SharedBuffer::pointer can be used as a
+   * Method or MethodProxy argument or return value like any other type.
+   * Sending the memfd form needs a connection that can pass unix file
+   * descriptors, as FileDescriptor does.
+   *
+   * Fill the buffer through mutable_data() before sending it; once it has
+   * been sealed the contents can no longer change.
+   *
+   * @ingroup core
+   *
+   * @author agent <agent@local>
+   */
+  class SharedBuffer
+  {
+    public:
+
+      typedef DBusCxxPointer<SharedBuffer> pointer;
+
+    protected:
+
+      SharedBuffer( size_t size );
+
+      SharedBuffer( int fd, uint64_t offset, uint64_t length );
+
+      SharedBuffer( pointer parent, size_t offset, size_t length );
+
+    public:
+
+      /** Creates a writable buffer of @p size bytes */
+      static pointer create( size_t size );
+
+      /** Creates a buffer holding a copy of @p size bytes from @p data */
+      static pointer create( const void* data, size_t size );
+
+      /**
+       * Maps @p length bytes at @p offset of a received memfd read-only and
+       * takes ownership of @p fd.
+       *
+       * @throw ErrorInvalidArgs if the memfd is not sealed against writing and
+       *        shrinking or is too short, ErrorNoMemory if it cannot be mapped
+       */
+      static pointer create_from_fd( int fd, uint64_t offset, uint64_t length );
+
+      ~SharedBuffer();
+
+      /**
+       * Returns a buffer for @p length bytes starting at @p offset of this one.
+       * The slice shares this buffer's memory, and sending it sends the same
+       * memfd with the slice's offset and length.
+       */
+      pointer slice( size_t offset, size_t length );
+
+      const uint8_t* data() const;
+
+      /** Returns the bytes for writing, or NULL once the buffer is sealed */
+      uint8_t* mutable_data();
+
+      size_t size() const;
+
+      /** True if the buffer lives in a memfd and is sent by file descriptor */
+      bool is_shared() const;
+
+      bool is_sealed() const;
+
+      /**
+       * Makes the contents immutable. Memfd backed buffers are remapped
+       * read-only and sealed so that receivers can trust them; pointers from
+       * mutable_data() are invalid afterwards.
+       *
+       * Appending the buffer to a message seals it.
+       *
+       * @return false if the memfd could not be sealed; the buffer is then
+       *         left unsealed and writable
+       * @throw ErrorNoMemory if the writable mapping cannot be restored
+       */
+      bool seal();
+
+      /** The memfd, or -1 if the buffer is sent inline */
+      int unix_fd() const;
+
+      /** Offset of data() within the memfd */
+      uint64_t offset() const;
+
+      /** Buffers smaller than this many bytes are sent inline; the default is 64 KiB */
+      static size_t inline_threshold();
+
+      static void set_inline_threshold( size_t bytes );
+
+    protected:
+
+      /** Set by the create() methods so that slices can keep us alive */
+      DBusCxxWeakPointer<SharedBuffer> m_self;
+
+      pointer m_parent;
+
+      int m_fd;
+
+      void* m_map;
+
+      size_t m_map_size;
+
+      std::vector<uint8_t> m_inline;
+
+      uint8_t* m_data;
+
+      size_t m_size;
+
+      uint64_t m_offset;
+
+      bool m_sealed;
+
+      static std::atomic<size_t> m_inline_threshold;
+
+  };
+
+}
+
+#endif
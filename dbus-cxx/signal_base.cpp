@@ -22,19 +22,109 @@
 #include "signalmessage.h"
 #include "connection.h"
 
+#include <algorithm>
+#include <map>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+
 namespace DBus
 {
 
+  struct signal_base::EmissionState
+  {
+    struct Window
+    {
+      Window(): has_sent(false), is_scheduled(false) { }
+
+      std::chrono::steady_clock::time_point last_sent;
+      bool has_sent;
+      bool is_scheduled;
+      std::function<void()> pending;
+    };
+
+    EmissionState(): max_rate(0.0), per_path(false), trailing(false), suppressed(0), flushed(0), sweep_at(min_sweep) { }
+
+    std::chrono::steady_clock::duration interval() const
+    {
+      return std::chrono::duration_cast<std::chrono::steady_clock::duration>( std::chrono::duration<double>( 1.0 / max_rate ) );
+    }
+
+    std::string key( const std::string& path ) const
+    {
+      return per_path ? path : std::string();
+    }
+
+    /**
+     * Drops the windows of paths that would admit their next emission and
+     * have nothing pending, once the map has doubled since the last sweep;
+     * mutex must be held
+     */
+    void evict_idle( std::chrono::steady_clock::time_point now )
+    {
+      if ( windows.size() < sweep_at ) return;
+
+      std::chrono::steady_clock::duration window_interval = interval();
+      std::map<std::string,Window>::iterator i = windows.begin();
+      while ( i != windows.end() )
+      {
+        if ( not i->second.is_scheduled and not i->second.pending and now - i->second.last_sent >= window_interval )
+          windows.erase( i++ );
+        else
+          ++i;
+      }
+
+      sweep_at = std::max( min_sweep, 2 * windows.size() );
+    }
+
+    /**
+     * Moves every held emission to sends as if it were sent now; mutex must
+     * be held. A scheduled flush then finds nothing to send.
+     */
+    void take_pending( std::vector<std::function<void()> >& sends )
+    {
+      std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+      std::map<std::string,Window>::iterator i;
+
+      for ( i = windows.begin(); i != windows.end(); ++i )
+      {
+        if ( not i->second.pending ) continue;
+        sends.push_back( i->second.pending );
+        i->second.pending = std::function<void()>();
+        i->second.last_sent = now;
+        i->second.has_sent = true;
+        flushed++;
+      }
+    }
+
+    static const size_t min_sweep = 64;
+
+    std::atomic<double> max_rate;
+    std::atomic<bool> per_path;
+    std::atomic<bool> trailing;
+    std::atomic<unsigned long> suppressed;
+    std::atomic<unsigned long> flushed;
+
+    std::mutex mutex;
+    std::map<std::string,Window> windows;
+    size_t sweep_at;
+  };
+
+  const size_t signal_base::EmissionState::min_sweep;
+
   signal_base::signal_base(const std::string& path, const std::string& interface, const std::string& name):
       m_path(path),
       m_interface(interface),
-      m_name(name)
+      m_name(name),
+      m_emission_state(new EmissionState)
   {
   }
 
   signal_base::signal_base(const std::string& interface, const std::string& name):
       m_interface(interface),
-      m_name(name)
+      m_name(name),
+      m_emission_state(new EmissionState)
   {
   }
 
@@ -42,14 +132,16 @@ namespace DBus
       m_connection(connection),
       m_path(path),
       m_interface(interface),
-      m_name(name)
+      m_name(name),
+      m_emission_state(new EmissionState)
   {
   }
 
   signal_base::signal_base(Connection::pointer connection, const std::string& interface, const std::string& name):
       m_connection(connection),
       m_interface(interface),
-      m_name(name)
+      m_name(name),
+      m_emission_state(new EmissionState)
   {
   }
 
@@ -57,9 +149,13 @@ namespace DBus
       m_path(other.m_path),
       m_interface(other.m_interface),
       m_name(other.m_name),
-      m_destination(other.m_destination)
+      m_destination(other.m_destination),
+      m_emission_state(new EmissionState)
   {
     // TODO connect to the other's connection
+    m_emission_state->max_rate = other.m_emission_state->max_rate.load();
+    m_emission_state->per_path = other.m_emission_state->per_path.load();
+    m_emission_state->trailing = other.m_emission_state->trailing.load();
   }
 
   signal_base::~signal_base()
@@ -140,6 +236,157 @@ namespace DBus
   {
   }
 
+  void signal_base::set_max_rate( double messages_per_second )
+  {
+    m_emission_state->max_rate = messages_per_second > 0.0 ? messages_per_second : 0.0;
+  }
+
+  double signal_base::max_rate() const
+  {
+    return m_emission_state->max_rate;
+  }
+
+  void signal_base::set_coalesce_by_path( bool coalesce )
+  {
+    EmissionState& state = *m_emission_state;
+    std::vector<std::function<void()> > held;
+
+    {
+      std::lock_guard<std::mutex> lock( state.mutex );
+      if ( state.per_path == coalesce ) return;
+
+      // Windows are keyed by path or not at all, so the old ones can't be kept
+      state.take_pending( held );
+      state.windows.clear();
+      state.sweep_at = EmissionState::min_sweep;
+      state.per_path = coalesce;
+    }
+
+    for ( size_t i = 0; i < held.size(); i++ ) held[i]();
+  }
+
+  bool signal_base::coalesce_by_path() const
+  {
+    return m_emission_state->per_path;
+  }
+
+  void signal_base::set_trailing_flush( bool flush )
+  {
+    m_emission_state->trailing = flush;
+  }
+
+  bool signal_base::trailing_flush() const
+  {
+    return m_emission_state->trailing;
+  }
+
+  void signal_base::flush_emissions()
+  {
+    EmissionState& state = *m_emission_state;
+    std::vector<std::function<void()> > held;
+
+    {
+      std::lock_guard<std::mutex> lock( state.mutex );
+      state.take_pending( held );
+    }
+
+    for ( size_t i = 0; i < held.size(); i++ ) held[i]();
+  }
+
+  unsigned long signal_base::suppressed_emissions() const
+  {
+    return m_emission_state->suppressed;
+  }
+
+  unsigned long signal_base::flushed_emissions() const
+  {
+    return m_emission_state->flushed;
+  }
+
+  bool signal_base::is_rate_limited() const
+  {
+    return m_emission_state->max_rate > 0.0;
+  }
+
+  bool signal_base::admit_emission( const std::string& path )
+  {
+    EmissionState& state = *m_emission_state;
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+    std::lock_guard<std::mutex> lock( state.mutex );
+    state.evict_idle( now );
+    EmissionState::Window& window = state.windows[ state.key(path) ];
+
+    if ( window.has_sent and now - window.last_sent < state.interval() ) {
+      state.suppressed++;
+      return false;
+    }
+
+    // This emission is newer than any pending one, which is superseded
+    window.last_sent = now;
+    window.has_sent = true;
+    window.pending = std::function<void()>();
+    return true;
+  }
+
+  void signal_base::hold_emission( const std::string& path, std::function<void()> send )
+  {
+    EmissionState& state = *m_emission_state;
+    std::string key;
+    int delay_milliseconds;
+
+    // Nothing could keep the signal alive until the flush
+    if ( m_self.expired() ) return;
+
+    {
+      std::lock_guard<std::mutex> lock( state.mutex );
+      key = state.key(path);
+      EmissionState::Window& window = state.windows[ key ];
+      window.pending = send;
+      if ( window.is_scheduled ) return;
+
+      std::chrono::steady_clock::duration remaining = window.last_sent + state.interval() - std::chrono::steady_clock::now();
+      delay_milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>( remaining ).count() + 1;
+      window.is_scheduled = true;
+    }
+
+    Connection::pointer conn = m_connection.lock();
+    if ( not conn ) {
+      std::lock_guard<std::mutex> lock( state.mutex );
+      state.windows[ key ].is_scheduled = false;
+      return;
+    }
+
+    conn->add_deferred_call( sigc::bind( sigc::ptr_fun( &signal_base::flush_emission ), DBusCxxWeakPointer<EmissionState>( m_emission_state ), key ),
+                             delay_milliseconds > 0 ? delay_milliseconds : 0 );
+  }
+
+  void signal_base::flush_emission( DBusCxxWeakPointer<EmissionState> weak_state, std::string key )
+  {
+    DBusCxxPointer<EmissionState> state = weak_state.lock();
+    std::function<void()> send;
+
+    // The signal has been destroyed
+    if ( not state ) return;
+
+    {
+      std::lock_guard<std::mutex> lock( state->mutex );
+      std::map<std::string,EmissionState::Window>::iterator i = state->windows.find( key );
+      if ( i == state->windows.end() ) return;
+
+      i->second.is_scheduled = false;
+      if ( not i->second.pending ) return;
+
+      send = i->second.pending;
+      i->second.pending = std::function<void()>();
+      i->second.last_sent = std::chrono::steady_clock::now();
+      i->second.has_sent = true;
+      state->flushed++;
+    }
+
+    send();
+  }
+
   bool signal_base::handle_dbus_outgoing(Message::const_pointer msg)
   {
     Connection::pointer conn = m_connection.lock();
@@ -17,6 +17,8 @@
  *   along with this software. If not see <http://www.gnu.org/licenses/>.  *
  ***************************************************************************/
 #include <string>
+#include <memory>
+#include <functional>
 
 #include <sigc++/sigc++.h>
 
@@ -102,8 +104,80 @@ namespace DBus
 
       virtual void set_arg_name(size_t i, const std::string& name);
 
+      /** @name Emission Policies */
+      //@{
+
+      /**
+       * Limits how many messages per second emit() sends. Emissions over the
+       * rate are suppressed before a message is built. 0, the default, sends
+       * every emission.
+       */
+      void set_max_rate( double messages_per_second );
+
+      double max_rate() const;
+
+      /**
+       * Applies the rate to each path separately, so that frequent emissions
+       * on one path do not suppress those on another. A signal is emitted on
+       * another path than its own with emit_on_path(). Changing this sends
+       * any held emissions and starts every path with a fresh window.
+       */
+      void set_coalesce_by_path( bool coalesce=true );
+
+      bool coalesce_by_path() const;
+
+      /**
+       * Keeps the last suppressed emission of each path and sends it once the
+       * rate allows, so the latest value always reaches peers. Needs a
+       * connection that is serviced by a dispatcher and a signal made with
+       * create(); a held emission is dropped if the signal is destroyed first.
+       */
+      void set_trailing_flush( bool flush=true );
+
+      bool trailing_flush() const;
+
+      /**
+       * Sends every emission held for the trailing flush now, instead of
+       * waiting for the rate to allow it.
+       */
+      void flush_emissions();
+
+      /** The number of emissions that were not sent as they happened */
+      unsigned long suppressed_emissions() const;
+
+      /** The number of suppressed emissions that were later sent by the trailing flush */
+      unsigned long flushed_emissions() const;
+
+      //@}
+
     protected:
 
+      struct EmissionState;
+
+      /** True if a max rate has been set */
+      bool is_rate_limited() const;
+
+      /**
+       * Returns true if an emission on the path may be sent now, otherwise
+       * counts it as suppressed.
+       */
+      bool admit_emission( const std::string& path );
+
+      /**
+       * Keeps send as the pending emission of the path, replacing any older
+       * one, and schedules the trailing flush.
+       */
+      void hold_emission( const std::string& path, std::function<void()> send );
+
+      static void flush_emission( DBusCxxWeakPointer<EmissionState> state, std::string key );
+
+      /**
+       * Set by create() of the signal types, so that a deferred flush can
+       * hold the signal weakly; empty for other signals, which then hold
+       * no emissions.
+       */
+      DBusCxxWeakPointer<signal_base> m_self;
+
       DBusCxxWeakPointer<Connection> m_connection;
 
       std::string m_sender;
@@ -118,6 +192,8 @@ namespace DBus
 
       std::string m_match_rule;
 
+      DBusCxxPointer<EmissionState> m_emission_state;
+
       bool handle_dbus_outgoing( Message::const_pointer );
   };
 
@@ -51,21 +51,21 @@ class signal_proxy ifelse($1, $2,,[<LIST(T_return, LOOP(T_arg%1,$1), LOOP(nil, C
   
     signal_proxy(const std::string& interface, const std::string& name):
       signal_proxy_base(interface, name)
-    { m_signal_dbus_incoming.connect( sigc::mem_fun(*this, &signal_proxy::on_dbus_incoming) ); }
+    { this->init_arg_signature(); m_signal_dbus_incoming.connect( sigc::mem_fun(*this, &signal_proxy::on_dbus_incoming) ); }
 
     signal_proxy(const std::string& path, const std::string& interface, const std::string& name):
       signal_proxy_base(path, interface, name)
-    { m_signal_dbus_incoming.connect( sigc::mem_fun(*this, &signal_proxy::on_dbus_incoming) ); }
+    { this->init_arg_signature(); m_signal_dbus_incoming.connect( sigc::mem_fun(*this, &signal_proxy::on_dbus_incoming) ); }
 
     signal_proxy(const std::string& interface, const std::string& name, const signal_proxy& src) :
       sigc::signal<LIST(T_return, LOOP(T_arg%1, $1))>(src),
       signal_proxy_base(interface, name)
-    { m_signal_dbus_incoming.connect( sigc::mem_fun(*this, &signal_proxy::on_dbus_incoming) ); }
+    { this->init_arg_signature(); m_signal_dbus_incoming.connect( sigc::mem_fun(*this, &signal_proxy::on_dbus_incoming) ); }
 
     signal_proxy(const std::string& path, const std::string& interface, const std::string& name, const signal_proxy& src) :
       sigc::signal<LIST(T_return, LOOP(T_arg%1, $1))>(src),
       signal_proxy_base(path, interface, name)
-    { m_signal_dbus_incoming.connect( sigc::mem_fun(*this, &signal_proxy::on_dbus_incoming) ); }
+    { this->init_arg_signature(); m_signal_dbus_incoming.connect( sigc::mem_fun(*this, &signal_proxy::on_dbus_incoming) ); }
 
     static pointer create(const std::string& interface, const std::string& name)
     { return pointer( new signal_proxy(interface, name) ); }
@@ -82,8 +82,64 @@ class signal_proxy ifelse($1, $2,,[<LIST(T_return, LOOP(T_arg%1,$1), LOOP(nil, C
     virtual signal_base::pointer clone()
     { return signal_base::pointer( new signal_proxy(*this) ); }
 
+    /** The arguments of one signal in a batch */
+    typedef std::tuple<LOOP(T_arg%1, $1)> Arguments;
+
+    typedef std::vector<Arguments> Batch;
+
+    /**
+     * Emitted once per dispatch round with every signal queued since the
+     * last one while batch delivery is enabled, after each of them has been
+     * delivered to the regular slots, if any are connected.
+     */
+    sigc::signal<void,const Batch&>& signal_batch()
+    { return m_signal_batch; }
+
   protected:
 
+    sigc::signal<void,const Batch&> m_signal_batch;
+
+    void init_arg_signature()
+    {
+FOR(1,$1,[dnl
+      T_arg%1 arg%1;
+      m_arg_signature += signature(arg%1);
+],[])dnl
+    }
+
+    virtual void deliver_batch( const std::vector<SignalMessage::const_pointer>& messages )
+    {
+      // Each signal is demarshalled once, for the batch and for the
+      // regular slots; the latter only when some are connected
+      bool __per_signal = not this->empty();
+      bool __batched = not m_signal_batch.empty();
+      Batch batch;
+
+      if ( __batched ) batch.reserve( messages.size() );
+
+      for ( size_t __i = 0; __i < messages.size(); __i++ )
+      {
+        FOR(1, $1,[
+        T_arg%1 _val_%1;])
+
+        try {
+          ifelse(eval($1>0),1,[
+          Message::iterator i = messages[[__i]]->begin();
+          i FOR(1, $1,[ >> _val_%1]);
+          ],[])
+        }
+        catch ( ErrorInvalidTypecast& e ) {
+          continue;
+        }
+
+        m_metrics.count_delivery();
+        if ( __per_signal ) this->emit(LIST(LOOP(_val_%1, $1)));
+        if ( __batched ) batch.push_back( Arguments(LOOP(_val_%1, $1)) );
+      }
+
+      if ( not batch.empty() ) m_signal_batch.emit( batch );
+    }
+
     virtual HandlerResult on_dbus_incoming( SignalMessage::const_pointer msg )
     {
       //T_return _retval;
@@ -129,6 +185,8 @@ dnl
  *   You should have received a copy of the GNU General Public License     *
  *   along with this software. If not see <http://www.gnu.org/licenses/>.  *
  ***************************************************************************/]
+#include <tuple>
+#include <vector>
 #include <dbus-cxx/signal_proxy_base.h>
 
 #ifndef DBUSCXX_SIGNALPROXY_H_
@@ -18,32 +18,59 @@
  ***************************************************************************/
 
 #include "signal_proxy_base.h"
+#include "connection.h"
+#include "methodbase.h"
+
+#include <map>
+#include <mutex>
 
 namespace DBus
 {
 
+  struct signal_proxy_base::BatchState
+  {
+    BatchState(): enabled(false), coalesce(false), scheduled(false), coalesced(0) { }
+
+    typedef std::pair<std::string,std::string> Key;
+
+    std::mutex mutex;
+    DBusCxxWeakPointer<signal_proxy_base> owner;
+    bool enabled;
+    bool coalesce;
+    bool scheduled;
+    unsigned long coalesced;
+    std::vector<SignalMessage::const_pointer> queue;
+    std::map<Key,size_t> positions;
+  };
+
   signal_proxy_base::signal_proxy_base( const std::string& path, const std::string& interface, const std::string& name ):
-      signal_base( path, interface, name )
+      signal_base( path, interface, name ),
+      m_batch_state( new BatchState )
   {
   }
 
   signal_proxy_base::signal_proxy_base( const std::string& interface, const std::string& name ):
-      signal_base( interface, name )
+      signal_base( interface, name ),
+      m_batch_state( new BatchState )
   {
   }
 
   signal_proxy_base::signal_proxy_base( DBusCxxPointer<Connection>  connection, const std::string& path, const std::string& interface, const std::string& name ):
-      signal_base( connection, path, interface, name )
+      signal_base( connection, path, interface, name ),
+      m_batch_state( new BatchState )
   {
   }
 
   signal_proxy_base::signal_proxy_base( DBusCxxPointer<Connection>  connection, const std::string& interface, const std::string& name ):
-      signal_base( connection, interface, name )
+      signal_base( connection, interface, name ),
+      m_batch_state( new BatchState )
   {
   }
 
   signal_proxy_base::signal_proxy_base( const signal_proxy_base& other ):
-      signal_base( other )
+      signal_base( other ),
+      m_batch_state( new BatchState ),
+      m_arg_signature( other.m_arg_signature )
   {
     // TODO connect to the other's connection
   }
@@ -56,7 +83,127 @@ namespace DBus
   {
     if ( not this->matches( msg ) ) return NOT_HANDLED;
 
-    return m_signal_dbus_incoming.emit( msg );
+    Connection::pointer conn;
+    {
+      std::lock_guard<std::mutex> lock( m_batch_state->mutex );
+      BatchState& state = *m_batch_state;
+
+      if ( state.enabled and not state.owner.expired() ) conn = m_connection.lock();
+
+      if ( conn ) {
+        // Turned away as the proxy's own handler would, and before it can
+        // replace a queued signal that does match
+        if ( not this->arguments_match( msg ) ) return NOT_HANDLED;
+
+        if ( state.coalesce ) {
+          const char* sender = msg->sender();
+          BatchState::Key key( sender ? sender : "", msg->path() );
+          std::map<BatchState::Key,size_t>::iterator i = state.positions.find( key );
+          if ( i != state.positions.end() ) {
+            state.queue[ i->second ] = msg;
+            state.coalesced++;
+            return HANDLED;
+          }
+          state.positions[ key ] = state.queue.size();
+        }
+
+        state.queue.push_back( msg );
+        if ( state.scheduled ) return HANDLED;
+        state.scheduled = true;
+      }
+    }
+
+    if ( not conn ) {
+      m_metrics.count_delivery();
+      return m_signal_dbus_incoming.emit( msg );
+    }
+
+    // Queued signals are counted when the batch is delivered
+    conn->add_deferred_call( sigc::bind( sigc::ptr_fun( &signal_proxy_base::flush_batch ), DBusCxxWeakPointer<BatchState>( m_batch_state ) ) );
+    return HANDLED;
+  }
+
+  bool signal_proxy_base::arguments_match( SignalMessage::const_pointer msg ) const
+  {
+    if ( m_arg_signature.empty() ) return true;
+    if ( dbus_message_has_signature( msg->cobj(), m_arg_signature.c_str() ) ) return true;
+    return MethodBase::arguments_may_convert( dbus_message_get_signature( msg->cobj() ), m_arg_signature );
+  }
+
+  void signal_proxy_base::set_batch_owner( pointer owner )
+  {
+    std::lock_guard<std::mutex> lock( m_batch_state->mutex );
+    m_batch_state->owner = owner;
+  }
+
+  void signal_proxy_base::set_batch_delivery( bool batch )
+  {
+    std::lock_guard<std::mutex> lock( m_batch_state->mutex );
+    m_batch_state->enabled = batch;
+  }
+
+  bool signal_proxy_base::batch_delivery() const
+  {
+    std::lock_guard<std::mutex> lock( m_batch_state->mutex );
+    return m_batch_state->enabled;
+  }
+
+  void signal_proxy_base::set_batch_coalescing( bool coalesce )
+  {
+    std::lock_guard<std::mutex> lock( m_batch_state->mutex );
+    m_batch_state->coalesce = coalesce;
+  }
+
+  bool signal_proxy_base::batch_coalescing() const
+  {
+    std::lock_guard<std::mutex> lock( m_batch_state->mutex );
+    return m_batch_state->coalesce;
+  }
+
+  unsigned long signal_proxy_base::coalesced_signals() const
+  {
+    std::lock_guard<std::mutex> lock( m_batch_state->mutex );
+    return m_batch_state->coalesced;
+  }
+
+  SignalProxyMetrics& signal_proxy_base::metrics()
+  {
+    return m_metrics;
+  }
+
+  const SignalProxyMetrics& signal_proxy_base::metrics() const
+  {
+    return m_metrics;
+  }
+
+  void signal_proxy_base::deliver_batch( const std::vector<SignalMessage::const_pointer>& messages )
+  {
+    for ( size_t i = 0; i < messages.size(); i++ )
+    {
+      m_metrics.count_delivery();
+      m_signal_dbus_incoming.emit( messages[i] );
+    }
+  }
+
+  void signal_proxy_base::flush_batch( DBusCxxWeakPointer<BatchState> weak_state )
+  {
+    DBusCxxPointer<BatchState> state = weak_state.lock();
+    std::vector<SignalMessage::const_pointer> messages;
+    signal_proxy_base::pointer owner;
+
+    // The proxy has been destroyed
+    if ( not state ) return;
+
+    {
+      std::lock_guard<std::mutex> lock( state->mutex );
+      messages.swap( state->queue );
+      state->positions.clear();
+      state->scheduled = false;
+      // Held until the batch has been delivered
+      owner = state->owner.lock();
+    }
+
+    if ( owner and not messages.empty() ) owner->deliver_batch( messages );
   }
 
   sigc::signal< HandlerResult, SignalMessage::const_pointer >::accumulated< MessageHandlerAccumulator > signal_proxy_base::signal_dbus_incoming()
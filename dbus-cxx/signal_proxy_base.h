@@ -16,7 +16,10 @@
  *   You should have received a copy of the GNU General Public License     *
  *   along with this software. If not see <http://www.gnu.org/licenses/>.  *
  ***************************************************************************/
+#include <vector>
+
 #include <dbus-cxx/signal_base.h>
+#include <dbus-cxx/metrics.h>
 
 #ifndef DBUSCXX_SIGNALPROXYBASE_H
 #define DBUSCXX_SIGNALPROXYBASE_H
@@ -64,10 +67,78 @@ namespace DBus
        */
       virtual signal_base::pointer clone() = 0;
 
+      /** @name Batched Delivery */
+      //@{
+
+      /**
+       * Queues incoming signals instead of handling each one as it arrives.
+       * The queue is delivered with deliver_batch() once per dispatch round.
+       * A typed signal_proxy demarshals each queued signal once and emits
+       * them together through signal_batch(); its regular slots are only
+       * called for each signal if any are connected, and
+       * signal_dbus_incoming() is not emitted for batched signals.
+       *
+       * Only takes effect once the proxy has been added to a connection.
+       */
+      void set_batch_delivery( bool batch=true );
+
+      bool batch_delivery() const;
+
+      /**
+       * Keeps only the latest queued signal from each sender and path.
+       * Replaced signals are never demarshalled.
+       */
+      void set_batch_coalescing( bool coalesce=true );
+
+      bool batch_coalescing() const;
+
+      /** The number of queued signals replaced by a newer one */
+      unsigned long coalesced_signals() const;
+
+      //@}
+
+      /** Counts the signals delivered to this proxy */
+      SignalProxyMetrics& metrics();
+
+      const SignalProxyMetrics& metrics() const;
+
     protected:
 
+      friend class Connection;
+
+      struct BatchState;
+
+      DBusCxxPointer<BatchState> m_batch_state;
+
+      /**
+       * The signature the arguments of a signal are extracted into, empty
+       * if any signal is accepted. Signals that can't be extracted are
+       * turned away before they are queued for a batch.
+       */
+      std::string m_arg_signature;
+
+      /** False if the arguments of the signal can't be extracted into m_arg_signature */
+      bool arguments_match( SignalMessage::const_pointer msg ) const;
+
+      /**
+       * Called by the connection the proxy is added to, so that a queued
+       * batch keeps the proxy alive until it has been delivered.
+       */
+      void set_batch_owner( pointer owner );
+
+      /**
+       * Delivers a batch of queued signals in the order they arrived and
+       * counts each delivery. The default handles each one through
+       * signal_dbus_incoming().
+       */
+      virtual void deliver_batch( const std::vector<SignalMessage::const_pointer>& messages );
+
+      static void flush_batch( DBusCxxWeakPointer<BatchState> state );
+
       std::string m_match_rule;
 
+      SignalProxyMetrics m_metrics;
+
       sigc::signal<HandlerResult,SignalMessage::const_pointer>::accumulated<MessageHandlerAccumulator> m_signal_dbus_incoming;
   };
 
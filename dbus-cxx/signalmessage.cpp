@@ -63,16 +63,24 @@ namespace DBus
 
   SignalMessage::pointer SignalMessage::create( DBusMessage* cobj, CreateMethod m )
   {
+    if ( m == CREATE_ALIAS ) {
+      SignalMessage::pointer cached_signal = dbus_cxx_dynamic_pointer_cast<SignalMessage>( Message::cached( cobj ) );
+      if ( cached_signal ) return cached_signal;
+    }
     return pointer( new SignalMessage(cobj, m) );
   }
 
   SignalMessage::pointer SignalMessage::create(Message::pointer msg)
   {
+    SignalMessage::pointer signal = dbus_cxx_dynamic_pointer_cast<SignalMessage>( msg );
+    if ( signal ) return signal;
     return pointer( new SignalMessage(msg) );
   }
 
   SignalMessage::const_pointer SignalMessage::create(Message::const_pointer msg)
   {
+    SignalMessage::const_pointer signal = dbus_cxx_dynamic_pointer_cast<const SignalMessage>( msg );
+    if ( signal ) return signal;
     return const_pointer( new SignalMessage(msg) );
   }
 
@@ -24,6 +24,8 @@
 #include <dbus-cxx/path.h>
 #include <dbus-cxx/variant.h>
 #include <dbus-cxx/filedescriptor.h>
+#include <dbus-cxx/sharedbuffer.h>
+#include <dbus-cxx/compressedbuffer.h>
 
 #ifndef DBUSCXX_SIGNATURE_H
 #define DBUSCXX_SIGNATURE_H
@@ -106,6 +108,8 @@ namespace DBus
 template <class T>
    inline std::string signature( const Variant<T> )     { return DBUS_TYPE_VARIANT_AS_STRING; }
   inline std::string signature( const FileDescriptor::pointer )  { return DBUS_TYPE_UNIX_FD_AS_STRING; }
+  inline std::string signature( const SharedBuffer::pointer )    { return DBUS_TYPE_VARIANT_AS_STRING; }
+  inline std::string signature( const CompressedBuffer::pointer ) { return "(say)"; }
 
   inline std::string signature( char )        { return DBUS_TYPE_BYTE_AS_STRING;        }
   inline std::string signature( int8_t )      { return DBUS_TYPE_BYTE_AS_STRING;        }
@@ -117,7 +121,7 @@ template <class T>
   
   inline std::string signature( float )         { return DBUS_TYPE_DOUBLE_AS_STRING; }
   
-   template <typename T> inline std::string signature( const std::vector<T> ) { T t; return DBUS_TYPE_ARRAY_AS_STRING + signature( t ); }
+   template <typename T, typename Alloc> inline std::string signature( const std::vector<T,Alloc>& ) { T t; return DBUS_TYPE_ARRAY_AS_STRING + signature( t ); }
 
    template <typename Key,typename Data> inline std::string signature( const std::map<Key,Data> )
    {
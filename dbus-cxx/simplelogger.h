@@ -28,16 +28,18 @@
  */
 #ifndef SIMPLELOGGER_LOG_FUNCTION_NAME
 #define SIMPLELOGGER_LOG_FUNCTION_NAME simplelogger_global_log_function
-#endif
 extern simplelogger_log_function SIMPLELOGGER_LOG_FUNCTION_NAME;
+#endif
 
+/* The pointer is read once, as it may be changed from another thread */
 #define SIMPLELOGGER_LOG_CSTR( logger, message, level ) do{\
-    if( !SIMPLELOGGER_LOG_FUNCTION_NAME ) break;\
+    simplelogger_log_function log_function = SIMPLELOGGER_LOG_FUNCTION_NAME;\
+    if( !log_function ) break;\
     struct SL_LogLocation location;\
     location.line_number = __LINE__;\
     location.file = __FILE__;\
     location.function = SIMPLELOGGER_FUNCTION;\
-    SIMPLELOGGER_LOG_FUNCTION_NAME( logger, &location, level, message );\
+    log_function( logger, &location, level, message );\
     } while(0)
 
 #define SIMPLELOGGER_TRACE_CSTR( logger, message ) do{\
@@ -28,12 +28,35 @@ namespace DBus
       m_cobj( cobj ),
       m_is_armed(false)
   {
-    if ( m_cobj ) dbus_timeout_set_data( cobj, this, NULL );
   }
 
   Timeout::pointer Timeout::create(DBusTimeout * cobj)
   {
-    return pointer( new Timeout(cobj) );
+    if ( cobj == NULL ) return pointer( new Timeout(cobj) );
+
+    pointer* cached = static_cast<pointer*>( dbus_timeout_get_data( cobj ) );
+    if ( cached ) return *cached;
+
+    pointer timeout( new Timeout(cobj) );
+    dbus_timeout_set_data( cobj, new pointer( timeout ), Timeout::free_wrapper );
+    return timeout;
+  }
+
+  void Timeout::free_wrapper( void* data )
+  {
+    pointer* cached = static_cast<pointer*>( data );
+
+    Timeout& timeout = **cached;
+
+    // Disarm first and clear under both locks so neither a concurrent
+    // arm() nor a pending timer callback can reach the freed timeout
+    {
+      std::lock_guard<std::mutex> arming_lock( timeout.m_arming_mutex );
+      timeout.disarm();
+      std::lock_guard<std::mutex> lock( timeout.m_cobj_mutex );
+      timeout.m_cobj = NULL;
+    }
+    delete cached;
   }
     
   Timeout::~Timeout()
@@ -42,9 +65,15 @@ namespace DBus
     if ( m_is_armed ) timer_delete( m_timer_id );
   }
 
+  DBusTimeout* Timeout::load_cobj() const
+  {
+    std::lock_guard<std::mutex> lock( m_cobj_mutex );
+    return m_cobj;
+  }
+
   bool Timeout::is_valid() const
   {
-    return m_cobj != NULL;
+    return this->load_cobj() != NULL;
   }
 
   Timeout::operator bool() const
@@ -54,30 +83,35 @@ namespace DBus
 
   int Timeout::interval( ) const
   {
-    if ( not this->is_valid() ) throw ErrorInvalidCObject::create();
+    std::lock_guard<std::mutex> lock( m_cobj_mutex );
+    if ( m_cobj == NULL ) throw ErrorInvalidCObject::create();
     return dbus_timeout_get_interval( m_cobj );
   }
 
   bool Timeout::is_enabled( ) const
   {
-    if ( not this->is_valid() ) throw ErrorInvalidCObject::create();
+    std::lock_guard<std::mutex> lock( m_cobj_mutex );
+    if ( m_cobj == NULL ) return false;
     return dbus_timeout_get_enabled( m_cobj );
   }
 
   bool Timeout::handle( )
   {
-    if ( not this->is_valid() ) throw ErrorInvalidCObject::create();
-    return dbus_timeout_handle( m_cobj );
+    // The handler may remove (and free) this timeout, so the lock is
+    // not held across the call into libdbus
+    DBusTimeout* cobj = this->load_cobj();
+    if ( cobj == NULL ) return false;
+    return dbus_timeout_handle( cobj );
   }
 
   bool Timeout::operator ==(const Timeout & other) const
   {
-    return m_cobj == other.m_cobj;
+    return this->load_cobj() == other.load_cobj();
   }
 
   bool Timeout::operator !=(const Timeout & other) const
   {
-    return m_cobj != other.m_cobj;
+    return this->load_cobj() != other.load_cobj();
   }
 
   void Timeout::arm(bool should_arm)
@@ -85,6 +119,13 @@ namespace DBus
     std::unique_lock<std::mutex> lock( m_arming_mutex );
     if ( should_arm )
     {
+      int intv;
+      {
+        std::lock_guard<std::mutex> cobj_lock( m_cobj_mutex );
+        if ( m_cobj == NULL ) return;
+        intv = dbus_timeout_get_interval( m_cobj );
+      }
+
       if ( not m_is_armed )
       {
         struct sigevent sigevent = {{0},0};
@@ -96,7 +137,6 @@ namespace DBus
         timer_create( CLOCK_REALTIME, &sigevent, &m_timer_id);
       }
       
-      int intv = this->interval();
       time_t sec;
       long int nsec;
       sec = intv / 1000;
@@ -109,11 +149,16 @@ namespace DBus
     }
     else
     {
-      if ( m_is_armed )
-      {
-          m_is_armed = false;
-          timer_delete( m_timer_id );
-      }
+      this->disarm();
+    }
+  }
+
+  void Timeout::disarm()
+  {
+    if ( m_is_armed )
+    {
+      m_is_armed = false;
+      timer_delete( m_timer_id );
     }
   }
 
@@ -124,12 +169,12 @@ namespace DBus
 
   DBusTimeout* Timeout::cobj( )
   {
-    return m_cobj;
+    return this->load_cobj();
   }
 
   Timeout::operator DBusTimeout*()
   {
-    return m_cobj;
+    return this->load_cobj();
   }
 
   void Timeout::timer_callback_proxy( sigval_t sv ) {
@@ -137,7 +182,8 @@ namespace DBus
     Timeout* t;
     t = ( Timeout* ) sv.sival_ptr;
 
-    if ( t != NULL and t->is_valid() ) t->handle();
+    // handle() does nothing once the timeout has been freed
+    if ( t != NULL ) t->handle();
   }
 
 }
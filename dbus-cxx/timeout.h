@@ -48,6 +48,11 @@ namespace DBus
       typedef DBusCxxPointer<Timeout> pointer;
       typedef DBusCxxWeakPointer<Timeout> weak_pointer;
       
+      /**
+       * Returns the wrapper of cobj, making it on the first call. The
+       * wrapper is kept in the timeout's data until libdbus frees the
+       * timeout, which also invalidates it.
+       */
       static pointer create( DBusTimeout* cobj=NULL );
       
       ~Timeout();
@@ -58,8 +63,10 @@ namespace DBus
 
       int interval() const;
 
+      /** False once libdbus has freed the timeout */
       bool is_enabled() const;
 
+      /** Returns false without handling once libdbus has freed the timeout */
       bool handle();
 
       bool operator==(const Timeout& other) const;
@@ -83,8 +90,18 @@ namespace DBus
 
       std::mutex m_arming_mutex;
 
+      /** Guards m_cobj against free_wrapper(); taken after m_arming_mutex */
+      mutable std::mutex m_cobj_mutex;
+
+      DBusTimeout* load_cobj() const;
+
+      /** Deletes the timer; m_arming_mutex must be held */
+      void disarm();
+
       static void timer_callback_proxy( sigval_t sv );
 
+      static void free_wrapper( void* data );
+
   };
 
 }
@@ -0,0 +1,348 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by agent                                           *
+ *   agent@local                                                           *
+ *                                                                         *
+ *   This file is part of the dbus-cxx library.                            *
+ *                                                                         *
+ *   The dbus-cxx library is free software; you can redistribute it and/or *
+ *   modify it under the terms of the GNU General Public License           *
+ *   version 3 as published by the Free Software Foundation.               *
+ *                                                                         *
+ *   The dbus-cxx library is distributed in the hope that it will be       *
+ *   useful, but WITHOUT ANY WARRANTY; without even the implied warranty   *
+ *   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU   *
+ *   General Public License for more details.                              *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this software. If not see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <unistd.h>
+#include <sys/syscall.h>
+
+#include "tracing.h"
+
+std::atomic<bool> dbuscxx_trace_enabled( false );
+
+namespace DBus
+{
+
+  namespace priv
+  {
+
+    /**
+     * The ring of trace events of one thread.
+     *
+     * Only the owning thread writes. Each slot carries a sequence number
+     * that is odd while the slot is being written, so a reader on another
+     * thread can tell a complete event from one that is being overwritten
+     * without taking a lock.
+     */
+    class TraceBuffer
+    {
+      public:
+
+        TraceBuffer( unsigned int capacity, uint32_t thread );
+
+        void record( TraceEvent event, DBusMessage* message, uint32_t reply_serial );
+
+        /** Appends the complete events recorded at or after since */
+        void read( std::vector<TraceRecord>& records, uint64_t since ) const;
+
+        /** The capacity asked for, before rounding */
+        unsigned int capacity() const { return m_capacity; }
+
+        /** Marks the ring as no longer written, once its thread exits or replaces it */
+        void retire() { m_retired = true; }
+
+        bool is_retired() const { return m_retired; }
+
+        /** True if the newest event was recorded at or after since */
+        bool has_events_since( uint64_t since ) const;
+
+      protected:
+
+        struct Slot
+        {
+          std::atomic<uint64_t> sequence;
+          TraceRecord record;
+        };
+
+        std::unique_ptr<Slot[]> m_slots;
+
+        size_t m_mask;
+
+        std::atomic<uint64_t> m_head;
+
+        uint32_t m_thread;
+
+        unsigned int m_capacity;
+
+        std::atomic<bool> m_retired;
+    };
+
+  }
+
+  static std::mutex trace_mutex;
+
+  static std::vector<std::shared_ptr<priv::TraceBuffer> > trace_buffers;
+
+  static std::atomic<unsigned int> trace_capacity( 4096 );
+
+  /** Events older than this were dropped by clearTrace() */
+  static std::atomic<uint64_t> trace_cleared( 0 );
+
+  /** Rings of exited threads kept beyond those with events since clearTrace() */
+  static const size_t max_retired_trace_buffers = 64;
+
+  /** Retires the thread's ring when the thread exits */
+  struct ThreadTraceBuffer
+  {
+    ~ThreadTraceBuffer() { if ( buffer ) buffer->retire(); }
+
+    std::shared_ptr<priv::TraceBuffer> buffer;
+  };
+
+  static thread_local ThreadTraceBuffer thread_trace_buffer;
+
+  static uint64_t trace_now()
+  {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch() ).count();
+  }
+
+  /**
+   * Drops retired rings whose events were all cleared, then the oldest
+   * retired rings beyond the limit; trace_mutex must be held
+   */
+  static void prune_trace_buffers()
+  {
+    uint64_t since = trace_cleared;
+    size_t retired = 0;
+    size_t i;
+
+    for ( i = 0; i < trace_buffers.size(); )
+    {
+      if ( trace_buffers[i]->is_retired() and not trace_buffers[i]->has_events_since( since ) )
+        trace_buffers.erase( trace_buffers.begin() + i );
+      else
+        i++;
+    }
+
+    for ( i = trace_buffers.size(); i > 0; i-- )
+    {
+      if ( not trace_buffers[i-1]->is_retired() ) continue;
+      if ( ++retired > max_retired_trace_buffers ) trace_buffers.erase( trace_buffers.begin() + ( i - 1 ) );
+    }
+  }
+
+  static priv::TraceBuffer& trace_buffer()
+  {
+    std::shared_ptr<priv::TraceBuffer>& buffer = thread_trace_buffer.buffer;
+    unsigned int capacity = trace_capacity;
+
+    // Only this thread writes its ring, so only it may swap it for a new size
+    if ( not buffer or buffer->capacity() != capacity ) {
+      if ( buffer ) buffer->retire();
+      buffer = std::make_shared<priv::TraceBuffer>( capacity, syscall( SYS_gettid ) );
+
+      std::lock_guard<std::mutex> lock( trace_mutex );
+      prune_trace_buffers();
+      trace_buffers.push_back( buffer );
+    }
+    return *buffer;
+  }
+
+  void setTracing( bool enabled, unsigned int capacity )
+  {
+    trace_capacity = capacity;
+    dbuscxx_trace_enabled = enabled;
+  }
+
+  bool tracingEnabled()
+  {
+    return dbuscxx_trace_enabled;
+  }
+
+  void clearTrace()
+  {
+    trace_cleared = trace_now();
+
+    std::lock_guard<std::mutex> lock( trace_mutex );
+    prune_trace_buffers();
+  }
+
+  static bool record_before( const TraceRecord& a, const TraceRecord& b )
+  {
+    return a.timestamp < b.timestamp;
+  }
+
+  std::vector<TraceRecord> traceRecords()
+  {
+    std::vector<TraceRecord> records;
+    uint64_t since = trace_cleared;
+
+    {
+      std::lock_guard<std::mutex> lock( trace_mutex );
+      for ( size_t i = 0; i < trace_buffers.size(); i++ )
+        trace_buffers[i]->read( records, since );
+    }
+
+    std::stable_sort( records.begin(), records.end(), record_before );
+    return records;
+  }
+
+  static const char* trace_event_name( TraceEvent event )
+  {
+    switch ( event )
+    {
+      case TRACE_MESSAGE_RECEIVED: return "received";
+      case TRACE_MESSAGE_ROUTED:   return "routed";
+      case TRACE_DEMARSHALLED:     return "demarshalled";
+      case TRACE_HANDLER_BEGIN:    return "handler";
+      case TRACE_HANDLER_END:      return "handler";
+      case TRACE_MESSAGE_QUEUED:   return "queued";
+      case TRACE_REPLY_RECEIVED:   return "reply received";
+    }
+    return "unknown";
+  }
+
+  /** Writes a string as a JSON string literal */
+  static void write_json_string( std::ostream& stream, const char* s )
+  {
+    stream << '"';
+    for ( ; *s; s++ )
+    {
+      if ( *s == '"' or *s == '\\' ) stream << '\\' << *s;
+      else if ( (unsigned char)*s >= 0x20 ) stream << *s;
+    }
+    stream << '"';
+  }
+
+  void writeChromeTrace( std::ostream& stream )
+  {
+    std::vector<TraceRecord> records = traceRecords();
+    long pid = getpid();
+    char timestamp[32];
+
+    stream << "{\"traceEvents\":[";
+
+    for ( size_t i = 0; i < records.size(); i++ )
+    {
+      const TraceRecord& r = records[i];
+
+      // The format counts in microseconds
+      snprintf( timestamp, sizeof(timestamp), "%llu.%03u",
+                (unsigned long long)( r.timestamp / 1000 ), (unsigned int)( r.timestamp % 1000 ) );
+
+      if ( i > 0 ) stream << ",";
+      stream << "\n{\"name\":";
+
+      if ( r.event == TRACE_HANDLER_BEGIN or r.event == TRACE_HANDLER_END ) {
+        write_json_string( stream, r.member );
+        stream << ",\"cat\":\"handler\",\"ph\":\"" << ( r.event == TRACE_HANDLER_BEGIN ? "B" : "E" ) << "\"";
+      }
+      else {
+        write_json_string( stream, trace_event_name( r.event ) );
+        stream << ",\"cat\":\"message\",\"ph\":\"i\",\"s\":\"t\"";
+      }
+
+      stream << ",\"ts\":" << timestamp << ",\"pid\":" << pid << ",\"tid\":" << r.thread
+             << ",\"args\":{\"member\":";
+      write_json_string( stream, r.member );
+      stream << ",\"type\":" << r.type
+             << ",\"serial\":" << r.serial
+             << ",\"reply_serial\":" << r.reply_serial << "}}";
+    }
+
+    stream << "\n],\"displayTimeUnit\":\"ns\"}\n";
+  }
+
+  void traceMessage( TraceEvent event, DBusMessage* message )
+  {
+    trace_buffer().record( event, message, message ? dbus_message_get_reply_serial( message ) : 0 );
+  }
+
+  void traceSerial( TraceEvent event, uint32_t reply_serial )
+  {
+    trace_buffer().record( event, NULL, reply_serial );
+  }
+
+  namespace priv
+  {
+
+    TraceBuffer::TraceBuffer( unsigned int capacity, uint32_t thread ):
+      m_head( 0 ),
+      m_thread( thread ),
+      m_capacity( capacity ),
+      m_retired( false )
+    {
+      size_t size = 2;
+      while ( size < capacity ) size <<= 1;
+
+      m_slots.reset( new Slot[size] );
+      m_mask = size - 1;
+      for ( size_t i = 0; i < size; i++ ) m_slots[i].sequence.store( 0, std::memory_order_relaxed );
+    }
+
+    void TraceBuffer::record( TraceEvent event, DBusMessage* message, uint32_t reply_serial )
+    {
+      uint64_t position = m_head.load( std::memory_order_relaxed );
+      Slot& slot = m_slots[ position & m_mask ];
+      const char* member = message ? dbus_message_get_member( message ) : NULL;
+
+      slot.sequence.store( 2 * position + 1, std::memory_order_relaxed );
+      std::atomic_thread_fence( std::memory_order_release );
+
+      slot.record.timestamp = trace_now();
+      slot.record.thread = m_thread;
+      slot.record.event = event;
+      slot.record.type = message ? dbus_message_get_type( message ) : 0;
+      slot.record.serial = message ? dbus_message_get_serial( message ) : 0;
+      slot.record.reply_serial = reply_serial;
+      std::strncpy( slot.record.member, member ? member : "", sizeof(slot.record.member) - 1 );
+      slot.record.member[ sizeof(slot.record.member) - 1 ] = '\0';
+
+      slot.sequence.store( 2 * position + 2, std::memory_order_release );
+      m_head.store( position + 1, std::memory_order_release );
+    }
+
+    void TraceBuffer::read( std::vector<TraceRecord>& records, uint64_t since ) const
+    {
+      uint64_t head = m_head.load( std::memory_order_acquire );
+      uint64_t position = head > m_mask + 1 ? head - m_mask - 1 : 0;
+      TraceRecord record;
+
+      for ( ; position < head; position++ )
+      {
+        const Slot& slot = m_slots[ position & m_mask ];
+        uint64_t sequence = slot.sequence.load( std::memory_order_acquire );
+
+        if ( sequence != 2 * position + 2 ) continue;
+        record = slot.record;
+        std::atomic_thread_fence( std::memory_order_acquire );
+
+        // Overwritten while we copied it
+        if ( slot.sequence.load( std::memory_order_relaxed ) != sequence ) continue;
+
+        if ( record.timestamp >= since ) records.push_back( record );
+      }
+    }
+
+    bool TraceBuffer::has_events_since( uint64_t since ) const
+    {
+      uint64_t head = m_head.load( std::memory_order_acquire );
+
+      // Only asked of retired rings, which nobody writes any more
+      if ( head == 0 ) return false;
+      return m_slots[ ( head - 1 ) & m_mask ].record.timestamp >= since;
+    }
+
+  }
+
+}
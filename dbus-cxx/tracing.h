@@ -0,0 +1,144 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by agent                                           *
+ *   agent@local                                                           *
+ *                                                                         *
+ *   This file is part of the dbus-cxx library.                            *
+ *                                                                         *
+ *   The dbus-cxx library is free software; you can redistribute it and/or *
+ *   modify it under the terms of the GNU General Public License           *
+ *   version 3 as published by the Free Software Foundation.               *
+ *                                                                         *
+ *   The dbus-cxx library is distributed in the hope that it will be       *
+ *   useful, but WITHOUT ANY WARRANTY; without even the implied warranty   *
+ *   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU   *
+ *   General Public License for more details.                              *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this software. If not see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#include <atomic>
+#include <ostream>
+#include <vector>
+#include <stdint.h>
+#include <dbus/dbus.h>
+#include <dbus-cxx/dbus-cxx-config.h>
+
+#ifdef DBUS_CXX_HAVE_SDT
+#include <sys/sdt.h>
+#endif
+
+#ifndef DBUSCXX_TRACING_H
+#define DBUSCXX_TRACING_H
+
+/**
+ * True while trace events are being recorded. Checked inline by the
+ * DBUSCXX_TRACE macros so that a disabled tracepoint costs one relaxed load.
+ */
+extern std::atomic<bool> dbuscxx_trace_enabled;
+
+namespace DBus
+{
+
+  /** The points in the life of a message that can be traced */
+  typedef enum TraceEvent
+  {
+    TRACE_MESSAGE_RECEIVED,   /**< A message passed the connection's filter */
+    TRACE_MESSAGE_ROUTED,     /**< A message reached an object path handler */
+    TRACE_DEMARSHALLED,       /**< A method's arguments were read from the call */
+    TRACE_HANDLER_BEGIN,      /**< A method's slot was called */
+    TRACE_HANDLER_END,        /**< A method's slot returned or threw */
+    TRACE_MESSAGE_QUEUED,     /**< A message, reply or otherwise, was handed to libdbus */
+    TRACE_REPLY_RECEIVED,     /**< The reply to a pending call arrived */
+  } TraceEvent;
+
+  /**
+   * One recorded trace event.
+   *
+   * @ingroup core
+   */
+  struct TraceRecord
+  {
+    /** Nanoseconds on the steady clock */
+    uint64_t timestamp;
+
+    /** The kernel id of the thread that recorded the event */
+    uint32_t thread;
+
+    TraceEvent event;
+
+    /** The message type, or 0 if the event was not recorded from a message */
+    int type;
+
+    uint32_t serial;
+
+    uint32_t reply_serial;
+
+    /** The member of the message, truncated */
+    char member[48];
+  };
+
+  /**
+   * Starts or stops recording trace events.
+   *
+   * Each thread records into its own ring of fixed size, so recording takes
+   * no lock; once a ring is full its oldest events are overwritten. The
+   * ring of an exited thread is kept so that its events can still be
+   * dumped, until clearTrace() drops them; at most 64 such rings are kept.
+   *
+   * @param capacity The number of events each ring holds, rounded up to a
+   * power of two. Each thread moves to a ring of the new size the next time
+   * it records; its old ring is kept as that of an exited thread.
+   */
+  void setTracing( bool enabled, unsigned int capacity=4096 );
+
+  bool tracingEnabled();
+
+  /** Drops the events recorded so far */
+  void clearTrace();
+
+  /**
+   * The events of every thread in timestamp order. Events being overwritten
+   * while the rings are read are skipped.
+   */
+  std::vector<TraceRecord> traceRecords();
+
+  /**
+   * Writes the recorded events in the Chrome trace event format, which
+   * chrome://tracing and Perfetto can load. Handler begin and end events
+   * become duration slices named after the method; all others are instant
+   * events.
+   */
+  void writeChromeTrace( std::ostream& stream );
+
+  /** Records an event for a message; use DBUSCXX_TRACE instead */
+  void traceMessage( TraceEvent event, DBusMessage* message );
+
+  /** Records an event that refers to a message by serial; use DBUSCXX_TRACE_SERIAL instead */
+  void traceSerial( TraceEvent event, uint32_t reply_serial );
+
+}
+
+/*
+ * With DBUS_CXX_HAVE_SDT every tracepoint is also a USDT probe in the
+ * dbus_cxx provider, named after the event (MESSAGE_RECEIVED, ...), with
+ * the DBusMessage pointer and a reply serial as arguments.
+ */
+#ifdef DBUS_CXX_HAVE_SDT
+#define DBUSCXX_TRACE_PROBE( EVENT, message, reply_serial ) DTRACE_PROBE2( dbus_cxx, EVENT, message, reply_serial )
+#else
+#define DBUSCXX_TRACE_PROBE( EVENT, message, reply_serial )
+#endif
+
+#define DBUSCXX_TRACE( EVENT, message ) do{\
+    DBUSCXX_TRACE_PROBE( EVENT, message, 0 );\
+    if( dbuscxx_trace_enabled.load( std::memory_order_relaxed ) )\
+      DBus::traceMessage( DBus::TRACE_##EVENT, message );\
+    } while(0)
+
+#define DBUSCXX_TRACE_SERIAL( EVENT, reply_serial ) do{\
+    DBUSCXX_TRACE_PROBE( EVENT, (void*)0, reply_serial );\
+    if( dbuscxx_trace_enabled.load( std::memory_order_relaxed ) )\
+      DBus::traceSerial( DBus::TRACE_##EVENT, reply_serial );\
+    } while(0)
+
+#endif
@@ -26,6 +26,8 @@
 #include <dbus-cxx/path.h>
 #include <dbus-cxx/signature.h>
 #include <dbus-cxx/filedescriptor.h>
+#include <dbus-cxx/sharedbuffer.h>
+#include <dbus-cxx/compressedbuffer.h>
 
 #ifndef DBUSCXX_TYPES_H
 #define DBUSCXX_TYPES_H
@@ -51,6 +53,9 @@ namespace DBus
 template <class T>
   inline Type type( const Variant<T>& )            { return TYPE_VARIANT; }
   inline Type type( const FileDescriptor& )     { return TYPE_UNIX_FD; }
+  inline Type type( const FileDescriptor::pointer& ) { return TYPE_UNIX_FD; }
+  inline Type type( const SharedBuffer::pointer& ) { return TYPE_VARIANT; }
+  inline Type type( const CompressedBuffer::pointer& ) { return TYPE_STRUCT; }
   
   inline Type type( const char& )               { return TYPE_BYTE; }
   inline Type type( const int8_t& )             { return TYPE_BYTE; }
@@ -62,8 +67,8 @@ template <class T>
   
   inline Type type( const float& )               { return TYPE_DOUBLE; }
 
-  template <typename T> 
-  inline Type type(const std::vector<T>&) { return TYPE_ARRAY; }
+  template <typename T, typename Alloc>
+  inline Type type(const std::vector<T,Alloc>&) { return TYPE_ARRAY; }
 
 //   template <typename T> inline Type type(const std::vector<T>&) { return TYPE_ARRAY; }
 
@@ -104,9 +109,12 @@ template <class T>
   inline std::string type_string( const Signature& )   { return "Signature"; }
 template <class T>
   inline std::string type_string( const Variant<T>& )     { return "Variant"; }
-template <class T>
-  inline std::string type_string( const std::vector<T>& ) { return "Array"; }
+template <class T, class Alloc>
+  inline std::string type_string( const std::vector<T,Alloc>& ) { return "Array"; }
   inline std::string type_string( const FileDescriptor& ) { return "FileDescriptor"; }
+  inline std::string type_string( const FileDescriptor::pointer& ) { return "FileDescriptor"; }
+  inline std::string type_string( const SharedBuffer::pointer& ) { return "SharedBuffer"; }
+  inline std::string type_string( const CompressedBuffer::pointer& ) { return "CompressedBuffer"; }
 //  template <typename T> inline std::string type_string()   { return 1; /* This is invalid; you must use one of the specializations only */}
 /*  template<> inline std::string type_string<uint8_t>()     { return "byte"; }
   template<> inline std::string type_string<int8_t>()      { return "byte"; }
@@ -18,15 +18,12 @@
  ***************************************************************************/
 #include <mutex>
 #include <thread>
-#include <iostream>
 
 #include "utility.h"
 #include "error.h"
 #include "connection.h"
 #include "dbus-cxx-private.h"
 
-simplelogger_log_function dbuscxx_log_function = nullptr;
-
 namespace DBus
 {
   
@@ -35,8 +32,6 @@ namespace DBus
 
   bool initialized_var = false;
 
-  static enum SL_LogLevel log_level = SL_INFO;
-
   void init(bool threadsafe)
   {
     dbus_bool_t result;
@@ -54,9 +49,21 @@ namespace DBus
 
         result = dbus_connection_allocate_data_slot( & Connection::m_weak_pointer_slot );
         if ( not result ) throw ErrorFailed::create(); 
+
+        result = dbus_message_allocate_data_slot( & Connection::m_outgoing_message_slot );
+        if ( not result ) throw ErrorFailed::create();
+
+        result = dbus_message_allocate_data_slot( & Message::m_wrapper_slot );
+        if ( not result ) throw ErrorFailed::create();
     }else{
         result = dbus_connection_allocate_data_slot( & Connection::m_weak_pointer_slot );
         if ( not result ) throw ErrorFailed::create(); 
+
+        result = dbus_message_allocate_data_slot( & Connection::m_outgoing_message_slot );
+        if ( not result ) throw ErrorFailed::create();
+
+        result = dbus_message_allocate_data_slot( & Message::m_wrapper_slot );
+        if ( not result ) throw ErrorFailed::create();
     }
 
     initialized_var = true;
@@ -67,31 +74,4 @@ namespace DBus
     return initialized_var;
   }
 
-  void setLoggingFunction( simplelogger_log_function function ){
-    dbuscxx_log_function = function;
-  }
-
-  void logStdErr( const char* logger_name, const struct SL_LogLocation* location,
-      const enum SL_LogLevel level,
-      const char* log_string ){
-    if( level <= log_level ) return;
-
-    char buffer[ 4096 ];
-    const char* stringLevel;
-    std::thread::id this_id = std::this_thread::get_id();
-
-    SL_LOGLEVEL_TO_STRING( stringLevel, level );
-
-    snprintf( buffer, 4096, "0x%08X %s [%s] - %s(%s:%d)", this_id, logger_name, stringLevel, log_string, 
-      location->file,
-      location->line_number );
-    std::cerr << buffer << std::endl;
-  }
-
-  void setLogLevel( const enum SL_LogLevel level ){
-    log_level = level;
-  }
 }
-
-
-
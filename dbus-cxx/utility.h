@@ -17,6 +17,8 @@
  *   along with this software. If not see <http://www.gnu.org/licenses/>.  *
  ***************************************************************************/
 
+#include <stdint.h>
+#include <string>
 #include <dbus/dbus.h>
 #include <dbus-cxx/pointer.h>
 #include <dbus-cxx/simplelogger_defs.h>
@@ -112,6 +114,39 @@ namespace DBus
    */
   void setLogLevel( const enum ::SL_LogLevel level );
 
+  /**
+   * Messages below this level are discarded before they are formatted,
+   * unless a logger has its own threshold. By default every level is passed
+   * on to the logging function; levels below DBUS_CXX_LOG_FLOOR are never
+   * compiled in.
+   */
+  void setLogThreshold( const enum ::SL_LogLevel level );
+
+  /**
+   * Sets the threshold for one logger and the loggers below it, so that
+   * "dbus.Connection" also covers "dbus.Connection.Outgoing".
+   */
+  void setLogThreshold( const std::string& logger, const enum ::SL_LogLevel level );
+
+  /** Removes the thresholds of every logger */
+  void clearLogThresholds();
+
+  /** True if a message of this level from this logger would be logged */
+  bool logEnabled( const char* logger, const enum ::SL_LogLevel level );
+
+  /**
+   * Hands log messages to a background thread that calls the logging
+   * function, so that logging never blocks the caller. Messages go through
+   * a fixed size lock-free ring; when it is full they are dropped and
+   * counted.
+   *
+   * @param capacity The number of messages the ring holds, rounded up to a power of two
+   */
+  void setAsyncLogging( bool enabled, unsigned int capacity=1024 );
+
+  /** The number of messages the asynchronous sink had to drop */
+  uint64_t droppedLogMessages();
+
 }
 
 #endif
@@ -0,0 +1,253 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by agent                                           *
+ *   agent@local                                                           *
+ *                                                                         *
+ *   This file is part of the dbus-cxx library.                            *
+ *                                                                         *
+ *   The dbus-cxx library is free software; you can redistribute it and/or *
+ *   modify it under the terms of the GNU General Public License           *
+ *   version 3 as published by the Free Software Foundation.               *
+ *                                                                         *
+ *   The dbus-cxx library is distributed in the hope that it will be       *
+ *   useful, but WITHOUT ANY WARRANTY; without even the implied warranty   *
+ *   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU   *
+ *   General Public License for more details.                              *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this software. If not see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#include "virtualsubtree.h"
+#include "connection.h"
+#include "utility.h"
+#include "dbus-cxx-private.h"
+
+#include <cstring>
+#include <sstream>
+
+namespace DBus
+{
+
+  thread_local const std::string* VirtualSubtree::m_current_tail = NULL;
+
+  VirtualSubtree::VirtualSubtree( const std::string& path ):
+      ObjectPathHandler( path, FALLBACK )
+  {
+    pthread_rwlock_init( &m_interfaces_rwlock, NULL );
+  }
+
+  VirtualSubtree::pointer VirtualSubtree::create( const std::string& path )
+  {
+    if ( path.empty() ) return pointer();
+    return pointer( new VirtualSubtree( path ) );
+  }
+
+  VirtualSubtree::~VirtualSubtree()
+  {
+    pthread_rwlock_destroy( &m_interfaces_rwlock );
+  }
+
+  bool VirtualSubtree::add_interface( Interface::pointer interface )
+  {
+    bool result = false;
+
+    if ( not interface ) return false;
+
+    // ========== WRITE LOCK ==========
+    pthread_rwlock_wrlock( &m_interfaces_rwlock );
+
+    if ( m_interfaces.find( interface->name() ) == m_interfaces.end() )
+    {
+      m_interfaces[ interface->name() ] = interface;
+      result = true;
+    }
+
+    // ========== UNLOCK ==========
+    pthread_rwlock_unlock( &m_interfaces_rwlock );
+
+    return result;
+  }
+
+  Interface::pointer VirtualSubtree::create_interface( const std::string& name )
+  {
+    Interface::pointer interface = Interface::create( name );
+    if ( this->add_interface( interface ) ) return interface;
+    return Interface::pointer();
+  }
+
+  Interface::pointer VirtualSubtree::interface( const std::string& name ) const
+  {
+    Interface::pointer result;
+    Interfaces::const_iterator i;
+
+    // ========== READ LOCK ==========
+    pthread_rwlock_rdlock( &m_interfaces_rwlock );
+
+    i = m_interfaces.find( name );
+    if ( i != m_interfaces.end() ) result = i->second;
+
+    // ========== UNLOCK ==========
+    pthread_rwlock_unlock( &m_interfaces_rwlock );
+
+    return result;
+  }
+
+  VirtualSubtree::Interfaces VirtualSubtree::interfaces() const
+  {
+    Interfaces result;
+
+    // ========== READ LOCK ==========
+    pthread_rwlock_rdlock( &m_interfaces_rwlock );
+
+    result = m_interfaces;
+
+    // ========== UNLOCK ==========
+    pthread_rwlock_unlock( &m_interfaces_rwlock );
+
+    return result;
+  }
+
+  void VirtualSubtree::set_resolver( ResolveSlot slot )
+  {
+    m_resolver = slot;
+  }
+
+  void VirtualSubtree::set_children( ChildrenSlot slot )
+  {
+    m_children = slot;
+  }
+
+  bool VirtualSubtree::resolve( const std::string& tail )
+  {
+    // The subtree's own path is always there to be introspected
+    if ( tail.empty() ) return true;
+    if ( m_resolver.empty() ) return true;
+    return m_resolver( tail );
+  }
+
+  std::string VirtualSubtree::introspect( const std::string& tail )
+  {
+    std::ostringstream sout;
+    std::vector<std::string> children;
+    std::vector<std::string>::iterator c;
+    Interfaces::const_iterator i;
+    std::string path = m_path;
+
+    if ( not tail.empty() )
+    {
+      if ( path.size() > 1 ) path += "/";
+      path += tail;
+    }
+
+    sout << "<node name=\"" << path << "\">\n"
+         << "  <interface name=\"" << DBUS_CXX_INTROSPECTABLE_INTERFACE << "\">\n"
+         << "    <method name=\"Introspect\">\n"
+         << "      <arg name=\"data\" type=\"s\" direction=\"out\"/>\n"
+         << "    </method>\n"
+         << "  </interface>\n";
+
+    // The subtree's own path is only a container for the virtual objects
+    if ( not tail.empty() )
+    {
+      // ========== READ LOCK ==========
+      pthread_rwlock_rdlock( &m_interfaces_rwlock );
+
+      for ( i = m_interfaces.begin(); i != m_interfaces.end(); i++ )
+        sout << i->second->introspect( 2 );
+
+      // ========== UNLOCK ==========
+      pthread_rwlock_unlock( &m_interfaces_rwlock );
+    }
+
+    if ( not m_children.empty() ) children = m_children( tail );
+    for ( c = children.begin(); c != children.end(); c++ )
+      sout << "  <node name=\"" << *c << "\"/>\n";
+
+    sout << "</node>\n";
+    return sout.str();
+  }
+
+  const std::string& VirtualSubtree::current_tail()
+  {
+    static const std::string empty;
+    if ( m_current_tail == NULL ) return empty;
+    return *m_current_tail;
+  }
+
+  std::string VirtualSubtree::tail_of( const char* path ) const
+  {
+    size_t base = m_path.size();
+
+    if ( path == NULL ) return std::string();
+    if ( strncmp( path, m_path.c_str(), base ) != 0 ) return std::string();
+
+    // A subtree at "/" has no separator of its own to skip
+    if ( base == 1 ) return std::string( path + 1 );
+    if ( path[base] == '/' ) return std::string( path + base + 1 );
+    return std::string();
+  }
+
+  HandlerResult VirtualSubtree::handle_message( Connection::pointer connection, Message::const_pointer message )
+  {
+    CallMessage::const_pointer callmessage;
+    std::vector<Interface::pointer> candidates;
+    std::vector<Interface::pointer>::iterator c;
+    Interfaces::iterator i;
+    HandlerResult result = NOT_HANDLED;
+    std::string tail;
+
+    if ( not message or message->type() != CALL_MESSAGE ) return NOT_HANDLED;
+
+    callmessage = CallMessage::create( message );
+    if ( not callmessage or callmessage->member() == NULL ) return NOT_HANDLED;
+
+    tail = this->tail_of( dbus_message_get_path( message->cobj() ) );
+
+    SIMPLELOGGER_DEBUG("dbus.VirtualSubtree","VirtualSubtree::handle_message: " << m_path << " tail '" << tail << "'");
+
+    if ( not this->resolve( tail ) )
+    {
+      if ( callmessage->expects_reply() )
+        connection->send( ErrorMessage::create( callmessage, DBUS_ERROR_UNKNOWN_OBJECT, "No such object" ) );
+      return HANDLED;
+    }
+
+    if ( callmessage->interface() != NULL and strcmp( callmessage->interface(), DBUS_CXX_INTROSPECTABLE_INTERFACE ) == 0 )
+    {
+      ReturnMessage::pointer return_message = callmessage->create_reply();
+      std::string introspection = DBUS_INTROSPECT_1_0_XML_DOCTYPE_DECL_NODE;
+      introspection += this->introspect( tail );
+      *return_message << introspection;
+      connection << return_message;
+      return HANDLED;
+    }
+
+    if ( tail.empty() ) return NOT_HANDLED;
+
+    // ========== READ LOCK ==========
+    pthread_rwlock_rdlock( &m_interfaces_rwlock );
+
+    if ( callmessage->interface() != NULL )
+    {
+      i = m_interfaces.find( callmessage->interface() );
+      if ( i != m_interfaces.end() ) candidates.push_back( i->second );
+    }
+    else
+    {
+      for ( i = m_interfaces.begin(); i != m_interfaces.end(); i++ )
+        candidates.push_back( i->second );
+    }
+
+    // ========== UNLOCK ==========
+    pthread_rwlock_unlock( &m_interfaces_rwlock );
+
+    // Handlers run unlocked, so that they may add interfaces themselves.
+    // Nested dispatches on this thread must not lose the outer call's tail
+    TailScope scope( tail );
+
+    for ( c = candidates.begin(); c != candidates.end() and result == NOT_HANDLED; c++ )
+      result = (*c)->handle_call_message( connection, callmessage );
+
+    return result;
+  }
+
+}
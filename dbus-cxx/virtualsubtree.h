@@ -0,0 +1,147 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by agent                                           *
+ *   agent@local                                                           *
+ *                                                                         *
+ *   This file is part of the dbus-cxx library.                            *
+ *                                                                         *
+ *   The dbus-cxx library is free software; you can redistribute it and/or *
+ *   modify it under the terms of the GNU General Public License           *
+ *   version 3 as published by the Free Software Foundation.               *
+ *                                                                         *
+ *   The dbus-cxx library is distributed in the hope that it will be       *
+ *   useful, but WITHOUT ANY WARRANTY; without even the implied warranty   *
+ *   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU   *
+ *   General Public License for more details.                              *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this software. If not see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#include <map>
+#include <string>
+#include <vector>
+
+#include <sigc++/sigc++.h>
+
+#include <dbus-cxx/objectpathhandler.h>
+#include <dbus-cxx/interface.h>
+
+#ifndef DBUSCXX_VIRTUALSUBTREE_H
+#define DBUSCXX_VIRTUALSUBTREE_H
+
+namespace DBus
+{
+
+  /**
+   * Exports a whole subtree of objects that exist only virtually.
+   *
+   * Each object below the subtree's path shares the same set of interfaces.
+   * No Object, Interface or Method instance is created per exported path.
+   * The subtree registers as a FALLBACK handler. For each call it resolves
+   * the tail of the path below its own path, such as "row42" or "a/b".
+   * During dispatch, methods read that tail with current_tail() to find the
+   * data they work on.
+   *
+   * Whether a path exists, and which child nodes introspection lists, both
+   * come from user supplied slots. A million rows exposed this way cost one
+   * handler and one set of interfaces.
+   *
+   * Calls to paths that don't resolve are answered with
+   * org.freedesktop.DBus.Error.UnknownObject. The shared interfaces don't
+   * belong to an Object, so their signals must be emitted with an explicit
+   * path, and properties are not exported.
+   *
+   * @ingroup local
+   * @ingroup objects
+   *
+   * @author agent <agent@local>
+   */
+  class VirtualSubtree: public ObjectPathHandler
+  {
+    protected:
+
+      VirtualSubtree( const std::string& path );
+
+    public:
+
+      typedef DBusCxxPointer<VirtualSubtree> pointer;
+
+      /** Returns true if the object at the path tail exists */
+      typedef sigc::slot<bool,const std::string&> ResolveSlot;
+
+      /** Returns the names of the children of the object at the path tail */
+      typedef sigc::slot<std::vector<std::string>,const std::string&> ChildrenSlot;
+
+      typedef std::map<std::string,Interface::pointer> Interfaces;
+
+      static pointer create( const std::string& path );
+
+      virtual ~VirtualSubtree();
+
+      /** Adds an interface shared by every object in the subtree */
+      bool add_interface( Interface::pointer interface );
+
+      /** Creates and adds an interface shared by every object in the subtree */
+      Interface::pointer create_interface( const std::string& name );
+
+      Interface::pointer interface( const std::string& name ) const;
+
+      /** Returns a copy of the shared interfaces */
+      Interfaces interfaces() const;
+
+      /**
+       * Sets the slot deciding which path tails exist. Without one every tail
+       * below the subtree's path exists.
+       */
+      void set_resolver( ResolveSlot slot );
+
+      /** Sets the slot listing children for introspection */
+      void set_children( ChildrenSlot slot );
+
+      /** True if the tail names an object in the subtree */
+      bool resolve( const std::string& tail );
+
+      /** Returns the DBus XML description of the object at the path tail */
+      std::string introspect( const std::string& tail );
+
+      /**
+       * The path tail of the call being dispatched on this thread, such as
+       * "row42" for /table/row42 on a subtree at /table. Empty outside of a
+       * dispatch or for the subtree's own path.
+       */
+      static const std::string& current_tail();
+
+      virtual HandlerResult handle_message( DBusCxxPointer<Connection> conn, Message::const_pointer msg );
+
+    protected:
+
+      /** Returns the tail of the path below the subtree's path */
+      std::string tail_of( const char* path ) const;
+
+      Interfaces m_interfaces;
+
+      mutable pthread_rwlock_t m_interfaces_rwlock;
+
+      ResolveSlot m_resolver;
+
+      ChildrenSlot m_children;
+
+      static thread_local const std::string* m_current_tail;
+
+      /**
+       * Makes tail the current tail of this thread while it lives, and
+       * restores the previous one even if a handler throws
+       */
+      struct TailScope
+      {
+        TailScope( const std::string& tail ): previous( m_current_tail ) { m_current_tail = &tail; }
+
+        ~TailScope() { m_current_tail = previous; }
+
+        const std::string* previous;
+      };
+
+  };
+
+}
+
+#endif
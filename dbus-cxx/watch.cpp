@@ -25,21 +25,45 @@ namespace DBus
 
   Watch::Watch( DBusWatch* cobj ): m_cobj( cobj )
   {
-    if ( m_cobj ) dbus_watch_set_data( cobj, this, NULL );
   }
 
   Watch::pointer Watch::create(DBusWatch * cobj)
   {
-    return pointer( new Watch(cobj) );
+    if ( cobj == NULL ) return pointer( new Watch(cobj) );
+
+    pointer* cached = static_cast<pointer*>( dbus_watch_get_data( cobj ) );
+    if ( cached ) return *cached;
+
+    pointer watch( new Watch(cobj) );
+    dbus_watch_set_data( cobj, new pointer( watch ), Watch::free_wrapper );
+    return watch;
+  }
+
+  void Watch::free_wrapper( void* data )
+  {
+    pointer* cached = static_cast<pointer*>( data );
+
+    // Anyone still holding the wrapper must not reach the freed watch
+    {
+      std::lock_guard<std::mutex> lock( (*cached)->m_cobj_mutex );
+      (*cached)->m_cobj = NULL;
+    }
+    delete cached;
   }
     
   Watch::~Watch()
   {
   }
 
+  DBusWatch* Watch::load_cobj() const
+  {
+    std::lock_guard<std::mutex> lock( m_cobj_mutex );
+    return m_cobj;
+  }
+
   bool Watch::is_valid() const
   {
-    return m_cobj != NULL;
+    return this->load_cobj() != NULL;
   }
 
   Watch::operator bool() const
@@ -49,19 +73,22 @@ namespace DBus
 
   int Watch::unix_fd( ) const
   {
-    if ( not this->is_valid() ) throw ErrorInvalidCObject::create();
+    std::lock_guard<std::mutex> lock( m_cobj_mutex );
+    if ( m_cobj == NULL ) throw ErrorInvalidCObject::create();
     return dbus_watch_get_unix_fd( m_cobj );
   }
 
   int Watch::socket( ) const
   {
-    if ( not this->is_valid() ) throw ErrorInvalidCObject::create();
+    std::lock_guard<std::mutex> lock( m_cobj_mutex );
+    if ( m_cobj == NULL ) throw ErrorInvalidCObject::create();
     return dbus_watch_get_socket( m_cobj );
   }
 
   unsigned int Watch::flags( ) const
   {
-    if ( not this->is_valid() ) return WATCH_ERROR;
+    std::lock_guard<std::mutex> lock( m_cobj_mutex );
+    if ( m_cobj == NULL ) return WATCH_ERROR;
     return dbus_watch_get_flags( m_cobj );
   }
 
@@ -77,14 +104,18 @@ namespace DBus
 
   bool Watch::is_enabled( ) const
   {
-    if ( not this->is_valid() ) throw ErrorInvalidCObject::create();
+    std::lock_guard<std::mutex> lock( m_cobj_mutex );
+    if ( m_cobj == NULL ) return false;
     return dbus_watch_get_enabled( m_cobj );
   }
 
   bool Watch::handle( unsigned int flags )
   {
-    if ( not this->is_valid() ) throw ErrorInvalidCObject::create();
-    return dbus_watch_handle( m_cobj, flags );
+    // The handler may remove (and free) this watch, so the lock is
+    // not held across the call into libdbus
+    DBusWatch* cobj = this->load_cobj();
+    if ( cobj == NULL ) return false;
+    return dbus_watch_handle( cobj, flags );
   }
 
   bool Watch::handle_read(bool error, bool hangup)
@@ -113,12 +144,12 @@ namespace DBus
 
   DBusWatch * Watch::cobj( )
   {
-    return m_cobj;
+    return this->load_cobj();
   }
 
   const DBusWatch * Watch::cobj( ) const
   {
-    return m_cobj;
+    return this->load_cobj();
   }
 
   Watch::operator DBusWatch*()
@@ -18,6 +18,7 @@
  ***************************************************************************/
 #include <dbus/dbus.h>
 #include <dbus-cxx/pointer.h>
+#include <mutex>
 
 #ifndef DBUSCXX_WATCH_H
 #define DBUSCXX_WATCH_H
@@ -45,6 +46,11 @@ namespace DBus
       typedef DBusCxxPointer<Watch> pointer;
       typedef DBusCxxWeakPointer<Watch> weak_pointer;
       
+      /**
+       * Returns the wrapper of cobj, making it on the first call. The
+       * wrapper is kept in the watch's data until libdbus frees the watch,
+       * which also invalidates it.
+       */
       static pointer create( DBusWatch* cobj = NULL );
       
       ~Watch();
@@ -63,8 +69,10 @@ namespace DBus
 
       bool is_writable() const;
 
+      /** False once libdbus has freed the watch */
       bool is_enabled() const;
 
+      /** Returns false without handling once libdbus has freed the watch */
       bool handle( unsigned int flags );
 
       bool handle_read( bool error=false, bool hangup=false );
@@ -81,6 +89,13 @@ namespace DBus
 
     protected:
       DBusWatch* m_cobj;
+
+      /** Guards m_cobj against free_wrapper() */
+      mutable std::mutex m_cobj_mutex;
+
+      DBusWatch* load_cobj() const;
+
+      static void free_wrapper( void* data );
   };
 
 }
@@ -40,7 +40,7 @@ void mylog( const char* logger_name, const struct SL_LogLocation* location,
 }
 
 DBus::FileDescriptor::pointer getFiledescriptor(){
-  return DBus::FileDescriptor::create( pipes[1] );
+  return DBus::FileDescriptor::duplicate( pipes[1] );
 }
 
 int main( int argc, char** argv ){
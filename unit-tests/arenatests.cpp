@@ -0,0 +1,142 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by agent                                           *
+ *   agent@local                                                           *
+ *                                                                         *
+ *   This file is part of the dbus-cxx library.                            *
+ *                                                                         *
+ *   The dbus-cxx library is free software; you can redistribute it and/or *
+ *   modify it under the terms of the GNU General Public License           *
+ *   version 3 as published by the Free Software Foundation.               *
+ *                                                                         *
+ *   The dbus-cxx library is distributed in the hope that it will be       *
+ *   useful, but WITHOUT ANY WARRANTY; without even the implied warranty   *
+ *   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU   *
+ *   General Public License for more details.                              *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this software. If not see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#include <dbus-cxx.h>
+#include <unistd.h>
+
+#include "test_macros.h"
+
+DBus::Dispatcher::pointer dispatch;
+
+DBus::LoopbackBus::pointer bus;
+
+bool arena_in_handler = false;
+
+int32_t sum( DBus::ArenaVector<int32_t> values, DBus::ArenaString name ){
+    arena_in_handler = DBus::Arena::current() != NULL and
+                       values.get_allocator().arena() == DBus::Arena::current() and
+                       name.get_allocator().arena() == DBus::Arena::current();
+
+    int32_t total = 0;
+    for ( size_t i = 0; i < values.size(); i++ ) total += values[i];
+    return total;
+}
+
+bool arena_allocate(){
+    DBus::Arena arena( 64 );
+
+    void* first = arena.allocate( 3, 1 );
+    void* aligned = arena.allocate( 8, 8 );
+    TEST_ASSERT_RET_FAIL( first and aligned );
+    TEST_ASSERT_RET_FAIL( (uintptr_t)aligned % 8 == 0 );
+    TEST_ASSERT_RET_FAIL( arena.bytes_allocated() == 16 );
+
+    // Larger than a block gets a block of its own
+    TEST_ASSERT_RET_FAIL( arena.allocate( 1000 ) );
+    TEST_ASSERT_RET_FAIL( arena.capacity() > 1000 );
+
+    arena.reset();
+    TEST_ASSERT_RET_FAIL( arena.bytes_allocated() == 0 );
+    TEST_ASSERT_RET_FAIL( arena.capacity() == 64 );
+
+    // An oversized first block is not the one kept
+    DBus::Arena large( 64 );
+    TEST_ASSERT_RET_FAIL( large.allocate( 1000 ) );
+    large.reset();
+    TEST_ASSERT_RET_FAIL( large.capacity() == 0 );
+    TEST_ASSERT_RET_FAIL( large.allocate( 8 ) );
+    large.reset();
+    return large.capacity() == 64;
+}
+
+bool arena_scope(){
+    TEST_ASSERT_RET_FAIL( DBus::Arena::current() == NULL );
+
+    // Outside a scope the allocator falls back to the heap
+    DBus::ArenaString heap( "allocated on the heap, too long for the small string buffer" );
+    TEST_ASSERT_RET_FAIL( heap.get_allocator().arena() == NULL );
+
+    {
+        DBus::ArenaScope outer;
+        TEST_ASSERT_RET_FAIL( outer.is_outermost() );
+        TEST_ASSERT_RET_FAIL( DBus::Arena::current() == &DBus::Arena::thread_arena() );
+
+        DBus::ArenaVector<int32_t> values;
+        for ( int i = 0; i < 100; i++ ) values.push_back( i );
+        TEST_ASSERT_RET_FAIL( outer.bytes_allocated() >= 100 * sizeof(int32_t) );
+
+        {
+            DBus::ArenaScope inner;
+            TEST_ASSERT_RET_FAIL( not inner.is_outermost() );
+        }
+
+        // The inner scope must not have reset the arena
+        TEST_ASSERT_RET_FAIL( DBus::Arena::thread_arena().bytes_allocated() >= 100 * sizeof(int32_t) );
+    }
+
+    TEST_ASSERT_RET_FAIL( DBus::Arena::current() == NULL );
+    return DBus::Arena::thread_arena().bytes_allocated() == 0;
+}
+
+bool arena_dispatch(){
+    DBus::Connection::pointer server = bus->create_connection();
+    DBus::Connection::pointer client = bus->create_connection();
+
+    server->request_name( "test.arena.Dispatch" );
+    DBus::Object::pointer object = server->create_object( "/arena/dispatch" );
+    object->create_method<int32_t,DBus::ArenaVector<int32_t>,DBus::ArenaString>( "test.Arena", "sum", sigc::ptr_fun( sum ) );
+    server->metrics().reset();
+
+    std::vector<int32_t> values;
+    for ( int i = 1; i <= 100; i++ ) values.push_back( i );
+
+    DBus::CallMessage::pointer msg = DBus::CallMessage::create( "test.arena.Dispatch", "/arena/dispatch", "test.Arena", "sum" );
+    *msg << values << std::string( "a name long enough not to fit in the string itself" );
+    DBus::Message::pointer reply = call_and_wait( client, msg );
+    TEST_ASSERT_RET_FAIL( reply and reply->type() == DBus::RETURN_MESSAGE );
+    int32_t total = 0;
+    reply->begin() >> total;
+    TEST_ASSERT_RET_FAIL( total == 5050 );
+    TEST_ASSERT_RET_FAIL( arena_in_handler );
+
+    TEST_ASSERT_RET_FAIL( server->metrics().dispatch_arena_bytes().count() > 0 );
+    return server->metrics().dispatch_arena_bytes().max() >= 100 * sizeof(int32_t);
+}
+
+#define ADD_TEST(name) do{ if( test_name == STRINGIFY(name) ){ \
+  ret = arena_##name();\
+} \
+} while( 0 )
+
+int main(int argc, char** argv){
+  if(argc < 2)
+    return 1;
+
+  std::string test_name = argv[1];
+  bool ret = false;
+
+  DBus::init();
+  dispatch = DBus::Dispatcher::create();
+  bus = DBus::LoopbackBus::create( dispatch );
+
+  ADD_TEST(allocate);
+  ADD_TEST(scope);
+  ADD_TEST(dispatch);
+
+  return !ret;
+}
@@ -0,0 +1,116 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by agent                                           *
+ *   agent@local                                                           *
+ *                                                                         *
+ *   This file is part of the dbus-cxx library.                            *
+ *                                                                         *
+ *   The dbus-cxx library is free software; you can redistribute it and/or *
+ *   modify it under the terms of the GNU General Public License           *
+ *   version 3 as published by the Free Software Foundation.               *
+ *                                                                         *
+ *   The dbus-cxx library is distributed in the hope that it will be       *
+ *   useful, but WITHOUT ANY WARRANTY; without even the implied warranty   *
+ *   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU   *
+ *   General Public License for more details.                              *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this software. If not see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#include <dbus-cxx.h>
+#include <cstring>
+
+#include "test_macros.h"
+
+DBus::Dispatcher::pointer dispatch;
+
+uint64_t sum_bytes( DBus::SharedBuffer::pointer buffer ){
+    uint64_t sum = 0;
+    for ( size_t i = 0; i < buffer->size(); i++ ) sum += buffer->data()[i];
+    return sum;
+}
+
+bool buffer_shared(){
+    DBus::Connection::pointer conn = dispatch->create_connection(DBus::BUS_SESSION);
+
+    DBus::Object::pointer object = conn->create_object( "/shared/buffer" );
+    object->create_method<uint64_t,DBus::SharedBuffer::pointer>( "test.Buffer", "Sum", sigc::ptr_fun( sum_bytes ) );
+
+    DBus::SharedBuffer::pointer frame = DBus::SharedBuffer::create( 1024 * 1024 );
+    memset( frame->mutable_data(), 3, frame->size() );
+
+    DBus::CallMessage::pointer msg = DBus::CallMessage::create( conn->unique_name(), "/shared/buffer", "test.Buffer", "Sum" );
+    *msg << frame;
+    DBus::Message::pointer reply = call_and_wait( conn, msg );
+    TEST_ASSERT_RET_FAIL( reply and reply->type() == DBus::RETURN_MESSAGE );
+
+    uint64_t sum;
+    reply >> sum;
+    return sum == 3 * frame->size();
+}
+
+DBus::CompressedBuffer::pointer echo_upper( DBus::CompressedBuffer::pointer buffer ){
+    std::string text = buffer->str();
+    for ( size_t i = 0; i < text.size(); i++ ) text[i] = toupper( text[i] );
+    return DBus::CompressedBuffer::create( text.data(), text.size(), DBus::COMPRESSION_LZ4 );
+}
+
+bool buffer_compressed(){
+    DBus::Connection::pointer conn = dispatch->create_connection(DBus::BUS_SESSION);
+
+    DBus::Object::pointer object = conn->create_object( "/compressed/buffer" );
+    object->create_method<DBus::CompressedBuffer::pointer,DBus::CompressedBuffer::pointer>( "test.Compressed", "Upper", sigc::ptr_fun( echo_upper ) );
+
+    std::string text;
+    for ( int i = 0; i < 1000; i++ ) text += "log line\n";
+
+    DBus::CallMessage::pointer msg = DBus::CallMessage::create( conn->unique_name(), "/compressed/buffer", "test.Compressed", "Upper" );
+    *msg << DBus::CompressedBuffer::create( text.data(), text.size(), DBus::COMPRESSION_ZSTD );
+    DBus::Message::pointer reply = call_and_wait( conn, msg );
+    TEST_ASSERT_RET_FAIL( reply and reply->type() == DBus::RETURN_MESSAGE );
+
+    DBus::CompressedBuffer::pointer upper;
+    reply >> upper;
+    return upper->size() == text.size() and upper->str().compare( 0, 9, "LOG LINE\n" ) == 0;
+}
+
+bool buffer_negotiate(){
+    DBus::Connection::pointer conn = dispatch->create_connection(DBus::BUS_SESSION);
+
+    // Any path answers with the codecs of this build
+    DBus::CallMessage::pointer msg = DBus::CallMessage::create( conn->unique_name(), "/no/object", DBUS_CXX_COMPRESSION_INTERFACE, "GetCodecs" );
+    DBus::Message::pointer reply = call_and_wait( conn, msg );
+    TEST_ASSERT_RET_FAIL( reply and reply->type() == DBus::RETURN_MESSAGE );
+
+    std::vector<std::string> codecs;
+    reply >> codecs;
+    TEST_ASSERT_RET_FAIL( codecs == DBus::CompressedBuffer::supported_codecs() );
+
+    DBus::CompressionCodec codec = DBus::CompressedBuffer::negotiate( codecs );
+    TEST_ASSERT_RET_FAIL( codecs.empty() == ( codec == DBus::COMPRESSION_NONE ) );
+    TEST_ASSERT_RET_FAIL( DBus::CompressedBuffer::is_supported( codec ) );
+
+    // A peer with no codec in common gets uncompressed buffers
+    return DBus::CompressedBuffer::negotiate( std::vector<std::string>( 1, "brotli" ) ) == DBus::COMPRESSION_NONE;
+}
+
+#define ADD_TEST(name) do{ if( test_name == STRINGIFY(name) ){ \
+  ret = buffer_##name();\
+} \
+} while( 0 )
+
+int main(int argc, char** argv){
+  if(argc < 1)
+    return 1;
+
+  std::string test_name = argv[1];
+  bool ret = false;
+
+  DBus::init();
+  dispatch = DBus::Dispatcher::create();
+
+  ADD_TEST(shared);
+  ADD_TEST(compressed);
+  ADD_TEST(negotiate);
+
+  return !ret;
+}
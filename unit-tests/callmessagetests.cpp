@@ -183,6 +183,27 @@ bool call_message_insertion_extraction_operator_multiple( )
   return true;
 }
 
+bool call_message_insertion_extraction_operator_try_get( )
+{
+  int32_t     i32 = 0;
+  std::string s;
+
+  DBus::CallMessage::pointer msg = DBus::CallMessage::create( "/org/freedesktop/DBus", "method" );
+  msg << (int32_t)42 << std::string( "Hello World" );
+
+  DBus::MessageIterator iter = msg->begin();
+
+  // A mismatch leaves the iterator where it was
+  TEST_ASSERT_RET_FAIL( not iter.try_get( s ) );
+  TEST_ASSERT_RET_FAIL( iter.try_get( i32 ) );
+  TEST_EQUALS_RET_FAIL( i32, 42 );
+  TEST_ASSERT_RET_FAIL( not iter.try_get( i32 ) );
+  TEST_ASSERT_RET_FAIL( iter.try_get( s ) );
+  TEST_EQUALS_RET_FAIL( s, std::string( "Hello World" ) );
+
+  return not iter.try_get( s );
+}
+
 #define ADD_TEST(name) do{ if( test_name == STRINGIFY(name) ){ \
   ret = call_message_insertion_extraction_operator_##name();\
 } \
@@ -208,6 +229,7 @@ int main(int argc, char** argv){
   ADD_TEST(string);
   ADD_TEST(array_double);
   ADD_TEST(multiple);
+  ADD_TEST(try_get);
 
   return !ret;
 }
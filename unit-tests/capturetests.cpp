@@ -0,0 +1,123 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by agent                                           *
+ *   agent@local                                                           *
+ *                                                                         *
+ *   This file is part of the dbus-cxx library.                            *
+ *                                                                         *
+ *   The dbus-cxx library is free software; you can redistribute it and/or *
+ *   modify it under the terms of the GNU General Public License           *
+ *   version 3 as published by the Free Software Foundation.               *
+ *                                                                         *
+ *   The dbus-cxx library is distributed in the hope that it will be       *
+ *   useful, but WITHOUT ANY WARRANTY; without even the implied warranty   *
+ *   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU   *
+ *   General Public License for more details.                              *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this software. If not see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#include <dbus-cxx.h>
+#include <unistd.h>
+#include <sstream>
+
+#include "test_macros.h"
+
+DBus::Dispatcher::pointer dispatch;
+
+int replay_calls = 0;
+
+double counted_add( double a, double b ){
+    replay_calls++;
+    return a + b;
+}
+
+bool capture_replay(){
+    DBus::Connection::pointer conn = dispatch->create_connection(DBus::BUS_SESSION);
+    DBus::Object::pointer object = conn->create_object( "/capture/path" );
+    object->create_method<double,double,double>( "test.Capture", "add", sigc::ptr_fun( counted_add ) );
+
+    std::ostringstream filename;
+    filename << "/tmp/dbus-cxx-capture-" << getpid();
+
+    DBus::MessageRecorder::pointer recorder = DBus::MessageRecorder::create( filename.str() );
+    recorder->attach( conn );
+
+    for ( int i = 0; i < 3; i++ ) {
+        DBus::CallMessage::pointer msg = DBus::CallMessage::create( conn->unique_name(), "/capture/path", "test.Capture", "add" );
+        *msg << 1.0 << (double)i;
+        DBus::Message::pointer reply = call_and_wait( conn, msg );
+        TEST_ASSERT_RET_FAIL( reply and reply->type() == DBus::RETURN_MESSAGE );
+    }
+    TEST_ASSERT_RET_FAIL( replay_calls == 3 );
+    recorder->close();
+
+    DBus::MessagePlayer::pointer player = DBus::MessagePlayer::create( filename.str() );
+    unlink( filename.str().c_str() );
+    TEST_ASSERT_RET_FAIL( player->size() == recorder->message_count() );
+    TEST_ASSERT_RET_FAIL( player->size() >= 3 );
+
+    // Each recorded call runs the method again, with no bus in between,
+    // and sends no reply to its long gone caller
+    uint64_t replies = conn->metrics().messages_out( DBus::RETURN_MESSAGE );
+    TEST_ASSERT_RET_FAIL( player->suppress_replies() );
+    TEST_ASSERT_RET_FAIL( player->play( object, conn, 0 ) == 3 );
+    TEST_ASSERT_RET_FAIL( replay_calls == 6 );
+    TEST_ASSERT_RET_FAIL( conn->metrics().messages_out( DBus::RETURN_MESSAGE ) == replies );
+
+    // Played into the connection, they take the incoming path to the object
+    TEST_ASSERT_RET_FAIL( player->play( conn, 0 ) == 3 );
+    TEST_ASSERT_RET_FAIL( replay_calls == 9 );
+
+    // Without a connection at all
+    TEST_ASSERT_RET_FAIL( player->play( object, 0 ) == 3 );
+    TEST_ASSERT_RET_FAIL( replay_calls == 12 );
+    TEST_ASSERT_RET_FAIL( conn->metrics().messages_out( DBus::RETURN_MESSAGE ) == replies );
+
+    DBus::Message::pointer first = player->message( 0 );
+    return first and player->timestamp( player->size() - 1 ) >= player->timestamp( 0 );
+}
+
+bool capture_unix_fd(){
+    int pipes[2];
+    TEST_ASSERT_RET_FAIL( pipe( pipes ) == 0 );
+
+    DBus::CallMessage::pointer msg = DBus::CallMessage::create( "/capture/path", "test.Capture", "pass" );
+    *msg << DBus::FileDescriptor::adopt( pipes[1] );
+    close( pipes[0] );
+
+    std::ostringstream filename;
+    filename << "/tmp/dbus-cxx-capture-fd-" << getpid();
+    DBus::MessageRecorder::pointer recorder = DBus::MessageRecorder::create( filename.str() );
+    unlink( filename.str().c_str() );
+
+    // The descriptor would not survive the capture, so the message is refused
+    bool refused = false;
+    try {
+        recorder->record( msg );
+    } catch ( DBus::ErrorNotSupported::pointer ) {
+        refused = true;
+    }
+
+    return refused and recorder->message_count() == 0;
+}
+
+#define ADD_TEST(name) do{ if( test_name == STRINGIFY(name) ){ \
+  ret = capture_##name();\
+} \
+} while( 0 )
+
+int main(int argc, char** argv){
+  if(argc < 1)
+    return 1;
+
+  std::string test_name = argv[1];
+  bool ret = false;
+
+  DBus::init();
+  dispatch = DBus::Dispatcher::create();
+
+  ADD_TEST(replay);
+  ADD_TEST(unix_fd);
+
+  return !ret;
+}
@@ -17,11 +17,18 @@
  *   along with this software. If not see <http://www.gnu.org/licenses/>.  *
  ***************************************************************************/
 #include <dbus-cxx.h>
+#include <unistd.h>
+#include <sstream>
+#include <set>
 
 #include "test_macros.h"
 
 DBus::Dispatcher::pointer dispatch;
 
+double example_method( double, double ){
+    return 0.0;
+}
+
 bool connection_create_signal_proxy(){
     DBus::Connection::pointer conn = dispatch->create_connection(DBus::BUS_SESSION);
 
@@ -62,6 +69,133 @@ bool connection_get_signal_proxy_by_iface_and_name(){
     return true;
 }
 
+void set_flag( bool* flag ){
+    *flag = true;
+}
+
+bool connection_flow_control(){
+    std::ostringstream address;
+    address << "unix:abstract=dbus-cxx-flow-" << getpid();
+
+    // Nobody services the server yet, so the client stays unauthenticated
+    // and everything it sends stays queued
+    DBus::Server::pointer server = DBus::Server::create( address.str() );
+    DBus::Connection::pointer client = DBus::Connection::create_peer( server->address() );
+
+    client->set_outgoing_watermarks( 0, 0, 4, 0 );
+    client->set_flow_control_policy( DBus::FLOW_CONTROL_FAIL );
+
+    for ( int i = 0; i < 4; i++ )
+        TEST_ASSERT_RET_FAIL( client->send( DBus::SignalMessage::create( "/flow", "test.Flow", "Tick" ) ) != 0 );
+    TEST_ASSERT_RET_FAIL( client->outgoing_messages() == 4 );
+    TEST_ASSERT_RET_FAIL( client->send( DBus::SignalMessage::create( "/flow", "test.Flow", "Tick" ) ) == 0 );
+    TEST_ASSERT_RET_FAIL( client->is_outgoing_congested() );
+
+    // Calls are refused rather than queued past the watermark
+    TEST_ASSERT_RET_FAIL( not client->send_with_reply_async( DBus::CallMessage::create( "/flow", "test.Flow", "Call" ) ) );
+    bool refused = false;
+    try {
+        client->send_with_reply_blocking( DBus::CallMessage::create( "/flow", "test.Flow", "Call" ) );
+    } catch ( DBus::ErrorLimitsExceeded::pointer ) {
+        refused = true;
+    }
+    TEST_ASSERT_RET_FAIL( refused );
+    TEST_ASSERT_RET_FAIL( client->outgoing_messages() == 4 );
+
+    client->set_flow_control_policy( DBus::FLOW_CONTROL_DROP_OLDEST_SIGNAL, 2 );
+    for ( int i = 0; i < 3; i++ )
+        TEST_ASSERT_RET_FAIL( client->send( DBus::SignalMessage::create( "/flow", "test.Flow", "Tock" ) ) == 0 );
+    TEST_ASSERT_RET_FAIL( client->held_signals() == 2 );
+    TEST_ASSERT_RET_FAIL( client->dropped_signals() == 1 );
+
+    // A blocked send gives up once the timeout has passed
+    client->set_flow_control_policy( DBus::FLOW_CONTROL_BLOCK, 2 );
+    client->set_flow_control_timeout( 50 );
+    TEST_ASSERT_RET_FAIL( client->send( DBus::CallMessage::create( "/flow", "test.Flow", "Call" ) ) == 0 );
+    client->set_flow_control_policy( DBus::FLOW_CONTROL_DROP_OLDEST_SIGNAL, 2 );
+
+    bool drained = false;
+    client->signal_outgoing_drained().connect( sigc::bind( sigc::ptr_fun( set_flag ), &drained ) );
+
+    TEST_ASSERT_RET_FAIL( dispatch->add_server( server ) );
+    TEST_ASSERT_RET_FAIL( dispatch->add_connection( client ) );
+
+    for ( int i = 0; i < 500 and not ( drained and client->held_signals() == 0 ); i++ )
+        usleep( 10000 );
+
+    TEST_ASSERT_RET_FAIL( drained );
+    TEST_ASSERT_RET_FAIL( not client->is_outgoing_congested() );
+
+    for ( int i = 0; i < 500 and client->outgoing_messages() > 0; i++ )
+        usleep( 10000 );
+
+    return client->outgoing_messages() == 0;
+}
+
+bool connection_connection_pool(){
+    DBus::Connection::pointer conn = dispatch->create_connection(DBus::BUS_SESSION);
+    DBus::Object::pointer object = conn->create_object( "/pooled/path" );
+    object->create_method<double,double,double>( "test.Pooled", "add", sigc::ptr_fun( example_method ) );
+
+    DBus::ConnectionPool::pointer pool = DBus::ConnectionPool::create( dispatch, DBus::BUS_SESSION, 3 );
+    TEST_ASSERT_RET_FAIL( pool and pool->size() == 3 );
+
+    DBus::ObjectProxy::pointer proxy = pool->create_object_proxy( conn->unique_name(), "/pooled/path" );
+    TEST_ASSERT_RET_FAIL( proxy->connection() == pool->primary() );
+
+    std::vector<DBus::PendingCall::pointer> pending;
+    std::set<std::string> destinations;
+    for ( int i = 0; i < 6; i++ ){
+        DBus::CallMessage::pointer msg = proxy->create_call_message( "test.Pooled", "add" );
+        *msg << 1.0 << 2.0;
+        pending.push_back( proxy->call_async( msg ) );
+    }
+
+    for ( size_t i = 0; i < pending.size(); i++ ){
+        DBus::Message::pointer reply = wait_for_reply( pending[i] );
+        TEST_ASSERT_RET_FAIL( reply and reply->type() == DBus::RETURN_MESSAGE );
+        destinations.insert( reply->destination() );
+    }
+
+    // Round robin sent two calls down each connection
+    TEST_ASSERT_RET_FAIL( destinations.size() == 3 );
+
+    pending.clear();
+    for ( unsigned int i = 0; i < pool->size(); i++ )
+        TEST_ASSERT_RET_FAIL( pool->outstanding( i ) == 0 );
+
+    return true;
+}
+
+DBus::FilterResult check_wrapper( DBus::Connection::pointer, DBus::Message::pointer msg, int* shared ){
+    // Handlers that alias the message being dispatched get the filter's wrapper
+    if ( dbus_message_is_signal( msg->cobj(), "test.Wrapper", "Ping" ) and DBus::Message::create( msg->cobj() ) == msg
+         and DBus::SignalMessage::create( msg->cobj() ) == msg )
+        (*shared)++;
+    return DBus::DONT_FILTER;
+}
+
+bool connection_message_wrapper(){
+    DBus::Connection::pointer sender = dispatch->create_connection(DBus::BUS_SESSION);
+    DBus::Connection::pointer receiver = dispatch->create_connection(DBus::BUS_SESSION);
+    int shared = 0;
+
+    DBus::signal_proxy_simple::pointer proxy = receiver->create_signal_proxy( "/test/wrapper", "test.Wrapper", "Ping" );
+    receiver->signal_filter().connect( sigc::bind( sigc::ptr_fun( check_wrapper ), &shared ) );
+
+    sender << DBus::SignalMessage::create( "/test/wrapper", "test.Wrapper", "Ping" );
+    for ( int i = 0; i < 100 and shared == 0; i++ ) usleep( 10000 );
+    TEST_ASSERT_RET_FAIL( shared == 1 );
+
+    // Aliasing outside dispatch still wraps the message in its own class
+    DBus::CallMessage::pointer call = DBus::CallMessage::create( "/org/freedesktop/DBus", "method" );
+    DBus::Message::pointer alias = DBus::Message::create( call->cobj() );
+    TEST_ASSERT_RET_FAIL( dbus_cxx_dynamic_pointer_cast<DBus::CallMessage>( alias ) );
+
+    // Copies are never shared
+    return DBus::Message::create( call->cobj(), DBus::CREATE_COPY ) != alias;
+}
+
 #define ADD_TEST(name) do{ if( test_name == STRINGIFY(name) ){ \
   ret = connection_##name();\
 } \
@@ -80,6 +214,9 @@ int main(int argc, char** argv){
   ADD_TEST(create_signal_proxy);
   ADD_TEST(get_signal_proxy_by_iface);
   ADD_TEST(get_signal_proxy_by_iface_and_name);
+  ADD_TEST(flow_control);
+  ADD_TEST(connection_pool);
+  ADD_TEST(message_wrapper);
 
   return !ret;
 }
@@ -0,0 +1,111 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by agent                                           *
+ *   agent@local                                                           *
+ *                                                                         *
+ *   This file is part of the dbus-cxx library.                            *
+ *                                                                         *
+ *   The dbus-cxx library is free software; you can redistribute it and/or *
+ *   modify it under the terms of the GNU General Public License           *
+ *   version 3 as published by the Free Software Foundation.               *
+ *                                                                         *
+ *   The dbus-cxx library is distributed in the hope that it will be       *
+ *   useful, but WITHOUT ANY WARRANTY; without even the implied warranty   *
+ *   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU   *
+ *   General Public License for more details.                              *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this software. If not see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#include <dbus-cxx.h>
+#include <dbus-cxx/headerlog.h>
+#include <atomic>
+#include <unistd.h>
+
+#include "test_macros.h"
+
+std::atomic<int> logged( 0 );
+
+int formatted = 0;
+
+void count_log( const char*, const struct SL_LogLocation*, const enum SL_LogLevel, const char* ){
+    logged++;
+}
+
+int format_counter(){
+    return ++formatted;
+}
+
+bool logging_lazy(){
+    DBus::setLoggingFunction( NULL );
+    DBUSCXX_DEBUG_STDSTR( "test.lazy", "value " << format_counter() );
+    TEST_ASSERT_RET_FAIL( formatted == 0 );
+
+    DBus::setLoggingFunction( count_log );
+    DBUSCXX_DEBUG_STDSTR( "test.lazy", "value " << format_counter() );
+    TEST_ASSERT_RET_FAIL( formatted == 1 );
+
+    // Above the threshold nothing is formatted either
+    DBus::setLogThreshold( SL_INFO );
+    DBUSCXX_DEBUG_STDSTR( "test.lazy", "value " << format_counter() );
+    return formatted == 1 and logged == 1;
+}
+
+bool logging_thresholds(){
+    DBus::setLoggingFunction( count_log );
+    DBus::setLogThreshold( SL_INFO );
+    DBus::setLogThreshold( "test.verbose", SL_TRACE );
+
+    TEST_ASSERT_RET_FAIL( DBus::logEnabled( "test.verbose", SL_DEBUG ) );
+    TEST_ASSERT_RET_FAIL( DBus::logEnabled( "test.verbose.child", SL_DEBUG ) );
+    TEST_ASSERT_RET_FAIL( not DBus::logEnabled( "test.verbosely", SL_DEBUG ) );
+    TEST_ASSERT_RET_FAIL( not DBus::logEnabled( "test.other", SL_DEBUG ) );
+    TEST_ASSERT_RET_FAIL( DBus::logEnabled( "test.other", SL_WARN ) );
+
+    DBUSCXX_DEBUG_STDSTR( "test.verbose.child", "wanted" );
+    DBUSCXX_DEBUG_STDSTR( "test.other", "not wanted" );
+    TEST_ASSERT_RET_FAIL( logged == 1 );
+
+    DBus::clearLogThresholds();
+    TEST_ASSERT_RET_FAIL( not DBus::logEnabled( "test.verbose", SL_DEBUG ) );
+
+    // Nothing is enabled without a logging function
+    DBus::setLoggingFunction( NULL );
+    return not DBus::logEnabled( "test.other", SL_FATAL );
+}
+
+bool logging_async(){
+    DBus::setLoggingFunction( count_log );
+    DBus::setAsyncLogging( true, 256 );
+
+    for ( int i = 0; i < 100; i++ )
+        DBUSCXX_DEBUG_STDSTR( "test.async", "message " << i );
+
+    for ( int i = 0; i < 100 and logged < 100; i++ ) usleep( 10000 );
+    TEST_ASSERT_RET_FAIL( logged == 100 );
+
+    // A full ring drops instead of blocking; stopping drains the rest
+    for ( int i = 0; i < 10000; i++ )
+        DBUSCXX_DEBUG_STDSTR( "test.async", "message " << i );
+    DBus::setAsyncLogging( false );
+
+    return logged + DBus::droppedLogMessages() == 10100;
+}
+
+#define ADD_TEST(name) do{ if( test_name == STRINGIFY(name) ){ \
+  ret = logging_##name();\
+} \
+} while( 0 )
+
+int main(int argc, char** argv){
+  if(argc < 2)
+    return 1;
+
+  std::string test_name = argv[1];
+  bool ret = false;
+
+  ADD_TEST(lazy);
+  ADD_TEST(thresholds);
+  ADD_TEST(async);
+
+  return !ret;
+}
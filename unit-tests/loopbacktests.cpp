@@ -0,0 +1,185 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by agent                                           *
+ *   agent@local                                                           *
+ *                                                                         *
+ *   This file is part of the dbus-cxx library.                            *
+ *                                                                         *
+ *   The dbus-cxx library is free software; you can redistribute it and/or *
+ *   modify it under the terms of the GNU General Public License           *
+ *   version 3 as published by the Free Software Foundation.               *
+ *                                                                         *
+ *   The dbus-cxx library is distributed in the hope that it will be       *
+ *   useful, but WITHOUT ANY WARRANTY; without even the implied warranty   *
+ *   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU   *
+ *   General Public License for more details.                              *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this software. If not see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#include <dbus-cxx.h>
+#include <unistd.h>
+#include <algorithm>
+
+#include "test_macros.h"
+
+DBus::Dispatcher::pointer dispatch;
+
+DBus::LoopbackBus::pointer bus;
+
+double add( double a, double b ){
+    return a + b;
+}
+
+std::string signal_value;
+
+void sigHandle( std::string value ){
+    signal_value = value;
+}
+
+DBus::FilterResult count_path( DBus::Connection::pointer, DBus::Message::pointer msg, const char* path, int* count ){
+    if ( msg->type() == DBus::SIGNAL_MESSAGE and dbus_message_has_path( msg->cobj(), path ) ) (*count)++;
+    return DBus::DONT_FILTER;
+}
+
+bool loopback_hello(){
+    DBus::Connection::pointer first = bus->create_connection();
+    DBus::Connection::pointer second = bus->create_connection();
+
+    TEST_ASSERT_RET_FAIL( first->unique_name() != NULL );
+    TEST_ASSERT_RET_FAIL( second->unique_name() != NULL );
+    TEST_ASSERT_RET_FAIL( std::string( first->unique_name() ) != second->unique_name() );
+
+    std::vector<std::string> names = bus->names();
+    return std::find( names.begin(), names.end(), first->unique_name() ) != names.end();
+}
+
+bool loopback_names(){
+    DBus::Connection::pointer first = bus->create_connection();
+    DBus::Connection::pointer second = bus->create_connection();
+
+    TEST_ASSERT_RET_FAIL( first->request_name( "test.loopback.Names" ) == DBUS_REQUEST_NAME_REPLY_PRIMARY_OWNER );
+    TEST_ASSERT_RET_FAIL( first->request_name( "test.loopback.Names" ) == DBUS_REQUEST_NAME_REPLY_ALREADY_OWNER );
+    TEST_ASSERT_RET_FAIL( second->request_name( "test.loopback.Names" ) == DBUS_REQUEST_NAME_REPLY_EXISTS );
+    TEST_ASSERT_RET_FAIL( second->name_has_owner( "test.loopback.Names" ) );
+    TEST_ASSERT_RET_FAIL( first->release_name( "test.loopback.Names" ) == DBUS_RELEASE_NAME_REPLY_RELEASED );
+    return not second->name_has_owner( "test.loopback.Names" );
+}
+
+bool loopback_method(){
+    DBus::Connection::pointer server = bus->create_connection();
+    DBus::Connection::pointer client = bus->create_connection();
+
+    TEST_ASSERT_RET_FAIL( server->request_name( "test.loopback.Method" ) == DBUS_REQUEST_NAME_REPLY_PRIMARY_OWNER );
+    DBus::Object::pointer object = server->create_object( "/loopback/method" );
+    object->create_method<double,double,double>( "test.Loopback", "add", sigc::ptr_fun( add ) );
+
+    DBus::CallMessage::pointer msg = DBus::CallMessage::create( "test.loopback.Method", "/loopback/method", "test.Loopback", "add" );
+    *msg << 1.0 << 2.0;
+    DBus::Message::pointer reply = call_and_wait( client, msg );
+    TEST_ASSERT_RET_FAIL( reply and reply->type() == DBus::RETURN_MESSAGE );
+
+    double sum = 0;
+    reply->begin() >> sum;
+    TEST_ASSERT_RET_FAIL( sum == 3.0 );
+
+    // Nobody owns the name, so the bus answers for it
+    msg = DBus::CallMessage::create( "test.loopback.Nobody", "/loopback/method", "test.Loopback", "add" );
+    *msg << 1.0 << 2.0;
+    reply = call_and_wait( client, msg );
+    return reply and reply->type() == DBus::ERROR_MESSAGE;
+}
+
+bool loopback_signal(){
+    DBus::Connection::pointer sender = bus->create_connection();
+    DBus::Connection::pointer receiver = bus->create_connection();
+
+    DBus::signal<void,std::string>::pointer signal = sender->create_signal<void,std::string>( "/loopback/signal", "test.Loopback", "Value" );
+    DBus::signal_proxy<void,std::string>::pointer proxy = receiver->create_signal_proxy<void,std::string>( "/loopback/signal", "test.Loopback", "Value" );
+    proxy->connect( sigc::ptr_fun( sigHandle ) );
+
+    int others = 0;
+    receiver->signal_filter().connect( sigc::bind( sigc::ptr_fun( count_path ), "/loopback/other", &others ) );
+
+    // A signal nobody subscribed to is not delivered; as both come from the
+    // same sender, it would have arrived before the one we wait for
+    DBus::signal<void,std::string>::pointer other = sender->create_signal<void,std::string>( "/loopback/other", "test.Loopback", "Value" );
+    other->emit( "Other" );
+    signal->emit( "Loopback" );
+
+    for ( int i = 0; i < 100 and signal_value.empty(); i++ ) usleep( 10000 );
+    TEST_ASSERT_RET_FAIL( signal_value == "Loopback" );
+    return others == 0;
+}
+
+bool loopback_match_args(){
+    DBus::Connection::pointer sender = bus->create_connection();
+    DBus::Connection::pointer receiver = bus->create_connection();
+    int matched = 0;
+    int unmatched = 0;
+
+    TEST_ASSERT_RET_FAIL( receiver->add_match( "type='signal',interface='test.Loopback',member='Arg',arg0='yes',arg1path='/loopback/'" ) );
+    TEST_ASSERT_RET_FAIL( receiver->add_match( "type='signal',interface='test.Loopback',member='Space',arg0namespace='test.loopback'" ) );
+    receiver->signal_filter().connect( sigc::bind( sigc::ptr_fun( count_path ), "/loopback/match", &matched ) );
+    receiver->signal_filter().connect( sigc::bind( sigc::ptr_fun( count_path ), "/loopback/unmatched", &unmatched ) );
+
+    // Rules the bus can't evaluate are refused rather than matching everything
+    TEST_ASSERT_RET_FAIL( not receiver->add_match( "type='signal',arg0has='yes'" ) );
+
+    DBus::SignalMessage::pointer msg = DBus::SignalMessage::create( "/loopback/unmatched", "test.Loopback", "Arg" );
+    *msg << std::string( "no" ) << DBus::Path( "/loopback/path" );
+    sender << msg;
+    msg = DBus::SignalMessage::create( "/loopback/unmatched", "test.Loopback", "Arg" );
+    *msg << std::string( "yes" ) << DBus::Path( "/elsewhere" );
+    sender << msg;
+    msg = DBus::SignalMessage::create( "/loopback/unmatched", "test.Loopback", "Space" );
+    *msg << std::string( "test.loopbackother" );
+    sender << msg;
+
+    msg = DBus::SignalMessage::create( "/loopback/match", "test.Loopback", "Arg" );
+    *msg << std::string( "yes" ) << DBus::Path( "/loopback/path" );
+    sender << msg;
+    msg = DBus::SignalMessage::create( "/loopback/match", "test.Loopback", "Space" );
+    *msg << std::string( "test.loopback.Names" );
+    sender << msg;
+
+    for ( int i = 0; i < 100 and matched < 2; i++ ) usleep( 10000 );
+    TEST_ASSERT_RET_FAIL( matched == 2 );
+    return unmatched == 0;
+}
+
+bool loopback_watch_cache(){
+    // Not added to the dispatcher, so its watches are left unhandled
+    DBus::Connection::pointer conn = DBus::Connection::create( bus->address(), true );
+    TEST_ASSERT_RET_FAIL( not conn->unhandled_watches().empty() );
+
+    // libdbus hands the same watch to every callback; so must we
+    DBus::Watch::pointer watch = conn->unhandled_watches().front();
+    TEST_ASSERT_RET_FAIL( DBus::Watch::create( watch->cobj() ) == watch );
+    return DBus::Watch::create( watch->cobj() )->unix_fd() == watch->unix_fd();
+}
+
+#define ADD_TEST(name) do{ if( test_name == STRINGIFY(name) ){ \
+  ret = loopback_##name();\
+} \
+} while( 0 )
+
+int main(int argc, char** argv){
+  if(argc < 2)
+    return 1;
+
+  std::string test_name = argv[1];
+  bool ret = false;
+
+  DBus::init();
+  dispatch = DBus::Dispatcher::create();
+  bus = DBus::LoopbackBus::create( dispatch );
+
+  ADD_TEST(hello);
+  ADD_TEST(names);
+  ADD_TEST(method);
+  ADD_TEST(signal);
+  ADD_TEST(match_args);
+  ADD_TEST(watch_cache);
+
+  return !ret;
+}
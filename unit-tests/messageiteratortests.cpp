@@ -18,6 +18,7 @@
  ***************************************************************************/
 #include <cstring>
 #include <unistd.h>
+#include <fcntl.h>
 #include <dbus-cxx.h>
 
 #include "test_macros.h"
@@ -657,6 +658,155 @@ bool call_message_iterator_insertion_extraction_operator_multiple( )
   return true;
 }
 
+bool call_message_append_extract_iterator_array_filedescriptor(){
+  std::vector<DBus::FileDescriptor::pointer> v;
+  std::vector<DBus::FileDescriptor::pointer> v2;
+  int pipes[2];
+  int received;
+  char readData[ 4 ];
+
+  if( pipe( pipes ) < 0 ){
+      return false;
+  }
+  DBus::FileDescriptor::pointer read_end = DBus::FileDescriptor::adopt( pipes[0] );
+  DBus::FileDescriptor::pointer write_end = DBus::FileDescriptor::adopt( pipes[1] );
+  for ( int i = 0; i < 3; i++ )
+    v.push_back( write_end->dup() );
+
+  DBus::CallMessage::pointer msg = DBus::CallMessage::create( "/org/freedesktop/DBus", "method" );
+  DBus::MessageAppendIterator iter1(msg);
+  iter1.append( v );
+  TEST_EQUALS_RET_FAIL( msg->begin().signature(), "ah" );
+
+  DBus::MessageIterator iter2(msg);
+  iter2 >> v2;
+  TEST_EQUALS_RET_FAIL( v2.size(), 3u );
+
+  for ( size_t i = 0; i < v2.size(); i++ )
+    TEST_EQUALS_RET_FAIL( write( v2[i]->getDescriptor(), "x", 1 ), 1 );
+  TEST_EQUALS_RET_FAIL( read( read_end->getDescriptor(), readData, 3 ), 3 );
+
+  // Received descriptors belong to the FileDescriptor they were extracted into
+  received = v2[0]->getDescriptor();
+  v2.clear();
+  TEST_ASSERT_RET_FAIL( fcntl( received, F_GETFD ) < 0 );
+
+  received = write_end->release();
+  TEST_ASSERT_RET_FAIL( not write_end->is_valid() );
+  TEST_ASSERT_RET_FAIL( fcntl( received, F_GETFD ) >= 0 );
+
+  // create() only borrows the descriptor
+  {
+    DBus::FileDescriptor::pointer borrowed = DBus::FileDescriptor::create( received );
+  }
+  TEST_ASSERT_RET_FAIL( fcntl( received, F_GETFD ) >= 0 );
+  close( received );
+  return true;
+}
+
+bool call_message_append_extract_iterator_sharedbuffer(){
+  DBus::SharedBuffer::pointer v = DBus::SharedBuffer::create( 256 * 1024 );
+  DBus::SharedBuffer::pointer v2;
+  DBus::SharedBuffer::pointer s2;
+
+  TEST_ASSERT_RET_FAIL( v->mutable_data() );
+  for ( size_t i = 0; i < v->size(); i++ )
+    v->mutable_data()[i] = i % 251;
+
+  DBus::CallMessage::pointer msg = DBus::CallMessage::create( "/org/freedesktop/DBus", "method" );
+  DBus::MessageAppendIterator iter1(msg);
+  iter1.append( v );
+  iter1.append( v->slice( 4096, 100 ) );
+
+  // Sending seals the buffer
+  TEST_ASSERT_RET_FAIL( v->is_sealed() );
+  TEST_ASSERT_RET_FAIL( v->mutable_data() == NULL );
+
+  DBus::MessageIterator iter2(msg);
+  v2 = (DBus::SharedBuffer::pointer)iter2;
+  iter2.next();
+  s2 = (DBus::SharedBuffer::pointer)iter2;
+
+  TEST_EQUALS_RET_FAIL( v->is_shared(), v2->is_shared() );
+  TEST_EQUALS_RET_FAIL( v2->size(), v->size() );
+  TEST_EQUALS_RET_FAIL( memcmp( v->data(), v2->data(), v->size() ), 0 );
+  TEST_EQUALS_RET_FAIL( s2->size(), 100u );
+  return TEST_EQUALS( memcmp( v->data() + 4096, s2->data(), 100 ), 0 );
+}
+
+bool call_message_iterator_insertion_extraction_operator_sharedbuffer(){
+  const char* text = "A buffer well under the inline threshold";
+  DBus::SharedBuffer::pointer v = DBus::SharedBuffer::create( text, strlen( text ) );
+  DBus::SharedBuffer::pointer v2;
+
+  TEST_ASSERT_RET_FAIL( not v->is_shared() );
+
+  DBus::CallMessage::pointer msg = DBus::CallMessage::create( "/org/freedesktop/DBus", "method" );
+  *msg << v;
+  TEST_EQUALS_RET_FAIL( msg->begin().signature(), "v" );
+
+  msg >> v2;
+
+  TEST_EQUALS_RET_FAIL( v2->size(), strlen( text ) );
+  return TEST_EQUALS( memcmp( text, v2->data(), v2->size() ), 0 );
+}
+
+bool call_message_append_extract_iterator_compressedbuffer(){
+  std::string text;
+  for ( int i = 0; i < 2000; i++ ) text += "forwarded log line\n";
+
+  DBus::CompressedBuffer::pointer none = DBus::CompressedBuffer::create( text.data(), text.size(), DBus::COMPRESSION_NONE );
+  DBus::CompressedBuffer::pointer lz4 = DBus::CompressedBuffer::create( text.data(), text.size(), DBus::COMPRESSION_LZ4 );
+  DBus::CompressedBuffer::pointer zstd = DBus::CompressedBuffer::create( text.data(), text.size(), DBus::COMPRESSION_ZSTD );
+  DBus::CompressedBuffer::pointer small = DBus::CompressedBuffer::create( "short", 5, DBus::COMPRESSION_ZSTD );
+  std::vector<uint8_t> payload;
+
+  // Compressed only where supported, and never below the threshold
+  std::string expected = DBus::CompressedBuffer::is_supported( DBus::COMPRESSION_LZ4 ) ? "lz4" : "";
+  TEST_EQUALS_RET_FAIL( lz4->encode( payload ), expected );
+  TEST_ASSERT_RET_FAIL( payload.size() <= text.size() );
+  TEST_EQUALS_RET_FAIL( small->encode( payload ), "" );
+
+  DBus::CallMessage::pointer msg = DBus::CallMessage::create( "/org/freedesktop/DBus", "method" );
+  DBus::MessageAppendIterator iter1(msg);
+  iter1.append( none );
+  iter1.append( lz4 );
+  iter1.append( zstd );
+  iter1.append( small );
+  TEST_EQUALS_RET_FAIL( msg->begin().signature(), "(say)" );
+
+  DBus::MessageIterator iter2(msg);
+  for ( int i = 0; i < 3; i++ ) {
+    DBus::CompressedBuffer::pointer v2 = (DBus::CompressedBuffer::pointer)iter2;
+    TEST_EQUALS_RET_FAIL( v2->str(), text );
+    iter2.next();
+  }
+  DBus::CompressedBuffer::pointer s2 = (DBus::CompressedBuffer::pointer)iter2;
+  TEST_EQUALS_RET_FAIL( s2->str(), "short" );
+
+  // Codecs we do not know are rejected
+  bool rejected = false;
+  try {
+    DBus::CompressedBuffer::decode( "unknown", payload.data(), payload.size() );
+  }
+  catch ( DBus::ErrorInvalidArgs::pointer e ) {
+    rejected = true;
+  }
+  return rejected;
+}
+
+bool call_message_iterator_insertion_extraction_operator_compressedbuffer(){
+  std::string text( 64 * 1024, 'x' );
+  DBus::CompressedBuffer::pointer v = DBus::CompressedBuffer::create( text.data(), text.size(), DBus::COMPRESSION_ZSTD );
+  DBus::CompressedBuffer::pointer v2;
+
+  DBus::CallMessage::pointer msg = DBus::CallMessage::create( "/org/freedesktop/DBus", "method" );
+  *msg << v;
+  msg >> v2;
+
+  return TEST_EQUALS( v2->str(), text );
+}
+
 #define ADD_TEST(name) do{ if( test_name == STRINGIFY(name) ){ \
   ret = call_message_append_extract_iterator_##name();\
 } \
@@ -695,6 +845,9 @@ int main(int argc, char** argv){
   ADD_TEST(array_string);
   ADD_TEST(array_array_string);
   ADD_TEST(filedescriptor);
+  ADD_TEST(array_filedescriptor);
+  ADD_TEST(sharedbuffer);
+  ADD_TEST(compressedbuffer);
   ADD_TEST(multiple);
 
   ADD_TEST2(bool);
@@ -717,6 +870,8 @@ int main(int argc, char** argv){
   ADD_TEST2(array_int);
   ADD_TEST2(array_string);
   ADD_TEST2(filedescriptor);
+  ADD_TEST2(sharedbuffer);
+  ADD_TEST2(compressedbuffer);
   ADD_TEST2(multiple);
 
   return !ret;
@@ -0,0 +1,200 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by agent                                           *
+ *   agent@local                                                           *
+ *                                                                         *
+ *   This file is part of the dbus-cxx library.                            *
+ *                                                                         *
+ *   The dbus-cxx library is free software; you can redistribute it and/or *
+ *   modify it under the terms of the GNU General Public License           *
+ *   version 3 as published by the Free Software Foundation.               *
+ *                                                                         *
+ *   The dbus-cxx library is distributed in the hope that it will be       *
+ *   useful, but WITHOUT ANY WARRANTY; without even the implied warranty   *
+ *   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU   *
+ *   General Public License for more details.                              *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this software. If not see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#include <dbus-cxx.h>
+#include <unistd.h>
+#include <stdexcept>
+
+#include "test_macros.h"
+
+DBus::Dispatcher::pointer dispatch;
+
+DBus::LoopbackBus::pointer bus;
+
+double add( double a, double b ){
+    return a + b;
+}
+
+double fail( double a ){
+    throw std::runtime_error( "failed on purpose" );
+}
+
+int delivered = 0;
+
+void sigHandle( std::string value ){
+    delivered++;
+}
+
+bool metrics_histogram(){
+    DBus::Histogram histogram;
+
+    histogram.record( 0 );
+    histogram.record( 1 );
+    histogram.record( 1000 );
+    histogram.record( 1023 );
+    histogram.record( 1024 );
+
+    TEST_ASSERT_RET_FAIL( histogram.count() == 5 );
+    TEST_ASSERT_RET_FAIL( histogram.sum() == 3048 );
+    TEST_ASSERT_RET_FAIL( histogram.max() == 1024 );
+    TEST_ASSERT_RET_FAIL( histogram.bucket( 0 ) == 1 );
+    TEST_ASSERT_RET_FAIL( histogram.bucket( 1 ) == 1 );
+    TEST_ASSERT_RET_FAIL( histogram.bucket( 10 ) == 2 );
+    TEST_ASSERT_RET_FAIL( histogram.bucket( 11 ) == 1 );
+    TEST_ASSERT_RET_FAIL( histogram.percentile( 50 ) == 1024 );
+    TEST_ASSERT_RET_FAIL( histogram.percentile( 100 ) == 1024 );
+    TEST_ASSERT_RET_FAIL( histogram.percentile( 20 ) == 1 );
+
+    histogram.reset();
+    return histogram.count() == 0 and histogram.percentile( 99 ) == 0;
+}
+
+bool metrics_method(){
+    DBus::Connection::pointer server = bus->create_connection();
+    DBus::Connection::pointer client = bus->create_connection();
+
+    server->request_name( "test.metrics.Method" );
+    DBus::Object::pointer object = server->create_object( "/metrics/method" );
+    DBus::MethodBase::pointer method = object->create_method<double,double,double>( "test.Metrics", "add", sigc::ptr_fun( add ) );
+    DBus::MethodBase::pointer failing = object->create_method<double,double>( "test.Metrics", "fail", sigc::ptr_fun( fail ) );
+
+    for ( int i = 0; i < 3; i++ ) {
+        DBus::CallMessage::pointer msg = DBus::CallMessage::create( "test.metrics.Method", "/metrics/method", "test.Metrics", "add" );
+        *msg << 1.0 << 2.0;
+        TEST_ASSERT_RET_FAIL( call_and_wait( client, msg )->type() == DBus::RETURN_MESSAGE );
+    }
+
+    DBus::CallMessage::pointer msg = DBus::CallMessage::create( "test.metrics.Method", "/metrics/method", "test.Metrics", "fail" );
+    *msg << 1.0;
+    TEST_ASSERT_RET_FAIL( call_and_wait( client, msg )->type() == DBus::ERROR_MESSAGE );
+
+    const DBus::MethodMetrics& metrics = method->metrics();
+    TEST_ASSERT_RET_FAIL( metrics.calls() == 3 );
+    TEST_ASSERT_RET_FAIL( metrics.errors() == 0 );
+    TEST_ASSERT_RET_FAIL( metrics.demarshal_time().count() == 3 );
+    TEST_ASSERT_RET_FAIL( metrics.handler_time().count() == 3 );
+    TEST_ASSERT_RET_FAIL( metrics.reply_time().count() == 3 );
+
+    TEST_ASSERT_RET_FAIL( failing->metrics().calls() == 1 );
+    TEST_ASSERT_RET_FAIL( failing->metrics().errors() == 1 );
+    return failing->metrics().reply_time().count() == 0;
+}
+
+bool metrics_connection(){
+    DBus::Connection::pointer server = bus->create_connection();
+    DBus::Connection::pointer client = bus->create_connection();
+
+    server->request_name( "test.metrics.Connection" );
+    DBus::Object::pointer object = server->create_object( "/metrics/connection" );
+    object->create_method<double,double,double>( "test.Metrics", "add", sigc::ptr_fun( add ) );
+
+    client->metrics().reset();
+    server->metrics().reset();
+    client->metrics().set_count_bytes();
+
+    DBus::CallMessage::pointer msg = DBus::CallMessage::create( "test.metrics.Connection", "/metrics/connection", "test.Metrics", "add" );
+    *msg << 1.0 << 2.0;
+    DBus::PendingCall::pointer pending = client->send_with_reply_async( msg );
+    TEST_ASSERT_RET_FAIL( client->metrics().messages_out( DBus::CALL_MESSAGE ) == 1 );
+    TEST_ASSERT_RET_FAIL( wait_for_reply( pending ) );
+
+    TEST_ASSERT_RET_FAIL( client->metrics().pending_replies() == 0 );
+    TEST_ASSERT_RET_FAIL( client->metrics().messages_in( DBus::RETURN_MESSAGE ) == 1 );
+    TEST_ASSERT_RET_FAIL( client->metrics().bytes_out() > 0 );
+    TEST_ASSERT_RET_FAIL( client->metrics().bytes_in() > 0 );
+    TEST_ASSERT_RET_FAIL( server->metrics().messages_in( DBus::CALL_MESSAGE ) == 1 );
+    TEST_ASSERT_RET_FAIL( server->metrics().messages_out( DBus::RETURN_MESSAGE ) == 1 );
+    TEST_ASSERT_RET_FAIL( server->metrics().bytes_in() == 0 );
+
+    // Cancelled calls stop counting as pending
+    msg = DBus::CallMessage::create( "test.metrics.Nobody", "/metrics/connection", "test.Metrics", "add" );
+    pending = client->send_with_reply_async( msg );
+    pending->cancel();
+    return client->metrics().pending_replies() == 0;
+}
+
+bool metrics_signal(){
+    DBus::Connection::pointer sender = bus->create_connection();
+    DBus::Connection::pointer receiver = bus->create_connection();
+
+    DBus::signal<void,std::string>::pointer signal = sender->create_signal<void,std::string>( "/metrics/signal", "test.Metrics", "Value" );
+    DBus::signal_proxy<void,std::string>::pointer proxy = receiver->create_signal_proxy<void,std::string>( "/metrics/signal", "test.Metrics", "Value" );
+    proxy->connect( sigc::ptr_fun( sigHandle ) );
+
+    signal->emit( "one" );
+    signal->emit( "two" );
+
+    for ( int i = 0; i < 100 and delivered < 2; i++ ) usleep( 10000 );
+    TEST_ASSERT_RET_FAIL( sender->metrics().messages_out( DBus::SIGNAL_MESSAGE ) == 2 );
+    return proxy->metrics().deliveries() == 2;
+}
+
+bool metrics_export(){
+    DBus::Connection::pointer server = bus->create_connection();
+    DBus::Connection::pointer client = bus->create_connection();
+
+    server->request_name( "test.metrics.Export" );
+    DBus::Object::pointer object = server->create_object( "/metrics/export" );
+    object->create_method<double,double,double>( "test.Metrics", "add", sigc::ptr_fun( add ) );
+    DBus::MetricsObject::pointer exporter = DBus::MetricsObject::create();
+    exporter->add_object( object );
+    TEST_ASSERT_RET_FAIL( server->register_object( exporter ) );
+
+    DBus::CallMessage::pointer msg = DBus::CallMessage::create( "test.metrics.Export", "/metrics/export", "test.Metrics", "add" );
+    *msg << 1.0 << 2.0;
+    call_and_wait( client, msg );
+
+    msg = DBus::CallMessage::create( "test.metrics.Export", "/org/dbus_cxx/Metrics", DBUS_CXX_METRICS_INTERFACE, "GetConnectionMetrics" );
+    DBus::Message::pointer reply = call_and_wait( client, msg );
+    TEST_ASSERT_RET_FAIL( reply and reply->type() == DBus::RETURN_MESSAGE );
+    std::map<std::string,uint64_t> connection_metrics;
+    reply->begin() >> connection_metrics;
+    TEST_ASSERT_RET_FAIL( connection_metrics["calls_in"] >= 2 );
+
+    msg = DBus::CallMessage::create( "test.metrics.Export", "/org/dbus_cxx/Metrics", DBUS_CXX_METRICS_INTERFACE, "GetMethodMetrics" );
+    reply = call_and_wait( client, msg );
+    TEST_ASSERT_RET_FAIL( reply and reply->type() == DBus::RETURN_MESSAGE );
+    std::map<std::string,std::map<std::string,uint64_t> > method_metrics;
+    reply->begin() >> method_metrics;
+    return method_metrics["/metrics/export test.Metrics.add"]["calls"] == 1;
+}
+
+#define ADD_TEST(name) do{ if( test_name == STRINGIFY(name) ){ \
+  ret = metrics_##name();\
+} \
+} while( 0 )
+
+int main(int argc, char** argv){
+  if(argc < 2)
+    return 1;
+
+  std::string test_name = argv[1];
+  bool ret = false;
+
+  DBus::init();
+  dispatch = DBus::Dispatcher::create();
+  bus = DBus::LoopbackBus::create( dispatch );
+
+  ADD_TEST(histogram);
+  ADD_TEST(method);
+  ADD_TEST(connection);
+  ADD_TEST(signal);
+  ADD_TEST(export);
+
+  return !ret;
+}
@@ -0,0 +1,150 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by agent                                           *
+ *   agent@local                                                           *
+ *                                                                         *
+ *   This file is part of the dbus-cxx library.                            *
+ *                                                                         *
+ *   The dbus-cxx library is free software; you can redistribute it and/or *
+ *   modify it under the terms of the GNU General Public License           *
+ *   version 3 as published by the Free Software Foundation.               *
+ *                                                                         *
+ *   The dbus-cxx library is distributed in the hope that it will be       *
+ *   useful, but WITHOUT ANY WARRANTY; without even the implied warranty   *
+ *   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU   *
+ *   General Public License for more details.                              *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this software. If not see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#include <dbus-cxx.h>
+#include <unistd.h>
+
+#include "test_macros.h"
+
+DBus::Dispatcher::pointer dispatch;
+DBus::Connection::pointer server;
+DBus::Connection::pointer client;
+DBus::ObjectManager::pointer manager;
+DBus::Object::pointer first;
+int added_signals = 0;
+int removed_signals = 0;
+
+void on_interfaces_added( const DBus::Path&, const std::set<std::string>& ){
+    added_signals++;
+}
+
+void on_interfaces_removed( const DBus::Path&, const std::set<std::string>& ){
+    removed_signals++;
+}
+
+void setup(){
+    server = dispatch->create_connection(DBus::BUS_SESSION);
+    client = dispatch->create_connection(DBus::BUS_SESSION);
+
+    manager = DBus::ObjectManager::create( "/test/manager" );
+    first = DBus::Object::create( "/test/manager/first" );
+    first->create_property<int32_t>( "test.Item", "Size" )->set_value( 3 );
+    manager->add_child( "first", first );
+    server->register_object( manager );
+}
+
+bool wait_for( DBus::ObjectManagerProxy::pointer proxy ){
+    for ( int i = 0; i < 100 and not proxy->is_loaded(); i++ ) usleep( 10000 );
+    return proxy->is_loaded();
+}
+
+bool objectmanager_introspect(){
+    std::string xml = manager->introspect();
+
+    TEST_ASSERT_RET_FAIL( xml.find( DBUS_CXX_OBJECT_MANAGER_INTERFACE ) != std::string::npos );
+    return xml.find( "GetManagedObjects" ) != std::string::npos;
+}
+
+bool objectmanager_get_managed_objects(){
+    DBus::CallMessage::pointer msg = DBus::CallMessage::create( server->unique_name(), "/test/manager", DBUS_CXX_OBJECT_MANAGER_INTERFACE, "GetManagedObjects" );
+
+    DBus::Message::pointer reply = call_and_wait( client, msg );
+    TEST_ASSERT_RET_FAIL( reply and reply->type() == DBus::RETURN_MESSAGE );
+
+    return TEST_STREQUALS( reply->begin().signature(), "a{oa{sa{sv}}}" );
+}
+
+bool objectmanager_proxy_mirror(){
+    DBus::ObjectManagerProxy::pointer proxy = DBus::ObjectManagerProxy::create( client, server->unique_name(), "/test/manager" );
+    TEST_ASSERT_RET_FAIL( wait_for( proxy ) );
+
+    TEST_ASSERT_RET_FAIL( proxy->has_object( "/test/manager/first" ) );
+    return proxy->object_interfaces( "/test/manager/first" ).count( "test.Item" ) == 1;
+}
+
+bool objectmanager_incremental(){
+    DBus::ObjectManagerProxy::pointer proxy = DBus::ObjectManagerProxy::create( client, server->unique_name(), "/test/manager" );
+    proxy->signal_interfaces_added().connect( sigc::ptr_fun( on_interfaces_added ) );
+    proxy->signal_interfaces_removed().connect( sigc::ptr_fun( on_interfaces_removed ) );
+    TEST_ASSERT_RET_FAIL( wait_for( proxy ) );
+
+    DBus::Object::pointer second = DBus::Object::create( "/test/manager/first/second" );
+    second->create_interface( "test.Other" );
+    first->add_child( "second", second );
+    first->create_interface( "test.Extra" );
+
+    for ( int i = 0; i < 100 and added_signals < 2; i++ ) usleep( 10000 );
+    TEST_ASSERT_RET_FAIL( added_signals == 2 );
+    TEST_ASSERT_RET_FAIL( proxy->has_object( "/test/manager/first/second" ) );
+    TEST_ASSERT_RET_FAIL( proxy->object_interfaces( "/test/manager/first" ).count( "test.Extra" ) == 1 );
+
+    first->remove_child( "second" );
+
+    for ( int i = 0; i < 100 and removed_signals < 1; i++ ) usleep( 10000 );
+    TEST_ASSERT_RET_FAIL( removed_signals == 1 );
+    return not proxy->has_object( "/test/manager/first/second" );
+}
+
+bool objectmanager_proxy_sender(){
+    DBus::Connection::pointer other = dispatch->create_connection(DBus::BUS_SESSION);
+    DBus::ObjectManager::pointer impostor = DBus::ObjectManager::create( "/test/manager" );
+    other->register_object( impostor );
+
+    DBus::ObjectManagerProxy::pointer proxy = DBus::ObjectManagerProxy::create( client, server->unique_name(), "/test/manager" );
+    proxy->signal_interfaces_added().connect( sigc::ptr_fun( on_interfaces_added ) );
+    TEST_ASSERT_RET_FAIL( wait_for( proxy ) );
+
+    // A manager at the same path on another connection must not reach the mirror
+    DBus::Object::pointer stranger = DBus::Object::create( "/test/manager/stranger" );
+    stranger->create_interface( "test.Other" );
+    impostor->add_child( "stranger", stranger );
+
+    DBus::Object::pointer third = DBus::Object::create( "/test/manager/third" );
+    third->create_interface( "test.Other" );
+    manager->add_child( "third", third );
+
+    for ( int i = 0; i < 100 and not proxy->has_object( "/test/manager/third" ); i++ ) usleep( 10000 );
+    TEST_ASSERT_RET_FAIL( proxy->has_object( "/test/manager/third" ) );
+    TEST_ASSERT_RET_FAIL( added_signals == 1 );
+    return not proxy->has_object( "/test/manager/stranger" );
+}
+
+#define ADD_TEST(name) do{ if( test_name == STRINGIFY(name) ){ \
+  ret = objectmanager_##name();\
+} \
+} while( 0 )
+
+int main(int argc, char** argv){
+  if(argc < 1)
+    return 1;
+
+  std::string test_name = argv[1];
+  bool ret = false;
+
+  DBus::init();
+  dispatch = DBus::Dispatcher::create();
+  setup();
+
+  ADD_TEST(introspect);
+  ADD_TEST(get_managed_objects);
+  ADD_TEST(proxy_mirror);
+  ADD_TEST(incremental);
+  ADD_TEST(proxy_sender);
+
+  return !ret;
+}
@@ -17,6 +17,7 @@
  *   along with this software. If not see <http://www.gnu.org/licenses/>.  *
  ***************************************************************************/
 #include <dbus-cxx.h>
+#include <cstring>
 
 #include "test_macros.h"
 
@@ -53,6 +54,245 @@ bool object_export_method(){
     return true;
 }
 
+bool object_introspect_cache(){
+    DBus::Object::pointer object = DBus::Object::create( "/cache/path" );
+    object->create_method<double,double,double>( "test.Cache", "first", sigc::ptr_fun( example_method ) );
+
+    std::string xml = object->introspect();
+    unsigned long generation = object->introspection_generation();
+    TEST_ASSERT_RET_FAIL( object->is_introspection_cached() );
+
+    // A second call is served from the cache
+    TEST_ASSERT_RET_FAIL( xml == object->introspect() );
+    TEST_ASSERT_RET_FAIL( object->introspection_generation() == generation );
+    TEST_ASSERT_RET_FAIL( object->is_introspection_cached() );
+
+    // A mutation discards it
+    object->create_method<double,double,double>( "test.Cache", "second", sigc::ptr_fun( example_method ) );
+    TEST_ASSERT_RET_FAIL( object->introspection_generation() > generation );
+    TEST_ASSERT_RET_FAIL( not object->is_introspection_cached() );
+    xml = object->introspect();
+    TEST_ASSERT_RET_FAIL( xml.find( "second" ) != std::string::npos );
+    TEST_ASSERT_RET_FAIL( object->is_introspection_cached() );
+
+    generation = object->introspection_generation();
+    object->create_property<int32_t>( "test.Cache", "Size" );
+    TEST_ASSERT_RET_FAIL( object->introspection_generation() > generation );
+
+    xml = object->introspect();
+    TEST_ASSERT_RET_FAIL( xml.find( "Size" ) != std::string::npos );
+
+    object->interface( "test.Cache" )->set_name( "test.Renamed" );
+    xml = object->introspect();
+    TEST_ASSERT_RET_FAIL( xml.find( "test.Renamed" ) != std::string::npos );
+
+    object->add_child( "child", DBus::Object::create( "/cache/path/child" ) );
+    xml = object->introspect();
+    TEST_ASSERT_RET_FAIL( xml.find( "<node name=\"child\"/>" ) != std::string::npos );
+
+    object->remove_interface( "test.Renamed" );
+    xml = object->introspect();
+    return xml.find( "test.Renamed" ) == std::string::npos;
+}
+
+bool object_router_lookup(){
+    DBus::ObjectPathRouter::pointer router = DBus::ObjectPathRouter::create();
+    DBus::ObjectPathHandler::pointer devices = DBus::ObjectPathHandler::create( "/devices", DBus::FALLBACK );
+    DBus::ObjectPathHandler::pointer first = DBus::ObjectPathHandler::create( "/devices/first" );
+    DBus::ObjectPathHandler::pointer second = DBus::ObjectPathHandler::create( "/devices/first/second" );
+
+    TEST_ASSERT_RET_FAIL( router->add( devices.get() ) );
+    TEST_ASSERT_RET_FAIL( router->add( first.get() ) );
+    TEST_ASSERT_RET_FAIL( router->add( second.get() ) );
+    TEST_ASSERT_RET_FAIL( not router->add( first.get() ) );
+
+    TEST_ASSERT_RET_FAIL( router->find( "/devices/first" ) == first.get() );
+    TEST_ASSERT_RET_FAIL( router->find( "/devices/other/deeper" ) == devices.get() );
+    TEST_ASSERT_RET_FAIL( router->find( "/elsewhere" ) == NULL );
+
+    TEST_ASSERT_RET_FAIL( router->remove( "/devices/first" ) );
+    TEST_ASSERT_RET_FAIL( router->find( "/devices/first/second" ) == second.get() );
+    TEST_ASSERT_RET_FAIL( router->find( "/devices/first" ) == devices.get() );
+
+    TEST_ASSERT_RET_FAIL( router->remove_subtree( "/devices" ) == 2 );
+    return router->size() == 0;
+}
+
+bool object_router_call(){
+    DBus::Connection::pointer conn = dispatch->create_connection(DBus::BUS_SESSION);
+    TEST_ASSERT_RET_FAIL( conn->enable_path_router() );
+
+    DBus::Object::pointer object = conn->create_object( "/routed/path" );
+    object->create_method<double,double,double>( "test.Routed", "add", sigc::ptr_fun( example_method ) );
+    TEST_ASSERT_RET_FAIL( conn->path_router()->handler( "/routed/path" ) == object.get() );
+
+    DBus::CallMessage::pointer msg = DBus::CallMessage::create( conn->unique_name(), "/routed/path", "test.Routed", "add" );
+    *msg << 1.0 << 2.0;
+    DBus::Message::pointer reply = call_and_wait( conn, msg );
+    return reply and reply->type() == DBus::RETURN_MESSAGE;
+}
+
+DBus::Result<double> checked_half( double value ){
+    if ( value < 0 ) return DBus::Result<double>::error( DBUS_ERROR_INVALID_ARGS, "negative value" );
+    return value / 2;
+}
+
+DBus::Result<void> checked_reset( std::string what ){
+    if ( what != "all" ) return DBus::Result<void>::error( DBUS_ERROR_INVALID_ARGS, "unknown target" );
+    return DBus::Result<void>();
+}
+
+bool object_result_error(){
+    DBus::Connection::pointer conn = dispatch->create_connection(DBus::BUS_SESSION);
+
+    DBus::Object::pointer object = conn->create_object( "/result/path" );
+    DBus::MethodBase::pointer method = object->create_method<DBus::Result<double>,double>( "test.Result", "half", sigc::ptr_fun( checked_half ) );
+    object->create_method<DBus::Result<void>,std::string>( "test.Result", "reset", sigc::ptr_fun( checked_reset ) );
+
+    DBus::CallMessage::pointer msg = DBus::CallMessage::create( conn->unique_name(), "/result/path", "test.Result", "half" );
+    *msg << 8.0;
+    DBus::Message::pointer reply = call_and_wait( conn, msg );
+    TEST_ASSERT_RET_FAIL( reply and reply->type() == DBus::RETURN_MESSAGE );
+    double value = 0;
+    reply->begin() >> value;
+    TEST_ASSERT_RET_FAIL( value == 4.0 );
+
+    msg = DBus::CallMessage::create( conn->unique_name(), "/result/path", "test.Result", "half" );
+    *msg << -1.0;
+    reply = call_and_wait( conn, msg );
+    TEST_ASSERT_RET_FAIL( reply and reply->type() == DBus::ERROR_MESSAGE );
+    TEST_ASSERT_RET_FAIL( strcmp( DBus::ErrorMessage::create( reply )->name(), DBUS_ERROR_INVALID_ARGS ) == 0 );
+    TEST_ASSERT_RET_FAIL( method->metrics().calls() == 2 and method->metrics().errors() == 1 );
+
+    msg = DBus::CallMessage::create( conn->unique_name(), "/result/path", "test.Result", "reset" );
+    *msg << std::string( "all" );
+    reply = call_and_wait( conn, msg );
+    TEST_ASSERT_RET_FAIL( reply and reply->type() == DBus::RETURN_MESSAGE );
+
+    // An error without a name is still an error
+    TEST_ASSERT_RET_FAIL( DBus::Result<double>::error( "", "unnamed" ).is_error() );
+    TEST_ASSERT_RET_FAIL( DBus::Result<void>::error( "", "unnamed" ).is_error() );
+
+    // Result<void> has no out argument
+    return object->introspect().find( "type=\"\"" ) == std::string::npos;
+}
+
+bool object_overload(){
+    DBus::Connection::pointer conn = dispatch->create_connection(DBus::BUS_SESSION);
+
+    DBus::Object::pointer object = conn->create_object( "/overload/path" );
+    object->create_method<double,double,double>( "test.Overload", "add", sigc::ptr_fun( example_method ) );
+    object->create_method<DBus::Result<void>,std::string>( "test.Overload", "add", sigc::ptr_fun( checked_reset ) );
+
+    // Routed past the numeric overload without a failed extraction
+    DBus::CallMessage::pointer msg = DBus::CallMessage::create( conn->unique_name(), "/overload/path", "test.Overload", "add" );
+    *msg << std::string( "all" );
+    DBus::Message::pointer reply = call_and_wait( conn, msg );
+    TEST_ASSERT_RET_FAIL( reply and reply->type() == DBus::RETURN_MESSAGE );
+
+    // Integers still convert into the double arguments
+    msg = DBus::CallMessage::create( conn->unique_name(), "/overload/path", "test.Overload", "add" );
+    *msg << (int32_t)1 << (int32_t)2;
+    reply = call_and_wait( conn, msg );
+    TEST_ASSERT_RET_FAIL( reply and reply->type() == DBus::RETURN_MESSAGE );
+
+    // A signal to the object's path is not a call
+    DBus::SignalMessage::pointer signal = DBus::SignalMessage::create( "/overload/path", "test.Overload", "add" );
+    return object->handle_message( conn, signal ) == DBus::NOT_HANDLED;
+}
+
+DBus::Object::pointer growing_object;
+
+std::string grow(){
+    growing_object->create_method<double,double,double>( "test.Grown", "add", sigc::ptr_fun( example_method ) );
+    return "grown";
+}
+
+bool object_handler_changes_methods(){
+    DBus::Connection::pointer conn = dispatch->create_connection(DBus::BUS_SESSION);
+
+    growing_object = conn->create_object( "/growing/path" );
+    growing_object->create_method<std::string>( "test.Growing", "grow", sigc::ptr_fun( grow ) );
+
+    // Adding an interface from within a handler used to deadlock on the lookup lock
+    DBus::Message::pointer reply = call_and_wait( conn, DBus::CallMessage::create( conn->unique_name(), "/growing/path", "test.Growing", "grow" ) );
+    TEST_ASSERT_RET_FAIL( reply and reply->type() == DBus::RETURN_MESSAGE );
+    TEST_ASSERT_RET_FAIL( growing_object->has_interface( "test.Grown" ) );
+
+    DBus::Interface::pointer grown = growing_object->interface( "test.Grown" );
+    TEST_ASSERT_RET_FAIL( grown and grown->has_method( "add" ) );
+
+    DBus::CallMessage::pointer msg = DBus::CallMessage::create( conn->unique_name(), "/growing/path", "test.Grown", "add" );
+    *msg << 1.0 << 2.0;
+    reply = call_and_wait( conn, msg );
+    TEST_ASSERT_RET_FAIL( reply and reply->type() == DBus::RETURN_MESSAGE );
+
+    // A removed method no longer answers
+    grown->remove_method( "add" );
+    TEST_ASSERT_RET_FAIL( not grown->has_method( "add" ) and not grown->method( "add" ) );
+
+    msg = DBus::CallMessage::create( conn->unique_name(), "/growing/path", "test.Grown", "add" );
+    *msg << 1.0 << 2.0;
+    reply = call_and_wait( conn, msg );
+    return reply and reply->type() == DBus::ERROR_MESSAGE;
+}
+
+bool object_no_interface_call(){
+    DBus::Connection::pointer conn = dispatch->create_connection(DBus::BUS_SESSION);
+
+    DBus::Object::pointer object = conn->create_object( "/default/path" );
+    object->create_method<double,double,double>( "add", sigc::ptr_fun( example_method ) );
+
+    // A call without an interface goes to the default interface
+    DBus::CallMessage::pointer msg = DBus::CallMessage::create( "/default/path", "add" );
+    msg->set_destination( conn->unique_name() );
+    *msg << 1.0 << 2.0;
+    DBus::Message::pointer reply = call_and_wait( conn, msg );
+    return reply and reply->type() == DBus::RETURN_MESSAGE;
+}
+
+std::string current_row(){
+    return DBus::VirtualSubtree::current_tail();
+}
+
+bool is_row( const std::string& tail ){
+    return tail.compare( 0, 3, "row" ) == 0;
+}
+
+DBus::VirtualSubtree::pointer extended_table;
+
+bool extend_table(){
+    return bool( extended_table->create_interface( "test.Extra" ) );
+}
+
+bool object_virtual_subtree(){
+    DBus::Connection::pointer conn = dispatch->create_connection(DBus::BUS_SESSION);
+
+    DBus::VirtualSubtree::pointer table = DBus::VirtualSubtree::create( "/table" );
+    table->create_interface( "test.Row" )->create_method<std::string>( "Name" )->set_method( sigc::ptr_fun( current_row ) );
+    table->interface( "test.Row" )->create_method<bool>( "Extend" )->set_method( sigc::ptr_fun( extend_table ) );
+    extended_table = table;
+    table->set_resolver( sigc::ptr_fun( is_row ) );
+    TEST_ASSERT_RET_FAIL( table->register_with_connection( conn ) );
+
+    DBus::Message::pointer reply = call_and_wait( conn, DBus::CallMessage::create( conn->unique_name(), "/table/row42", "test.Row", "Name" ) );
+    TEST_ASSERT_RET_FAIL( reply and reply->type() == DBus::RETURN_MESSAGE );
+    std::string name;
+    reply >> name;
+    TEST_ASSERT_RET_FAIL( name == "row42" );
+
+    reply = call_and_wait( conn, DBus::CallMessage::create( conn->unique_name(), "/table/column7", "test.Row", "Name" ) );
+    TEST_ASSERT_RET_FAIL( reply and reply->type() == DBus::ERROR_MESSAGE );
+
+    // A handler adding an interface must not deadlock on the subtree
+    reply = call_and_wait( conn, DBus::CallMessage::create( conn->unique_name(), "/table/row1", "test.Row", "Extend" ) );
+    TEST_ASSERT_RET_FAIL( reply and reply->type() == DBus::RETURN_MESSAGE );
+    extended_table.reset();
+    TEST_ASSERT_RET_FAIL( table->interface( "test.Extra" ) );
+
+    return table->introspect( "row1" ).find( "test.Row" ) != std::string::npos;
+}
+
 #define ADD_TEST(name) do{ if( test_name == STRINGIFY(name) ){ \
   ret = object_##name();\
 } \
@@ -71,6 +311,14 @@ int main(int argc, char** argv){
   ADD_TEST(proxy_create);
   ADD_TEST(proxy_create_method1);
   ADD_TEST(export_method);
+  ADD_TEST(introspect_cache);
+  ADD_TEST(router_lookup);
+  ADD_TEST(router_call);
+  ADD_TEST(virtual_subtree);
+  ADD_TEST(result_error);
+  ADD_TEST(overload);
+  ADD_TEST(handler_changes_methods);
+  ADD_TEST(no_interface_call);
 
   return !ret;
 }
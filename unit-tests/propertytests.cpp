@@ -0,0 +1,143 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by agent                                           *
+ *   agent@local                                                           *
+ *                                                                         *
+ *   This file is part of the dbus-cxx library.                            *
+ *                                                                         *
+ *   The dbus-cxx library is free software; you can redistribute it and/or *
+ *   modify it under the terms of the GNU General Public License           *
+ *   version 3 as published by the Free Software Foundation.               *
+ *                                                                         *
+ *   The dbus-cxx library is distributed in the hope that it will be       *
+ *   useful, but WITHOUT ANY WARRANTY; without even the implied warranty   *
+ *   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU   *
+ *   General Public License for more details.                              *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this software. If not see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#include <dbus-cxx.h>
+#include <unistd.h>
+
+#include "test_macros.h"
+
+DBus::Dispatcher::pointer dispatch;
+DBus::Connection::pointer server;
+DBus::Connection::pointer client;
+DBus::Object::pointer object;
+DBus::Property<int32_t>::pointer temperature;
+DBus::Property<std::string>::pointer label;
+int changed_signals = 0;
+
+DBus::HandlerResult on_properties_changed( DBus::SignalMessage::const_pointer ){
+    changed_signals++;
+    return DBus::HANDLED;
+}
+
+void setup(){
+    server = dispatch->create_connection(DBus::BUS_SESSION);
+    client = dispatch->create_connection(DBus::BUS_SESSION);
+
+    object = server->create_object( "/test/properties" );
+    temperature = object->create_property<int32_t>( "test.Sensor", "Temperature" );
+    label = object->create_property<std::string>( "test.Sensor", "Label", DBus::PROPERTY_READWRITE );
+    temperature->set_value( 20 );
+}
+
+int32_t plain_count(){
+    return 0;
+}
+
+bool property_introspect(){
+    std::string xml = object->introspect();
+
+    TEST_ASSERT_RET_FAIL( xml.find( "<property name=\"Temperature\" type=\"i\" access=\"read\"/>" ) != std::string::npos );
+    TEST_ASSERT_RET_FAIL( xml.find( "<property name=\"Label\" type=\"s\" access=\"readwrite\"/>" ) != std::string::npos );
+    TEST_ASSERT_RET_FAIL( xml.find( DBUS_CXX_PROPERTIES_INTERFACE ) != std::string::npos );
+
+    // Objects without properties don't advertise the properties interface
+    DBus::Object::pointer plain = DBus::Object::create( "/test/plain" );
+    plain->create_method<int32_t>( "test.Plain", "Count", sigc::ptr_fun( plain_count ) );
+    return plain->introspect().find( DBUS_CXX_PROPERTIES_INTERFACE ) == std::string::npos;
+}
+
+bool property_get(){
+    DBus::CallMessage::pointer msg = DBus::CallMessage::create( server->unique_name(), "/test/properties", DBUS_CXX_PROPERTIES_INTERFACE, "Get" );
+    *msg << std::string( "test.Sensor" ) << std::string( "Temperature" );
+
+    DBus::Message::pointer reply = call_and_wait( client, msg );
+    TEST_ASSERT_RET_FAIL( reply and reply->type() == DBus::RETURN_MESSAGE );
+
+    DBus::Variant<int32_t> value;
+    DBus::Message::iterator i = reply->begin();
+    i >> value;
+
+    return TEST_EQUALS( value.data, 20 );
+}
+
+bool property_set(){
+    DBus::CallMessage::pointer msg = DBus::CallMessage::create( server->unique_name(), "/test/properties", DBUS_CXX_PROPERTIES_INTERFACE, "Set" );
+    std::string name = "front";
+    *msg << std::string( "test.Sensor" ) << std::string( "Label" ) << DBus::Variant<std::string>( name );
+
+    DBus::Message::pointer reply = call_and_wait( client, msg );
+    TEST_ASSERT_RET_FAIL( reply and reply->type() == DBus::RETURN_MESSAGE );
+
+    return TEST_STREQUALS( label->value(), "front" );
+}
+
+bool property_set_read_only(){
+    DBus::CallMessage::pointer msg = DBus::CallMessage::create( server->unique_name(), "/test/properties", DBUS_CXX_PROPERTIES_INTERFACE, "Set" );
+    int32_t temp = 100;
+    *msg << std::string( "test.Sensor" ) << std::string( "Temperature" ) << DBus::Variant<int32_t>( temp );
+
+    DBus::Message::pointer reply = call_and_wait( client, msg );
+    TEST_ASSERT_RET_FAIL( reply and reply->type() == DBus::ERROR_MESSAGE );
+
+    return TEST_EQUALS( temperature->value(), 20 );
+}
+
+bool property_coalesce(){
+    DBus::signal_proxy_base::pointer proxy = client->create_signal_proxy( "/test/properties", DBUS_CXX_PROPERTIES_INTERFACE, "PropertiesChanged" );
+    proxy->signal_dbus_incoming().connect( sigc::ptr_fun( on_properties_changed ) );
+
+    // Long enough that only the explicit flush below sends anything
+    DBus::Interface::pointer sensor = object->interface( "test.Sensor" );
+    sensor->set_properties_changed_interval( 60000 );
+    for ( int32_t i = 0; i < 1000; i++ ) temperature->set_value( i );
+    label->set_value( "rear" );
+    sensor->flush_properties_changed();
+
+    // The reply follows the signal on the same connection
+    DBus::CallMessage::pointer msg = DBus::CallMessage::create( server->unique_name(), "/test/properties", DBUS_CXX_PROPERTIES_INTERFACE, "Get" );
+    *msg << std::string( "test.Sensor" ) << std::string( "Temperature" );
+    TEST_ASSERT_RET_FAIL( call_and_wait( client, msg ) );
+    for ( int i = 0; i < 100 and changed_signals < 1; i++ ) usleep( 10000 );
+
+    return TEST_EQUALS( changed_signals, 1 );
+}
+
+#define ADD_TEST(name) do{ if( test_name == STRINGIFY(name) ){ \
+  ret = property_##name();\
+} \
+} while( 0 )
+
+int main(int argc, char** argv){
+  if(argc < 1)
+    return 1;
+
+  std::string test_name = argv[1];
+  bool ret = false;
+
+  DBus::init();
+  dispatch = DBus::Dispatcher::create();
+  setup();
+
+  ADD_TEST(introspect);
+  ADD_TEST(get);
+  ADD_TEST(set);
+  ADD_TEST(set_read_only);
+  ADD_TEST(coalesce);
+
+  return !ret;
+}
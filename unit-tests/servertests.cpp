@@ -0,0 +1,89 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by agent                                           *
+ *   agent@local                                                           *
+ *                                                                         *
+ *   This file is part of the dbus-cxx library.                            *
+ *                                                                         *
+ *   The dbus-cxx library is free software; you can redistribute it and/or *
+ *   modify it under the terms of the GNU General Public License           *
+ *   version 3 as published by the Free Software Foundation.               *
+ *                                                                         *
+ *   The dbus-cxx library is distributed in the hope that it will be       *
+ *   useful, but WITHOUT ANY WARRANTY; without even the implied warranty   *
+ *   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU   *
+ *   General Public License for more details.                              *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this software. If not see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#include <dbus-cxx.h>
+#include <unistd.h>
+#include <sstream>
+
+#include "test_macros.h"
+
+DBus::Dispatcher::pointer dispatch;
+
+double example_method( double, double ){
+    return 0.0;
+}
+
+bool server_peer(){
+    std::ostringstream address;
+    address << "unix:abstract=dbus-cxx-test-" << getpid();
+
+    DBus::Server::pointer server = DBus::Server::create( address.str() );
+    TEST_ASSERT_RET_FAIL( server->is_connected() );
+    TEST_ASSERT_RET_FAIL( dispatch->add_server( server ) );
+
+    DBus::Object::pointer object = DBus::Object::create( "/peer/path" );
+    object->create_method<double,double,double>( "test.Peer", "add", sigc::ptr_fun( example_method ) );
+    TEST_ASSERT_RET_FAIL( server->register_object( object ) );
+
+    DBus::Connection::pointer client = DBus::Connection::create_peer( server->address() );
+    TEST_ASSERT_RET_FAIL( dispatch->add_connection( client ) );
+
+    DBus::CallMessage::pointer msg = DBus::CallMessage::create( "/peer/path", "test.Peer", "add" );
+    *msg << 1.0 << 2.0;
+    DBus::Message::pointer reply = call_and_wait( client, msg );
+    TEST_ASSERT_RET_FAIL( reply and reply->type() == DBus::RETURN_MESSAGE );
+
+    return server->connections().size() == 1;
+}
+
+bool server_call_timeout(){
+    std::ostringstream address;
+    address << "unix:abstract=dbus-cxx-timeout-" << getpid();
+
+    // Nobody services the server, so the call is never answered
+    DBus::Server::pointer server = DBus::Server::create( address.str() );
+    DBus::Connection::pointer client = DBus::Connection::create_peer( server->address() );
+    TEST_ASSERT_RET_FAIL( dispatch->add_connection( client ) );
+
+    // The dispatcher handles the reply timeout, which completes the call with an error
+    DBus::CallMessage::pointer msg = DBus::CallMessage::create( "/peer/path", "test.Peer", "add" );
+    DBus::Message::pointer reply = wait_for_reply( client->send_with_reply_async( msg, 100 ), 2000 );
+
+    return reply and reply->type() == DBus::ERROR_MESSAGE;
+}
+
+#define ADD_TEST(name) do{ if( test_name == STRINGIFY(name) ){ \
+  ret = server_##name();\
+} \
+} while( 0 )
+
+int main(int argc, char** argv){
+  if(argc < 1)
+    return 1;
+
+  std::string test_name = argv[1];
+  bool ret = false;
+
+  DBus::init();
+  dispatch = DBus::Dispatcher::create();
+
+  ADD_TEST(peer);
+  ADD_TEST(call_timeout);
+
+  return !ret;
+}
@@ -18,6 +18,7 @@
  ***************************************************************************/
 #include <dbus-cxx.h>
 #include <unistd.h>
+#include <sstream>
 
 #include "test_macros.h"
 
@@ -52,6 +53,122 @@ bool signal_tx_rx(){
     return true;
 }
 
+int rate_count = 0;
+
+void rateHandle( std::string value ){
+    signal_value = value;
+    rate_count++;
+}
+
+bool signal_rate_limit(){
+    DBus::Connection::pointer conn = dispatch->create_connection(DBus::BUS_SESSION);
+
+    DBus::signal<void,std::string>::pointer signal = conn->create_signal<void,std::string>( "/test/signal", "test.signal.type", "Rate" );
+    DBus::signal_proxy<void,std::string>::pointer proxy = conn->create_signal_proxy<void,std::string>( "/test/signal", "test.signal.type", "Rate" );
+
+    proxy->connect( sigc::ptr_fun( rateHandle ) );
+
+    signal->set_max_rate( 10 );
+    signal->set_coalesce_by_path();
+    signal->set_trailing_flush();
+
+    for ( int i = 0; i < 1000; i++ ) {
+        std::ostringstream value;
+        value << "v" << i;
+        signal->emit( value.str() );
+    }
+    TEST_ASSERT_RET_FAIL( signal->suppressed_emissions() > 0 );
+
+    // Another path has its own window
+    unsigned long suppressed = signal->suppressed_emissions();
+    signal->emit_on_path( "/test/other", "other" );
+    TEST_ASSERT_RET_FAIL( signal->suppressed_emissions() == suppressed );
+
+    // Sent now rather than when the window closes
+    signal->flush_emissions();
+    for ( int i = 0; i < 100 and signal_value != "v999"; i++ )
+        usleep( 10000 );
+
+    // The last value always arrives through the trailing flush
+    TEST_ASSERT_RET_FAIL( signal_value == "v999" );
+    TEST_ASSERT_RET_FAIL( signal->flushed_emissions() >= 1 );
+    return rate_count == (int)( 1000 - suppressed + signal->flushed_emissions() );
+}
+
+typedef DBus::signal_proxy<void,std::string>::Batch StringBatch;
+
+int batch_count = 0;
+int batch_items = 0;
+
+void batchHandle( const StringBatch& batch ){
+    batch_count++;
+    batch_items += batch.size();
+    signal_value = std::get<0>( batch.back() );
+}
+
+bool signal_batch(){
+    DBus::Connection::pointer conn = dispatch->create_connection(DBus::BUS_SESSION);
+
+    DBus::signal<void,std::string>::pointer signal = conn->create_signal<void,std::string>( "/test/signal", "test.signal.type", "Batch" );
+    DBus::signal_proxy<void,std::string>::pointer proxy = conn->create_signal_proxy<void,std::string>( "/test/signal", "test.signal.type", "Batch" );
+
+    proxy->set_batch_delivery();
+    proxy->signal_batch().connect( sigc::ptr_fun( batchHandle ) );
+    proxy->connect( sigc::ptr_fun( rateHandle ) );
+    rate_count = 0;
+
+    for ( int i = 0; i < 100; i++ ) {
+        std::ostringstream value;
+        value << "v" << i;
+        signal->emit( value.str() );
+    }
+
+    for ( int i = 0; i < 100 and batch_items < 100; i++ )
+        usleep( 10000 );
+
+    TEST_ASSERT_RET_FAIL( batch_items == 100 );
+    TEST_ASSERT_RET_FAIL( batch_count <= batch_items );
+
+    // Regular slots still see every signal
+    TEST_ASSERT_RET_FAIL( rate_count == 100 );
+    return signal_value == "v99";
+}
+
+bool signal_batch_coalesce(){
+    DBus::Connection::pointer conn = dispatch->create_connection(DBus::BUS_SESSION);
+
+    DBus::signal<void,std::string>::pointer signal = conn->create_signal<void,std::string>( "/test/signal", "test.signal.type", "Coalesce" );
+    DBus::signal_proxy<void,std::string>::pointer proxy = conn->create_signal_proxy<void,std::string>( "/test/signal", "test.signal.type", "Coalesce" );
+
+    proxy->set_batch_delivery();
+    proxy->set_batch_coalescing();
+    proxy->signal_batch().connect( sigc::ptr_fun( batchHandle ) );
+
+    for ( int i = 0; i < 100; i++ ) {
+        std::ostringstream value;
+        value << "v" << i;
+        signal->emit( value.str() );
+    }
+
+    for ( int i = 0; i < 100 and batch_items + (int)proxy->coalesced_signals() < 100; i++ )
+        usleep( 10000 );
+
+    // Each batch holds at most one signal for our only sender and path
+    TEST_ASSERT_RET_FAIL( batch_items == batch_count );
+    TEST_ASSERT_RET_FAIL( batch_items + proxy->coalesced_signals() == 100 );
+
+    // Only the signals that reached the batch slot count as delivered
+    TEST_ASSERT_RET_FAIL( proxy->metrics().deliveries() == (uint64_t)batch_items );
+
+    // A signal of the wrong type is turned away instead of replacing a queued one
+    unsigned long coalesced = proxy->coalesced_signals();
+    DBus::SignalMessage::pointer wrong = DBus::SignalMessage::create( "/test/signal", "test.signal.type", "Coalesce" );
+    *wrong << (int32_t)42;
+    TEST_ASSERT_RET_FAIL( proxy->handle_signal( wrong ) == DBus::NOT_HANDLED );
+    TEST_ASSERT_RET_FAIL( proxy->coalesced_signals() == coalesced );
+    return signal_value == "v99";
+}
+
 #define ADD_TEST(name) do{ if( test_name == STRINGIFY(name) ){ \
   ret = signal_##name();\
 } \
@@ -69,6 +186,9 @@ int main(int argc, char** argv){
 
   ADD_TEST(create);
   ADD_TEST(tx_rx);
+  ADD_TEST(rate_limit);
+  ADD_TEST(batch);
+  ADD_TEST(batch_coalesce);
 
   return !ret;
 }
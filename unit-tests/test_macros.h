@@ -10,4 +10,24 @@
 #define STR_EXPAND(tok) #tok
 #define STRINGIFY(tok) STR_EXPAND(tok)
 
+#include <unistd.h>
+#include <dbus-cxx.h>
+
+/*
+ * Polls for the reply rather than blocking in libdbus, which would race
+ * the dispatch thread for the reply on the same connection. Returns a
+ * null pointer if no reply came within the timeout.
+ */
+inline DBus::Message::pointer wait_for_reply( DBus::PendingCall::pointer pending, int timeout_milliseconds = 1000 ){
+    if ( not pending ) return DBus::Message::pointer();
+    for ( int i = 0; i < timeout_milliseconds / 10 and not pending->completed(); i++ ) usleep( 10000 );
+    if ( not pending->completed() ) return DBus::Message::pointer();
+    return pending->steal_reply();
+}
+
+/* Sends the call on the connection and waits for its reply as wait_for_reply() */
+inline DBus::Message::pointer call_and_wait( DBus::Connection::pointer conn, DBus::CallMessage::pointer msg, int timeout_milliseconds = 1000 ){
+    return wait_for_reply( conn->send_with_reply_async( msg ), timeout_milliseconds );
+}
+
 #endif
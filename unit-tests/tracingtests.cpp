@@ -0,0 +1,152 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by agent                                           *
+ *   agent@local                                                           *
+ *                                                                         *
+ *   This file is part of the dbus-cxx library.                            *
+ *                                                                         *
+ *   The dbus-cxx library is free software; you can redistribute it and/or *
+ *   modify it under the terms of the GNU General Public License           *
+ *   version 3 as published by the Free Software Foundation.               *
+ *                                                                         *
+ *   The dbus-cxx library is distributed in the hope that it will be       *
+ *   useful, but WITHOUT ANY WARRANTY; without even the implied warranty   *
+ *   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU   *
+ *   General Public License for more details.                              *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this software. If not see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#include <dbus-cxx.h>
+#include <unistd.h>
+#include <sstream>
+#include <thread>
+
+#include "test_macros.h"
+
+DBus::Dispatcher::pointer dispatch;
+
+DBus::LoopbackBus::pointer bus;
+
+double add( double a, double b ){
+    return a + b;
+}
+
+size_t count_events( const std::vector<DBus::TraceRecord>& records, DBus::TraceEvent event ){
+    size_t count = 0;
+    for ( size_t i = 0; i < records.size(); i++ )
+        if ( records[i].event == event ) count++;
+    return count;
+}
+
+bool tracing_disabled(){
+    DBus::CallMessage::pointer msg = DBus::CallMessage::create( "test.tracing", "/tracing", "test.Tracing", "nothing" );
+
+    DBus::setTracing( false );
+    DBus::clearTrace();
+    DBUSCXX_TRACE( MESSAGE_RECEIVED, msg->cobj() );
+    return DBus::traceRecords().empty();
+}
+
+bool tracing_ring(){
+    DBus::CallMessage::pointer msg = DBus::CallMessage::create( "test.tracing", "/tracing", "test.Tracing", "ring" );
+
+    // The ring of this thread is created with the first event
+    DBus::setTracing( true, 8 );
+    DBus::clearTrace();
+
+    for ( int i = 0; i < 20; i++ ) DBUSCXX_TRACE( MESSAGE_RECEIVED, msg->cobj() );
+
+    std::thread other( [](){ DBUSCXX_TRACE_SERIAL( REPLY_RECEIVED, 42 ); } );
+    other.join();
+
+    std::vector<DBus::TraceRecord> records = DBus::traceRecords();
+    TEST_ASSERT_RET_FAIL( count_events( records, DBus::TRACE_MESSAGE_RECEIVED ) == 8 );
+    TEST_ASSERT_RET_FAIL( count_events( records, DBus::TRACE_REPLY_RECEIVED ) == 1 );
+    TEST_ASSERT_RET_FAIL( records.back().reply_serial == 42 );
+    TEST_ASSERT_RET_FAIL( std::string( records.front().member ) == "ring" );
+
+    for ( size_t i = 1; i < records.size(); i++ )
+        TEST_ASSERT_RET_FAIL( records[i - 1].timestamp <= records[i].timestamp );
+
+    DBus::clearTrace();
+    return DBus::traceRecords().empty();
+}
+
+bool tracing_lifecycle(){
+    DBus::Connection::pointer server = bus->create_connection();
+    DBus::Connection::pointer client = bus->create_connection();
+
+    server->request_name( "test.tracing.Lifecycle" );
+    DBus::Object::pointer object = server->create_object( "/tracing/lifecycle" );
+    object->create_method<double,double,double>( "test.Tracing", "add", sigc::ptr_fun( add ) );
+
+    DBus::setTracing( true );
+    DBus::clearTrace();
+
+    DBus::CallMessage::pointer msg = DBus::CallMessage::create( "test.tracing.Lifecycle", "/tracing/lifecycle", "test.Tracing", "add" );
+    *msg << 1.0 << 2.0;
+    TEST_ASSERT_RET_FAIL( call_and_wait( client, msg ) );
+
+    std::vector<DBus::TraceRecord> records = DBus::traceRecords();
+    DBus::setTracing( false );
+
+    TEST_ASSERT_RET_FAIL( count_events( records, DBus::TRACE_MESSAGE_ROUTED ) == 1 );
+    TEST_ASSERT_RET_FAIL( count_events( records, DBus::TRACE_DEMARSHALLED ) == 1 );
+    TEST_ASSERT_RET_FAIL( count_events( records, DBus::TRACE_HANDLER_BEGIN ) == 1 );
+    TEST_ASSERT_RET_FAIL( count_events( records, DBus::TRACE_HANDLER_END ) == 1 );
+    // The loopback bus forwards both messages over its own connections
+    TEST_ASSERT_RET_FAIL( count_events( records, DBus::TRACE_MESSAGE_QUEUED ) == 4 );
+    TEST_ASSERT_RET_FAIL( count_events( records, DBus::TRACE_REPLY_RECEIVED ) == 1 );
+
+    // The handler runs between the call being routed and the reply being queued
+    size_t i = 0;
+    const DBus::TraceEvent order[] = { DBus::TRACE_MESSAGE_QUEUED, DBus::TRACE_MESSAGE_ROUTED,
+      DBus::TRACE_HANDLER_BEGIN, DBus::TRACE_HANDLER_END, DBus::TRACE_MESSAGE_QUEUED, DBus::TRACE_REPLY_RECEIVED };
+    for ( size_t j = 0; j < records.size() and i < 6; j++ )
+        if ( records[j].event == order[i] ) i++;
+    return i == 6;
+}
+
+bool tracing_chrome(){
+    DBus::CallMessage::pointer msg = DBus::CallMessage::create( "test.tracing", "/tracing", "test.Tracing", "chrome" );
+    std::ostringstream stream;
+
+    DBus::setTracing( true );
+    DBus::clearTrace();
+    DBUSCXX_TRACE( HANDLER_BEGIN, msg->cobj() );
+    DBUSCXX_TRACE( HANDLER_END, msg->cobj() );
+    DBUSCXX_TRACE( MESSAGE_QUEUED, msg->cobj() );
+    DBus::setTracing( false );
+
+    DBus::writeChromeTrace( stream );
+    std::string json = stream.str();
+
+    TEST_ASSERT_RET_FAIL( json.find( "{\"traceEvents\":[" ) == 0 );
+    TEST_ASSERT_RET_FAIL( json.find( "\"name\":\"chrome\",\"cat\":\"handler\",\"ph\":\"B\"" ) != std::string::npos );
+    TEST_ASSERT_RET_FAIL( json.find( "\"name\":\"chrome\",\"cat\":\"handler\",\"ph\":\"E\"" ) != std::string::npos );
+    return json.find( "\"name\":\"queued\",\"cat\":\"message\",\"ph\":\"i\"" ) != std::string::npos;
+}
+
+#define ADD_TEST(name) do{ if( test_name == STRINGIFY(name) ){ \
+  ret = tracing_##name();\
+} \
+} while( 0 )
+
+int main(int argc, char** argv){
+  if(argc < 2)
+    return 1;
+
+  std::string test_name = argv[1];
+  bool ret = false;
+
+  DBus::init();
+  dispatch = DBus::Dispatcher::create();
+  bus = DBus::LoopbackBus::create( dispatch );
+
+  ADD_TEST(disabled);
+  ADD_TEST(ring);
+  ADD_TEST(lifecycle);
+  ADD_TEST(chrome);
+
+  return !ret;
+}
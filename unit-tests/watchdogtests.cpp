@@ -0,0 +1,128 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by agent                                           *
+ *   agent@local                                                           *
+ *                                                                         *
+ *   This file is part of the dbus-cxx library.                            *
+ *                                                                         *
+ *   The dbus-cxx library is free software; you can redistribute it and/or *
+ *   modify it under the terms of the GNU General Public License           *
+ *   version 3 as published by the Free Software Foundation.               *
+ *                                                                         *
+ *   The dbus-cxx library is distributed in the hope that it will be       *
+ *   useful, but WITHOUT ANY WARRANTY; without even the implied warranty   *
+ *   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU   *
+ *   General Public License for more details.                              *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this software. If not see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#include <dbus-cxx.h>
+#include <unistd.h>
+#include <signal.h>
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+#include "test_macros.h"
+
+DBus::Dispatcher::pointer dispatch;
+
+DBus::LoopbackBus::pointer bus;
+
+std::mutex reports_mutex;
+
+std::vector<DBus::Dispatcher::SlowHandler> reports;
+
+void on_slow_handler( const DBus::Dispatcher::SlowHandler& report ){
+    std::lock_guard<std::mutex> lock( reports_mutex );
+    reports.push_back( report );
+}
+
+/* Keeps running for the whole time, even if a signal interrupts a sleep */
+int slow( int milliseconds ){
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now() + std::chrono::milliseconds( milliseconds );
+    while ( std::chrono::steady_clock::now() < end )
+        std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+    return milliseconds;
+}
+
+bool call_slow( int milliseconds ){
+    DBus::Connection::pointer server = bus->create_connection();
+    DBus::Connection::pointer client = bus->create_connection();
+
+    server->request_name( "test.watchdog.Slow" );
+    DBus::Object::pointer object = server->create_object( "/watchdog" );
+    object->create_method<int,int>( "test.Watchdog", "slow", sigc::ptr_fun( slow ) );
+
+    DBus::CallMessage::pointer msg = DBus::CallMessage::create( "test.watchdog.Slow", "/watchdog", "test.Watchdog", "slow" );
+    *msg << milliseconds;
+    return bool( call_and_wait( client, msg, 2000 ) );
+}
+
+bool watchdog_fast(){
+    dispatch->set_watchdog( std::chrono::milliseconds( 500 ) );
+    TEST_ASSERT_RET_FAIL( call_slow( 1 ) );
+
+    std::lock_guard<std::mutex> lock( reports_mutex );
+    return reports.empty();
+}
+
+bool watchdog_slow(){
+    dispatch->set_watchdog( std::chrono::milliseconds( 20 ) );
+    TEST_ASSERT_RET_FAIL( dispatch->watchdog_budget() == std::chrono::milliseconds( 20 ) );
+    TEST_ASSERT_RET_FAIL( call_slow( 200 ) );
+    usleep( 50000 );
+
+    std::lock_guard<std::mutex> lock( reports_mutex );
+    bool live = false;
+    bool finished = false;
+    for ( size_t i = 0; i < reports.size(); i++ ) {
+        if ( reports[i].member != "slow" ) continue;
+        TEST_ASSERT_RET_FAIL( reports[i].path == "/watchdog" );
+        TEST_ASSERT_RET_FAIL( reports[i].interface == "test.Watchdog" );
+        TEST_ASSERT_RET_FAIL( reports[i].type == DBus::CALL_MESSAGE );
+        if ( reports[i].finished ) {
+            finished = true;
+            TEST_ASSERT_RET_FAIL( reports[i].duration >= std::chrono::milliseconds( 200 ) );
+        }
+        else {
+            live = true;
+            TEST_ASSERT_RET_FAIL( reports[i].duration < std::chrono::milliseconds( 200 ) );
+        }
+    }
+    return live and finished;
+}
+
+bool watchdog_backtrace(){
+    dispatch->set_watchdog( std::chrono::milliseconds( 20 ), SIGRTMIN + 2 );
+    TEST_ASSERT_RET_FAIL( call_slow( 100 ) );
+
+    std::lock_guard<std::mutex> lock( reports_mutex );
+    for ( size_t i = 0; i < reports.size(); i++ )
+        if ( reports[i].member == "slow" and not reports[i].finished ) return not reports[i].backtrace.empty();
+    return false;
+}
+
+#define ADD_TEST(name) do{ if( test_name == STRINGIFY(name) ){ \
+  ret = watchdog_##name();\
+} \
+} while( 0 )
+
+int main(int argc, char** argv){
+  if(argc < 2)
+    return 1;
+
+  std::string test_name = argv[1];
+  bool ret = false;
+
+  DBus::init();
+  dispatch = DBus::Dispatcher::create();
+  bus = DBus::LoopbackBus::create( dispatch );
+  dispatch->signal_slow_handler().connect( sigc::ptr_fun( on_slow_handler ) );
+
+  ADD_TEST(fast);
+  ADD_TEST(slow);
+  ADD_TEST(backtrace);
+
+  return !ret;
+}